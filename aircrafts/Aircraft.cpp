@@ -7,9 +7,18 @@
 #include "Aircraft.h"
 #include "worlds/Charger.h"
 
+#include <charconv>
+#include <cstring>
 #include <stdexcept>
 
-Aircraft::Aircraft(AircraftCompany eCompany)
+// The transitions used by the aircraft methods must be in the transitions table.
+static_assert(GetNextState(AircraftState::Idle, AircraftAction::TakeOff) == AircraftState::Flying, "Fly() needs Idle to Flying.");
+static_assert(GetNextState(AircraftState::Flying, AircraftAction::Land) == AircraftState::Idle, "Land() needs Flying to Idle.");
+static_assert(GetNextState(AircraftState::Idle, AircraftAction::Connect) == AircraftState::Charging, "ChargeAircraft() needs Idle to Charging.");
+static_assert(GetNextState(AircraftState::Queued, AircraftAction::Connect) == AircraftState::Charging, "ChargeAircraft() needs Queued to Charging.");
+static_assert(GetNextState(AircraftState::Charging, AircraftAction::Disconnect) == AircraftState::Idle, "StopCharging() needs Charging to Idle.");
+
+Aircraft::Aircraft(AircraftCompany eCompany, float fStateOfCharge)
 {
     // Throw an exception if the company is invalid.
     if (eCompany >= AircraftCompany::TotalCompanies)
@@ -17,125 +26,123 @@ Aircraft::Aircraft(AircraftCompany eCompany)
         throw std::runtime_error("Invalid aircraft company.");
     }
 
+    // Throw an exception if the state of charge is out of range, or not a number.
+    if (!(fStateOfCharge >= 0 && fStateOfCharge <= 1))
+    {
+        throw std::runtime_error("Invalid state of charge.");
+    }
+
     // Set the aircraft type.
     mpoAircraftType = AircraftType::GetAircraftType(eCompany);
 
     // Register the aircraft and get the aircraft Id.
     muiAircraftId = mpoAircraftType->RegisterAircraft();
 
-    // The aircraft is not flying.
-    mbIsFlying = false;
+    // The aircraft has not flown, the flights number its fault draws.
+    muiFlights = 0;
+
+    // The aircraft is on the ground.
+    meState = AircraftState::Idle;
 
     // The aircraft is not charging.
     mpoCharger = nullptr;
 
-    // The battery is fully charged.
-    mfBatteryCharge = mpoAircraftType->GetBatteryCapacity();
-}
+    // The battery is charged to the initial state of charge, full by default.
+    mfBatteryCharge = fStateOfCharge * mpoAircraftType->GetBatteryCapacity();
 
-string Aircraft::GetName() const
-{
-    return mpoAircraftType->CompanyName() + "-" + to_string(muiAircraftId);
+    // Build the name from the company name and the Id.
+    string_view sCompany = mpoAircraftType->CompanyName();
+    memcpy(macName, sCompany.data(), sCompany.size());
+    macName[sCompany.size()] = '-';
+    char* pcEnd = to_chars(macName + sCompany.size() + 1, macName + sizeof(macName), muiAircraftId).ptr;
+    muiNameSize = (uint8_t)(pcEnd - macName);
 }
 
-float Aircraft::GetCurrentRange() const
+float Aircraft::GetTimeToFullCharge() const
 {
-    return mfBatteryCharge / mpoAircraftType->GetEnergyUse();
+    // Return the time it will take to fully charge the aircraft from the current state of charge.
+    return mpoAircraftType->GetBatteryModel().GetTimeToCharge(GetStateOfCharge(), 1.0f);
 }
 
-float Aircraft::GetTimeToFullCharge() const
+float Aircraft::GetTimeToCharge(float fFromCharge, float fToCharge) const
 {
-    // Get how much charge the aircraft needs to be fully charged.
-    float fChargeNeeded = mpoAircraftType->GetBatteryCapacity() - mfBatteryCharge;
-
-    // Return the time it will take to fully charge the aircraft.
-    return mpoAircraftType->GetTimeToCharge() * fChargeNeeded / mpoAircraftType->GetBatteryCapacity();
+    const float kfInverseBatteryCapacity = mpoAircraftType->GetInverseBatteryCapacity();
+    return mpoAircraftType->GetBatteryModel().GetTimeToCharge(fFromCharge * kfInverseBatteryCapacity, fToCharge * kfInverseBatteryCapacity);
 }
 
-float Aircraft::Fly(float fDistance)
+float Aircraft::Fly(float fDistance) noexcept(!kbValidation)
 {
-    // Throw an exception if the aircraft is already flying.
-    if (mbIsFlying)
+    if constexpr (kbValidation)
     {
-        throw std::runtime_error("The aircraft is already flying.");
+        // Throw an exception if the distance is negative.
+        if (fDistance < 0)
+        {
+            throw std::runtime_error("The distance is negative.");
+        }
+
+        // Throw an exception if there is not enough battery charge to fly.
+        if (fDistance > GetCurrentRange())
+        {
+            throw std::runtime_error("Not enough battery charge to fly the distance.");
+        }
     }
 
-    // Throw an exception if the distance is negative.
-    if (fDistance < 0)
-    {
-        throw std::runtime_error("The distance is negative.");
-    }
-
-    // Throw an exception if there is not enough battery charge to fly.
-    if (fDistance > GetCurrentRange())
-    {
-        throw std::runtime_error("Not enough battery charge to fly the distance.");
-    }
+    // The aircraft changes its state to flying.
+    ChangeState(AircraftAction::TakeOff);
 
     // Consume the battery charge.
     mfBatteryCharge -= fDistance * mpoAircraftType->GetEnergyUse();
 
-    // The aircraft changes its state to flying.
-    mbIsFlying = true;
-
     // The time the aircraft will be flying in hours.
-    float fFlyingTime = fDistance / mpoAircraftType->GetCruiseSpeed();
+    float fFlyingTime = fDistance * mpoAircraftType->GetHoursPerMile();
 
     // Report the flight.
-    mpoAircraftType->ReportFlight(fDistance, fFlyingTime);
+    mpoAircraftType->ReportFlight(fDistance, fFlyingTime, muiAircraftId, muiFlights++);
 
     // Return the time the aircraft will be flying in hours.
     return fFlyingTime;
 }
 
-void Aircraft::Land()
+void Aircraft::Land() noexcept(!kbValidation)
 {
-    // Throw an exception if the aircraft is not flying.
-    if (!mbIsFlying)
-    {
-        throw std::runtime_error("The aircraft is not flying.");
-    }
-
     // The aircraft changes its state to not flying.
-    mbIsFlying = false;
+    ChangeState(AircraftAction::Land);
 }
 
-float Aircraft::ChargeAircraft(Charger* poCharger, float fEnergy)
+float Aircraft::ChargeAircraft(Charger* poCharger, float fEnergy, float fPowerFactor) noexcept(!kbValidation)
 {
-    // Throw an exception if the aircraft is already charging.
-    if (mpoCharger != nullptr)
-    {
-        throw std::runtime_error("The aircraft is already charging.");
-    }
-
-    // Throw an exception if the aircraft is flying.
-    if (mbIsFlying)
-    {
-        throw std::runtime_error("The aircraft is flying.");
-    }
-
-    // Throw an exception if the energy is negative.
-    if (fEnergy < 0)
-    {
-        throw std::runtime_error("The energy is negative.");
-    }
-
-    // Throw an exception if the energy exceeds the remaining battery capacity.
-    if (fEnergy > mpoAircraftType->GetBatteryCapacity() - mfBatteryCharge)
+    if constexpr (kbValidation)
     {
-        throw std::runtime_error("The energy exceeds the remaining battery capacity.");
+        // Throw an exception if the energy is negative.
+        if (fEnergy < 0)
+        {
+            throw std::runtime_error("The energy is negative.");
+        }
+
+        // Throw an exception if the energy exceeds the remaining battery capacity.
+        if (fEnergy > mpoAircraftType->GetBatteryCapacity() - mfBatteryCharge)
+        {
+            throw std::runtime_error("The energy exceeds the remaining battery capacity.");
+        }
+
+        // Throw an exception if the power factor is out of range.
+        if (fPowerFactor <= 0 || fPowerFactor > 1)
+        {
+            throw std::runtime_error("The power factor is out of range.");
+        }
     }
 
-    // Charge the aircraft.
+    // Connect the aircraft to the charger.
+    ChangeState(AircraftAction::Connect);
     mpoCharger = poCharger;
     mpoCharger->StartCharging();
 
+    // Get the time it will take to charge the aircraft in hours.
+    float fTimeToCharge = GetTimeToCharge(mfBatteryCharge, mfBatteryCharge + fEnergy) / fPowerFactor;
+
     // Charge the aircraft.
     mfBatteryCharge += fEnergy;
 
-    // Get the time it will take to charge the aircraft in hours.
-    float fTimeToCharge = mpoAircraftType->GetTimeToCharge() * fEnergy / mpoAircraftType->GetBatteryCapacity();
-
     // Report the charge session.
     mpoAircraftType->ReportChargeSession(fTimeToCharge);
 
@@ -143,13 +150,10 @@ float Aircraft::ChargeAircraft(Charger* poCharger, float fEnergy)
     return fTimeToCharge;
 }
 
-Charger* Aircraft::StopCharging()
+Charger* Aircraft::StopCharging() noexcept(!kbValidation)
 {
-    // Throw an exception if the aircraft is not charging.
-    if (mpoCharger == nullptr)
-    {
-        throw std::runtime_error("The aircraft is not charging.");
-    }
+    // Disconnect the aircraft from the charger.
+    ChangeState(AircraftAction::Disconnect);
 
     // Stop charging the aircraft.
     Charger* poCharger = mpoCharger;
@@ -159,3 +163,146 @@ Charger* Aircraft::StopCharging()
     // Return the charger that was charging the aircraft.
     return poCharger;
 }
+
+void Aircraft::MoveToState(AircraftState eState, float fBatteryCharge, Charger* poCharger) noexcept(!kbValidation)
+{
+    if constexpr (kbValidation)
+    {
+        // Throw an exception if the battery charge is out of range.
+        if (fBatteryCharge < 0 || fBatteryCharge > mpoAircraftType->GetBatteryCapacity())
+        {
+            throw std::runtime_error("The battery charge is out of range.");
+        }
+
+        // Throw an exception if the charger does not match the new state.
+        if ((eState == AircraftState::Charging) != (poCharger != nullptr))
+        {
+            throw std::runtime_error("Only a charging aircraft uses a charger.");
+        }
+    }
+
+    // Get back to idle with the action leaving the current state.
+    switch (meState)
+    {
+        case AircraftState::Queued:
+        {
+            ChangeState(AircraftAction::Dequeue);
+        }
+        break;
+
+        case AircraftState::Charging:
+        {
+            ChangeState(AircraftAction::Disconnect);
+            mpoCharger->StopCharging();
+            mpoCharger = nullptr;
+        }
+        break;
+
+        case AircraftState::Flying:
+        {
+            ChangeState(AircraftAction::Land);
+        }
+        break;
+
+        case AircraftState::Faulted:
+        {
+            ChangeState(AircraftAction::Repair);
+        }
+        break;
+
+        default:
+        {
+            // The aircraft is idle already.
+        }
+        break;
+    }
+
+    // Enter the new state with the actions leading to it from idle.
+    switch (eState)
+    {
+        case AircraftState::Queued:
+        {
+            ChangeState(AircraftAction::Queue);
+        }
+        break;
+
+        case AircraftState::Charging:
+        {
+            ChangeState(AircraftAction::Connect);
+            mpoCharger = poCharger;
+            mpoCharger->StartCharging();
+        }
+        break;
+
+        case AircraftState::Flying:
+        {
+            ChangeState(AircraftAction::TakeOff);
+        }
+        break;
+
+        case AircraftState::Faulted:
+        {
+            ChangeState(AircraftAction::TakeOff);
+            ChangeState(AircraftAction::Fault);
+        }
+        break;
+
+        default:
+        {
+            // The aircraft stays idle.
+        }
+        break;
+    }
+
+    mfBatteryCharge = fBatteryCharge;
+}
+
+void Aircraft::RevertFly(float fDistance) noexcept(!kbValidation)
+{
+    // The aircraft is on the ground again.
+    ChangeState(AircraftAction::Land);
+
+    // Revert the flight report with the same flying time calculated by Fly().
+    mpoAircraftType->RevertFlight(fDistance, fDistance * mpoAircraftType->GetHoursPerMile(), muiAircraftId, --muiFlights);
+
+    // Restore the battery charge.
+    mfBatteryCharge += fDistance * mpoAircraftType->GetEnergyUse();
+}
+
+void Aircraft::RevertLand() noexcept(!kbValidation)
+{
+    // The aircraft is flying again.
+    ChangeState(AircraftAction::TakeOff);
+}
+
+void Aircraft::RevertChargeAircraft(float fEnergy, float fPowerFactor) noexcept(!kbValidation)
+{
+    // Disconnect the charger.
+    ChangeState(AircraftAction::Disconnect);
+    mpoCharger->StopCharging();
+    mpoCharger = nullptr;
+
+    // Revert the charge session report with the time calculated by ChargeAircraft().
+    mpoAircraftType->RevertChargeSession(GetTimeToCharge(mfBatteryCharge - fEnergy, mfBatteryCharge) / fPowerFactor);
+
+    // Restore the battery charge.
+    mfBatteryCharge -= fEnergy;
+}
+
+void Aircraft::RevertStopCharging(Charger* poCharger) noexcept(!kbValidation)
+{
+    // Connect the charger again.
+    ChangeState(AircraftAction::Connect);
+    mpoCharger = poCharger;
+    mpoCharger->StartCharging();
+}
+
+void Aircraft::ThrowInvalidAction(AircraftAction eAction) const
+{
+    static const char* const kapcActions[] = { "take off", "land", "queue", "dequeue", "connect", "disconnect", "fault", "repair" };
+    static_assert(sizeof(kapcActions) / sizeof(kapcActions[0]) == (size_t)AircraftAction::TotalActions,
+                  "The action names do not match the aircraft actions.");
+
+    throw std::runtime_error(string("The aircraft cannot ") + kapcActions[(size_t)eAction]
+        + " while " + AircraftStateName(meState) + ".");
+}
@@ -16,6 +16,12 @@ TEST_CASE( "Aircraft::Aircraft", )
 
     // Check if we get an exception with a negative company.
     REQUIRE_THROWS(Aircraft((AircraftCompany)-1));
+
+    // Check the initial state of charge, full by default and within [0, 1].
+    REQUIRE(Aircraft(AircraftCompany::Bravo).GetStateOfCharge() == 1.0f);
+    REQUIRE(Aircraft(AircraftCompany::Bravo, 0.25f).GetBatteryCharge() == 25.0f);
+    REQUIRE_THROWS(Aircraft(AircraftCompany::Bravo, -0.1f));
+    REQUIRE_THROWS(Aircraft(AircraftCompany::Bravo, 1.5f));
 }
 
 // Test the Aircraft::GetName() method.
@@ -240,3 +246,150 @@ TEST_CASE( "Aircraft::GetCharger", )
     REQUIRE(oAircraft.GetCharger() == &oCharger);
 }
 
+
+// Test the Aircraft::RevertFly() method.
+TEST_CASE( "Aircraft::RevertFly", )
+{
+    // Check if we get an exception when reverting a flight of an aircraft that is not flying.
+    Aircraft oAircraft(AircraftCompany::Alpha);
+    REQUIRE_THROWS(oAircraft.RevertFly(1));
+
+    // Check if the battery charge and the statistics are restored after reverting a flight.
+    AircraftType* poAircraftType = oAircraft.GetAircraftType();
+    uint32_t uiFlights = poAircraftType->TotalFlights();
+    uint32_t uiFaults = poAircraftType->TotalNumberOfFaults();
+    const float fRange = oAircraft.GetCurrentRange();
+    oAircraft.Fly(fRange);
+    uint32_t uiFlightFaults = poAircraftType->TotalNumberOfFaults() - uiFaults;
+    oAircraft.RevertFly(fRange);
+    REQUIRE_FALSE(oAircraft.IsFlying());
+    REQUIRE(oAircraft.GetBatteryCharge() == poAircraftType->GetBatteryCapacity());
+    REQUIRE(poAircraftType->TotalFlights() == uiFlights);
+    REQUIRE(poAircraftType->TotalNumberOfFaults() == uiFaults);
+
+    // Check if flying again draws the same faults.
+    oAircraft.Fly(fRange);
+    REQUIRE(poAircraftType->TotalNumberOfFaults() - uiFaults == uiFlightFaults);
+}
+
+// Test the Aircraft::RevertLand() method.
+TEST_CASE( "Aircraft::RevertLand", )
+{
+    // Check if we get an exception when reverting a landing of an aircraft that is flying.
+    Aircraft oAircraft(AircraftCompany::Alpha);
+    oAircraft.Fly(oAircraft.GetCurrentRange());
+    REQUIRE_THROWS(oAircraft.RevertLand());
+
+    // Check if the aircraft is flying after reverting the landing.
+    oAircraft.Land();
+    oAircraft.RevertLand();
+    REQUIRE(oAircraft.IsFlying());
+}
+
+// Test the Aircraft::RevertChargeAircraft() method.
+TEST_CASE( "Aircraft::RevertChargeAircraft", )
+{
+    // Check if we get an exception when reverting a charge of an aircraft that is not charging.
+    Aircraft oAircraft(AircraftCompany::Alpha);
+    REQUIRE_THROWS(oAircraft.RevertChargeAircraft(0.5f));
+
+    // Check if the battery charge, the charger and the statistics are restored after reverting a charge.
+    oAircraft.Fly(oAircraft.GetCurrentRange());
+    oAircraft.Land();
+    uint32_t uiChargeSessions = oAircraft.GetAircraftType()->TotalChargeSessions();
+    Charger oCharger;
+    oAircraft.ChargeAircraft(&oCharger, 0.5f);
+    oAircraft.RevertChargeAircraft(0.5f);
+    REQUIRE(oAircraft.GetBatteryCharge() == 0);
+    REQUIRE_FALSE(oAircraft.IsCharging());
+    REQUIRE_FALSE(oCharger.IsCharging());
+    REQUIRE(oAircraft.GetAircraftType()->TotalChargeSessions() == uiChargeSessions);
+}
+
+// Test the Aircraft::RevertStopCharging() method.
+TEST_CASE( "Aircraft::RevertStopCharging", )
+{
+    // Check if the aircraft is connected to the same charger after reverting a stop charging.
+    Aircraft oAircraft(AircraftCompany::Alpha);
+    oAircraft.Fly(oAircraft.GetCurrentRange());
+    oAircraft.Land();
+    Charger oCharger;
+    oAircraft.ChargeAircraft(&oCharger, 0.5f);
+    oAircraft.RevertStopCharging(oAircraft.StopCharging());
+    REQUIRE(oAircraft.GetCharger() == &oCharger);
+    REQUIRE(oCharger.IsCharging());
+
+    // Check if we get an exception when reverting a stop charging of an aircraft that is charging.
+    REQUIRE_THROWS(oAircraft.RevertStopCharging(&oCharger));
+}
+
+// Test the Aircraft::GetState() method.
+TEST_CASE( "Aircraft::GetState", )
+{
+    // Check the aircraft goes through the states of a flight and a charge.
+    Aircraft oAircraft(AircraftCompany::Alpha);
+    REQUIRE(oAircraft.GetState() == AircraftState::Idle);
+    oAircraft.Fly(oAircraft.GetCurrentRange());
+    REQUIRE(oAircraft.GetState() == AircraftState::Flying);
+    oAircraft.Land();
+    REQUIRE(oAircraft.GetState() == AircraftState::Idle);
+    oAircraft.Queue();
+    REQUIRE(oAircraft.GetState() == AircraftState::Queued);
+    Charger oCharger;
+    oAircraft.ChargeAircraft(&oCharger, 0.1f);
+    REQUIRE(oAircraft.GetState() == AircraftState::Charging);
+    oAircraft.StopCharging();
+    REQUIRE(oAircraft.GetState() == AircraftState::Idle);
+}
+
+// Test the Aircraft::Queue() and Aircraft::Dequeue() methods.
+TEST_CASE( "Aircraft::Queue", )
+{
+    // Check if we get an exception when queueing an aircraft that is flying.
+    Aircraft oAircraft(AircraftCompany::Alpha);
+    oAircraft.Fly(1);
+    REQUIRE_THROWS(oAircraft.Queue());
+
+    // Check if we get an exception when queueing an aircraft already queued.
+    oAircraft.Land();
+    oAircraft.Queue();
+    REQUIRE_THROWS(oAircraft.Queue());
+
+    // Check if we get an exception when taking off from the queue.
+    REQUIRE_THROWS(oAircraft.Fly(1));
+
+    // Check if the aircraft is idle after leaving the queue, and cannot leave it twice.
+    oAircraft.Dequeue();
+    REQUIRE(oAircraft.GetState() == AircraftState::Idle);
+    REQUIRE_THROWS(oAircraft.Dequeue());
+}
+
+// Test the Aircraft::MoveToState() method.
+TEST_CASE( "Aircraft::MoveToState", )
+{
+    // Check the aircraft gets the state and the charge without reporting anything.
+    AircraftType::ResetStatistics();
+    Aircraft oAircraft(AircraftCompany::Alpha);
+    AircraftType* poAircraftType = oAircraft.GetAircraftType();
+    oAircraft.MoveToState(AircraftState::Flying, 100);
+    REQUIRE(oAircraft.GetState() == AircraftState::Flying);
+    REQUIRE(oAircraft.GetBatteryCharge() == 100);
+    REQUIRE(poAircraftType->TotalFlights() == 0);
+
+    // Check the charger follows the aircraft into and out of the charging state.
+    Charger oCharger;
+    oAircraft.MoveToState(AircraftState::Charging, 120, &oCharger);
+    REQUIRE(oAircraft.GetCharger() == &oCharger);
+    REQUIRE(oCharger.IsCharging());
+    oAircraft.MoveToState(AircraftState::Queued, 120);
+    REQUIRE(oAircraft.GetState() == AircraftState::Queued);
+    REQUIRE(oAircraft.GetCharger() == nullptr);
+    REQUIRE(!oCharger.IsCharging());
+    REQUIRE(poAircraftType->TotalChargeSessions() == 0);
+
+    // Check if we get an exception with a charge out of range or a charger not matching the state.
+    REQUIRE_THROWS(oAircraft.MoveToState(AircraftState::Flying, -1));
+    REQUIRE_THROWS(oAircraft.MoveToState(AircraftState::Flying, poAircraftType->GetBatteryCapacity() + 1));
+    REQUIRE_THROWS(oAircraft.MoveToState(AircraftState::Charging, 100));
+    REQUIRE_THROWS(oAircraft.MoveToState(AircraftState::Idle, 100, &oCharger));
+}
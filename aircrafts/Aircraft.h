@@ -1,9 +1,12 @@
 #ifndef _AIRCRAFT_H_
 #define _AIRCRAFT_H_
 
+#include "AircraftState.h"
 #include "AircraftType.h"
+#include "utils/Validation.h"
 
 #include <cstdint>
+#include <string_view>
 
 using namespace std;
 class Charger;
@@ -15,6 +18,11 @@ class Charger;
  *       It represents an aircraft in a simulation world where the
  *       only existing aircrafts are eVTOLs.
  * 
+ * @note  The state changes follow the kaeAircraftTransitions table. The
+ *        states and arguments are only checked in validation builds, see
+ *        Validation.h, otherwise the methods are noexcept and the callers
+ *        must drive the aircraft through valid transitions.
+ * 
  */
 class Aircraft
 {
@@ -25,8 +33,12 @@ public:
      * @brief Construct a new Aircraft object
      * 
      * @param eCompany              The aircraft company.
+     * @param fStateOfCharge        The initial battery charge as a fraction of the capacity.
+     * 
+     * @throw std::runtime_error if the company is invalid or the state of charge
+     *        is not in the range [0, 1].
      */
-    Aircraft(AircraftCompany eCompany);
+    Aircraft(AircraftCompany eCompany, float fStateOfCharge = 1.0f);
 
     /********** Destructor **********/
 
@@ -44,14 +56,21 @@ public:
      * 
      * @return If the aircraft is charging.
      */
-    inline bool IsCharging() const { return mpoCharger != nullptr; }
+    inline bool IsCharging() const { return meState == AircraftState::Charging; }
 
     /**
      * @brief Gets if the aircraft is flying.
      * 
      * @return If the aircraft is flying.
      */
-    inline bool IsFlying() const { return mbIsFlying; }
+    inline bool IsFlying() const { return meState == AircraftState::Flying; }
+
+    /**
+     * @brief Gets the aircraft state.
+     * 
+     * @return The aircraft state.
+     */
+    inline AircraftState GetState() const { return meState; }
 
     /**
      * @brief Gets the current charger attached to the aircraft.
@@ -65,7 +84,7 @@ public:
      * 
      * @return The aircraft Id.
      */
-    inline uint8_t GetId() const { return muiAircraftId; }
+    inline uint32_t GetId() const { return muiAircraftId; }
 
     /**
      * @brief Gets the aircraft type.
@@ -74,6 +93,13 @@ public:
      */
     inline AircraftType* GetAircraftType() const { return mpoAircraftType; }
 
+    /**
+     * @brief Gets the battery state of charge.
+     * 
+     * @return The battery charge as a fraction of the capacity.
+     */
+    inline float GetStateOfCharge() const { return mfBatteryCharge * mpoAircraftType->GetInverseBatteryCapacity(); }
+
     /**
      * @brief Gets the battery charge.
      * 
@@ -87,16 +113,16 @@ public:
     /**
      * @brief Gets the aircraft name composed of the company name and the Id.
      * 
-     * @return The aircraft name.
+     * @return The aircraft name, valid while the aircraft exists.
      */
-    string GetName() const;
+    inline string_view GetName() const { return string_view(macName, muiNameSize); }
 
     /**
      * @brief Gets the current range of the aircraft in miles.
      * 
      * @return The current range of the aircraft in miles.
      */
-    float GetCurrentRange() const;
+    inline float GetCurrentRange() const { return mfBatteryCharge * mpoAircraftType->GetMilesPerEnergy(); }
 
     /**
      * @brief Gets the time it takes to charge the aircraft to full from the current charge.
@@ -105,6 +131,17 @@ public:
      */
     float GetTimeToFullCharge() const;
 
+    /**
+     * @brief Gets the time it takes to charge the aircraft between two battery charges,
+     *        according to the aircraft type battery model.
+     * 
+     * @param fFromCharge   The initial battery charge in kWh.
+     * @param fToCharge     The target battery charge in kWh.
+     * 
+     * @return The time it takes to charge in hours.
+     */
+    float GetTimeToCharge(float fFromCharge, float fToCharge) const;
+
     /**
     * @brief Fly the aircraft for a given distance.
     * 
@@ -113,44 +150,149 @@ public:
     * @return The time the aircraft will be flying in hours.
     * 
     * @throw std::runtime_error if there is not enough battery charge to fly the distance,
-    *        if the aircraft is already flying, if the distance is negative, or if the aircraft is charging.
+    *        if the aircraft is not idle, or if the distance is negative (validation builds).
     */
-    float Fly(float fDistance);
+    float Fly(float fDistance) noexcept(!kbValidation);
     
     /**
      * @brief Land the aircraft indefinitely.
      * 
+     * @throw std::runtime_error if the aircraft is not flying (validation builds).
      */
-    void Land();
+    void Land() noexcept(!kbValidation);
+
+    /**
+     * @brief Put the aircraft in line for a free charger.
+     * 
+     * @throw std::runtime_error if the aircraft is not idle (validation builds).
+     */
+    inline void Queue() noexcept(!kbValidation) { ChangeState(AircraftAction::Queue); }
+
+    /**
+     * @brief Leave the line for a free charger without charging.
+     * 
+     * @throw std::runtime_error if the aircraft is not queued (validation builds).
+     */
+    inline void Dequeue() noexcept(!kbValidation) { ChangeState(AircraftAction::Dequeue); }
 
     /**
      * @brief Charge the aircraft.
      * 
      * @param poCharger     The charger to use to charge the aircraft.
      * @param fEnergy       The energy to charge the aircraft in kWh.
+     * @param fPowerFactor  The average fraction of the nominal charging power
+     *                      delivered by the charger, in the range (0, 1].
      * 
      * @return The time it takes to charge the aircraft in hours.
      * 
-     * @throw std::runtime_error if the aircraft is already charging or is flying,
-     *        if the energy is negative or exceeds the remaining battery capacity.
+     * @throw std::runtime_error if the aircraft is not idle or queued, if the energy
+     *        is negative or exceeds the remaining battery capacity, or if the power
+     *        factor is out of range (validation builds).
      */
-    float ChargeAircraft(Charger* poCharger, float fEnergy);
+    float ChargeAircraft(Charger* poCharger, float fEnergy, float fPowerFactor = 1.0f) noexcept(!kbValidation);
 
     /**
      * @brief Stop charging the aircraft and return the charger.
      * 
      * @return The charger that was charging the aircraft.
      * 
-     * @throw std::runtime_error if the aircraft is not charging.
+     * @throw std::runtime_error if the aircraft is not charging (validation builds).
      */
-    Charger* StopCharging();
+    Charger* StopCharging() noexcept(!kbValidation);
+
+    /**
+     * @brief Move the aircraft to the state of a world that tracks the fleet
+     *        in its own arrays, leaving the current state and entering the new
+     *        one through the transitions table, without reporting any flight
+     *        or charge session.
+     * 
+     * @param eState          The new state.
+     * @param fBatteryCharge  The battery charge in kWh.
+     * @param poCharger       The charger used if the new state is charging, nullptr otherwise.
+     * 
+     * @throw std::runtime_error if the battery charge is out of range, or if
+     *        the charger does not match the new state (validation builds).
+     */
+    void MoveToState(AircraftState eState, float fBatteryCharge, Charger* poCharger = nullptr) noexcept(!kbValidation);
+
+
+    /********** Reverse Methods **********/
+
+    /**
+     * @brief Revert a flight, restoring the battery charge and the aircraft
+     *        type statistics, including the random draw for the faults.
+     * 
+     * @param fDistance     The distance flown in miles.
+     * 
+     * @throw std::runtime_error if the aircraft is not flying (validation builds).
+     */
+    void RevertFly(float fDistance) noexcept(!kbValidation);
+
+    /**
+     * @brief Revert a landing, the aircraft is flying again.
+     * 
+     * @throw std::runtime_error if the aircraft is not idle (validation builds).
+     */
+    void RevertLand() noexcept(!kbValidation);
+
+    /**
+     * @brief Revert a charge, disconnecting the charger and restoring the
+     *        battery charge and the aircraft type statistics.
+     * 
+     * @param fEnergy       The energy charged in kWh.
+     * @param fPowerFactor  The power factor used to charge.
+     * 
+     * @throw std::runtime_error if the aircraft is not charging (validation builds).
+     */
+    void RevertChargeAircraft(float fEnergy, float fPowerFactor = 1.0f) noexcept(!kbValidation);
+
+    /**
+     * @brief Revert a stop charging, connecting the aircraft to the charger again.
+     * 
+     * @param poCharger     The charger returned by StopCharging().
+     * 
+     * @throw std::runtime_error if the aircraft is not idle or queued (validation builds).
+     */
+    void RevertStopCharging(Charger* poCharger) noexcept(!kbValidation);
 
 private:
+    /**
+     * @brief Change the aircraft state with an action, following the transitions table.
+     * 
+     * @param eAction   The action.
+     * 
+     * @throw std::runtime_error if the action is not valid in the current state (validation builds).
+     */
+    inline void ChangeState(AircraftAction eAction) noexcept(!kbValidation)
+    {
+        AircraftState eState = GetNextState(meState, eAction);
+        if constexpr (kbValidation)
+        {
+            if (eState == AircraftState::TotalStates)
+            {
+                ThrowInvalidAction(eAction);
+            }
+        }
+        meState = eState;
+    }
+
+    /**
+     * @brief Throw the exception for an action not valid in the current state.
+     * 
+     * @param eAction   The action.
+     */
+    [[noreturn]] void ThrowInvalidAction(AircraftAction eAction) const;
+
     AircraftType* mpoAircraftType;
     Charger* mpoCharger;
-    bool mbIsFlying;
+    AircraftState meState;
     float mfBatteryCharge;
-    uint8_t muiAircraftId;
+    uint32_t muiAircraftId;
+    uint32_t muiFlights;
+
+    // The name built once at construction, "Charlie-4294967295" is the longest.
+    char macName[20];
+    uint8_t muiNameSize;
 };
 
 #endif // _AIRCRAFT_H_
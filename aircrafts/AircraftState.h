@@ -0,0 +1,134 @@
+#ifndef _AIRCRAFTSTATE_H_
+#define _AIRCRAFTSTATE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The state of an aircraft.
+ *
+ */
+enum class AircraftState : uint8_t
+{
+    // The aircraft is on the ground and not charging.
+    Idle,
+    // The aircraft is waiting for a free charger.
+    Queued,
+    // The aircraft is connected to a charger.
+    Charging,
+    // The aircraft is flying.
+    Flying,
+    // The aircraft is grounded by a fault, reserved as the worlds only count the faults.
+    Faulted,
+
+    // Not a state, the result of an invalid transition.
+    TotalStates,
+};
+
+/**
+ * @brief The actions that change the state of an aircraft.
+ *
+ */
+enum class AircraftAction : uint8_t
+{
+    TakeOff,
+    Land,
+    Queue,
+    Dequeue,
+    Connect,
+    Disconnect,
+    Fault,
+    Repair,
+
+    TotalActions,
+};
+
+/**
+ * @brief The aircraft states transition table, the next state indexed by the
+ *        current state and the action, TotalStates if the action is not valid.
+ *
+ */
+constexpr AircraftState kaeAircraftTransitions[(size_t)AircraftState::TotalStates][(size_t)AircraftAction::TotalActions] = {
+#define INVALID AircraftState::TotalStates
+    //             TakeOff,                Land,                 Queue,                 Dequeue,             Connect,                 Disconnect,          Fault,                  Repair
+    /*Idle*/     { AircraftState::Flying,  INVALID,              AircraftState::Queued, INVALID,             AircraftState::Charging, INVALID,             INVALID,                INVALID             },
+    /*Queued*/   { INVALID,                INVALID,              INVALID,               AircraftState::Idle, AircraftState::Charging, INVALID,             INVALID,                INVALID             },
+    /*Charging*/ { INVALID,                INVALID,              INVALID,               INVALID,             INVALID,                 AircraftState::Idle, INVALID,                INVALID             },
+    /*Flying*/   { INVALID,                AircraftState::Idle,  INVALID,               INVALID,             INVALID,                 INVALID,             AircraftState::Faulted, INVALID             },
+    /*Faulted*/  { INVALID,                INVALID,              INVALID,               INVALID,             INVALID,                 INVALID,             INVALID,                AircraftState::Idle },
+#undef INVALID
+};
+
+/**
+ * @brief Get the state of an aircraft after an action.
+ *
+ * @param eState    The current state.
+ * @param eAction   The action.
+ *
+ * @return The next state, or TotalStates if the action is not valid in the current state.
+ */
+constexpr AircraftState GetNextState(AircraftState eState, AircraftAction eAction)
+{
+    return kaeAircraftTransitions[(size_t)eState][(size_t)eAction];
+}
+
+/**
+ * @brief Check at compile time that every state can get back to Idle, so an
+ *        aircraft can never get stuck.
+ *
+ * @return True if Idle is reachable from every state.
+ */
+constexpr bool IsIdleReachable()
+{
+    bool abReachable[(size_t)AircraftState::TotalStates] = { true };
+
+    // Propagate backwards from Idle, one step per state is enough.
+    for (size_t uiStep = 0; uiStep < (size_t)AircraftState::TotalStates; uiStep++)
+    {
+        for (size_t uiState = 0; uiState < (size_t)AircraftState::TotalStates; uiState++)
+        {
+            for (size_t uiAction = 0; uiAction < (size_t)AircraftAction::TotalActions; uiAction++)
+            {
+                AircraftState eNext = kaeAircraftTransitions[uiState][uiAction];
+                if (eNext != AircraftState::TotalStates && abReachable[(size_t)eNext])
+                {
+                    abReachable[uiState] = true;
+                }
+            }
+        }
+    }
+
+    for (bool bReachable : abReachable)
+    {
+        if (!bReachable)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(IsIdleReachable(), "An aircraft state cannot get back to Idle.");
+
+/**
+ * @brief Get the name of an aircraft state.
+ *
+ * @param eState    The state.
+ *
+ * @return The state name.
+ */
+constexpr const char* AircraftStateName(AircraftState eState)
+{
+    switch (eState)
+    {
+        case AircraftState::Idle:     return "Idle";
+        case AircraftState::Queued:   return "Queued";
+        case AircraftState::Charging: return "Charging";
+        case AircraftState::Flying:   return "Flying";
+        case AircraftState::Faulted:  return "Faulted";
+        default:                      return "Unknown";
+    }
+}
+
+#endif // _AIRCRAFTSTATE_H_
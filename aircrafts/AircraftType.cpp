@@ -6,42 +6,56 @@
 
 #include "AircraftType.h"
 
+#include <algorithm>
 #include <stdexcept>
 
-// Loading all the types of aircrafts at build time.
-/*static*/ AircraftType AircraftType::msoAircraftTypes[] = {
-    AircraftType(AircraftCompany::Alpha,   120/*mph*/, 320/*kWh*/, 0.6 /*hours*/, 1.6/*kWh/mile*/, 4, 0.25),
-    AircraftType(AircraftCompany::Bravo,   100/*mph*/, 100/*kWh*/, 0.2 /*hours*/, 1.5/*kWh/mile*/, 5, 0.10),
-    AircraftType(AircraftCompany::Charlie, 160/*mph*/, 220/*kWh*/, 0.8 /*hours*/, 2.2/*kWh/mile*/, 3, 0.05),
-    AircraftType(AircraftCompany::Delta,    90/*mph*/, 120/*kWh*/, 0.62/*hours*/, 0.8/*kWh/mile*/, 2, 0.22),
-    AircraftType(AircraftCompany::Echo,     30/*mph*/, 150/*kWh*/, 0.3 /*hours*/, 5.8/*kWh/mile*/, 2, 0.61),
+// Loading all the types of aircrafts from the build time catalogue, per thread.
+/*static*/ thread_local AircraftType AircraftType::msoAircraftTypes[] = {
+    AircraftType(kaoAircraftSpecs[(size_t)AircraftCompany::Alpha]),
+    AircraftType(kaoAircraftSpecs[(size_t)AircraftCompany::Bravo]),
+    AircraftType(kaoAircraftSpecs[(size_t)AircraftCompany::Charlie]),
+    AircraftType(kaoAircraftSpecs[(size_t)AircraftCompany::Delta]),
+    AircraftType(kaoAircraftSpecs[(size_t)AircraftCompany::Echo]),
 };
 
-AircraftType::AircraftType(AircraftCompany eCompany,
-                           uint16_t uiCruiseSpeed,
-                           uint16_t uiBatteryCapacity,
-                           float fTimeToCharge,
-                           float fEnergyUse,
-                           uint8_t uiPassengers,
-                           float fFaultProbability)
-    : mkeCompany(eCompany),
-      mkuiCruiseSpeed(uiCruiseSpeed),
-      mkuiBatteryCapacity(uiBatteryCapacity),
-      mkfTimeToCharge(fTimeToCharge),
-      mkfEnergyUse(fEnergyUse),
-      mkuiPassengers(uiPassengers),
-      mkfFaultProbability(fFaultProbability),
+// The battery models of all the threads, linear until set at startup.
+/*static*/ BatteryModel AircraftType::msoBatteryModels[] = {
+    BatteryModel(kaoAircraftSpecs[(size_t)AircraftCompany::Alpha].fTimeToCharge),
+    BatteryModel(kaoAircraftSpecs[(size_t)AircraftCompany::Bravo].fTimeToCharge),
+    BatteryModel(kaoAircraftSpecs[(size_t)AircraftCompany::Charlie].fTimeToCharge),
+    BatteryModel(kaoAircraftSpecs[(size_t)AircraftCompany::Delta].fTimeToCharge),
+    BatteryModel(kaoAircraftSpecs[(size_t)AircraftCompany::Echo].fTimeToCharge),
+};
+
+// The fault draws of this thread sample the real rate by default.
+/*static*/ thread_local FaultSampling AircraftType::msoFaultSampling;
+
+AircraftType::AircraftType(const AircraftSpecs& oSpecs)
+    : mkeCompany(oSpecs.eCompany),
+      mkuiCruiseSpeed(oSpecs.uiCruiseSpeed),
+      mkuiBatteryCapacity(oSpecs.uiBatteryCapacity),
+      mkfTimeToCharge(oSpecs.fTimeToCharge),
+      mkfEnergyUse(oSpecs.fEnergyUse),
+      mkuiPassengers(oSpecs.uiPassengers),
+      mkfFaultProbability(oSpecs.fFaultProbability),
+      mkfMilesPerEnergy(oSpecs.GetMilesPerEnergy()),
+      mkfHoursPerMile(oSpecs.GetHoursPerMile()),
+      mkfInverseBatteryCapacity(oSpecs.GetInverseBatteryCapacity()),
       muiTotalNumberOfFaults(0),
+      mfEstimatedNumberOfFaults(0.0f),
       muiTotalChargeSessions(0),
       mfTotalTimeCharging(0.0f),
       mfTotalNumberOfMiles(0.0f),
       muiTotalAircrafts(0),
       mfTotalFlightTime(0.0f),
-      muiTotalFlights(0)
+      muiTotalFlights(0),
+      muiFaultSeed(0)
 {
     // Check if the number of aircraft types matches the number of companies.
     static_assert(sizeof(AircraftType::msoAircraftTypes) / sizeof(AircraftType) == (size_t)AircraftCompany::TotalCompanies,
               "The number of aircraft types does not match the number of companies.");
+    static_assert(sizeof(AircraftType::msoBatteryModels) / sizeof(BatteryModel) == (size_t)AircraftCompany::TotalCompanies,
+              "The number of battery models does not match the number of companies.");
 }
 
 /*static*/ AircraftType* AircraftType::GetAircraftType(AircraftCompany eCompany)
@@ -56,6 +70,75 @@ AircraftType::AircraftType(AircraftCompany eCompany,
     return &AircraftType::msoAircraftTypes[(size_t)eCompany];
 }
 
+/*static*/ bool AircraftType::ParseCompany(string_view sName, AircraftCompany& eCompany)
+{
+    for (AircraftType& oAircraftType : msoAircraftTypes)
+    {
+        if (oAircraftType.CompanyName() == sName)
+        {
+            eCompany = oAircraftType.GetCompany();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*static*/ void AircraftType::SeedFaultGenerators(uint32_t uiSeed)
+{
+    // Give each aircraft type a different stream.
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        msoAircraftTypes[i].moFaultRandom.Seed(uiSeed + (uint32_t)i * 0x9E3779B9u);
+        msoAircraftTypes[i].muiFaultSeed = uiSeed + (uint32_t)i * 0x9E3779B9u;
+    }
+}
+
+/*static*/ void AircraftType::SetFaultSampling(const FaultSampling& koSampling)
+{
+    // The likelihood ratio needs the fractional faults to be sampled with some probability.
+    if (!(koSampling.fImportanceFactor > 0))
+    {
+        throw std::runtime_error("The importance factor of the faults must be positive.");
+    }
+
+    msoFaultSampling = koSampling;
+}
+
+/*static*/ void AircraftType::SetBatteryModel(AircraftCompany eCompany, const BatteryModel& koBatteryModel)
+{
+    // Throw an exception if the company is invalid.
+    if (eCompany >= AircraftCompany::TotalCompanies)
+    {
+        throw std::runtime_error("Invalid aircraft company.");
+    }
+
+    msoBatteryModels[(size_t)eCompany] = koBatteryModel;
+}
+
+/*static*/ void AircraftType::ResetStatistics()
+{
+    TruncateStatistics();
+    for (AircraftType& oAircraftType : msoAircraftTypes)
+    {
+        oAircraftType.muiTotalAircrafts = 0;
+    }
+}
+
+/*static*/ void AircraftType::TruncateStatistics()
+{
+    for (AircraftType& oAircraftType : msoAircraftTypes)
+    {
+        oAircraftType.muiTotalNumberOfFaults = 0;
+        oAircraftType.mfEstimatedNumberOfFaults = 0.0f;
+        oAircraftType.muiTotalChargeSessions = 0;
+        oAircraftType.mfTotalTimeCharging = 0.0f;
+        oAircraftType.mfTotalNumberOfMiles = 0.0f;
+        oAircraftType.mfTotalFlightTime = 0.0f;
+        oAircraftType.muiTotalFlights = 0;
+    }
+}
+
 float AircraftType::TotalNumberOfPassengerMiles() const
 {
     return TotalNumberOfPassengers() * mfTotalNumberOfMiles;
@@ -71,7 +154,7 @@ float AircraftType::AverageDistanceTravelledPerFlight() const
     return muiTotalFlights > 0 ? mfTotalNumberOfMiles / muiTotalFlights : 0.0f;
 }
 
-void AircraftType::ReportFlight(float fDistance, float fTime)
+uint16_t AircraftType::ReportFlight(float fDistance, float fTime, uint32_t uiAircraftId, uint32_t uiFlight)
 {
     // Update the total number of flights.
     ++muiTotalFlights;
@@ -83,7 +166,25 @@ void AircraftType::ReportFlight(float fDistance, float fTime)
     mfTotalFlightTime += fTime;
 
     // Update the total number of faults.
-    muiTotalNumberOfFaults += CalculateFaultsPerFlight(fTime);
+    float fEstimatedFaults = 0.0f;
+    uint16_t uiFaults = CalculateFaultsPerFlight(fTime, DrawFlightRandom(uiAircraftId, uiFlight, false), fEstimatedFaults);
+    muiTotalNumberOfFaults += uiFaults;
+    mfEstimatedNumberOfFaults += fEstimatedFaults;
+
+    return uiFaults;
+}
+
+void AircraftType::RevertFlight(float fDistance, float fTime, uint32_t uiAircraftId, uint32_t uiFlight)
+{
+    // Recalculate the faults with the same random draw and undo it.
+    float fEstimatedFaults = 0.0f;
+    muiTotalNumberOfFaults -= CalculateFaultsPerFlight(fTime, DrawFlightRandom(uiAircraftId, uiFlight, true), fEstimatedFaults);
+    mfEstimatedNumberOfFaults -= fEstimatedFaults;
+
+    // Revert the total flight time, miles and number of flights.
+    mfTotalFlightTime -= fTime;
+    mfTotalNumberOfMiles -= fDistance;
+    --muiTotalFlights;
 }
 
 float AircraftType::AverageTimeChargingPerChargeSession() const
@@ -100,7 +201,14 @@ void AircraftType::ReportChargeSession(float fTimeCharging)
     mfTotalTimeCharging += fTimeCharging;
 }
 
-string AircraftType::CompanyName() const
+void AircraftType::RevertChargeSession(float fTimeCharging)
+{
+    // Revert the total number of charging sessions and the total time charging.
+    --muiTotalChargeSessions;
+    mfTotalTimeCharging -= fTimeCharging;
+}
+
+string_view AircraftType::CompanyName() const
 {
     switch (mkeCompany)
     {
@@ -113,7 +221,7 @@ string AircraftType::CompanyName() const
     }
 }
 
-uint16_t AircraftType::CalculateFaultsPerFlight(float fFlightTime) const
+uint16_t AircraftType::CalculateFaultsPerFlight(float fFlightTime, float fRandom, float& fEstimatedFaults) const
 {
     // Calculate the probability of faults that will occur during the flight.
     float fProbabilityOfFaults = mkfFaultProbability * fFlightTime;
@@ -124,14 +232,42 @@ uint16_t AircraftType::CalculateFaultsPerFlight(float fFlightTime) const
     // Get the decimal part of the probability of faults.
     float fDecimalPart = fProbabilityOfFaults - uiFaults;
 
-    // Get a random number between 0 and 1.
-    float fRandom = (float)rand() / RAND_MAX;
+    fEstimatedFaults = uiFaults;
+
+    // The antithetic draw of a pair of runs.
+    if (msoFaultSampling.bAntithetic)
+    {
+        fRandom = 1.0f - fRandom;
+    }
 
     // If the random number is less than the decimal part, add one to the number of faults.
-    if (fRandom < fDecimalPart)
+    // With importance sampling the decimal part is raised, and the fault only counts
+    // its likelihood ratio in the estimate.
+    float fSampledPart = min(1.0f, fDecimalPart * msoFaultSampling.fImportanceFactor);
+    if (fRandom < fSampledPart)
     {
         ++uiFaults;
+        fEstimatedFaults += fDecimalPart / fSampledPart;
     }
 
     return uiFaults;
 }
+
+float AircraftType::DrawFlightRandom(uint32_t uiAircraftId, uint32_t uiFlight, bool bRevert)
+{
+    // The common random numbers only depend on the aircraft and its flight.
+    if (msoFaultSampling.bCommonRandomNumbers)
+    {
+        return CounterRandom(muiFaultSeed, uiAircraftId, uiFlight);
+    }
+
+    // The type stream draws in the order of the flights, and steps back to revert them.
+    if (!bRevert)
+    {
+        return moFaultRandom.Next();
+    }
+
+    float fRandom = moFaultRandom.Current();
+    moFaultRandom.Previous();
+    return fRandom;
+}
@@ -7,6 +7,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 // Test the AircraftType::CompanyName() method.
 // Check if we can print all the company names, as this can fail if the enum gets updated.
 TEST_CASE( "AircraftType::CompanyName()" )
@@ -17,3 +21,138 @@ TEST_CASE( "AircraftType::CompanyName()" )
         REQUIRE(AircraftType::GetAircraftType((AircraftCompany)i)->CompanyName() != "Unknown");
     }
 }
+
+// Test the AircraftType::AircraftType() constructor.
+// Check the aircraft types are loaded from the specs catalogue, including the reciprocals.
+TEST_CASE( "AircraftType::AircraftType()" )
+{
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; ++i)
+    {
+        const AircraftSpecs& koSpecs = kaoAircraftSpecs[i];
+        const AircraftType* kpoAircraftType = AircraftType::GetAircraftType((AircraftCompany)i);
+
+        REQUIRE(kpoAircraftType->GetCompany() == koSpecs.eCompany);
+        REQUIRE(kpoAircraftType->GetCruiseSpeed() == koSpecs.uiCruiseSpeed);
+        REQUIRE(kpoAircraftType->GetBatteryCapacity() == koSpecs.uiBatteryCapacity);
+        REQUIRE(kpoAircraftType->GetEnergyUse() == koSpecs.fEnergyUse);
+
+        // The reciprocals are within one rounding of the divisions.
+        REQUIRE(abs(kpoAircraftType->GetMilesPerEnergy() * koSpecs.fEnergyUse - 1.0f) < 1e-6f);
+        REQUIRE(abs(kpoAircraftType->GetHoursPerMile() * koSpecs.uiCruiseSpeed - 1.0f) < 1e-6f);
+        REQUIRE(abs(kpoAircraftType->GetInverseBatteryCapacity() * koSpecs.uiBatteryCapacity - 1.0f) < 1e-6f);
+    }
+}
+
+// Test the AircraftType::SetFaultSampling() method with common random numbers.
+// Check the faults of a flight do not depend on the flights of the other aircrafts, and revert exactly.
+TEST_CASE( "AircraftType::SetFaultSampling() common random numbers" )
+{
+    const FaultSampling koPrevious = AircraftType::GetFaultSampling();
+    FaultSampling oSampling;
+    oSampling.bCommonRandomNumbers = true;
+    AircraftType::SetFaultSampling(oSampling);
+
+    // Fly the same flights of two aircrafts in both orders, with a fractional fault of one half.
+    AircraftType* poAircraftType = AircraftType::GetAircraftType(AircraftCompany::Alpha);
+    const float kfTime = 0.5f / poAircraftType->GetFaultProbability();
+    vector<uint16_t> auiForward, auiBackward;
+    AircraftType::SeedFaultGenerators(7);
+    for (uint32_t uiFlight = 0; uiFlight < 64; uiFlight++)
+    {
+        auiForward.push_back(poAircraftType->ReportFlight(1, kfTime, 0, uiFlight));
+        auiForward.push_back(poAircraftType->ReportFlight(1, kfTime, 1, uiFlight));
+    }
+    AircraftType::SeedFaultGenerators(7);
+    for (uint32_t uiFlight = 0; uiFlight < 64; uiFlight++)
+    {
+        auiBackward.push_back(poAircraftType->ReportFlight(1, kfTime, 1, uiFlight));
+        auiBackward.push_back(poAircraftType->ReportFlight(1, kfTime, 0, uiFlight));
+    }
+    for (size_t i = 0; i < auiForward.size(); i += 2)
+    {
+        REQUIRE(auiForward[i] == auiBackward[i + 1]);
+        REQUIRE(auiForward[i + 1] == auiBackward[i]);
+    }
+
+    // The draws are not all the same.
+    REQUIRE(count(auiForward.begin(), auiForward.end(), 0) > 0);
+    REQUIRE(count(auiForward.begin(), auiForward.end(), 1) > 0);
+
+    // Reverting a flight undoes its faults.
+    uint32_t uiFaults = poAircraftType->TotalNumberOfFaults();
+    poAircraftType->ReportFlight(1, kfTime, 2, 0);
+    poAircraftType->RevertFlight(1, kfTime, 2, 0);
+    REQUIRE(poAircraftType->TotalNumberOfFaults() == uiFaults);
+
+    AircraftType::SetFaultSampling(koPrevious);
+}
+
+// Test the AircraftType::SetFaultSampling() method with antithetic draws.
+// Check a flight faults with u or with 1 - u, and exactly once per pair for a fractional fault of one half.
+TEST_CASE( "AircraftType::SetFaultSampling() antithetic" )
+{
+    const FaultSampling koPrevious = AircraftType::GetFaultSampling();
+    FaultSampling oSampling;
+    oSampling.bCommonRandomNumbers = true;
+
+    AircraftType* poAircraftType = AircraftType::GetAircraftType(AircraftCompany::Bravo);
+    const float kfTime = 0.5f / poAircraftType->GetFaultProbability();
+    AircraftType::SeedFaultGenerators(11);
+    for (uint32_t uiFlight = 0; uiFlight < 64; uiFlight++)
+    {
+        oSampling.bAntithetic = false;
+        AircraftType::SetFaultSampling(oSampling);
+        uint16_t uiFaults = poAircraftType->ReportFlight(1, kfTime, 0, uiFlight);
+        oSampling.bAntithetic = true;
+        AircraftType::SetFaultSampling(oSampling);
+        uiFaults += poAircraftType->ReportFlight(1, kfTime, 0, uiFlight);
+        REQUIRE(uiFaults == 1);
+    }
+
+    AircraftType::SetFaultSampling(koPrevious);
+}
+
+// Test the AircraftType::SetFaultSampling() method with importance sampling.
+// Check the estimated faults are unbiased and closer to the expected ones than the sampled faults at the real rate.
+TEST_CASE( "AircraftType::SetFaultSampling() importance sampling" )
+{
+    const FaultSampling koPrevious = AircraftType::GetFaultSampling();
+    REQUIRE_THROWS(AircraftType::SetFaultSampling(FaultSampling{ false, false, 0.0f }));
+
+    // Short Charlie flights, with a probability of fault of 0.5%.
+    AircraftType* poAircraftType = AircraftType::GetAircraftType(AircraftCompany::Charlie);
+    const float kfTime = 0.1f;
+    const uint32_t kuiFlights = 2000;
+    const float kfExpectedFaults = kuiFlights * poAircraftType->GetFaultProbability() * kfTime;
+
+    // The mean error of the estimate over some replications, at the real rate or 100 times it.
+    auto MeanError = [&](float fImportanceFactor)
+    {
+        AircraftType::SetFaultSampling(FaultSampling{ true, false, fImportanceFactor });
+        float fError = 0;
+        for (uint32_t uiSeed = 1; uiSeed <= 20; uiSeed++)
+        {
+            AircraftType::ResetStatistics();
+            AircraftType::SeedFaultGenerators(uiSeed);
+            for (uint32_t uiFlight = 0; uiFlight < kuiFlights; uiFlight++)
+            {
+                poAircraftType->ReportFlight(1, kfTime, 0, uiFlight);
+            }
+            fError += abs(poAircraftType->EstimatedNumberOfFaults() - kfExpectedFaults);
+        }
+        return fError / 20;
+    };
+
+    // At the real rate the estimate is the sampled faults.
+    float fRealError = MeanError(1.0f);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Charlie)->EstimatedNumberOfFaults()
+        == AircraftType::GetAircraftType(AircraftCompany::Charlie)->TotalNumberOfFaults());
+
+    // Sampling every fault with a probability of 50% the estimate is much closer.
+    float fImportanceError = MeanError(100.0f);
+    REQUIRE(fImportanceError * 3 < fRealError);
+    REQUIRE(poAircraftType->TotalNumberOfFaults() > 10 * kfExpectedFaults);
+
+    AircraftType::ResetStatistics();
+    AircraftType::SetFaultSampling(koPrevious);
+}
@@ -1,8 +1,12 @@
 #ifndef _AIRCRAFTSPECS_H_
 #define _AIRCRAFTSPECS_H_
 
+#include "BatteryModel.h"
+#include "utils/Random.h"
+
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 using namespace std;
 
@@ -29,11 +33,122 @@ enum class AircraftCompany : uint8_t
     TotalCompanies,
 };
 
+/**
+ * @brief The specifications of an aircraft type, known at build time.
+ * 
+ * @note  The reciprocals are calculated at compile time, so the aircrafts
+ *        multiply instead of dividing by the specifications on every flight.
+ * 
+ */
+struct AircraftSpecs
+{
+    AircraftCompany eCompany;       ///< The aircraft company.
+    uint16_t uiCruiseSpeed;         ///< The cruise speed in mph.
+    uint16_t uiBatteryCapacity;     ///< The battery capacity in kWh.
+    float fTimeToCharge;            ///< The time to charge in hours.
+    float fEnergyUse;               ///< The energy use at cruise in kWh/mile.
+    uint8_t uiPassengers;           ///< The passengers count.
+    float fFaultProbability;        ///< The probability of fault per hour.
+
+    /**
+     * @brief Get the miles flown per kWh, the reciprocal of the energy use.
+     * 
+     * @return The miles per kWh.
+     */
+    constexpr float GetMilesPerEnergy() const { return 1.0f / fEnergyUse; }
+
+    /**
+     * @brief Get the hours to fly a mile, the reciprocal of the cruise speed.
+     * 
+     * @return The hours per mile.
+     */
+    constexpr float GetHoursPerMile() const { return 1.0f / uiCruiseSpeed; }
+
+    /**
+     * @brief Get the reciprocal of the battery capacity in 1/kWh.
+     * 
+     * @return The reciprocal of the battery capacity.
+     */
+    constexpr float GetInverseBatteryCapacity() const { return 1.0f / uiBatteryCapacity; }
+};
+
+/**
+ * @brief The built-in catalogue of aircraft types, one per company and in
+ *        the same order as the AircraftCompany enum.
+ * 
+ */
+constexpr AircraftSpecs kaoAircraftSpecs[] = {
+    {AircraftCompany::Alpha,   120/*mph*/, 320/*kWh*/, 0.6f /*hours*/, 1.6f/*kWh/mile*/, 4, 0.25f},
+    {AircraftCompany::Bravo,   100/*mph*/, 100/*kWh*/, 0.2f /*hours*/, 1.5f/*kWh/mile*/, 5, 0.10f},
+    {AircraftCompany::Charlie, 160/*mph*/, 220/*kWh*/, 0.8f /*hours*/, 2.2f/*kWh/mile*/, 3, 0.05f},
+    {AircraftCompany::Delta,    90/*mph*/, 120/*kWh*/, 0.62f/*hours*/, 0.8f/*kWh/mile*/, 2, 0.22f},
+    {AircraftCompany::Echo,     30/*mph*/, 150/*kWh*/, 0.3f /*hours*/, 5.8f/*kWh/mile*/, 2, 0.61f},
+};
+
+/**
+ * @brief Check at compile time that the catalogue has one entry per company,
+ *        in the same order as the AircraftCompany enum.
+ * 
+ * @return True if the catalogue is complete and ordered.
+ */
+constexpr bool IsAircraftSpecsCatalogueValid()
+{
+    if (sizeof(kaoAircraftSpecs) / sizeof(AircraftSpecs) != (size_t)AircraftCompany::TotalCompanies)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        if ((size_t)kaoAircraftSpecs[i].eCompany != i)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(IsAircraftSpecsCatalogueValid(), "The aircraft specs do not match the aircraft companies.");
+
+/**
+ * @brief The variance reduction options of the fault draws, to compare
+ *        worlds with fewer replications.
+ * 
+ */
+struct FaultSampling
+{
+    /**
+     * @brief Draw the faults per aircraft and flight instead of per type in
+     *        the order of the flights (common random numbers), so the same
+     *        flight gets the same draw in worlds with the same seed even when
+     *        their events are ordered differently.
+     */
+    bool bCommonRandomNumbers = false;
+
+    /**
+     * @brief Use 1 - u instead of every draw u, to pair a run with another
+     *        one of the same seed without it (antithetic variates).
+     */
+    bool bAntithetic = false;
+
+    /**
+     * @brief The factor raising the probability of the fractional fault of
+     *        a flight (importance sampling), 1 to sample the real rate. The
+     *        sampled faults are biased, the estimated faults are reweighted
+     *        by the likelihood ratio and stay unbiased.
+     */
+    float fImportanceFactor = 1.0f;
+};
+
 /**
  * @brief Represents a type of an aircraft.
  * 
  * @note  This class is used to store the specifications of an aircraft type,
  *        but also to calculate some statistics about the aircraft type.
+ *        Each thread has its own aircraft types, so worlds can run in
+ *        parallel threads, one world at a time per thread. The battery
+ *        models are not statistics, all the threads share them.
  */
 class AircraftType
 {
@@ -41,23 +156,11 @@ private:
     /********** Constructors **********/
 
     /**
-     * @brief Construct a new Aircraft Specs object
+     * @brief Construct a new Aircraft Type object
      * 
-     * @param eCompany              The aircraft company.
-     * @param uiCruiseSpeed         The cruise speed in mph.
-     * @param uiBatteryCapacity     The battery capacity in kWh.
-     * @param fTimeToCharge         The time to charge in hours.
-     * @param fEnergyUse            The energy use at cruise in kWh/mile.
-     * @param uiPassengers          The passengers count.
-     * @param fFaultProbability     The probability of fault per hour.
+     * @param oSpecs    The aircraft specifications.
      */
-    AircraftType(AircraftCompany eCompany,
-                uint16_t uiCruiseSpeed,
-                uint16_t uiBatteryCapacity,
-                float fTimeToCharge,
-                float fEnergyUse,
-                uint8_t uiPassengers,
-                float fFaultProbability);
+    AircraftType(const AircraftSpecs& oSpecs);
 
     /********** Properties **********/
 
@@ -90,6 +193,13 @@ public:
      */
     inline float GetTimeToCharge() const { return mkfTimeToCharge; }
 
+    /**
+     * @brief Get the battery charging model, shared by the types of all the threads.
+     * 
+     * @return The battery model.
+     */
+    inline const BatteryModel& GetBatteryModel() const { return msoBatteryModels[(size_t)mkeCompany]; }
+
     /**
      * @brief Get the energy use at cruise in kWh/mile.
      * 
@@ -97,6 +207,27 @@ public:
      */
     inline float GetEnergyUse() const { return mkfEnergyUse; }
 
+    /**
+     * @brief Get the miles flown per kWh, precalculated from the energy use.
+     * 
+     * @return The miles per kWh.
+     */
+    inline float GetMilesPerEnergy() const { return mkfMilesPerEnergy; }
+
+    /**
+     * @brief Get the hours to fly a mile, precalculated from the cruise speed.
+     * 
+     * @return The hours per mile.
+     */
+    inline float GetHoursPerMile() const { return mkfHoursPerMile; }
+
+    /**
+     * @brief Get the reciprocal of the battery capacity in 1/kWh.
+     * 
+     * @return The reciprocal of the battery capacity.
+     */
+    inline float GetInverseBatteryCapacity() const { return mkfInverseBatteryCapacity; }
+
     /**
      * @brief Get the passengers count.
      * 
@@ -116,28 +247,37 @@ public:
      * 
      * @return The total number of faults. 
      */
-    inline uint16_t TotalNumberOfFaults() const { return muiTotalNumberOfFaults; }
+    inline uint32_t TotalNumberOfFaults() const { return muiTotalNumberOfFaults; }
+
+    /**
+     * @brief Get the estimated number of faults, the sampled faults weighted
+     *        by their likelihood ratio. It is the total number of faults
+     *        unless the fault rate is importance sampled.
+     * 
+     * @return The estimated number of faults. 
+     */
+    inline float EstimatedNumberOfFaults() const { return mfEstimatedNumberOfFaults; }
 
     /**
      * @brief Get the total number of aircrafts of this type.
      * 
      * @return The total number of aircrafts. 
      */
-    inline uint8_t TotalAircrafts() const { return muiTotalAircrafts; }
+    inline uint32_t TotalAircrafts() const { return muiTotalAircrafts; }
 
     /**
      * @brief Get the total number of flights.
      * 
      * @return The total number of flights. 
      */
-    inline uint16_t TotalFlights() const { return muiTotalFlights; }
+    inline uint32_t TotalFlights() const { return muiTotalFlights; }
 
     /**
      * @brief Get the total charge sessions.
      * 
      * @return The total charge sessions. 
      */
-    inline uint16_t TotalChargeSessions() const { return muiTotalChargeSessions; }
+    inline uint32_t TotalChargeSessions() const { return muiTotalChargeSessions; }
 
     /**
      * @brief Get the total number of miles travelled by the aircrafts of this type.
@@ -151,7 +291,7 @@ public:
      * 
      * @return The total number of passengers. 
      */
-    inline uint16_t TotalNumberOfPassengers() const { return mkuiPassengers * muiTotalFlights; }
+    inline uint32_t TotalNumberOfPassengers() const { return mkuiPassengers * muiTotalFlights; }
 
 
     /********** Static Methods **********/
@@ -167,6 +307,72 @@ public:
      */
     static AircraftType* GetAircraftType(AircraftCompany eCompany);
 
+    /**
+     * @brief Get a company from its name.
+     * 
+     * @param sName     The company name, as CompanyName() returns it.
+     * @param eCompany  Gets the company.
+     * 
+     * @return If the name is a known company.
+     */
+    static bool ParseCompany(string_view sName, AircraftCompany& eCompany);
+
+    /**
+     * @brief Seed the fault generators of all the aircraft types.
+     * 
+     * @param uiSeed    The seed, each aircraft type derives its own stream from it.
+     */
+    static void SeedFaultGenerators(uint32_t uiSeed);
+
+    /**
+     * @brief Get the variance reduction options of the fault draws of this thread.
+     * 
+     * @return The fault sampling options.
+     */
+    static inline const FaultSampling& GetFaultSampling() { return msoFaultSampling; }
+
+    /**
+     * @brief Set the variance reduction options of the fault draws of this
+     *        thread, for the next flights.
+     * 
+     * @param koSampling    The fault sampling options.
+     * 
+     * @throws std::runtime_error if the importance factor is not positive.
+     */
+    static void SetFaultSampling(const FaultSampling& koSampling);
+
+    /**
+     * @brief Set the battery charging model of an aircraft type in all the
+     *        threads, by default the charging is linear and takes the time
+     *        to charge from empty to full.
+     * 
+     * @param eCompany          The aircraft company.
+     * @param koBatteryModel    The battery model.
+     * 
+     * @note  The models are read by the worlds of every thread without a
+     *        lock, so they are set at startup, before any world runs.
+     * 
+     * @throws std::runtime_error if the company is not valid.
+     */
+    static void SetBatteryModel(AircraftCompany eCompany, const BatteryModel& koBatteryModel);
+
+    /**
+     * @brief Reset the statistics and the aircrafts count of all the aircraft
+     *        types, to run another world in the same thread.
+     * 
+     */
+    static void ResetStatistics();
+
+    /**
+     * @brief Restart the statistics of all the aircraft types from zero,
+     *        keeping the aircrafts count, to collect them after a warm-up.
+     * 
+     * @note  The flights and charge sessions count when they are reported,
+     *        at their start. A session started before and replanned after
+     *        is reverted and reported again, so only its change counts.
+     */
+    static void TruncateStatistics();
+
 
     /********** Methods **********/
 
@@ -175,7 +381,7 @@ public:
      * 
      * @return The Id for the new registered aircraft. 
      */
-    inline uint8_t RegisterAircraft() { return muiTotalAircrafts++; }
+    inline uint32_t RegisterAircraft() { return muiTotalAircrafts++; }
 
     /**
      * @brief Get the total number of passenger miles.
@@ -201,10 +407,27 @@ public:
     /**
      * @brief Report a flight for the aircraft type.
      * 
-     * @param fFlightTime   The flight time in hours.
      * @param fDistance     The distance travelled in miles.
+     * @param fFlightTime   The flight time in hours.
+     * @param uiAircraftId  The aircraft Id, for the common random numbers.
+     * @param uiFlight      The flight number of the aircraft, for the common random numbers.
+     * 
+     * @return The number of faults that occurred during the flight.
      */ 
-    void ReportFlight(float fFlightTime, float fDistance);
+    uint16_t ReportFlight(float fDistance, float fFlightTime, uint32_t uiAircraftId = 0, uint32_t uiFlight = 0);
+
+    /**
+     * @brief Revert the last reported flight, including its faults and the
+     *        random draw used to calculate them.
+     * 
+     * @param fDistance     The distance travelled in miles, as reported.
+     * @param fFlightTime   The flight time in hours, as reported.
+     * @param uiAircraftId  The aircraft Id, as reported.
+     * @param uiFlight      The flight number of the aircraft, as reported.
+     * 
+     * @note  Flights must be reverted in the reverse order they were reported.
+     */
+    void RevertFlight(float fDistance, float fFlightTime, uint32_t uiAircraftId = 0, uint32_t uiFlight = 0);
 
     /**
      * @brief Get the average time charging per charge session in hours.
@@ -220,22 +443,43 @@ public:
      */
     void ReportChargeSession(float fTimeCharging);
 
+    /**
+     * @brief Revert a reported charging session.
+     * 
+     * @param fTimeCharging   The time charging in hours, as reported.
+     */
+    void RevertChargeSession(float fTimeCharging);
+
     /**
      * @brief Get the aircraft company name in string format.
      * 
-     * @return The company name.
+     * @return The company name, a constant string.
      */
-    string CompanyName() const;
+    string_view CompanyName() const;
 
 private:
     /**
      * @brief Calculate the number of faults that will occur during a flight.
      * 
-     * @param fFlightTime   The flight time in hours.
+     * @param fFlightTime       The flight time in hours.
+     * @param fRandom           A random number in the range [0, 1).
+     * @param fEstimatedFaults  The faults weighted by their likelihood ratio.
      * 
      * @return The number of faults that will occur during the flight.
      */
-    uint16_t CalculateFaultsPerFlight(float fFlightTime) const;
+    uint16_t CalculateFaultsPerFlight(float fFlightTime, float fRandom, float& fEstimatedFaults) const;
+
+    /**
+     * @brief Get the random number of a flight, from the type stream or the
+     *        common random numbers as the fault sampling sets.
+     * 
+     * @param uiAircraftId  The aircraft Id.
+     * @param uiFlight      The flight number of the aircraft.
+     * @param bRevert       If the draw of the last flight is reverted.
+     * 
+     * @return A random number in the range [0, 1).
+     */
+    float DrawFlightRandom(uint32_t uiAircraftId, uint32_t uiFlight, bool bRevert);
 
 
     /********** Constants **********/
@@ -247,20 +491,30 @@ private:
     const float mkfEnergyUse;
     const uint8_t mkuiPassengers;
     const float mkfFaultProbability;
+    const float mkfMilesPerEnergy;
+    const float mkfHoursPerMile;
+    const float mkfInverseBatteryCapacity;
 
     /********** Variables **********/
-    uint16_t muiTotalNumberOfFaults;
-    uint16_t muiTotalChargeSessions;
+    uint32_t muiTotalNumberOfFaults;
+    float mfEstimatedNumberOfFaults;
+    uint32_t muiTotalChargeSessions;
     float mfTotalTimeCharging;
     float mfTotalNumberOfMiles;
-    uint8_t muiTotalAircrafts;
+    uint32_t muiTotalAircrafts;
 
     // For the statistics.
     float mfTotalFlightTime;
-    uint16_t muiTotalFlights;
+    uint32_t muiTotalFlights;
+
+    // Random generator for the faults, reversible to undo flights.
+    ReversibleRandom moFaultRandom;
+    uint32_t muiFaultSeed; // The seed of the common random numbers.
 
     /********** Static Variables **********/
-    static AircraftType msoAircraftTypes[];
+    static thread_local AircraftType msoAircraftTypes[];
+    static thread_local FaultSampling msoFaultSampling;
+    static BatteryModel msoBatteryModels[];
 };
 
 #endif // _AIRCRAFTSPECS_H_
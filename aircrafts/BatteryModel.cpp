@@ -0,0 +1,134 @@
+/**
+ * @brief Implementation of the BatteryModel class methods and constructors.
+ * 
+ */
+
+#include "BatteryModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Temperature range where the battery charges at the nominal rate.
+static const float kfOptimalMinTemperature = 15.0f;
+static const float kfOptimalMaxTemperature = 35.0f;
+
+// Charging rate lost per degree out of the optimal range, and the minimum rate.
+static const float kfDeratingPerDegree = 0.02f;
+static const float kfMinDerating = 0.2f;
+
+BatteryModel::BatteryModel(float fTimeToCharge,
+                           float fConstantVoltageSoc,
+                           float fMinimumCurrent,
+                           float fTemperature)
+    : mfConstantVoltageSoc(fConstantVoltageSoc),
+      mfMinimumCurrent(fMinimumCurrent)
+{
+    // Throw an exception if the parameters are out of range.
+    if (fTimeToCharge <= 0)
+    {
+        throw std::runtime_error("The time to charge must be positive.");
+    }
+
+    if (fConstantVoltageSoc <= 0 || fConstantVoltageSoc > 1)
+    {
+        throw std::runtime_error("The constant voltage SOC must be in the range (0, 1].");
+    }
+
+    if (fMinimumCurrent <= 0 || fMinimumCurrent > 1)
+    {
+        throw std::runtime_error("The minimum current must be in the range (0, 1].");
+    }
+
+    // Derate the charging rate with the degrees out of the optimal temperature range.
+    float fDegreesOut = max(max(kfOptimalMinTemperature - fTemperature, fTemperature - kfOptimalMaxTemperature), 0.0f);
+    mfDerating = max(1.0f - kfDeratingPerDegree * fDegreesOut, kfMinDerating);
+
+    // Get the constant current time and where the taper reaches the minimum current.
+    mfConstantCurrentTime = fTimeToCharge / mfDerating;
+    mfMinimumCurrentSoc = 1.0f - mfMinimumCurrent * (1.0f - mfConstantVoltageSoc);
+
+    // Precompute the time per SOC table.
+    for (size_t i = 0; i <= kuiTableSize; i++)
+    {
+        mafTimeAtSoc[i] = CalculateTimeAtSoc(static_cast<float>(i) / kuiTableSize);
+    }
+
+    // Precompute the SOC per time table.
+    mfTimeScale = kuiTableSize / GetTimeToFullCharge();
+    for (size_t i = 0; i <= kuiTableSize; i++)
+    {
+        mafSocAtTime[i] = CalculateSocAtTime(i / mfTimeScale);
+    }
+    mafSocAtTime[kuiTableSize] = 1.0f;
+}
+
+float BatteryModel::GetSocAfterCharging(float fSoc, float fTime) const
+{
+    // Get the time it takes to reach the initial SOC from empty, and add the charging time.
+    float fTargetTime = Interpolate(mafTimeAtSoc, fSoc * kuiTableSize) + fTime;
+
+    // Check if the battery gets fully charged.
+    if (fTargetTime >= GetTimeToFullCharge())
+    {
+        return 1.0f;
+    }
+
+    // The interpolation of both tables could not match exactly, never go back.
+    return max(Interpolate(mafSocAtTime, fTargetTime * mfTimeScale), fSoc);
+}
+
+void BatteryModel::GetTimesToFullCharge(const float* pafSoc, float* pafTimes, size_t uiCount) const
+{
+    const float kfTimeToFullCharge = GetTimeToFullCharge();
+
+    for (size_t i = 0; i < uiCount; i++)
+    {
+        pafTimes[i] = kfTimeToFullCharge - Interpolate(mafTimeAtSoc, pafSoc[i] * kuiTableSize);
+    }
+}
+
+float BatteryModel::CalculateTimeAtSoc(float fSoc) const
+{
+    // Constant current phase.
+    if (fSoc <= mfConstantVoltageSoc)
+    {
+        return fSoc * mfConstantCurrentTime;
+    }
+
+    // Constant voltage phase, the current decreases linearly with the remaining
+    // capacity, so the time grows logarithmically.
+    float fTaperTime = (1.0f - mfConstantVoltageSoc) * mfConstantCurrentTime;
+    float fConstantVoltageTime = mfConstantVoltageSoc * mfConstantCurrentTime;
+
+    if (fSoc <= mfMinimumCurrentSoc)
+    {
+        return fConstantVoltageTime + fTaperTime * log((1.0f - mfConstantVoltageSoc) / (1.0f - fSoc));
+    }
+
+    // Minimum current phase until the battery is full.
+    float fMinimumCurrentTime = fConstantVoltageTime + fTaperTime * log(1.0f / mfMinimumCurrent);
+    return fMinimumCurrentTime + (fSoc - mfMinimumCurrentSoc) * mfConstantCurrentTime / mfMinimumCurrent;
+}
+
+float BatteryModel::CalculateSocAtTime(float fTime) const
+{
+    // Constant current phase.
+    float fConstantVoltageTime = mfConstantVoltageSoc * mfConstantCurrentTime;
+    if (fTime <= fConstantVoltageTime)
+    {
+        return fTime / mfConstantCurrentTime;
+    }
+
+    // Constant voltage phase.
+    float fTaperTime = (1.0f - mfConstantVoltageSoc) * mfConstantCurrentTime;
+    float fMinimumCurrentTime = fConstantVoltageTime + fTaperTime * log(1.0f / mfMinimumCurrent);
+
+    if (fTime <= fMinimumCurrentTime)
+    {
+        return 1.0f - (1.0f - mfConstantVoltageSoc) * exp(-(fTime - fConstantVoltageTime) / fTaperTime);
+    }
+
+    // Minimum current phase until the battery is full.
+    return min(mfMinimumCurrentSoc + (fTime - fMinimumCurrentTime) * mfMinimumCurrent / mfConstantCurrentTime, 1.0f);
+}
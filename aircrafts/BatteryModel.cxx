@@ -0,0 +1,79 @@
+/**
+ * @brief Contains tests for the BatteryModel class.
+ * 
+*/
+
+#include "BatteryModel.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+// Test the BatteryModel::BatteryModel() constructor.
+TEST_CASE( "BatteryModel::BatteryModel" )
+{
+    // Check if we get an exception with parameters out of range.
+    REQUIRE_THROWS(BatteryModel(0));
+    REQUIRE_THROWS(BatteryModel(1, 0));
+    REQUIRE_THROWS(BatteryModel(1, 1.5f));
+    REQUIRE_THROWS(BatteryModel(1, 0.8f, 0));
+
+    // Check if the charging rate is derated out of the optimal temperature range.
+    REQUIRE(BatteryModel(1).GetDerating() == 1);
+    REQUIRE(BatteryModel(1, 1, 0.05f, -10).GetDerating() < 1);
+    REQUIRE(BatteryModel(1, 1, 0.05f, 50).GetDerating() < 1);
+}
+
+// Test the BatteryModel::GetTimeToCharge() method.
+TEST_CASE( "BatteryModel::GetTimeToCharge" )
+{
+    // Check if the default model is linear.
+    BatteryModel oLinear(0.6f);
+    REQUIRE(oLinear.GetTimeToFullCharge() == 0.6f);
+    REQUIRE(oLinear.GetTimeToCharge(0, 0.5f) == 0.3f);
+    REQUIRE(oLinear.GetTimeToCharge(0.5f, 1) == 0.3f);
+
+    // Check if the constant voltage phase takes longer than the constant current one.
+    BatteryModel oTapered(0.6f, 0.8f);
+    REQUIRE(oTapered.GetTimeToCharge(0, 0.5f) == oLinear.GetTimeToCharge(0, 0.5f));
+    REQUIRE(oTapered.GetTimeToCharge(0.8f, 1) > oLinear.GetTimeToCharge(0.8f, 1));
+    REQUIRE(oTapered.GetTimeToFullCharge() > oLinear.GetTimeToFullCharge());
+
+    // Check if the time is monotone with the SOC.
+    for (float fSoc = 0.01f; fSoc <= 1; fSoc += 0.01f)
+    {
+        REQUIRE(oTapered.GetTimeToCharge(0, fSoc) >= oTapered.GetTimeToCharge(0, fSoc - 0.01f));
+    }
+
+    // Check if a colder battery takes longer to charge.
+    REQUIRE(BatteryModel(0.6f, 0.8f, 0.05f, 0).GetTimeToFullCharge() > oTapered.GetTimeToFullCharge());
+}
+
+// Test the BatteryModel::GetSocAfterCharging() method.
+TEST_CASE( "BatteryModel::GetSocAfterCharging" )
+{
+    // Check if charging the time to full charge gets the battery full.
+    BatteryModel oTapered(0.6f, 0.8f);
+    REQUIRE(oTapered.GetSocAfterCharging(0.2f, oTapered.GetTimeToCharge(0.2f, 1)) == 1);
+    REQUIRE(oTapered.GetSocAfterCharging(0.2f, 10) == 1);
+
+    // Check if charging is the inverse of the time to charge.
+    float fSoc = oTapered.GetSocAfterCharging(0.2f, oTapered.GetTimeToCharge(0.2f, 0.9f));
+    REQUIRE(fSoc > 0.89f);
+    REQUIRE(fSoc < 0.91f);
+
+    // Check if the SOC never decreases.
+    REQUIRE(oTapered.GetSocAfterCharging(0.5f, 0) >= 0.5f);
+}
+
+// Test the BatteryModel::GetTimesToFullCharge() method.
+TEST_CASE( "BatteryModel::GetTimesToFullCharge" )
+{
+    // Check if the batch gets the same times as the single queries.
+    BatteryModel oTapered(0.6f, 0.8f);
+    const float kafSoc[] = { 0, 0.25f, 0.5f, 0.85f, 1 };
+    float afTimes[5];
+    oTapered.GetTimesToFullCharge(kafSoc, afTimes, 5);
+    for (size_t i = 0; i < 5; i++)
+    {
+        REQUIRE(afTimes[i] == oTapered.GetTimeToCharge(kafSoc[i], 1));
+    }
+}
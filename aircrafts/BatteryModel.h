@@ -0,0 +1,149 @@
+#ifndef _BATTERY_MODEL_H_
+#define _BATTERY_MODEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Constant-current/constant-voltage (CC/CV) battery charging model.
+ * 
+ * @note  The battery charges at the nominal rate, a full battery in the time
+ *        to charge, until reaching the constant voltage state of charge (SOC),
+ *        then the current tapers linearly with the remaining capacity until
+ *        a minimum current, which is kept until the battery is full. The rate
+ *        is derated when the temperature is out of the optimal range.
+ * 
+ *        The curve is precomputed at construction into two monotone lookup
+ *        tables, time per SOC and SOC per time, so the time to reach a SOC and
+ *        the charge reached after some time are O(1) interpolations.
+ * 
+ *        With the default parameters the model is linear, which is the
+ *        charging assumed in the problem statement.
+ * 
+ */
+class BatteryModel
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Battery Model object.
+     * 
+     * @param fTimeToCharge         The time to charge from empty at the nominal rate in hours.
+     * @param fConstantVoltageSoc   The SOC in the range (0, 1] where the current starts tapering.
+     * @param fMinimumCurrent       The minimum current during the taper, as a fraction of the nominal.
+     * @param fTemperature          The battery temperature in Celsius degrees.
+     * 
+     * @throw std::runtime_error if any of the parameters is out of range.
+     */
+    BatteryModel(float fTimeToCharge,
+                 float fConstantVoltageSoc = 1.0f,
+                 float fMinimumCurrent = 0.05f,
+                 float fTemperature = 25.0f);
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the time to charge from empty to full in hours.
+     * 
+     * @return The time to charge from empty to full.
+     */
+    inline float GetTimeToFullCharge() const { return mafTimeAtSoc[kuiTableSize]; }
+
+    /**
+     * @brief Get the charging rate derating factor for the temperature.
+     * 
+     * @return The derating factor in the range (0, 1].
+     */
+    inline float GetDerating() const { return mfDerating; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Get the time to charge between two states of charge.
+     * 
+     * @param fFromSoc      The initial SOC in the range [0, 1].
+     * @param fToSoc        The target SOC in the range [fFromSoc, 1].
+     * 
+     * @return The time to charge in hours.
+     */
+    inline float GetTimeToCharge(float fFromSoc, float fToSoc) const
+    {
+        return Interpolate(mafTimeAtSoc, fToSoc * kuiTableSize) - Interpolate(mafTimeAtSoc, fFromSoc * kuiTableSize);
+    }
+
+    /**
+     * @brief Get the SOC reached after charging for some time.
+     * 
+     * @param fSoc          The initial SOC in the range [0, 1].
+     * @param fTime         The time charging in hours.
+     * 
+     * @return The SOC reached, in the range [fSoc, 1].
+     */
+    float GetSocAfterCharging(float fSoc, float fTime) const;
+
+    /**
+     * @brief Get the time to charge to full for a batch of states of charge.
+     * 
+     * @param pafSoc        The states of charge in the range [0, 1].
+     * @param pafTimes      The output times to full charge in hours.
+     * @param uiCount       The number of states of charge.
+     */
+    void GetTimesToFullCharge(const float* pafSoc, float* pafTimes, size_t uiCount) const;
+
+private:
+    /**
+     * @brief Interpolate a lookup table.
+     * 
+     * @param pafTable      The table with kuiTableSize + 1 entries.
+     * @param fPosition     The position in the range [0, kuiTableSize].
+     * 
+     * @return The interpolated value.
+     */
+    static inline float Interpolate(const float* pafTable, float fPosition)
+    {
+        size_t uiIndex = fPosition < kuiTableSize ? static_cast<size_t>(fPosition) : kuiTableSize - 1;
+        return pafTable[uiIndex] + (fPosition - uiIndex) * (pafTable[uiIndex + 1] - pafTable[uiIndex]);
+    }
+
+    /**
+     * @brief Calculate the time to charge from empty to a SOC with the curve.
+     * 
+     * @param fSoc          The SOC in the range [0, 1].
+     * 
+     * @return The time to charge in hours.
+     */
+    float CalculateTimeAtSoc(float fSoc) const;
+
+    /**
+     * @brief Calculate the SOC reached from empty after some time with the curve.
+     * 
+     * @param fTime         The time charging in hours.
+     * 
+     * @return The SOC in the range [0, 1].
+     */
+    float CalculateSocAtTime(float fTime) const;
+
+    /********** Constants **********/
+
+    static constexpr size_t kuiTableSize = 256; // Power of two, so the grid points are exact.
+
+    /********** Variables **********/
+
+    float mfConstantCurrentTime; // The time to charge the full capacity at constant current.
+    float mfConstantVoltageSoc;  // The SOC where the current starts tapering.
+    float mfMinimumCurrent;      // The minimum taper current as a fraction of the nominal.
+    float mfMinimumCurrentSoc;   // The SOC where the taper reaches the minimum current.
+    float mfDerating;            // The temperature derating factor.
+
+    float mfTimeScale;           // The positions in the SOC per time table per hour.
+
+    float mafTimeAtSoc[kuiTableSize + 1]; // The time from empty to reach the SOC i / kuiTableSize.
+    float mafSocAtTime[kuiTableSize + 1]; // The SOC reached from empty after the time j / mfTimeScale.
+};
+
+#endif // _BATTERY_MODEL_H_
@@ -0,0 +1,372 @@
+/**
+ * @brief Implementation of the C interface of the simulation engine.
+ *
+ */
+
+#include "EvtolApi.h"
+#include "worlds/Scenario.h"
+#include "worlds/StatisticsWriter.h"
+#include "worlds/SimpleWorld/World.h"
+#include "worlds/SteppedWorld/World.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+
+static_assert(EVTOL_COMPANIES == (size_t)AircraftCompany::TotalCompanies, "The C interface companies do not match the aircraft companies.");
+
+// A world with its scenario and the thread owning it.
+struct EvtolWorld
+{
+    unique_ptr<Scenario> poScenario;
+    unique_ptr<SimulationWorld> poWorld;
+    thread::id oThread;
+};
+
+// The message of the last error and the world of each thread.
+static thread_local string tsLastError;
+static thread_local const EvtolWorld* tpoThreadWorld = nullptr;
+
+// Keep the message of an error and get its status.
+static EvtolStatus Fail(EvtolStatus eStatus, const string& sMessage)
+{
+    tsLastError = sMessage;
+    return eStatus;
+}
+
+// Check a world can be used by the calling thread.
+static EvtolStatus CheckWorld(const EvtolWorld* poWorld)
+{
+    if (poWorld == nullptr)
+    {
+        return Fail(EVTOL_INVALID_ARGUMENT, "The world is null.");
+    }
+    if (poWorld->oThread != this_thread::get_id())
+    {
+        return Fail(EVTOL_WRONG_THREAD, "The world belongs to another thread.");
+    }
+    return EVTOL_OK;
+}
+
+// Create a world for a scenario with the rest of the configuration, in the calling thread.
+static EvtolWorld* CreateWorld(unique_ptr<Scenario> poScenario, const EvtolConfig& koConfig)
+{
+    if (tpoThreadWorld != nullptr)
+    {
+        Fail(EVTOL_INVALID_ARGUMENT, "The thread has a world already.");
+        return nullptr;
+    }
+    if (koConfig.bStepped != 0 && koConfig.fSitePowerCap > 0)
+    {
+        Fail(EVTOL_INVALID_ARGUMENT, "The stepped world does not share a site power cap.");
+        return nullptr;
+    }
+
+    try
+    {
+        FaultSampling oSampling;
+        oSampling.bCommonRandomNumbers = koConfig.bCommonRandomNumbers != 0;
+        oSampling.bAntithetic = koConfig.bAntithetic != 0;
+        oSampling.fImportanceFactor = koConfig.fImportanceFactor;
+        AircraftType::SetFaultSampling(oSampling);
+        AircraftType::ResetStatistics();
+
+        unique_ptr<EvtolWorld> poWorld = make_unique<EvtolWorld>();
+        if (koConfig.bStepped != 0)
+        {
+            poWorld->poWorld = SteppedWorld::CreateWorld(*poScenario, false);
+        }
+        else
+        {
+            SimpleWorld::WorldOptions oOptions;
+            oOptions.fSitePowerCap = koConfig.fSitePowerCap;
+            poWorld->poWorld = SimpleWorld::CreateWorld(*poScenario, oOptions);
+        }
+        poWorld->poScenario = std::move(poScenario);
+        poWorld->oThread = this_thread::get_id();
+
+        tsLastError.clear();
+        tpoThreadWorld = poWorld.get();
+        return poWorld.release();
+    }
+    catch (const std::exception& oError)
+    {
+        Fail(EVTOL_FAILED, oError.what());
+        return nullptr;
+    }
+}
+
+// Get the configuration of a caller, with the defaults of the fields it does not know.
+static bool ReadConfig(const EvtolConfig* poConfig, EvtolConfig& oConfig)
+{
+    EvtolInitConfig(&oConfig);
+    if (poConfig == nullptr || poConfig->uiSize < sizeof(uint32_t))
+    {
+        Fail(EVTOL_INVALID_ARGUMENT, "The configuration is null or has no size.");
+        return false;
+    }
+    memcpy(&oConfig, poConfig, min<size_t>(poConfig->uiSize, sizeof(oConfig)));
+    oConfig.uiSize = sizeof(oConfig);
+    return true;
+}
+
+extern "C" EVTOL_API void EvtolInitConfig(EvtolConfig* poConfig)
+{
+    if (poConfig == nullptr)
+    {
+        return;
+    }
+
+    memset(poConfig, 0, sizeof(*poConfig));
+    poConfig->uiSize = sizeof(*poConfig);
+    fill(poConfig->auiAircrafts, poConfig->auiAircrafts + EVTOL_COMPANIES, 4u);
+    poConfig->uiChargers = Scenario::kuiDefaultChargers;
+    poConfig->fImportanceFactor = 1.0f;
+}
+
+extern "C" EVTOL_API EvtolWorld* EvtolCreateWorld(const EvtolConfig* poConfig)
+{
+    EvtolConfig oConfig;
+    if (!ReadConfig(poConfig, oConfig))
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        unique_ptr<Scenario> poScenario = make_unique<Scenario>();
+        poScenario->SetChargersCount(oConfig.uiChargers);
+        poScenario->SetSeed(oConfig.uiSeed);
+        for (size_t i = 0; i < EVTOL_COMPANIES; i++)
+        {
+            poScenario->AddAircrafts(static_cast<AircraftCompany>(i), oConfig.auiAircrafts[i], 1.0f, AircraftState::Idle);
+        }
+        return CreateWorld(std::move(poScenario), oConfig);
+    }
+    catch (const std::exception& oError)
+    {
+        Fail(EVTOL_INVALID_ARGUMENT, oError.what());
+        return nullptr;
+    }
+}
+
+extern "C" EVTOL_API EvtolWorld* EvtolLoadWorld(const char* pcPath, const EvtolConfig* poConfig)
+{
+    EvtolConfig oConfig;
+    if (!ReadConfig(poConfig, oConfig))
+    {
+        return nullptr;
+    }
+    if (pcPath == nullptr)
+    {
+        Fail(EVTOL_INVALID_ARGUMENT, "The scenario path is null.");
+        return nullptr;
+    }
+
+    try
+    {
+        return CreateWorld(Scenario::Load(pcPath), oConfig);
+    }
+    catch (const std::exception& oError)
+    {
+        Fail(EVTOL_INVALID_ARGUMENT, oError.what());
+        return nullptr;
+    }
+}
+
+extern "C" EVTOL_API void EvtolDestroyWorld(EvtolWorld* poWorld)
+{
+    if (poWorld == nullptr || CheckWorld(poWorld) != EVTOL_OK)
+    {
+        return;
+    }
+
+    tpoThreadWorld = nullptr;
+    delete poWorld;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolRun(EvtolWorld* poWorld, uint32_t uiHours)
+{
+    EvtolStatus eStatus = EvtolStart(poWorld, uiHours);
+    return eStatus == EVTOL_OK ? EvtolRunUntil(poWorld, uiHours) : eStatus;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolStart(EvtolWorld* poWorld, double fHorizon)
+{
+    EvtolStatus eStatus = CheckWorld(poWorld);
+    if (eStatus != EVTOL_OK)
+    {
+        return eStatus;
+    }
+
+    try
+    {
+        poWorld->poWorld->Start(static_cast<float>(fHorizon));
+    }
+    catch (const std::exception& oError)
+    {
+        return Fail(EVTOL_INVALID_ARGUMENT, oError.what());
+    }
+
+    return EVTOL_OK;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolRunUntil(EvtolWorld* poWorld, double fTime)
+{
+    EvtolStatus eStatus = CheckWorld(poWorld);
+    if (eStatus != EVTOL_OK)
+    {
+        return eStatus;
+    }
+    if (isnan(fTime))
+    {
+        return Fail(EVTOL_INVALID_ARGUMENT, "The time is not a number.");
+    }
+
+    try
+    {
+        poWorld->poWorld->RunUntil(static_cast<float>(fTime));
+    }
+    catch (const std::exception& oError)
+    {
+        return Fail(EVTOL_FAILED, oError.what());
+    }
+
+    return EVTOL_OK;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolStep(EvtolWorld* poWorld, uint64_t uiMaxEvents, uint64_t* puiEvents)
+{
+    EvtolStatus eStatus = CheckWorld(poWorld);
+    if (eStatus != EVTOL_OK)
+    {
+        return eStatus;
+    }
+
+    try
+    {
+        uint64_t uiEvents = poWorld->poWorld->Step(uiMaxEvents);
+        if (puiEvents != nullptr)
+        {
+            *puiEvents = uiEvents;
+        }
+    }
+    catch (const std::exception& oError)
+    {
+        return Fail(EVTOL_FAILED, oError.what());
+    }
+
+    return EVTOL_OK;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolStepFor(EvtolWorld* poWorld, uint64_t uiMicroseconds, uint64_t* puiEvents)
+{
+    EvtolStatus eStatus = CheckWorld(poWorld);
+    if (eStatus != EVTOL_OK)
+    {
+        return eStatus;
+    }
+
+    try
+    {
+        uint64_t uiEvents = poWorld->poWorld->StepFor(chrono::microseconds(uiMicroseconds));
+        if (puiEvents != nullptr)
+        {
+            *puiEvents = uiEvents;
+        }
+    }
+    catch (const std::exception& oError)
+    {
+        return Fail(EVTOL_FAILED, oError.what());
+    }
+
+    return EVTOL_OK;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolGetTime(const EvtolWorld* poWorld, double* pfTime, int32_t* pbFinished)
+{
+    EvtolStatus eStatus = CheckWorld(poWorld);
+    if (eStatus != EVTOL_OK)
+    {
+        return eStatus;
+    }
+    if (pfTime == nullptr)
+    {
+        return Fail(EVTOL_INVALID_ARGUMENT, "The time is null.");
+    }
+
+    *pfTime = poWorld->poWorld->GetWorldTime();
+    if (pbFinished != nullptr)
+    {
+        *pbFinished = poWorld->poWorld->IsFinished() ? 1 : 0;
+    }
+
+    return EVTOL_OK;
+}
+
+extern "C" EVTOL_API size_t EvtolGetMetricsCount(void)
+{
+    return StatisticsWriter::GetMetricsCount();
+}
+
+extern "C" EVTOL_API const char* EvtolGetMetricName(size_t uiMetric)
+{
+    return uiMetric < StatisticsWriter::GetMetricsCount() ? StatisticsWriter::GetMetric(uiMetric).pcName : nullptr;
+}
+
+extern "C" EVTOL_API int32_t EvtolFindMetric(const char* pcName)
+{
+    const StatisticsMetric* poMetric = pcName != nullptr ? StatisticsWriter::FindMetric(pcName) : nullptr;
+    return poMetric != nullptr ? static_cast<int32_t>(poMetric - &StatisticsWriter::GetMetric(0)) : -1;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolGetMetric(const EvtolWorld* poWorld, size_t uiMetric, double* pafValues, size_t uiCount)
+{
+    EvtolStatus eStatus = CheckWorld(poWorld);
+    if (eStatus != EVTOL_OK)
+    {
+        return eStatus;
+    }
+    if (uiMetric >= StatisticsWriter::GetMetricsCount() || pafValues == nullptr || uiCount < EVTOL_COMPANIES)
+    {
+        return Fail(EVTOL_INVALID_ARGUMENT, "The metric is unknown or the array is too small.");
+    }
+
+    const StatisticsMetric& koMetric = StatisticsWriter::GetMetric(uiMetric);
+    for (size_t i = 0; i < EVTOL_COMPANIES; i++)
+    {
+        pafValues[i] = koMetric.pfGetValue(*AircraftType::GetAircraftType(static_cast<AircraftCompany>(i)));
+    }
+
+    return EVTOL_OK;
+}
+
+extern "C" EVTOL_API EvtolStatus EvtolGetStatistics(const EvtolWorld* poWorld, double* pafValues, size_t uiCount)
+{
+    EvtolStatus eStatus = CheckWorld(poWorld);
+    if (eStatus != EVTOL_OK)
+    {
+        return eStatus;
+    }
+    if (pafValues == nullptr || uiCount < StatisticsWriter::GetMetricsCount() * EVTOL_COMPANIES)
+    {
+        return Fail(EVTOL_INVALID_ARGUMENT, "The array is too small for all the metrics.");
+    }
+
+    for (size_t uiMetric = 0; uiMetric < StatisticsWriter::GetMetricsCount(); uiMetric++)
+    {
+        EvtolGetMetric(poWorld, uiMetric, pafValues + uiMetric * EVTOL_COMPANIES, EVTOL_COMPANIES);
+    }
+
+    return EVTOL_OK;
+}
+
+extern "C" EVTOL_API const char* EvtolGetLastError(void)
+{
+    return tsLastError.c_str();
+}
@@ -0,0 +1,173 @@
+/**
+ * @brief Contains tests for the C interface of the simulation engine.
+ *
+*/
+
+#include "EvtolApi.h"
+#include "worlds/Scenario.h"
+#include "worlds/SimpleWorld/World.h"
+#include "worlds/StatisticsWriter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test the EvtolRun() and EvtolGetStatistics() functions.
+// Check the statistics are the ones of a world run directly with the same scenario.
+TEST_CASE( "EvtolRun" )
+{
+    EvtolConfig oConfig;
+    EvtolInitConfig(&oConfig);
+    oConfig.auiAircrafts[1] = 0;
+    oConfig.uiChargers = 2;
+    oConfig.uiSeed = 42;
+
+    // The statistics of a world run directly.
+    Scenario oScenario;
+    oScenario.SetChargersCount(2);
+    oScenario.SetSeed(42);
+    for (size_t i = 0; i < EVTOL_COMPANIES; i++)
+    {
+        oScenario.AddAircrafts(static_cast<AircraftCompany>(i), oConfig.auiAircrafts[i], 1.0f, AircraftState::Idle);
+    }
+    AircraftType::ResetStatistics();
+    SimpleWorld::CreateWorld(oScenario)->RunSimulation(3);
+    vector<double> afExpected;
+    for (size_t uiMetric = 0; uiMetric < StatisticsWriter::GetMetricsCount(); uiMetric++)
+    {
+        for (size_t i = 0; i < EVTOL_COMPANIES; i++)
+        {
+            afExpected.push_back(StatisticsWriter::GetMetric(uiMetric).pfGetValue(*AircraftType::GetAircraftType(static_cast<AircraftCompany>(i))));
+        }
+    }
+
+    EvtolWorld* poWorld = EvtolCreateWorld(&oConfig);
+    REQUIRE(poWorld != nullptr);
+    REQUIRE(EvtolRun(poWorld, 3) == EVTOL_OK);
+    REQUIRE(EvtolRun(poWorld, 3) == EVTOL_INVALID_ARGUMENT);
+    REQUIRE(string(EvtolGetLastError()) == "The simulation already started.");
+
+    vector<double> afValues(EvtolGetMetricsCount() * EVTOL_COMPANIES);
+    REQUIRE(EvtolGetStatistics(poWorld, afValues.data(), afValues.size() - 1) == EVTOL_INVALID_ARGUMENT);
+    REQUIRE(EvtolGetStatistics(poWorld, afValues.data(), afValues.size()) == EVTOL_OK);
+    REQUIRE(afValues == afExpected);
+
+    // A metric alone, by name.
+    const int32_t kiMetric = EvtolFindMetric("flights");
+    REQUIRE(kiMetric >= 0);
+    REQUIRE(string(EvtolGetMetricName(kiMetric)) == "flights");
+    double afFlights[EVTOL_COMPANIES];
+    REQUIRE(EvtolGetMetric(poWorld, kiMetric, afFlights, EVTOL_COMPANIES) == EVTOL_OK);
+    REQUIRE(afFlights[0] > 0);
+    REQUIRE(afFlights[1] == 0);
+    REQUIRE(afFlights[0] == afValues[kiMetric * EVTOL_COMPANIES]);
+    REQUIRE(EvtolFindMetric("wind") == -1);
+    REQUIRE(EvtolGetMetricName(EvtolGetMetricsCount()) == nullptr);
+
+    EvtolDestroyWorld(poWorld);
+}
+
+// Test the EvtolStep() and EvtolRunUntil() functions.
+// Check a world is advanced by many calls until its horizon.
+TEST_CASE( "EvtolStep" )
+{
+    EvtolConfig oConfig;
+    EvtolInitConfig(&oConfig);
+    oConfig.uiSeed = 42;
+    EvtolWorld* poWorld = EvtolCreateWorld(&oConfig);
+    REQUIRE(poWorld != nullptr);
+    REQUIRE(EvtolStart(poWorld, -1) == EVTOL_INVALID_ARGUMENT);
+    REQUIRE(EvtolStart(poWorld, 2.5) == EVTOL_OK);
+
+    uint64_t uiEvents = 0;
+    REQUIRE(EvtolStep(poWorld, 10, &uiEvents) == EVTOL_OK);
+    REQUIRE(uiEvents == 10);
+    REQUIRE(EvtolRunUntil(poWorld, 1.5) == EVTOL_OK);
+
+    double fTime = 0;
+    int32_t bFinished = 1;
+    REQUIRE(EvtolGetTime(poWorld, &fTime, &bFinished) == EVTOL_OK);
+    REQUIRE(fTime == 1.5);
+    REQUIRE(bFinished == 0);
+
+    while (!bFinished)
+    {
+        REQUIRE(EvtolStepFor(poWorld, 100, &uiEvents) == EVTOL_OK);
+        REQUIRE(EvtolGetTime(poWorld, &fTime, &bFinished) == EVTOL_OK);
+    }
+    REQUIRE(fTime == 2.5);
+    REQUIRE(EvtolRunUntil(poWorld, 10) == EVTOL_OK);
+    REQUIRE(EvtolGetTime(poWorld, &fTime, nullptr) == EVTOL_OK);
+    REQUIRE(fTime == 2.5);
+
+    EvtolDestroyWorld(poWorld);
+}
+
+// Test the EvtolCreateWorld() function.
+// Check a thread has one world at a time, and the worlds are only used by their thread.
+TEST_CASE( "EvtolCreateWorld" )
+{
+    EvtolConfig oConfig;
+    EvtolInitConfig(&oConfig);
+    REQUIRE(EvtolCreateWorld(nullptr) == nullptr);
+
+    // A configuration of an older version, only with the size, gets the defaults.
+    EvtolConfig oOlder;
+    oOlder.uiSize = sizeof(uint32_t);
+    EvtolWorld* poWorld = EvtolCreateWorld(&oOlder);
+    REQUIRE(poWorld != nullptr);
+    REQUIRE(EvtolCreateWorld(&oConfig) == nullptr);
+
+    EvtolStatus eStatus = EVTOL_OK;
+    EvtolWorld* poOtherWorld = nullptr;
+    thread oThread([&]()
+    {
+        eStatus = EvtolRun(poWorld, 1);
+        poOtherWorld = EvtolCreateWorld(&oConfig);
+        EvtolDestroyWorld(poOtherWorld);
+    });
+    oThread.join();
+    REQUIRE(eStatus == EVTOL_WRONG_THREAD);
+    REQUIRE(poOtherWorld != nullptr);
+
+    REQUIRE(EvtolRun(poWorld, 1) == EVTOL_OK);
+    EvtolDestroyWorld(poWorld);
+
+    poWorld = EvtolCreateWorld(&oConfig);
+    REQUIRE(poWorld != nullptr);
+    EvtolDestroyWorld(poWorld);
+
+    // The stepped world does not share a site power cap.
+    oConfig.bStepped = 1;
+    oConfig.fSitePowerCap = 100;
+    REQUIRE(EvtolCreateWorld(&oConfig) == nullptr);
+    REQUIRE(string(EvtolGetLastError()) == "The stepped world does not share a site power cap.");
+}
+
+// Test the EvtolRun() function of both worlds.
+// Check the library prints nothing to the standard output of the host.
+TEST_CASE( "EvtolRun quiet" )
+{
+    EvtolConfig oConfig;
+    EvtolInitConfig(&oConfig);
+
+    ostringstream oOutput;
+    streambuf* poConsole = cout.rdbuf(oOutput.rdbuf());
+    EvtolStatus aeStatus[2] = { EVTOL_FAILED, EVTOL_FAILED };
+    for (int iStepped = 0; iStepped < 2; iStepped++)
+    {
+        oConfig.bStepped = iStepped;
+        EvtolWorld* poWorld = EvtolCreateWorld(&oConfig);
+        aeStatus[iStepped] = poWorld != nullptr ? EvtolRun(poWorld, 3) : EVTOL_FAILED;
+        EvtolDestroyWorld(poWorld);
+    }
+    cout.rdbuf(poConsole);
+
+    REQUIRE(aeStatus[0] == EVTOL_OK);
+    REQUIRE(aeStatus[1] == EVTOL_OK);
+    REQUIRE(oOutput.str().empty());
+}
@@ -0,0 +1,249 @@
+#ifndef _EVTOL_API_H_
+#define _EVTOL_API_H_
+
+/**
+ * @brief The C interface of the simulation engine, to embed it in other
+ *        programs and languages without running the simulation executable.
+ *
+ * @note  The worlds print nothing, their statistics are copied to arrays
+ *        owned by the caller, indexed by company in the order of
+ *        AircraftCompany (Alpha, Bravo, Charlie, Delta, Echo). The aircraft
+ *        types keep the statistics per thread, so a thread has one world at
+ *        a time, and a world is only used by the thread that created it.
+ *        The functions do not throw, they return a status and the message
+ *        of the last error of the thread is kept.
+ *
+ *        The configuration starts with its size, so the fields added in
+ *        later versions get their defaults for the programs built before.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(EVTOL_SHARED)
+#ifdef EVTOL_BUILDING
+#define EVTOL_API __declspec(dllexport)
+#else
+#define EVTOL_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define EVTOL_API __attribute__((visibility("default")))
+#else
+#define EVTOL_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The number of aircraft companies, the size of the arrays per company.
+ *
+ */
+#define EVTOL_COMPANIES 5
+
+/**
+ * @brief The result of a call.
+ *
+ */
+typedef enum EvtolStatus
+{
+    EVTOL_OK = 0,               ///< The call succeeded.
+    EVTOL_INVALID_ARGUMENT = 1, ///< An argument is null, out of range or too small.
+    EVTOL_WRONG_THREAD = 2,     ///< The world belongs to another thread.
+    EVTOL_FAILED = 3,           ///< The simulation failed, see EvtolGetLastError().
+} EvtolStatus;
+
+/**
+ * @brief A simulation world, opaque.
+ *
+ */
+typedef struct EvtolWorld EvtolWorld;
+
+/**
+ * @brief The configuration of a world.
+ *
+ */
+typedef struct EvtolConfig
+{
+    uint32_t uiSize;                            ///< The size of the structure, set by EvtolInitConfig().
+    uint32_t auiAircrafts[EVTOL_COMPANIES];     ///< The aircrafts per company, idle with full batteries.
+    uint32_t uiChargers;                        ///< The number of chargers.
+    uint32_t uiSeed;                            ///< The random seed, 0 for the current time.
+    float fSitePowerCap;                        ///< The power cap in kW shared by the chargers, 0 for unlimited, and for the stepped world.
+    int32_t bStepped;                           ///< If the world advances in fixed time steps instead of events.
+    int32_t bCommonRandomNumbers;               ///< If the faults are drawn per aircraft and flight.
+    int32_t bAntithetic;                        ///< If the faults are drawn with 1 - u.
+    float fImportanceFactor;                    ///< The factor of the fault rate, the estimated faults are reweighted.
+} EvtolConfig;
+
+/**
+ * @brief Set the default configuration, a fleet of 20 aircrafts, 4 of each
+ *        company, and 3 chargers.
+ *
+ * @param poConfig  The configuration.
+ */
+EVTOL_API void EvtolInitConfig(EvtolConfig* poConfig);
+
+/**
+ * @brief Create a world, and restart the statistics of the calling thread.
+ *
+ * @param poConfig  The configuration, from EvtolInitConfig().
+ *
+ * @return The world, or NULL if the configuration is not valid or the
+ *         thread has a world already.
+ */
+EVTOL_API EvtolWorld* EvtolCreateWorld(const EvtolConfig* poConfig);
+
+/**
+ * @brief Create a world with the fleet, chargers and seed of a scenario file,
+ *        text or binary, and restart the statistics of the calling thread.
+ *
+ * @param pcPath    The path of the scenario.
+ * @param poConfig  The configuration of the rest, the fleet, chargers and seed are not used.
+ *
+ * @return The world, or NULL if the scenario cannot be loaded, the
+ *         configuration is not valid or the thread has a world already.
+ */
+EVTOL_API EvtolWorld* EvtolLoadWorld(const char* pcPath, const EvtolConfig* poConfig);
+
+/**
+ * @brief Destroy a world, in the thread that created it.
+ *
+ * @param poWorld   The world, NULL is ignored.
+ */
+EVTOL_API void EvtolDestroyWorld(EvtolWorld* poWorld);
+
+/**
+ * @brief Run the simulation of a world from its start until its end.
+ *
+ * @param poWorld   The world.
+ * @param uiHours   The simulation time in hours.
+ *
+ * @return EVTOL_OK, or an error if the world already started.
+ */
+EVTOL_API EvtolStatus EvtolRun(EvtolWorld* poWorld, uint32_t uiHours);
+
+/**
+ * @brief Start the simulation of a world, to advance it with EvtolRunUntil(),
+ *        EvtolStep() and EvtolStepFor(). They start it without end if it was not.
+ *
+ * @param poWorld   The world.
+ * @param fHorizon  The time the simulation ends in hours, fractional, or
+ *                  INFINITY for no end. The flights and charge sessions in
+ *                  progress then are reported.
+ *
+ * @return EVTOL_OK, or an error if the world already started or the horizon
+ *         is negative.
+ */
+EVTOL_API EvtolStatus EvtolStart(EvtolWorld* poWorld, double fHorizon);
+
+/**
+ * @brief Advance the simulation of a world until a time, the events and the
+ *        statistics continue from the previous call.
+ *
+ * @param poWorld   The world.
+ * @param fTime     The time in hours, the horizon at most.
+ *
+ * @return EVTOL_OK, or an error if an argument is not valid.
+ */
+EVTOL_API EvtolStatus EvtolRunUntil(EvtolWorld* poWorld, double fTime);
+
+/**
+ * @brief Advance the simulation of a world by a number of events, a time step
+ *        of a stepped world counts as one.
+ *
+ * @param poWorld       The world.
+ * @param uiMaxEvents   The maximum number of events to process.
+ * @param puiEvents     Gets the events processed, fewer if the simulation
+ *                      finished, or NULL.
+ *
+ * @return EVTOL_OK, or an error if an argument is not valid.
+ */
+EVTOL_API EvtolStatus EvtolStep(EvtolWorld* poWorld, uint64_t uiMaxEvents, uint64_t* puiEvents);
+
+/**
+ * @brief Advance the simulation of a world for a wall clock time, to bound
+ *        the time of the call.
+ *
+ * @param poWorld       The world.
+ * @param uiMicroseconds The wall clock time to spend.
+ * @param puiEvents     Gets the events processed, or NULL.
+ *
+ * @return EVTOL_OK, or an error if an argument is not valid.
+ */
+EVTOL_API EvtolStatus EvtolStepFor(EvtolWorld* poWorld, uint64_t uiMicroseconds, uint64_t* puiEvents);
+
+/**
+ * @brief Get the time the simulation of a world reached.
+ *
+ * @param poWorld   The world.
+ * @param pfTime    Gets the time in hours.
+ * @param pbFinished Gets 1 if the simulation reached its end, 0 otherwise, or NULL.
+ *
+ * @return EVTOL_OK, or an error if an argument is not valid.
+ */
+EVTOL_API EvtolStatus EvtolGetTime(const EvtolWorld* poWorld, double* pfTime, int32_t* pbFinished);
+
+/**
+ * @brief Get the number of metrics per company.
+ *
+ * @return The number of metrics.
+ */
+EVTOL_API size_t EvtolGetMetricsCount(void);
+
+/**
+ * @brief Get the name of a metric, as the statistics files name it.
+ *
+ * @param uiMetric  The metric, lower than EvtolGetMetricsCount().
+ *
+ * @return The name in snake case, or NULL if there is no such metric.
+ */
+EVTOL_API const char* EvtolGetMetricName(size_t uiMetric);
+
+/**
+ * @brief Find a metric by name.
+ *
+ * @param pcName    The name in snake case, as "passenger_miles".
+ *
+ * @return The metric, or -1 if the name is not a known metric.
+ */
+EVTOL_API int32_t EvtolFindMetric(const char* pcName);
+
+/**
+ * @brief Copy a metric of every company.
+ *
+ * @param poWorld   The world.
+ * @param uiMetric  The metric.
+ * @param pafValues Gets the values, indexed by company.
+ * @param uiCount   The size of the array, at least EVTOL_COMPANIES.
+ *
+ * @return EVTOL_OK, or an error if an argument is not valid.
+ */
+EVTOL_API EvtolStatus EvtolGetMetric(const EvtolWorld* poWorld, size_t uiMetric, double* pafValues, size_t uiCount);
+
+/**
+ * @brief Copy all the metrics of every company at once.
+ *
+ * @param poWorld   The world.
+ * @param pafValues Gets the values, the metric at uiMetric * EVTOL_COMPANIES + company.
+ * @param uiCount   The size of the array, at least EvtolGetMetricsCount() * EVTOL_COMPANIES.
+ *
+ * @return EVTOL_OK, or an error if an argument is not valid.
+ */
+EVTOL_API EvtolStatus EvtolGetStatistics(const EvtolWorld* poWorld, double* pafValues, size_t uiCount);
+
+/**
+ * @brief Get the message of the last error of the calling thread.
+ *
+ * @return The message, empty if there was none, valid until the next call
+ *         of the thread.
+ */
+EVTOL_API const char* EvtolGetLastError(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _EVTOL_API_H_
@@ -0,0 +1,20 @@
+# Writes the build id of the engine, a hash of its sources, to the header OUTPUT.
+# The header only changes when a source does, so the results cached by the
+# engine are kept across the builds that do not change it.
+#
+# Usage: cmake -DOUTPUT=<header> -DSOURCES=<source>,<source>... -P EngineId.cmake
+
+string(REPLACE "," ";" SOURCES "${SOURCES}")
+list(SORT SOURCES)
+
+set(HASHES "")
+foreach(SOURCE ${SOURCES})
+    file(SHA256 "${SOURCE}" HASH)
+    string(APPEND HASHES "${HASH}")
+endforeach()
+string(SHA256 ENGINE_ID "${HASHES}")
+string(SUBSTRING "${ENGINE_ID}" 0 16 ENGINE_ID)
+
+file(WRITE "${OUTPUT}.tmp" "// Generated by EngineId.cmake, the hash of the engine sources.\n#define EVTOL_ENGINE_ID \"${ENGINE_ID}\"\n")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -0,0 +1,280 @@
+/**
+ * @brief Implementation of the CompositionSweep class.
+ *
+ */
+
+#include "CompositionSweep.h"
+#include "worlds/Scenario.h"
+#include "worlds/SimpleWorld/World.h"
+#include "utils/TextWriter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Split the aircrafts left between the companies from one, completing the compositions.
+static void EnumerateFrom(FleetComposition& oComposition, size_t uiCompany, uint32_t uiAircraftsLeft, vector<FleetComposition>& oCompositions)
+{
+    // The last company gets all the aircrafts left.
+    if (uiCompany + 1 == oComposition.size())
+    {
+        oComposition[uiCompany] = uiAircraftsLeft;
+        oCompositions.push_back(oComposition);
+        return;
+    }
+
+    for (uint32_t uiAircrafts = 0; uiAircrafts <= uiAircraftsLeft; uiAircrafts++)
+    {
+        oComposition[uiCompany] = uiAircrafts;
+        EnumerateFrom(oComposition, uiCompany + 1, uiAircraftsLeft - uiAircrafts, oCompositions);
+    }
+}
+
+CompositionSweep::CompositionSweep(uint32_t uiAircrafts, uint32_t uiChargers, uint16_t uiHours, float fSitePowerCap)
+    : muiAircrafts(uiAircrafts),
+      muiChargers(uiChargers),
+      muiHours(uiHours),
+      mfSitePowerCap(fSitePowerCap),
+      mpoCache(nullptr)
+{
+    vector<FleetComposition> oCompositions = EnumerateCompositions(uiAircrafts);
+    moResults.reserve(oCompositions.size());
+    for (const FleetComposition& koComposition : oCompositions)
+    {
+        moResults.push_back(CompositionResult{ koComposition, 0, 0, false });
+    }
+}
+
+void CompositionSweep::Run(uint32_t uiSeeds, uint32_t uiFirstSeed, uint32_t uiThreads)
+{
+    SetSeedResults(RunShard(0, moResults.size(), uiSeeds, uiFirstSeed, uiThreads), uiSeeds);
+}
+
+vector<SeedResult> CompositionSweep::RunShard(size_t uiBegin, size_t uiEnd, uint32_t uiSeeds, uint32_t uiFirstSeed, uint32_t uiThreads) const
+{
+    if (uiBegin > uiEnd || uiEnd > moResults.size())
+    {
+        throw std::runtime_error("The compositions " + to_string(uiBegin) + " to " + to_string(uiEnd) + " are not in the sweep.");
+    }
+
+    if (uiThreads == 0)
+    {
+        uiThreads = max(1u, thread::hardware_concurrency());
+    }
+
+    // Each thread takes the next composition not run yet, the first error stops them.
+    vector<SeedResult> oSeedResults((uiEnd - uiBegin) * uiSeeds);
+    atomic<size_t> uiNextResult(uiBegin);
+    atomic<bool> bFailed(false);
+    exception_ptr poError;
+    auto Worker = [&]()
+    {
+        // The fault sampling of the thread is restored once it finishes.
+        const FaultSampling koPreviousSampling = AircraftType::GetFaultSampling();
+        try
+        {
+            for (size_t i = uiNextResult++; i < uiEnd && !bFailed; i = uiNextResult++)
+            {
+                for (uint32_t k = 0; k < uiSeeds; k++)
+                {
+                    oSeedResults[(i - uiBegin) * uiSeeds + k] = RunSeed(moResults[i].auiAircrafts, uiFirstSeed + k);
+                }
+            }
+        }
+        catch (...)
+        {
+            if (!bFailed.exchange(true))
+            {
+                poError = current_exception();
+            }
+        }
+        AircraftType::SetFaultSampling(koPreviousSampling);
+    };
+
+    // The calling thread is one of the workers.
+    vector<thread> oThreads;
+    oThreads.reserve(uiThreads - 1);
+    for (uint32_t i = 1; i < uiThreads; i++)
+    {
+        oThreads.emplace_back(Worker);
+    }
+    Worker();
+    for (thread& oThread : oThreads)
+    {
+        oThread.join();
+    }
+
+    if (poError)
+    {
+        rethrow_exception(poError);
+    }
+
+    return oSeedResults;
+}
+
+void CompositionSweep::SetSeedResults(const vector<SeedResult>& koSeedResults, uint32_t uiSeeds)
+{
+    if (uiSeeds == 0 || koSeedResults.size() != moResults.size() * uiSeeds)
+    {
+        throw std::runtime_error("There must be a result for every composition and seed.");
+    }
+
+    // Add the seeds in their order, the antithetic draws run every seed as a pair.
+    const uint32_t kuiRuns = moFaultSampling.bAntithetic ? 2 * uiSeeds : uiSeeds;
+    for (size_t i = 0; i < moResults.size(); i++)
+    {
+        double fPassengerMiles = 0;
+        double fFaults = 0;
+        for (uint32_t k = 0; k < uiSeeds; k++)
+        {
+            fPassengerMiles += koSeedResults[i * uiSeeds + k].fPassengerMiles;
+            fFaults += koSeedResults[i * uiSeeds + k].fFaults;
+        }
+
+        moResults[i].fPassengerMiles = static_cast<float>(fPassengerMiles / kuiRuns);
+        moResults[i].fFaults = static_cast<float>(fFaults / kuiRuns);
+    }
+
+    MarkParetoFront(moResults);
+}
+
+SeedResult CompositionSweep::RunSeed(const FleetComposition& koAircrafts, uint32_t uiSeed) const
+{
+    // The key of everything the result depends on, with the engine and the specifications.
+    CacheKey oKey;
+    vector<double> afCached;
+    if (mpoCache != nullptr)
+    {
+        oKey = ResultCache::CreateKey("composition_sweep");
+        oKey.AddInteger(muiChargers).AddInteger(muiHours).AddFloat(mfSitePowerCap).AddInteger(uiSeed)
+            .AddInteger(moFaultSampling.bCommonRandomNumbers).AddInteger(moFaultSampling.bAntithetic)
+            .AddFloat(moFaultSampling.fImportanceFactor);
+        for (uint32_t uiAircrafts : koAircrafts)
+        {
+            oKey.AddInteger(uiAircrafts);
+        }
+        if (mpoCache->Find(oKey, afCached) && afCached.size() == 2)
+        {
+            return SeedResult{ afCached[0], afCached[1] };
+        }
+    }
+
+    // The antithetic draws run the seed as a pair.
+    const uint32_t kuiRuns = moFaultSampling.bAntithetic ? 2 : 1;
+    FaultSampling oSampling = moFaultSampling;
+
+    SeedResult oResult{ 0, 0 };
+    for (uint32_t uiRun = 0; uiRun < kuiRuns; uiRun++)
+    {
+        oSampling.bAntithetic = uiRun == 1;
+        AircraftType::SetFaultSampling(oSampling);
+
+        // Build the fleet with full batteries, every aircraft takes off at the start.
+        Scenario oScenario;
+        oScenario.SetChargersCount(muiChargers);
+        oScenario.SetHours(muiHours);
+        oScenario.SetSeed(uiSeed);
+        for (size_t i = 0; i < koAircrafts.size(); i++)
+        {
+            oScenario.AddAircrafts(static_cast<AircraftCompany>(i), koAircrafts[i], 1.0f, AircraftState::Idle);
+        }
+
+        // Run the world with the statistics of this thread from zero.
+        AircraftType::ResetStatistics();
+        SimpleWorld::QuietWorld oWorld(oScenario, mfSitePowerCap);
+        oWorld.RunSimulation(muiHours);
+
+        for (size_t i = 0; i < koAircrafts.size(); i++)
+        {
+            const AircraftType* poAircraftType = AircraftType::GetAircraftType(static_cast<AircraftCompany>(i));
+            oResult.fPassengerMiles += poAircraftType->TotalNumberOfPassengerMiles();
+            oResult.fFaults += poAircraftType->EstimatedNumberOfFaults();
+        }
+    }
+
+    if (mpoCache != nullptr)
+    {
+        mpoCache->Insert(oKey, { oResult.fPassengerMiles, oResult.fFaults });
+    }
+
+    return oResult;
+}
+
+void CompositionSweep::WriteCsv(ostream& oStream, bool bParetoFrontOnly) const
+{
+    TextWriter oOutput(oStream);
+
+    // The header, a column per company.
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        for (char cCharacter : AircraftType::GetAircraftType(static_cast<AircraftCompany>(i))->CompanyName())
+        {
+            oOutput << static_cast<char>(tolower(static_cast<unsigned char>(cCharacter)));
+        }
+        oOutput << ',';
+    }
+    oOutput << "passenger_miles,faults,pareto_front" << endl;
+
+    // The results in their order, or the front by decreasing passenger miles.
+    vector<size_t> auiRows(moResults.size());
+    iota(auiRows.begin(), auiRows.end(), 0);
+    if (bParetoFrontOnly)
+    {
+        auiRows.erase(remove_if(auiRows.begin(), auiRows.end(), [this](size_t i) { return !moResults[i].bParetoFront; }), auiRows.end());
+        sort(auiRows.begin(), auiRows.end(), [this](size_t i, size_t j) { return moResults[i].fPassengerMiles > moResults[j].fPassengerMiles; });
+    }
+
+    for (size_t uiRow : auiRows)
+    {
+        const CompositionResult& koResult = moResults[uiRow];
+        for (uint32_t uiAircrafts : koResult.auiAircrafts)
+        {
+            oOutput << uiAircrafts << ',';
+        }
+        oOutput << TextWriter::Shortest(koResult.fPassengerMiles) << ',' << TextWriter::Shortest(koResult.fFaults) << ','
+            << (koResult.bParetoFront ? 1 : 0) << '\n';
+    }
+    oOutput << flush;
+}
+
+/*static*/ vector<FleetComposition> CompositionSweep::EnumerateCompositions(uint32_t uiAircrafts)
+{
+    vector<FleetComposition> oCompositions;
+    FleetComposition oComposition{};
+    EnumerateFrom(oComposition, 0, uiAircrafts, oCompositions);
+    return oCompositions;
+}
+
+/*static*/ void CompositionSweep::MarkParetoFront(vector<CompositionResult>& oResults)
+{
+    // Sweep by decreasing passenger miles and increasing faults, a result is in
+    // the front if it has fewer faults than all the previous ones, or ties with
+    // the last one in the front.
+    vector<CompositionResult*> apoResults;
+    apoResults.reserve(oResults.size());
+    for (CompositionResult& oResult : oResults)
+    {
+        oResult.bParetoFront = false;
+        apoResults.push_back(&oResult);
+    }
+    sort(apoResults.begin(), apoResults.end(), [](const CompositionResult* poA, const CompositionResult* poB)
+    {
+        return poA->fPassengerMiles != poB->fPassengerMiles ? poA->fPassengerMiles > poB->fPassengerMiles : poA->fFaults < poB->fFaults;
+    });
+
+    const CompositionResult* poLast = nullptr;
+    for (CompositionResult* poResult : apoResults)
+    {
+        if (poLast == nullptr || poResult->fFaults < poLast->fFaults
+            || (poResult->fFaults == poLast->fFaults && poResult->fPassengerMiles == poLast->fPassengerMiles))
+        {
+            poResult->bParetoFront = true;
+            poLast = poResult;
+        }
+    }
+}
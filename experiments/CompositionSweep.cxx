@@ -0,0 +1,135 @@
+/**
+ * @brief Contains tests for the CompositionSweep class.
+ *
+*/
+
+#include "CompositionSweep.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+// Test the CompositionSweep::EnumerateCompositions() method.
+// Check there are C(n + 4, 4) different compositions of n aircrafts.
+TEST_CASE( "CompositionSweep::EnumerateCompositions" )
+{
+    vector<FleetComposition> oCompositions = CompositionSweep::EnumerateCompositions(20);
+    REQUIRE(oCompositions.size() == 10626);
+    REQUIRE(set<FleetComposition>(oCompositions.begin(), oCompositions.end()).size() == oCompositions.size());
+    for (const FleetComposition& koComposition : oCompositions)
+    {
+        REQUIRE(accumulate(koComposition.begin(), koComposition.end(), 0u) == 20);
+    }
+
+    // The fleets of one aircraft have a single company each, an empty fleet is a single composition.
+    REQUIRE(CompositionSweep::EnumerateCompositions(1).size() == (size_t)AircraftCompany::TotalCompanies);
+    REQUIRE(CompositionSweep::EnumerateCompositions(0).size() == 1);
+}
+
+// Test the CompositionSweep::MarkParetoFront() method.
+TEST_CASE( "CompositionSweep::MarkParetoFront" )
+{
+    vector<CompositionResult> oResults = {
+        { {}, 100, 5, false },  // Front, the most passenger miles.
+        { {}, 90, 5, false },   // Dominated by the first one.
+        { {}, 80, 2, false },   // Front.
+        { {}, 80, 2, false },   // Front, tied.
+        { {}, 70, 3, false },   // Dominated by the third one.
+        { {}, 10, 0, false },   // Front, the fewest faults.
+    };
+    CompositionSweep::MarkParetoFront(oResults);
+    REQUIRE(oResults[0].bParetoFront);
+    REQUIRE_FALSE(oResults[1].bParetoFront);
+    REQUIRE(oResults[2].bParetoFront);
+    REQUIRE(oResults[3].bParetoFront);
+    REQUIRE_FALSE(oResults[4].bParetoFront);
+    REQUIRE(oResults[5].bParetoFront);
+}
+
+// Test the CompositionSweep::Run() method.
+// Check the results do not depend on the number of threads.
+TEST_CASE( "CompositionSweep::Run" )
+{
+    CompositionSweep oSerial(4, 1, 2);
+    oSerial.Run(2, 42, 1);
+    CompositionSweep oParallel(4, 1, 2);
+    oParallel.Run(2, 42, 4);
+
+    REQUIRE(oSerial.GetResults().size() == 70);
+    for (size_t i = 0; i < oSerial.GetResults().size(); i++)
+    {
+        REQUIRE(oSerial.GetResults()[i].fPassengerMiles > 0);
+        REQUIRE(oSerial.GetResults()[i].fPassengerMiles == oParallel.GetResults()[i].fPassengerMiles);
+        REQUIRE(oSerial.GetResults()[i].fFaults == oParallel.GetResults()[i].fFaults);
+    }
+
+    // The table has a header and a row per composition.
+    ostringstream oStream;
+    oSerial.WriteCsv(oStream);
+    string sTable = oStream.str();
+    REQUIRE(sTable.rfind("alpha,bravo,charlie,delta,echo,passenger_miles,faults,pareto_front\n", 0) == 0);
+    REQUIRE(count(sTable.begin(), sTable.end(), '\n') == 71);
+}
+
+// Test the CompositionSweep::SetFaultSampling() method.
+// Check the antithetic pairs do not depend on the number of threads, and the sampling of the calling thread is kept.
+TEST_CASE( "CompositionSweep::SetFaultSampling" )
+{
+    FaultSampling oSampling;
+    oSampling.bCommonRandomNumbers = true;
+    oSampling.bAntithetic = true;
+    oSampling.fImportanceFactor = 4.0f;
+
+    CompositionSweep oSerial(3, 1, 2);
+    oSerial.SetFaultSampling(oSampling);
+    oSerial.Run(2, 42, 1);
+    CompositionSweep oParallel(3, 1, 2);
+    oParallel.SetFaultSampling(oSampling);
+    oParallel.Run(2, 42, 3);
+
+    for (size_t i = 0; i < oSerial.GetResults().size(); i++)
+    {
+        REQUIRE(oSerial.GetResults()[i].fFaults == oParallel.GetResults()[i].fFaults);
+    }
+    REQUIRE_FALSE(AircraftType::GetFaultSampling().bAntithetic);
+    REQUIRE(AircraftType::GetFaultSampling().fImportanceFactor == 1.0f);
+}
+
+// Test the CompositionSweep::Run() method with a tapered battery model.
+// Check the taper slows the charging of the worker threads too, so they fly fewer passenger miles.
+TEST_CASE( "CompositionSweep::Run tapered battery model" )
+{
+    CompositionSweep oLinear(4, 1, 3);
+    oLinear.Run(1, 42, 4);
+
+    // Taper from half the charge on all the types, in the cold.
+    vector<BatteryModel> oPreviousModels;
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        const AircraftType* poAircraftType = AircraftType::GetAircraftType((AircraftCompany)i);
+        oPreviousModels.push_back(poAircraftType->GetBatteryModel());
+        AircraftType::SetBatteryModel((AircraftCompany)i, BatteryModel(poAircraftType->GetTimeToCharge(), 0.5f, 0.05f, 0.0f));
+    }
+    CompositionSweep oSerial(4, 1, 3);
+    oSerial.Run(1, 42, 1);
+    CompositionSweep oParallel(4, 1, 3);
+    oParallel.Run(1, 42, 4);
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        AircraftType::SetBatteryModel((AircraftCompany)i, oPreviousModels[i]);
+    }
+
+    float fLinearMiles = 0;
+    float fTaperedMiles = 0;
+    for (size_t i = 0; i < oLinear.GetResults().size(); i++)
+    {
+        REQUIRE(oParallel.GetResults()[i].fPassengerMiles == oSerial.GetResults()[i].fPassengerMiles);
+        REQUIRE(oParallel.GetResults()[i].fPassengerMiles <= oLinear.GetResults()[i].fPassengerMiles);
+        fLinearMiles += oLinear.GetResults()[i].fPassengerMiles;
+        fTaperedMiles += oParallel.GetResults()[i].fPassengerMiles;
+    }
+    REQUIRE(fTaperedMiles < fLinearMiles);
+}
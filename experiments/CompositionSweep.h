@@ -0,0 +1,225 @@
+#ifndef _COMPOSITION_SWEEP_H_
+#define _COMPOSITION_SWEEP_H_
+
+#include "aircrafts/AircraftType.h"
+#include "ResultCache.h"
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The number of aircrafts of each company in a fleet.
+ *
+ */
+using FleetComposition = array<uint32_t, (size_t)AircraftCompany::TotalCompanies>;
+
+/**
+ * @brief The statistics of a fleet composition, averaged over the seeds.
+ *
+ */
+struct CompositionResult
+{
+    FleetComposition auiAircrafts; ///< The aircrafts per company.
+    float fPassengerMiles;         ///< The passenger miles of all the aircraft types.
+    float fFaults;                 ///< The estimated faults of all the aircraft types.
+    bool bParetoFront;             ///< If no other composition has more passenger miles with fewer faults.
+};
+
+/**
+ * @brief The statistics of a fleet composition for one seed, summed over its
+ *        runs, two of them with antithetic draws.
+ *
+ */
+struct SeedResult
+{
+    double fPassengerMiles; ///< The passenger miles of all the aircraft types.
+    double fFaults;         ///< The estimated faults of all the aircraft types.
+};
+
+/**
+ * @brief Runs a simple world for every composition of a fleet, with the same
+ *        seeds for all of them, on a pool of threads.
+ *
+ * @note  Each thread runs one world at a time, the aircraft types statistics
+ *        are per thread, see AircraftType. The threads take the compositions
+ *        from a shared counter, and write the results of each composition to
+ *        its own slot, so there is no locking. The results of each seed are
+ *        added in the order of the seeds, so a sweep run in shards, by other
+ *        processes, gets the same results as one run at once.
+ *
+ */
+class CompositionSweep
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Composition Sweep object with all the compositions.
+     *
+     * @param uiAircrafts        The number of aircrafts of every fleet.
+     * @param uiChargers         The number of chargers.
+     * @param uiHours            The simulation time in hours.
+     * @param fSitePowerCap      The power cap in kW shared by all the chargers,
+     *                           0 for unlimited.
+     */
+    CompositionSweep(uint32_t uiAircrafts, uint32_t uiChargers, uint16_t uiHours, float fSitePowerCap = 0);
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of aircrafts of every fleet.
+     *
+     * @return The number of aircrafts.
+     */
+    inline uint32_t GetAircraftsCount() const { return muiAircrafts; }
+
+    /**
+     * @brief Get the number of chargers.
+     *
+     * @return The number of chargers.
+     */
+    inline uint32_t GetChargersCount() const { return muiChargers; }
+
+    /**
+     * @brief Get the simulation time.
+     *
+     * @return The simulation time in hours.
+     */
+    inline uint16_t GetHours() const { return muiHours; }
+
+    /**
+     * @brief Get the site power cap.
+     *
+     * @return The power cap in kW, 0 for unlimited.
+     */
+    inline float GetSitePowerCap() const { return mfSitePowerCap; }
+
+    /**
+     * @brief Get the results, in the order of the compositions.
+     *
+     * @return The results, with zero statistics until Run() is called.
+     */
+    inline const vector<CompositionResult>& GetResults() const { return moResults; }
+
+    /**
+     * @brief Set the variance reduction of the fault draws. With antithetic
+     *        draws every seed runs twice, with u and 1 - u.
+     * 
+     * @param koSampling    The fault sampling options, none by default.
+     */
+    inline void SetFaultSampling(const FaultSampling& koSampling) { moFaultSampling = koSampling; }
+
+    /**
+     * @brief Get the variance reduction of the fault draws.
+     *
+     * @return The fault sampling options.
+     */
+    inline const FaultSampling& GetFaultSampling() const { return moFaultSampling; }
+
+    /**
+     * @brief Set the cache of the results, the runs found in it are not run again.
+     *
+     * @param poCache   The cache, which must outlive the runs, nullptr for none.
+     */
+    inline void SetResultCache(ResultCache* poCache) { mpoCache = poCache; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Run every composition once per seed, and find the Pareto front.
+     *
+     * @param uiSeeds       The number of seeds, at least 1.
+     * @param uiFirstSeed   The first seed, the next ones are consecutive, none can be 0.
+     * @param uiThreads     The number of threads, 0 for one per hardware thread.
+     *
+     * @throw std::runtime_error if a world fails, once all the threads finished.
+     */
+    void Run(uint32_t uiSeeds, uint32_t uiFirstSeed, uint32_t uiThreads = 0);
+
+    /**
+     * @brief Run a range of compositions once per seed, without changing the
+     *        results.
+     *
+     * @param uiBegin       The first composition.
+     * @param uiEnd         The composition after the last one.
+     * @param uiSeeds       The number of seeds.
+     * @param uiFirstSeed   The first seed, the next ones are consecutive, none can be 0.
+     * @param uiThreads     The number of threads, 0 for one per hardware thread.
+     *
+     * @return The results of each composition and seed, the seeds of a composition
+     *         are consecutive.
+     *
+     * @throw std::runtime_error if the range is not valid, or a world fails once
+     *        all the threads finished.
+     */
+    vector<SeedResult> RunShard(size_t uiBegin, size_t uiEnd, uint32_t uiSeeds, uint32_t uiFirstSeed, uint32_t uiThreads = 0) const;
+
+    /**
+     * @brief Set the results from the results of every composition and seed,
+     *        averaged over the runs, and find the Pareto front.
+     *
+     * @param koSeedResults The results of each composition and seed, the seeds
+     *                      of a composition are consecutive.
+     * @param uiSeeds       The number of seeds.
+     *
+     * @throw std::runtime_error if there is not a result for every composition and seed.
+     */
+    void SetSeedResults(const vector<SeedResult>& koSeedResults, uint32_t uiSeeds);
+
+    /**
+     * @brief Write the results as CSV with a header line.
+     *
+     * @param oStream           The output stream.
+     * @param bParetoFrontOnly  If only the compositions in the Pareto front are written,
+     *                          by decreasing passenger miles.
+     */
+    void WriteCsv(ostream& oStream, bool bParetoFrontOnly = false) const;
+
+    /**
+     * @brief Get all the ways to split a fleet between the companies, in
+     *        lexicographic order.
+     *
+     * @param uiAircrafts   The number of aircrafts of the fleet.
+     *
+     * @return The compositions, C(uiAircrafts + companies - 1, companies - 1).
+     */
+    static vector<FleetComposition> EnumerateCompositions(uint32_t uiAircrafts);
+
+    /**
+     * @brief Mark the results not dominated by another one, which has at least
+     *        as many passenger miles and as few faults, being better in one.
+     *
+     * @param oResults      The results.
+     */
+    static void MarkParetoFront(vector<CompositionResult>& oResults);
+
+private:
+    /**
+     * @brief Run a composition for a seed in the calling thread, or find its
+     *        result in the cache.
+     *
+     * @param koAircrafts   The composition.
+     * @param uiSeed        The seed.
+     *
+     * @return The statistics summed over the runs of the seed.
+     */
+    SeedResult RunSeed(const FleetComposition& koAircrafts, uint32_t uiSeed) const;
+
+    /********** Variables **********/
+
+    uint32_t muiAircrafts;              // The number of aircrafts of every fleet.
+    uint32_t muiChargers;               // The number of chargers.
+    uint16_t muiHours;                  // The simulation time in hours.
+    float mfSitePowerCap;               // The site power cap in kW, 0 for unlimited.
+    FaultSampling moFaultSampling;      // The variance reduction of the fault draws.
+    ResultCache* mpoCache;              // The cache of the results, nullptr for none.
+    vector<CompositionResult> moResults; // The results per composition.
+};
+
+#endif // _COMPOSITION_SWEEP_H_
@@ -0,0 +1,263 @@
+/**
+ * @brief Implementation of the ReplicationController class.
+ *
+ */
+
+#include "ReplicationController.h"
+#include "worlds/SimpleWorld/World.h"
+#include "utils/TextWriter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+// Copy the fleet, chargers and hours of a scenario into another one with its own seed.
+static void CopyScenario(const Scenario& koScenario, uint32_t uiSeed, Scenario& oCopy)
+{
+    oCopy.SetHours(koScenario.GetHours());
+    oCopy.SetChargersCount(koScenario.GetChargersCount());
+    oCopy.SetSeed(uiSeed);
+
+    // Add the aircrafts in groups of consecutive equal ones.
+    for (uint32_t i = 0; i < koScenario.GetAircraftsCount(); )
+    {
+        const ScenarioAircraft& koAircraft = koScenario.GetAircraft(i);
+        uint32_t uiCount = 1;
+        while (i + uiCount < koScenario.GetAircraftsCount()
+            && koScenario.GetAircraft(i + uiCount).eCompany == koAircraft.eCompany
+            && koScenario.GetAircraft(i + uiCount).fStateOfCharge == koAircraft.fStateOfCharge
+            && koScenario.GetAircraft(i + uiCount).eState == koAircraft.eState)
+        {
+            uiCount++;
+        }
+
+        oCopy.AddAircrafts(koAircraft.eCompany, uiCount, koAircraft.fStateOfCharge, koAircraft.eState);
+        i += uiCount;
+    }
+}
+
+ReplicationController::ReplicationController(const Scenario& koScenario, float fSitePowerCap)
+    : mkoScenario(koScenario),
+      mfSitePowerCap(fSitePowerCap),
+      mpoCache(nullptr),
+      muiBatchSize(kuiDefaultBatchSize),
+      muiReplications(0),
+      mfCpuSeconds(0),
+      mfElapsedSeconds(0)
+{
+}
+
+void ReplicationController::SetResultCache(ResultCache* poCache)
+{
+    mpoCache = poCache;
+
+    // The fleet can be large, it is hashed once for all the replications.
+    moScenarioKey = CacheKey();
+    moScenarioKey.AddInteger(mkoScenario.GetAircraftsCount());
+    for (uint32_t i = 0; poCache != nullptr && i < mkoScenario.GetAircraftsCount(); i++)
+    {
+        const ScenarioAircraft& koAircraft = mkoScenario.GetAircraft(i);
+        moScenarioKey.AddInteger(static_cast<uint64_t>(koAircraft.eCompany)).AddFloat(koAircraft.fStateOfCharge)
+            .AddInteger(static_cast<uint64_t>(koAircraft.eState));
+    }
+}
+
+void ReplicationController::AddTarget(string_view sMetric, AircraftCompany eCompany, float fRelativeHalfWidth)
+{
+    const StatisticsMetric* poMetric = StatisticsWriter::FindMetric(sMetric);
+    if (poMetric == nullptr)
+    {
+        throw std::runtime_error("Unknown metric " + string(sMetric) + ".");
+    }
+
+    // Only the counters add up for all the companies, the averages or capacities do not.
+    if (eCompany > AircraftCompany::TotalCompanies || (eCompany == AircraftCompany::TotalCompanies && !poMetric->bCounter))
+    {
+        throw std::runtime_error("The metric " + string(sMetric) + " is not a total of all the companies.");
+    }
+
+    if (!(fRelativeHalfWidth > 0))
+    {
+        throw std::runtime_error("The half-width of the confidence interval must be positive.");
+    }
+
+    moTargets.push_back(PrecisionTarget{ poMetric, eCompany, fRelativeHalfWidth, RunningStatistics() });
+}
+
+bool ReplicationController::Run(uint32_t uiMaxReplications, uint32_t uiFirstSeed, uint32_t uiThreads)
+{
+    if (uiThreads == 0)
+    {
+        uiThreads = max(1u, thread::hardware_concurrency());
+    }
+
+    chrono::steady_clock::time_point oStart = chrono::steady_clock::now();
+    vector<double> afValues;
+    vector<double> afSeconds;
+    while (muiReplications < uiMaxReplications && !AreTargetsMet())
+    {
+        // Run a batch, each thread takes the next replication not run yet, the first error stops them.
+        const uint32_t kuiBatch = min(muiBatchSize, uiMaxReplications - muiReplications);
+        afValues.assign(static_cast<size_t>(kuiBatch) * moTargets.size(), 0);
+        afSeconds.assign(kuiBatch, 0);
+
+        atomic<uint32_t> uiNextReplication(0);
+        atomic<bool> bFailed(false);
+        exception_ptr poError;
+        auto Worker = [&]()
+        {
+            // The fault sampling of the thread is restored once it finishes.
+            const FaultSampling koPreviousSampling = AircraftType::GetFaultSampling();
+            try
+            {
+                for (uint32_t i = uiNextReplication++; i < kuiBatch && !bFailed; i = uiNextReplication++)
+                {
+                    chrono::steady_clock::time_point oRunStart = chrono::steady_clock::now();
+                    RunReplication(uiFirstSeed + muiReplications + i, &afValues[i * moTargets.size()]);
+                    afSeconds[i] = chrono::duration<double>(chrono::steady_clock::now() - oRunStart).count();
+                }
+            }
+            catch (...)
+            {
+                if (!bFailed.exchange(true))
+                {
+                    poError = current_exception();
+                }
+            }
+            AircraftType::SetFaultSampling(koPreviousSampling);
+        };
+
+        // The calling thread is one of the workers.
+        vector<thread> oThreads;
+        oThreads.reserve(min(uiThreads, kuiBatch) - 1);
+        for (uint32_t i = 1; i < min(uiThreads, kuiBatch); i++)
+        {
+            oThreads.emplace_back(Worker);
+        }
+        Worker();
+        for (thread& oThread : oThreads)
+        {
+            oThread.join();
+        }
+
+        if (poError)
+        {
+            rethrow_exception(poError);
+        }
+
+        // Add the replications to the estimates in the order of their seeds.
+        for (uint32_t i = 0; i < kuiBatch; i++)
+        {
+            for (size_t t = 0; t < moTargets.size(); t++)
+            {
+                moTargets[t].oStatistics.Add(afValues[i * moTargets.size() + t]);
+            }
+            mfCpuSeconds += afSeconds[i];
+        }
+        muiReplications += kuiBatch;
+    }
+
+    mfElapsedSeconds += chrono::duration<double>(chrono::steady_clock::now() - oStart).count();
+    return AreTargetsMet();
+}
+
+bool ReplicationController::AreTargetsMet() const
+{
+    if (muiReplications < kuiMinReplications)
+    {
+        return false;
+    }
+
+    return all_of(moTargets.begin(), moTargets.end(), [](const PrecisionTarget& koTarget) { return koTarget.IsMet(); });
+}
+
+void ReplicationController::RunReplication(uint32_t uiSeed, double* pfValues) const
+{
+    // The key of everything the values depend on, with the engine and the specifications.
+    CacheKey oKey;
+    vector<double> afCached;
+    if (mpoCache != nullptr)
+    {
+        oKey = ResultCache::CreateKey("replication");
+        oKey.AddInteger(moScenarioKey.GetHigh()).AddInteger(moScenarioKey.GetLow()).AddInteger(mkoScenario.GetChargersCount())
+            .AddInteger(mkoScenario.GetHours()).AddFloat(mfSitePowerCap).AddInteger(uiSeed)
+            .AddInteger(moFaultSampling.bCommonRandomNumbers).AddInteger(moFaultSampling.bAntithetic)
+            .AddFloat(moFaultSampling.fImportanceFactor);
+        for (const PrecisionTarget& koTarget : moTargets)
+        {
+            oKey.AddText(koTarget.poMetric->pcName).AddInteger(static_cast<uint64_t>(koTarget.eCompany));
+        }
+        if (mpoCache->Find(oKey, afCached) && afCached.size() == moTargets.size())
+        {
+            copy(afCached.begin(), afCached.end(), pfValues);
+            return;
+        }
+    }
+
+    // The antithetic draws run the seed as a pair.
+    const uint32_t kuiRuns = moFaultSampling.bAntithetic ? 2 : 1;
+    FaultSampling oSampling = moFaultSampling;
+    fill(pfValues, pfValues + moTargets.size(), 0.0);
+
+    for (uint32_t uiRun = 0; uiRun < kuiRuns; uiRun++)
+    {
+        oSampling.bAntithetic = uiRun == 1;
+        AircraftType::SetFaultSampling(oSampling);
+
+        // Run the world with the statistics of this thread from zero.
+        Scenario oScenario;
+        CopyScenario(mkoScenario, uiSeed, oScenario);
+        AircraftType::ResetStatistics();
+        SimpleWorld::QuietWorld oWorld(oScenario, mfSitePowerCap);
+        oWorld.RunSimulation(oScenario.GetHours());
+
+        // The value of a company, or the total of all of them.
+        for (size_t t = 0; t < moTargets.size(); t++)
+        {
+            const PrecisionTarget& koTarget = moTargets[t];
+            for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+            {
+                if (koTarget.eCompany == AircraftCompany::TotalCompanies || koTarget.eCompany == static_cast<AircraftCompany>(i))
+                {
+                    pfValues[t] += koTarget.poMetric->pfGetValue(*AircraftType::GetAircraftType(static_cast<AircraftCompany>(i))) / kuiRuns;
+                }
+            }
+        }
+    }
+
+    if (mpoCache != nullptr)
+    {
+        mpoCache->Insert(oKey, vector<double>(pfValues, pfValues + moTargets.size()));
+    }
+}
+
+void ReplicationController::WriteReport(ostream& oStream) const
+{
+    TextWriter oOutput(oStream);
+
+    oOutput << "metric,company,replications,mean,half_width,relative_half_width,target,met,cpu_seconds,elapsed_seconds" << endl;
+    for (const PrecisionTarget& koTarget : moTargets)
+    {
+        const RunningStatistics& koStatistics = koTarget.oStatistics;
+        double fRelativeHalfWidth = koStatistics.GetMean() != 0 ? koStatistics.GetHalfWidth() / abs(koStatistics.GetMean()) : 0;
+
+        oOutput << koTarget.poMetric->pcName << ',';
+        if (koTarget.eCompany == AircraftCompany::TotalCompanies)
+        {
+            oOutput << "all";
+        }
+        else
+        {
+            oOutput << AircraftType::GetAircraftType(koTarget.eCompany)->CompanyName();
+        }
+        oOutput << ',' << muiReplications << ',' << TextWriter::Shortest(static_cast<float>(koStatistics.GetMean()))
+            << ',' << TextWriter::Shortest(static_cast<float>(koStatistics.GetHalfWidth()))
+            << ',' << TextWriter::Shortest(static_cast<float>(fRelativeHalfWidth))
+            << ',' << TextWriter::Shortest(koTarget.fRelativeHalfWidth) << ',' << (koTarget.IsMet() ? 1 : 0)
+            << ',' << TextWriter::Fixed(mfCpuSeconds, 3) << ',' << TextWriter::Fixed(mfElapsedSeconds, 3) << '\n';
+    }
+    oOutput << flush;
+}
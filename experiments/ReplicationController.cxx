@@ -0,0 +1,79 @@
+/**
+ * @brief Contains tests for the ReplicationController class.
+ *
+*/
+
+#include "ReplicationController.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <string>
+
+// The scenario of the tests, a small fleet.
+static unique_ptr<Scenario> CreateScenario()
+{
+    unique_ptr<Scenario> poScenario = make_unique<Scenario>();
+    poScenario->SetHours(2);
+    poScenario->SetChargersCount(2);
+    poScenario->AddAircrafts(AircraftCompany::Alpha, 3, 1.0f, AircraftState::Idle);
+    poScenario->AddAircrafts(AircraftCompany::Delta, 3, 1.0f, AircraftState::Idle);
+    poScenario->AddAircrafts(AircraftCompany::Echo, 2, 0.5f, AircraftState::Queued);
+    return poScenario;
+}
+
+// Test the ReplicationController::AddTarget() method.
+// Check the unknown metrics, the averages of all the companies and the invalid half-widths are rejected.
+TEST_CASE( "ReplicationController::AddTarget" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+    ReplicationController oController(*poScenario);
+    oController.AddTarget("passenger_miles", AircraftCompany::Alpha, 0.01f);
+    oController.AddTarget("faults", AircraftCompany::TotalCompanies, 0.1f);
+    REQUIRE(oController.GetTargets().size() == 2);
+
+    REQUIRE_THROWS(oController.AddTarget("wind", AircraftCompany::Alpha, 0.01f));
+    REQUIRE_THROWS(oController.AddTarget("average_flight_time_hours", AircraftCompany::TotalCompanies, 0.01f));
+    REQUIRE_THROWS(oController.AddTarget("faults", AircraftCompany::Alpha, 0.0f));
+}
+
+// Test the ReplicationController::Run() method.
+// Check it stops once the targets are met, and the estimates do not depend on the number of threads.
+TEST_CASE( "ReplicationController::Run" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+
+    // The flights do not depend on the seed, their interval is met after the first check.
+    ReplicationController oSerial(*poScenario);
+    oSerial.SetBatchSize(3);
+    oSerial.AddTarget("flights", AircraftCompany::TotalCompanies, 0.01f);
+    oSerial.AddTarget("faults", AircraftCompany::TotalCompanies, 0.5f);
+    REQUIRE(oSerial.Run(300, 42, 1));
+    REQUIRE(oSerial.GetReplications() >= ReplicationController::kuiMinReplications);
+    REQUIRE(oSerial.GetReplications() % 3 == 0);
+    REQUIRE(oSerial.GetTargets()[0].oStatistics.GetVariance() == 0);
+    REQUIRE(oSerial.GetTargets()[1].oStatistics.GetHalfWidth() <= 0.5 * oSerial.GetTargets()[1].oStatistics.GetMean());
+    REQUIRE(oSerial.GetCpuSeconds() > 0);
+
+    ReplicationController oParallel(*poScenario);
+    oParallel.SetBatchSize(3);
+    oParallel.AddTarget("flights", AircraftCompany::TotalCompanies, 0.01f);
+    oParallel.AddTarget("faults", AircraftCompany::TotalCompanies, 0.5f);
+    REQUIRE(oParallel.Run(300, 42, 4));
+    REQUIRE(oParallel.GetReplications() == oSerial.GetReplications());
+    REQUIRE(oParallel.GetTargets()[1].oStatistics.GetMean() == oSerial.GetTargets()[1].oStatistics.GetMean());
+
+    // A target too narrow stops at the most replications.
+    ReplicationController oLimited(*poScenario);
+    oLimited.AddTarget("faults", AircraftCompany::Alpha, 1e-6f);
+    REQUIRE_FALSE(oLimited.Run(10, 42, 2));
+    REQUIRE(oLimited.GetReplications() == 10);
+
+    // The report has a header and a row per target.
+    ostringstream oStream;
+    oSerial.WriteReport(oStream);
+    string sReport = oStream.str();
+    REQUIRE(sReport.rfind("metric,company,replications,mean,half_width,relative_half_width,target,met,", 0) == 0);
+    REQUIRE(sReport.find("\nflights,all,") != string::npos);
+    REQUIRE(sReport.find("\nfaults,all,") != string::npos);
+}
@@ -0,0 +1,196 @@
+#ifndef _REPLICATION_CONTROLLER_H_
+#define _REPLICATION_CONTROLLER_H_
+
+#include "aircrafts/AircraftType.h"
+#include "ResultCache.h"
+#include "utils/RunningStatistics.h"
+#include "worlds/Scenario.h"
+#include "worlds/StatisticsWriter.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief A statistic to estimate with a precision, and its estimate.
+ *
+ */
+struct PrecisionTarget
+{
+    const StatisticsMetric* poMetric;   ///< The metric.
+    AircraftCompany eCompany;           ///< The company, or TotalCompanies for all of them.
+    float fRelativeHalfWidth;           ///< The half-width of the 95% confidence interval relative to the mean.
+    RunningStatistics oStatistics;      ///< The values of the replications.
+
+    /**
+     * @brief Check if the confidence interval is narrow enough.
+     *
+     * @return If the target is met, never with a mean of 0, as for rare faults
+     *         not sampled yet.
+     */
+    inline bool IsMet() const
+    {
+        return oStatistics.GetMean() != 0 && oStatistics.GetHalfWidth() <= fRelativeHalfWidth * abs(oStatistics.GetMean());
+    }
+};
+
+/**
+ * @brief Runs replications of a scenario, each with another seed, until the
+ *        confidence intervals of the targeted statistics are as narrow as
+ *        asked (sequential stopping).
+ *
+ * @note  The replications run in batches on a pool of threads, and are added
+ *        to the estimates in the order of their seeds once the batch is done,
+ *        so the estimates and the stopping point do not depend on the number
+ *        of threads. The targets are checked after every batch, and only
+ *        once there are kuiMinReplications, which keeps the stopping from
+ *        trusting the variance of the first few values.
+ *
+ */
+class ReplicationController
+{
+public:
+    /********** Constants **********/
+
+    static constexpr uint32_t kuiMinReplications = 5;   ///< The replications before checking the targets.
+    static constexpr uint32_t kuiDefaultBatchSize = 8;  ///< The replications run between the checks by default.
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Replication Controller object without targets.
+     *
+     * @param koScenario        The fleet, chargers and hours of every replication,
+     *                          which must outlive the controller. Its seed is not used.
+     * @param fSitePowerCap     The power cap in kW shared by all the chargers,
+     *                          0 for unlimited.
+     */
+    ReplicationController(const Scenario& koScenario, float fSitePowerCap = 0);
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the targets, with their estimates.
+     *
+     * @return The targets, in the order they were added.
+     */
+    inline const vector<PrecisionTarget>& GetTargets() const { return moTargets; }
+
+    /**
+     * @brief Get the number of replications run.
+     *
+     * @return The replications, a pair of runs each with antithetic draws.
+     */
+    inline uint32_t GetReplications() const { return muiReplications; }
+
+    /**
+     * @brief Get the CPU time spent, the time of every run added.
+     *
+     * @return The CPU time in seconds.
+     */
+    inline double GetCpuSeconds() const { return mfCpuSeconds; }
+
+    /**
+     * @brief Get the elapsed time of the replications.
+     *
+     * @return The elapsed time in seconds.
+     */
+    inline double GetElapsedSeconds() const { return mfElapsedSeconds; }
+
+    /**
+     * @brief Set the number of replications run between the checks of the targets.
+     *
+     * @param uiBatchSize   The batch size, at least 1.
+     */
+    inline void SetBatchSize(uint32_t uiBatchSize) { muiBatchSize = uiBatchSize > 0 ? uiBatchSize : 1; }
+
+    /**
+     * @brief Set the variance reduction of the fault draws. With antithetic
+     *        draws every replication is the mean of a pair of runs with the
+     *        same seed, with u and 1 - u.
+     *
+     * @param koSampling    The fault sampling options, none by default.
+     */
+    inline void SetFaultSampling(const FaultSampling& koSampling) { moFaultSampling = koSampling; }
+
+    /**
+     * @brief Set the cache of the results, the replications found in it are
+     *        not run again.
+     *
+     * @param poCache   The cache, which must outlive the runs, nullptr for none.
+     */
+    void SetResultCache(ResultCache* poCache);
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Add a statistic to estimate.
+     *
+     * @param sMetric               The metric name, as the statistics writers name it.
+     * @param eCompany              The company, or TotalCompanies for the sum of all of them.
+     * @param fRelativeHalfWidth    The half-width of the 95% confidence interval relative
+     *                              to the mean, as 0.01 for a 1%.
+     *
+     * @throw std::runtime_error if the metric is unknown, cannot be added up for all the
+     *        companies, or the half-width is not positive.
+     */
+    void AddTarget(string_view sMetric, AircraftCompany eCompany, float fRelativeHalfWidth);
+
+    /**
+     * @brief Run replications until all the targets are met.
+     *
+     * @param uiMaxReplications     The most replications to run, counting the previous calls.
+     * @param uiFirstSeed           The seed of the first replication, the next ones are
+     *                              consecutive, none can be 0.
+     * @param uiThreads             The number of threads, 0 for one per hardware thread.
+     *
+     * @return If all the targets are met.
+     *
+     * @throw std::runtime_error if a world fails, once all the threads finished.
+     */
+    bool Run(uint32_t uiMaxReplications, uint32_t uiFirstSeed, uint32_t uiThreads = 0);
+
+    /**
+     * @brief Check if all the targets are met.
+     *
+     * @return If there are enough replications and every target is met.
+     */
+    bool AreTargetsMet() const;
+
+    /**
+     * @brief Write the replications, the time spent and the precision
+     *        achieved per target as CSV with a header line.
+     *
+     * @param oStream   The output stream.
+     */
+    void WriteReport(ostream& oStream) const;
+
+private:
+    /**
+     * @brief Run a replication in the calling thread, or find its result in the cache.
+     *
+     * @param uiSeed    The seed of the replication.
+     * @param pfValues  Gets the value of every target.
+     */
+    void RunReplication(uint32_t uiSeed, double* pfValues) const;
+
+    /********** Variables **********/
+
+    const Scenario& mkoScenario;        // The fleet, chargers and hours.
+    float mfSitePowerCap;               // The site power cap in kW, 0 for unlimited.
+    FaultSampling moFaultSampling;      // The variance reduction of the fault draws.
+    ResultCache* mpoCache;              // The cache of the results, nullptr for none.
+    CacheKey moScenarioKey;             // The key of the fleet, hashed once for the cache.
+    uint32_t muiBatchSize;              // The replications between the checks.
+    vector<PrecisionTarget> moTargets;  // The statistics to estimate.
+    uint32_t muiReplications;           // The replications run.
+    double mfCpuSeconds;                // The time of every run added.
+    double mfElapsedSeconds;            // The elapsed time of the replications.
+};
+
+#endif // _REPLICATION_CONTROLLER_H_
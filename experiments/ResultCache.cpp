@@ -0,0 +1,419 @@
+/**
+ * @brief Implementation of the CacheKey and ResultCache classes.
+ *
+ */
+
+#include "ResultCache.h"
+#include "aircrafts/AircraftType.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+// The hash of the engine sources, generated by the build.
+#if __has_include("EngineId.h")
+#include "EngineId.h"
+#else
+#define EVTOL_ENGINE_ID "built " __DATE__ " " __TIME__
+#endif
+
+// The magic and the version of the log and the index files.
+static const char kacLogMagic[4] = { 'E', 'V', 'R', 'L' };
+static const char kacIndexMagic[4] = { 'E', 'V', 'R', 'I' };
+static const uint16_t kuiVersion = 1;
+
+// The header of the log, followed by the records.
+struct LogHeader
+{
+    char acMagic[4];
+    uint16_t uiVersion;
+    uint16_t uiReserved;
+};
+
+// The header of a result in the log, followed by its values.
+struct LogRecord
+{
+    uint64_t uiKeyHigh;
+    uint64_t uiKeyLow;
+    uint32_t uiValues;
+    uint32_t uiReserved;
+};
+
+// The header of the index, followed by the slots.
+struct IndexHeader
+{
+    char acMagic[4];
+    uint16_t uiVersion;
+    uint16_t uiReserved;
+    uint64_t uiLogSize;     // The bytes of the log indexed.
+    uint64_t uiResults;     // The results indexed.
+    uint64_t uiCapacity;    // The slots, a power of two.
+};
+
+// A slot of the index, empty with an offset of 0, which is the log header.
+struct IndexSlot
+{
+    uint64_t uiKeyHigh;
+    uint64_t uiKeyLow;
+    uint64_t uiOffset;      // The offset of the result in the log.
+};
+
+// Mix the bits of a value, the SplitMix64 finalizer.
+static inline uint64_t Mix(uint64_t uiValue)
+{
+    uiValue ^= uiValue >> 30;
+    uiValue *= 0xBF58476D1CE4E5B9ull;
+    uiValue ^= uiValue >> 27;
+    uiValue *= 0x94D049BB133111EBull;
+    uiValue ^= uiValue >> 31;
+    return uiValue;
+}
+
+// Read the record at an offset of the log, false if it is cut.
+static bool ReadRecord(const char* pcLog, size_t uiLogSize, size_t uiOffset, LogRecord& oRecord)
+{
+    if (uiLogSize - uiOffset < sizeof(LogRecord))
+    {
+        return false;
+    }
+    memcpy(&oRecord, pcLog + uiOffset, sizeof(oRecord));
+    return (uiLogSize - uiOffset - sizeof(LogRecord)) / sizeof(double) >= oRecord.uiValues;
+}
+
+// Read the values of the record at an offset of the log.
+static void ReadValues(const char* pcLog, size_t uiOffset, const LogRecord& koRecord, vector<double>& afValues)
+{
+    afValues.resize(koRecord.uiValues);
+    memcpy(afValues.data(), pcLog + uiOffset + sizeof(LogRecord), koRecord.uiValues * sizeof(double));
+}
+
+CacheKey::CacheKey()
+    : muiHigh(0x243F6A8885A308D3ull),
+      muiLow(0x13198A2E03707344ull)
+{
+}
+
+CacheKey& CacheKey::AddInteger(uint64_t uiValue)
+{
+    // Two lanes mixed differently, so a collision of one is not one of the other.
+    muiHigh = Mix(muiHigh ^ uiValue);
+    muiLow = Mix(muiLow + uiValue * 0x9E3779B97F4A7C15ull + 1);
+    return *this;
+}
+
+CacheKey& CacheKey::AddFloat(double fValue)
+{
+    uint64_t uiBits;
+    memcpy(&uiBits, &fValue, sizeof(uiBits));
+    return AddInteger(uiBits);
+}
+
+CacheKey& CacheKey::AddText(string_view sValue)
+{
+    // The length first, so the texts added one after the other are not ambiguous.
+    AddInteger(sValue.size());
+    for (size_t i = 0; i < sValue.size(); i += sizeof(uint64_t))
+    {
+        uint64_t uiWord = 0;
+        memcpy(&uiWord, sValue.data() + i, min(sizeof(uint64_t), sValue.size() - i));
+        AddInteger(uiWord);
+    }
+    return *this;
+}
+
+ResultCache::ResultCache(const string& sDirectory)
+    : msLogPath((filesystem::path(sDirectory) / "results.log").string()),
+      msIndexPath((filesystem::path(sDirectory) / "results.idx").string()),
+      muiIndexedCount(0),
+      mbAppended(false),
+      muiHits(0),
+      muiMisses(0)
+{
+    error_code oError;
+    filesystem::create_directories(sDirectory, oError);
+    if (oError)
+    {
+        throw std::runtime_error("Cannot create the cache directory " + sDirectory + ".");
+    }
+
+    // Start the log with its header.
+    if (!filesystem::exists(msLogPath) || filesystem::file_size(msLogPath) == 0)
+    {
+        ofstream oLog(msLogPath, ios::binary | ios::trunc);
+        LogHeader oHeader{ {}, kuiVersion, 0 };
+        memcpy(oHeader.acMagic, kacLogMagic, sizeof(kacLogMagic));
+        if (!oLog.write(reinterpret_cast<const char*>(&oHeader), sizeof(oHeader)))
+        {
+            throw std::runtime_error("Cannot write the cache log " + msLogPath + ".");
+        }
+    }
+
+    mpoLog = make_unique<MappedFile>(msLogPath);
+    LogHeader oLogHeader;
+    if (mpoLog->GetSize() < sizeof(oLogHeader))
+    {
+        throw std::runtime_error("The cache log " + msLogPath + " is truncated.");
+    }
+    memcpy(&oLogHeader, mpoLog->GetData(), sizeof(oLogHeader));
+    if (memcmp(oLogHeader.acMagic, kacLogMagic, sizeof(kacLogMagic)) != 0 || oLogHeader.uiVersion != kuiVersion)
+    {
+        throw std::runtime_error("The cache log " + msLogPath + " has an unsupported format.");
+    }
+
+    // Use the index if it matches the log, a stale or broken one is rewritten on closing.
+    size_t uiOffset = sizeof(LogHeader);
+    if (filesystem::exists(msIndexPath))
+    {
+        mpoIndex = make_unique<MappedFile>(msIndexPath);
+        IndexHeader oIndexHeader;
+        bool bValid = mpoIndex->GetSize() >= sizeof(oIndexHeader);
+        if (bValid)
+        {
+            memcpy(&oIndexHeader, mpoIndex->GetData(), sizeof(oIndexHeader));
+            bValid = memcmp(oIndexHeader.acMagic, kacIndexMagic, sizeof(kacIndexMagic)) == 0 && oIndexHeader.uiVersion == kuiVersion
+                && oIndexHeader.uiLogSize >= sizeof(LogHeader) && oIndexHeader.uiLogSize <= mpoLog->GetSize()
+                && oIndexHeader.uiCapacity > 0 && (oIndexHeader.uiCapacity & (oIndexHeader.uiCapacity - 1)) == 0
+                && mpoIndex->GetSize() == sizeof(oIndexHeader) + oIndexHeader.uiCapacity * sizeof(IndexSlot);
+        }
+        if (bValid)
+        {
+            uiOffset = static_cast<size_t>(oIndexHeader.uiLogSize);
+            muiIndexedCount = static_cast<size_t>(oIndexHeader.uiResults);
+        }
+        else
+        {
+            mpoIndex.reset();
+            mbAppended = true;
+        }
+    }
+    else if (mpoLog->GetSize() > sizeof(LogHeader))
+    {
+        mbAppended = true;
+    }
+
+    // Read the results not indexed, up to the first one cut.
+    LogRecord oRecord;
+    vector<double> afValues;
+    while (ReadRecord(mpoLog->GetData(), mpoLog->GetSize(), uiOffset, oRecord))
+    {
+        ReadValues(mpoLog->GetData(), uiOffset, oRecord, afValues);
+        moRecent.emplace(CacheKey(oRecord.uiKeyHigh, oRecord.uiKeyLow), afValues);
+        uiOffset += sizeof(LogRecord) + oRecord.uiValues * sizeof(double);
+        mbAppended = true;
+    }
+
+    // Drop the result cut at the end, so the next ones are appended after the last whole one.
+    if (uiOffset < mpoLog->GetSize())
+    {
+        mpoLog.reset();
+        filesystem::resize_file(msLogPath, uiOffset, oError);
+        if (oError)
+        {
+            throw std::runtime_error("Cannot truncate the cache log " + msLogPath + ".");
+        }
+        mpoLog = make_unique<MappedFile>(msLogPath);
+    }
+
+    moLogOutput.open(msLogPath, ios::binary | ios::app);
+    if (!moLogOutput)
+    {
+        throw std::runtime_error("Cannot open the cache log " + msLogPath + ".");
+    }
+}
+
+ResultCache::~ResultCache()
+{
+    // The index is only an accelerator, the log has all the results if it cannot be written.
+    if (mbAppended)
+    {
+        try
+        {
+            WriteIndex();
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+size_t ResultCache::GetResultsCount() const
+{
+    lock_guard<mutex> oLock(moMutex);
+    return muiIndexedCount + moRecent.size();
+}
+
+uint64_t ResultCache::GetHitsCount() const
+{
+    lock_guard<mutex> oLock(moMutex);
+    return muiHits;
+}
+
+uint64_t ResultCache::GetMissesCount() const
+{
+    lock_guard<mutex> oLock(moMutex);
+    return muiMisses;
+}
+
+/*static*/ const char* ResultCache::GetEngineId()
+{
+    return EVTOL_ENGINE_ID;
+}
+
+/*static*/ CacheKey ResultCache::CreateKey(string_view sKind)
+{
+    CacheKey oKey;
+    oKey.AddText(GetEngineId()).AddText(sKind);
+
+    // The specifications of the types, with the charge curve the runs of every thread use sampled.
+    const uint32_t kuiCurvePoints = 32;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+    {
+        const AircraftType* poAircraftType = AircraftType::GetAircraftType(static_cast<AircraftCompany>(i));
+        oKey.AddInteger(poAircraftType->GetCruiseSpeed()).AddInteger(poAircraftType->GetBatteryCapacity())
+            .AddFloat(poAircraftType->GetTimeToCharge()).AddFloat(poAircraftType->GetEnergyUse())
+            .AddInteger(poAircraftType->GetPassengers()).AddFloat(poAircraftType->GetFaultProbability());
+
+        const BatteryModel& koBatteryModel = poAircraftType->GetBatteryModel();
+        oKey.AddFloat(koBatteryModel.GetDerating());
+        for (uint32_t j = 0; j <= kuiCurvePoints; j++)
+        {
+            oKey.AddFloat(koBatteryModel.GetTimeToCharge(0, static_cast<float>(j) / kuiCurvePoints));
+        }
+    }
+
+    return oKey;
+}
+
+bool ResultCache::Find(const CacheKey& koKey, vector<double>& afValues)
+{
+    lock_guard<mutex> oLock(moMutex);
+    auto oRecent = moRecent.find(koKey);
+    bool bFound = oRecent != moRecent.end();
+    if (bFound)
+    {
+        afValues = oRecent->second;
+    }
+    else
+    {
+        bFound = FindIndexed(koKey, afValues);
+    }
+
+    (bFound ? muiHits : muiMisses)++;
+    return bFound;
+}
+
+void ResultCache::Insert(const CacheKey& koKey, const vector<double>& kafValues)
+{
+    lock_guard<mutex> oLock(moMutex);
+    vector<double> afIndexed;
+    if (moRecent.count(koKey) > 0 || FindIndexed(koKey, afIndexed))
+    {
+        return;
+    }
+
+    // Write the whole result at once, a crash can only cut the last one.
+    LogRecord oRecord{ koKey.GetHigh(), koKey.GetLow(), static_cast<uint32_t>(kafValues.size()), 0 };
+    string sRecord(sizeof(oRecord) + kafValues.size() * sizeof(double), '\0');
+    memcpy(&sRecord[0], &oRecord, sizeof(oRecord));
+    memcpy(&sRecord[sizeof(oRecord)], kafValues.data(), kafValues.size() * sizeof(double));
+    if (!moLogOutput.write(sRecord.data(), sRecord.size()).flush())
+    {
+        throw std::runtime_error("Cannot write the cache log " + msLogPath + ".");
+    }
+
+    moRecent.emplace(koKey, kafValues);
+    mbAppended = true;
+}
+
+bool ResultCache::FindIndexed(const CacheKey& koKey, vector<double>& afValues) const
+{
+    if (!mpoIndex)
+    {
+        return false;
+    }
+
+    // Probe the slots from the one of the key until the key or an empty slot.
+    IndexHeader oHeader;
+    memcpy(&oHeader, mpoIndex->GetData(), sizeof(oHeader));
+    const char* pcSlots = mpoIndex->GetData() + sizeof(oHeader);
+    const uint64_t kuiMask = oHeader.uiCapacity - 1;
+    for (uint64_t i = koKey.GetLow() & kuiMask, uiProbes = 0; uiProbes < oHeader.uiCapacity; i = (i + 1) & kuiMask, uiProbes++)
+    {
+        IndexSlot oSlot;
+        memcpy(&oSlot, pcSlots + i * sizeof(IndexSlot), sizeof(oSlot));
+        if (oSlot.uiOffset == 0)
+        {
+            return false;
+        }
+
+        LogRecord oRecord;
+        if (oSlot.uiKeyHigh == koKey.GetHigh() && oSlot.uiKeyLow == koKey.GetLow()
+            && ReadRecord(mpoLog->GetData(), mpoLog->GetSize(), static_cast<size_t>(oSlot.uiOffset), oRecord))
+        {
+            ReadValues(mpoLog->GetData(), static_cast<size_t>(oSlot.uiOffset), oRecord, afValues);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ResultCache::WriteIndex()
+{
+    // Map the whole log again, with the results appended since it was opened.
+    moLogOutput.close();
+    mpoIndex.reset();
+    mpoLog = make_unique<MappedFile>(msLogPath);
+
+    vector<IndexSlot> aoRecords;
+    LogRecord oRecord;
+    size_t uiOffset = sizeof(LogHeader);
+    while (ReadRecord(mpoLog->GetData(), mpoLog->GetSize(), uiOffset, oRecord))
+    {
+        aoRecords.push_back(IndexSlot{ oRecord.uiKeyHigh, oRecord.uiKeyLow, uiOffset });
+        uiOffset += sizeof(LogRecord) + oRecord.uiValues * sizeof(double);
+    }
+
+    // At most half of the slots are used, so the probes stay short.
+    uint64_t uiCapacity = 16;
+    while (uiCapacity < 2 * aoRecords.size())
+    {
+        uiCapacity *= 2;
+    }
+    vector<IndexSlot> aoSlots(uiCapacity, IndexSlot{ 0, 0, 0 });
+    uint64_t uiResults = 0;
+    for (const IndexSlot& koRecord : aoRecords)
+    {
+        uint64_t i = koRecord.uiKeyLow & (uiCapacity - 1);
+        while (aoSlots[i].uiOffset != 0 && !(aoSlots[i].uiKeyHigh == koRecord.uiKeyHigh && aoSlots[i].uiKeyLow == koRecord.uiKeyLow))
+        {
+            i = (i + 1) & (uiCapacity - 1);
+        }
+        if (aoSlots[i].uiOffset == 0)
+        {
+            aoSlots[i] = koRecord;
+            uiResults++;
+        }
+    }
+
+    // Write the index aside and replace the previous one, a reader sees either of them whole.
+    const string ksTemporaryPath = msIndexPath + "." + to_string(hash<thread::id>()(this_thread::get_id()) ^
+        static_cast<size_t>(chrono::steady_clock::now().time_since_epoch().count())) + ".tmp";
+    {
+        ofstream oIndex(ksTemporaryPath, ios::binary | ios::trunc);
+        IndexHeader oHeader{ {}, kuiVersion, 0, uiOffset, uiResults, uiCapacity };
+        memcpy(oHeader.acMagic, kacIndexMagic, sizeof(kacIndexMagic));
+        oIndex.write(reinterpret_cast<const char*>(&oHeader), sizeof(oHeader));
+        oIndex.write(reinterpret_cast<const char*>(aoSlots.data()), aoSlots.size() * sizeof(IndexSlot));
+        if (!oIndex.flush())
+        {
+            throw std::runtime_error("Cannot write the cache index " + ksTemporaryPath + ".");
+        }
+    }
+    filesystem::rename(ksTemporaryPath, msIndexPath);
+    mbAppended = false;
+}
@@ -0,0 +1,129 @@
+/**
+ * @brief Contains tests for the CacheKey and ResultCache classes.
+ *
+*/
+
+#include "ResultCache.h"
+#include "CompositionSweep.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+// Test the CacheKey class.
+// Check the keys depend on the values and their order, and the texts on where they end.
+TEST_CASE( "CacheKey" )
+{
+    REQUIRE(CacheKey().AddInteger(1).AddFloat(2.5) == CacheKey().AddInteger(1).AddFloat(2.5));
+    REQUIRE_FALSE(CacheKey().AddInteger(1).AddInteger(2) == CacheKey().AddInteger(2).AddInteger(1));
+    REQUIRE_FALSE(CacheKey().AddFloat(0.1f) == CacheKey().AddFloat(0.1));
+    REQUIRE_FALSE(CacheKey().AddText("ab").AddText("c") == CacheKey().AddText("a").AddText("bc"));
+    REQUIRE_FALSE(CacheKey() == CacheKey().AddInteger(0));
+    REQUIRE(ResultCache::CreateKey("test") == ResultCache::CreateKey("test"));
+    REQUIRE_FALSE(ResultCache::CreateKey("test") == ResultCache::CreateKey("other"));
+}
+
+// Test the ResultCache class.
+// Check the results are found again once reopened, from the index and from the log appended after it, and a cut one is dropped.
+TEST_CASE( "ResultCache" )
+{
+    const filesystem::path koDirectory = filesystem::temp_directory_path() / "evtol_cache";
+    filesystem::remove_all(koDirectory);
+
+    vector<double> afValues;
+    {
+        ResultCache oCache(koDirectory.string());
+        REQUIRE_FALSE(oCache.Find(CacheKey().AddInteger(0), afValues));
+        for (uint64_t i = 0; i < 100; i++)
+        {
+            oCache.Insert(CacheKey().AddInteger(i), { static_cast<double>(i), 0.5 });
+        }
+        oCache.Insert(CacheKey().AddInteger(100), {});
+        oCache.Insert(CacheKey().AddInteger(0), { 7 });
+        REQUIRE(oCache.GetResultsCount() == 101);
+        REQUIRE(oCache.Find(CacheKey().AddInteger(0), afValues));
+        REQUIRE(afValues == vector<double>{ 0, 0.5 });
+        REQUIRE(oCache.GetHitsCount() == 1);
+        REQUIRE(oCache.GetMissesCount() == 1);
+    }
+
+    // Drop a result appended after the index, the stale index is rewritten, then cut the end of the log.
+    const string ksLogPath = (koDirectory / "results.log").string();
+    const uintmax_t kuiIndexedSize = filesystem::file_size(ksLogPath);
+    {
+        ResultCache oCache(koDirectory.string());
+        REQUIRE(oCache.GetResultsCount() == 101);
+        oCache.Insert(CacheKey().AddInteger(101), { 101 });
+    }
+    filesystem::resize_file(ksLogPath, kuiIndexedSize);
+    {
+        ResultCache oCache(koDirectory.string());
+        oCache.Insert(CacheKey().AddInteger(102), { 102 });
+    }
+    {
+        ofstream oLog(ksLogPath, ios::binary | ios::app);
+        oLog << "cut";
+    }
+
+    ResultCache oCache(koDirectory.string());
+    REQUIRE(oCache.GetResultsCount() == 102);
+    for (uint64_t i = 0; i < 100; i++)
+    {
+        REQUIRE(oCache.Find(CacheKey().AddInteger(i), afValues));
+        REQUIRE(afValues == vector<double>{ static_cast<double>(i), 0.5 });
+    }
+    REQUIRE(oCache.Find(CacheKey().AddInteger(100), afValues));
+    REQUIRE(afValues.empty());
+    REQUIRE_FALSE(oCache.Find(CacheKey().AddInteger(101), afValues));
+    REQUIRE(oCache.Find(CacheKey().AddInteger(102), afValues));
+    REQUIRE(afValues == vector<double>{ 102 });
+
+    // The results go after the last whole one.
+    oCache.Insert(CacheKey().AddInteger(103), { 103 });
+    REQUIRE(filesystem::file_size(ksLogPath) == kuiIndexedSize + 2 * (24 + 8));
+}
+
+// Test the CompositionSweep::SetResultCache() method.
+// Check a sweep run again finds all its results, and a change of the specifications runs them again.
+TEST_CASE( "CompositionSweep::SetResultCache" )
+{
+    const filesystem::path koDirectory = filesystem::temp_directory_path() / "evtol_sweep_cache";
+    filesystem::remove_all(koDirectory);
+
+    CompositionSweep oFirst(3, 1, 1);
+    CompositionSweep oSecond(3, 1, 1);
+    {
+        ResultCache oCache(koDirectory.string());
+        oFirst.SetResultCache(&oCache);
+        oFirst.Run(2, 42, 1);
+        REQUIRE(oCache.GetMissesCount() == 70);
+    }
+    {
+        ResultCache oCache(koDirectory.string());
+        oSecond.SetResultCache(&oCache);
+        oSecond.Run(2, 42, 1);
+        REQUIRE(oCache.GetHitsCount() == 70);
+        REQUIRE(oCache.GetMissesCount() == 0);
+    }
+    for (size_t i = 0; i < oFirst.GetResults().size(); i++)
+    {
+        REQUIRE(oSecond.GetResults()[i].fPassengerMiles == oFirst.GetResults()[i].fPassengerMiles);
+        REQUIRE(oSecond.GetResults()[i].fFaults == oFirst.GetResults()[i].fFaults);
+    }
+
+    // A slower charge of a type changes every key.
+    const AircraftType* poAlpha = AircraftType::GetAircraftType(AircraftCompany::Alpha);
+    const BatteryModel koBatteryModel = poAlpha->GetBatteryModel();
+    AircraftType::SetBatteryModel(AircraftCompany::Alpha, BatteryModel(poAlpha->GetTimeToCharge(), 0.8f));
+    {
+        ResultCache oCache(koDirectory.string());
+        oSecond.SetResultCache(&oCache);
+        oSecond.Run(1, 42, 1);
+        REQUIRE(oCache.GetHitsCount() == 0);
+        REQUIRE(oCache.GetResultsCount() == 105);
+    }
+    AircraftType::SetBatteryModel(AircraftCompany::Alpha, koBatteryModel);
+
+    filesystem::remove_all(koDirectory);
+}
@@ -0,0 +1,266 @@
+#ifndef _RESULT_CACHE_H_
+#define _RESULT_CACHE_H_
+
+#include "utils/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The 128-bit hash of the configuration of a run, built by adding its
+ *        values in order.
+ *
+ * @note  Each value goes through two lanes mixed with the SplitMix64
+ *        finalizer, so two configurations get the same key with a
+ *        probability of about 2^-128. It is not a cryptographic hash, the
+ *        cache is not meant to be shared with untrusted writers.
+ *
+ */
+class CacheKey
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Cache Key object without values.
+     *
+     */
+    CacheKey();
+
+    /**
+     * @brief Construct a new Cache Key object from the halves of a key.
+     *
+     * @param uiHigh    The high 64 bits.
+     * @param uiLow     The low 64 bits.
+     */
+    CacheKey(uint64_t uiHigh, uint64_t uiLow) : muiHigh(uiHigh), muiLow(uiLow) {}
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the high half of the key.
+     *
+     * @return The high 64 bits.
+     */
+    inline uint64_t GetHigh() const { return muiHigh; }
+
+    /**
+     * @brief Get the low half of the key.
+     *
+     * @return The low 64 bits.
+     */
+    inline uint64_t GetLow() const { return muiLow; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Add an integer value.
+     *
+     * @param uiValue   The value.
+     *
+     * @return This key.
+     */
+    CacheKey& AddInteger(uint64_t uiValue);
+
+    /**
+     * @brief Add a floating point value, by its bits, a float converts exactly.
+     *
+     * @param fValue    The value.
+     *
+     * @return This key.
+     */
+    CacheKey& AddFloat(double fValue);
+
+    /**
+     * @brief Add a text, with its length.
+     *
+     * @param sValue    The text.
+     *
+     * @return This key.
+     */
+    CacheKey& AddText(string_view sValue);
+
+    /**
+     * @brief Compare two keys.
+     *
+     * @param koOther   The other key.
+     *
+     * @return If the keys are equal.
+     */
+    inline bool operator==(const CacheKey& koOther) const { return muiHigh == koOther.muiHigh && muiLow == koOther.muiLow; }
+
+private:
+    /********** Variables **********/
+
+    uint64_t muiHigh;   // The first lane.
+    uint64_t muiLow;    // The second lane.
+};
+
+/**
+ * @brief A local on-disk cache of the results of the runs, by the key of
+ *        their configuration, so the runs done before return at once and an
+ *        interrupted sweep resumes where it stopped.
+ *
+ * @note  The keys made by CreateKey() start with the build id of the engine,
+ *        a hash of its sources, and the specifications of the aircraft
+ *        types, so changing any of them misses the results of before without
+ *        clearing the cache. The results are appended to a log, the source of
+ *        truth, and found with an open addressing index mapped in memory. The
+ *        index is rewritten from the log when the cache is destroyed, and the
+ *        results appended to the log after it was written, as by a process
+ *        that did not finish, are read into memory when the cache is opened.
+ *        A result cut by a crash at the end of the log is dropped. The cache
+ *        can be used by many threads, but only by one process at a time.
+ *
+ */
+class ResultCache
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Open the cache in a directory, created if it does not exist.
+     *
+     * @param sDirectory    The directory.
+     *
+     * @throw std::runtime_error if the directory cannot be used, or has a
+     *        cache of another format version.
+     */
+    explicit ResultCache(const string& sDirectory);
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+
+    /********** Destructor **********/
+
+    /**
+     * @brief Rewrite the index if results were added, and close the cache.
+     *
+     */
+    ~ResultCache();
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of results in the cache.
+     *
+     * @return The number of results.
+     */
+    size_t GetResultsCount() const;
+
+    /**
+     * @brief Get the number of results found since the cache was opened.
+     *
+     * @return The number of hits.
+     */
+    uint64_t GetHitsCount() const;
+
+    /**
+     * @brief Get the number of results not found since the cache was opened.
+     *
+     * @return The number of misses.
+     */
+    uint64_t GetMissesCount() const;
+
+
+    /********** Static Methods **********/
+
+    /**
+     * @brief Get the build id of the engine.
+     *
+     * @return The hash of the engine sources, or the build time of the cache
+     *         if it was built without it.
+     */
+    static const char* GetEngineId();
+
+    /**
+     * @brief Create a key with the engine build id, a kind of run, and the
+     *        specifications of the aircraft types of the calling thread.
+     *
+     * @param sKind     The kind of run, as the experiment running it.
+     *
+     * @return The key, to add the configuration of the run to.
+     */
+    static CacheKey CreateKey(string_view sKind);
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Find the result of a run.
+     *
+     * @param koKey     The key of the run configuration.
+     * @param afValues  Gets the values of the result if found.
+     *
+     * @return If the result was found.
+     */
+    bool Find(const CacheKey& koKey, vector<double>& afValues);
+
+    /**
+     * @brief Add the result of a run, unless there is one already.
+     *
+     * @param koKey     The key of the run configuration.
+     * @param kafValues The values of the result.
+     *
+     * @throw std::runtime_error if the log cannot be written.
+     */
+    void Insert(const CacheKey& koKey, const vector<double>& kafValues);
+
+private:
+    /********** Types **********/
+
+    // The hash of a key in the memory table, its bits are already mixed.
+    struct KeyHash
+    {
+        size_t operator()(const CacheKey& koKey) const { return static_cast<size_t>(koKey.GetLow()); }
+    };
+
+    /********** Methods **********/
+
+    /**
+     * @brief Find a result in the index mapped in memory.
+     *
+     * @param koKey     The key.
+     * @param afValues  Gets the values of the result if found.
+     *
+     * @return If the result was found.
+     */
+    bool FindIndexed(const CacheKey& koKey, vector<double>& afValues) const;
+
+    /**
+     * @brief Rewrite the index with all the results of the log, and replace
+     *        the previous one at once.
+     *
+     */
+    void WriteIndex();
+
+    /********** Variables **********/
+
+    string msLogPath;                   // The path of the log.
+    string msIndexPath;                 // The path of the index.
+    unique_ptr<MappedFile> mpoLog;      // The log mapped when the cache was opened.
+    unique_ptr<MappedFile> mpoIndex;    // The index mapped when the cache was opened, if valid.
+    size_t muiIndexedCount;             // The results in the index.
+    ofstream moLogOutput;               // The log, to append the results to.
+
+    mutable mutex moMutex;              // Guards the variables below.
+    unordered_map<CacheKey, vector<double>, KeyHash> moRecent; // The results not in the index.
+    bool mbAppended;                    // If results were appended to the log.
+    uint64_t muiHits;                   // The results found.
+    uint64_t muiMisses;                 // The results not found.
+};
+
+#endif // _RESULT_CACHE_H_
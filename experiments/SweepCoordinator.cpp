@@ -0,0 +1,207 @@
+/**
+ * @brief Implementation of the SweepCoordinator class.
+ *
+ */
+
+#include "SweepCoordinator.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+SweepCoordinator::SweepCoordinator(CompositionSweep& oSweep, uint32_t uiSeeds, uint32_t uiFirstSeed, uint32_t uiShardSize)
+    : moSweep(oSweep),
+      muiSeeds(max(1u, uiSeeds)),
+      muiFirstSeed(uiFirstSeed),
+      muiShardsDone(0),
+      muiWorkers(0),
+      muiRetries(0)
+{
+    // The blocks of compositions, each one with every seed.
+    const size_t kuiCompositions = moSweep.GetResults().size();
+    uiShardSize = max(1u, uiShardSize);
+    for (size_t uiBegin = 0; uiBegin < kuiCompositions; uiBegin += uiShardSize)
+    {
+        for (uint32_t k = 0; k < muiSeeds; k++)
+        {
+            moPendingShards.push_back(moShards.size());
+            moShards.push_back(Shard{ uiBegin, min(kuiCompositions, uiBegin + uiShardSize), muiFirstSeed + k, 0 });
+        }
+    }
+    moSeedResults.resize(kuiCompositions * muiSeeds);
+}
+
+uint32_t SweepCoordinator::GetWorkersCount() const
+{
+    lock_guard<mutex> oLock(moMutex);
+    return muiWorkers;
+}
+
+uint32_t SweepCoordinator::GetRetriesCount() const
+{
+    lock_guard<mutex> oLock(moMutex);
+    return muiRetries;
+}
+
+void SweepCoordinator::Listen(const string& sAddress)
+{
+    moListener = Socket::Listen(sAddress);
+}
+
+void SweepCoordinator::Run()
+{
+    if (!moListener.IsOpen())
+    {
+        throw std::runtime_error("The coordinator is not listening for workers.");
+    }
+
+    // Accept the workers until the sweep is over, checking it between the connections.
+    const int kiAcceptTimeout = 100;
+    vector<thread> oThreads;
+    for (;;)
+    {
+        {
+            lock_guard<mutex> oLock(moMutex);
+            if (IsOver())
+            {
+                break;
+            }
+        }
+
+        if (moListener.WaitReadable(kiAcceptTimeout))
+        {
+            Socket oConnection = moListener.Accept();
+            if (oConnection.IsOpen())
+            {
+                {
+                    lock_guard<mutex> oLock(moMutex);
+                    muiWorkers++;
+                }
+                oThreads.emplace_back(&SweepCoordinator::Serve, this, std::move(oConnection));
+            }
+        }
+    }
+
+    // The workers joining now find no one listening, the ones in progress finish their shard.
+    moListener.Close();
+    for (thread& oThread : oThreads)
+    {
+        oThread.join();
+    }
+
+    if (!msError.empty())
+    {
+        throw std::runtime_error(msError);
+    }
+
+    moSweep.SetSeedResults(moSeedResults, muiSeeds);
+}
+
+void SweepCoordinator::Serve(Socket oConnection)
+{
+    // Send the settings of the sweep, the floats with all their digits.
+    const FaultSampling& koSampling = moSweep.GetFaultSampling();
+    ostringstream oSettings;
+    oSettings.precision(numeric_limits<float>::max_digits10);
+    oSettings << "SWEEP " << moSweep.GetAircraftsCount() << ' ' << moSweep.GetChargersCount() << ' ' << moSweep.GetHours()
+        << ' ' << moSweep.GetSitePowerCap() << ' ' << koSampling.bCommonRandomNumbers << ' ' << koSampling.bAntithetic
+        << ' ' << koSampling.fImportanceFactor;
+    if (!oConnection.SendLine(oSettings.str()))
+    {
+        return;
+    }
+
+    // Hand out a shard every time the worker is ready, until it leaves or the sweep is over.
+    string sLine;
+    vector<SeedResult> oResults;
+    bool bConnected = true;
+    while (bConnected && oConnection.ReceiveLine(sLine) && sLine == "READY")
+    {
+        size_t uiShard;
+        {
+            unique_lock<mutex> oLock(moMutex);
+            moShardsChanged.wait(oLock, [this]() { return !moPendingShards.empty() || IsOver(); });
+            if (IsOver())
+            {
+                oConnection.SendLine("DONE");
+                return;
+            }
+            uiShard = moPendingShards.front();
+            moPendingShards.pop_front();
+            moShards[uiShard].uiAttempts++;
+        }
+
+        const Shard& koShard = moShards[uiShard];
+        bool bReceived = false;
+        if (oConnection.SendLine("SHARD " + to_string(uiShard) + ' ' + to_string(koShard.uiBegin) + ' '
+            + to_string(koShard.uiEnd) + ' ' + to_string(koShard.uiSeed)))
+        {
+            bReceived = ReceiveResult(oConnection, uiShard, oResults, bConnected);
+        }
+        else
+        {
+            bConnected = false;
+        }
+
+        // Keep the result, or hand out the shard again.
+        lock_guard<mutex> oLock(moMutex);
+        if (bReceived)
+        {
+            for (size_t i = koShard.uiBegin; i < koShard.uiEnd; i++)
+            {
+                moSeedResults[i * muiSeeds + (koShard.uiSeed - muiFirstSeed)] = oResults[i - koShard.uiBegin];
+            }
+            muiShardsDone++;
+        }
+        else if (koShard.uiAttempts >= kuiMaxAttempts)
+        {
+            msError = "The shard " + to_string(uiShard) + " failed " + to_string(kuiMaxAttempts) + " times.";
+        }
+        else
+        {
+            moPendingShards.push_front(uiShard);
+            muiRetries++;
+        }
+        moShardsChanged.notify_all();
+    }
+}
+
+bool SweepCoordinator::ReceiveResult(Socket& oConnection, size_t uiShard, vector<SeedResult>& oResults, bool& bConnected) const
+{
+    // A shard failed by the worker leaves it ready for another one, a malformed result does not.
+    string sLine;
+    if (!oConnection.ReceiveLine(sLine))
+    {
+        bConnected = false;
+        return false;
+    }
+    istringstream oHeader(sLine);
+    string sKind;
+    size_t uiId = 0;
+    size_t uiCount = 0;
+    oHeader >> sKind >> uiId;
+    if (sKind == "FAILED" && uiId == uiShard)
+    {
+        return false;
+    }
+    const Shard& koShard = moShards[uiShard];
+    if (sKind != "RESULT" || uiId != uiShard || !(oHeader >> uiCount) || uiCount != koShard.uiEnd - koShard.uiBegin)
+    {
+        bConnected = false;
+        return false;
+    }
+
+    oResults.resize(uiCount);
+    for (SeedResult& oResult : oResults)
+    {
+        if (!oConnection.ReceiveLine(sLine) || !(istringstream(sLine) >> oResult.fPassengerMiles >> oResult.fFaults))
+        {
+            bConnected = false;
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,86 @@
+/**
+ * @brief Contains tests for the SweepCoordinator and SweepWorker classes.
+ *
+*/
+
+#include "SweepCoordinator.h"
+#include "SweepWorker.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+// Connect as a worker, take a shard and leave without its result, as a worker that crashed.
+static bool TakeShardAndLeave(const string& ksAddress)
+{
+    Socket oConnection = Socket::Connect(ksAddress);
+    string sLine;
+    return oConnection.ReceiveLine(sLine) && sLine.rfind("SWEEP ", 0) == 0 && oConnection.SendLine("READY")
+        && oConnection.ReceiveLine(sLine) && sLine.rfind("SHARD ", 0) == 0;
+}
+
+// Test the SweepCoordinator::Run() method.
+// Check the workers joining and leaving, and the shard of a lost worker run again, give the results of a single process.
+TEST_CASE( "SweepCoordinator::Run" )
+{
+    const string ksAddress = "unix:" + (filesystem::temp_directory_path() / "evtol_sweep.sock").string();
+    FaultSampling oSampling;
+    oSampling.bAntithetic = true;
+
+    CompositionSweep oLocal(3, 1, 1);
+    oLocal.SetFaultSampling(oSampling);
+    oLocal.Run(2, 42, 2);
+
+    CompositionSweep oSharded(3, 1, 1);
+    oSharded.SetFaultSampling(oSampling);
+    SweepCoordinator oCoordinator(oSharded, 2, 42, 8);
+    REQUIRE(oCoordinator.GetShardsCount() == 10);
+    oCoordinator.Listen(ksAddress);
+    thread oThread(&SweepCoordinator::Run, &oCoordinator);
+
+    // One worker is lost with its shard, another one leaves after two shards, the last one runs the rest.
+    REQUIRE(TakeShardAndLeave(ksAddress));
+    REQUIRE(SweepWorker(ksAddress, 2).Run(2) == 2);
+    REQUIRE(SweepWorker(ksAddress, 2).Run() == 8);
+    oThread.join();
+
+    REQUIRE(oCoordinator.GetWorkersCount() == 3);
+    REQUIRE(oCoordinator.GetRetriesCount() == 1);
+    for (size_t i = 0; i < oLocal.GetResults().size(); i++)
+    {
+        REQUIRE(oSharded.GetResults()[i].fPassengerMiles == oLocal.GetResults()[i].fPassengerMiles);
+        REQUIRE(oSharded.GetResults()[i].fFaults == oLocal.GetResults()[i].fFaults);
+        REQUIRE(oSharded.GetResults()[i].bParetoFront == oLocal.GetResults()[i].bParetoFront);
+    }
+
+    // The socket is removed once the sweep is complete.
+    REQUIRE_FALSE(filesystem::exists(ksAddress.substr(5)));
+}
+
+// Test the SweepCoordinator::Run() method.
+// Check the sweep fails once a shard is lost by as many workers as its attempts.
+TEST_CASE( "SweepCoordinator::Run fails" )
+{
+    const string ksAddress = "unix:" + (filesystem::temp_directory_path() / "evtol_sweep_fails.sock").string();
+    CompositionSweep oSweep(2, 1, 1);
+    SweepCoordinator oCoordinator(oSweep, 1, 42);
+    REQUIRE_THROWS_AS(oCoordinator.Run(), std::runtime_error);
+    oCoordinator.Listen(ksAddress);
+
+    // The sweep has a single shard, every worker takes it once handed out again.
+    REQUIRE(oCoordinator.GetShardsCount() == 1);
+    bool bTaken = true;
+    thread oThread([&ksAddress, &bTaken]()
+    {
+        for (uint32_t i = 0; i < SweepCoordinator::kuiMaxAttempts; i++)
+        {
+            bTaken = TakeShardAndLeave(ksAddress) && bTaken;
+        }
+    });
+    REQUIRE_THROWS_AS(oCoordinator.Run(), std::runtime_error);
+    oThread.join();
+    REQUIRE(bTaken);
+    REQUIRE(oCoordinator.GetRetriesCount() == SweepCoordinator::kuiMaxAttempts - 1);
+}
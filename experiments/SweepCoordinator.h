@@ -0,0 +1,165 @@
+#ifndef _SWEEP_COORDINATOR_H_
+#define _SWEEP_COORDINATOR_H_
+
+#include "CompositionSweep.h"
+#include "utils/Socket.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Hands out the shards of a composition sweep to worker processes over
+ *        a socket, retries the shards of the workers lost, and merges their
+ *        results into the sweep, see SweepWorker.
+ *
+ * @note  A shard is a block of consecutive compositions run with one seed.
+ *        The workers can connect and leave at any time, each one is served
+ *        by its own thread, which gives it the next shard pending every time
+ *        it is ready. A shard whose worker disconnects or fails before
+ *        sending its result goes back to the front of the pending shards, up
+ *        to kuiMaxAttempts times. The results are kept per composition and
+ *        seed, and added in the order of the seeds once all of them are in,
+ *        so the sweep gets the same results as run in a single process.
+ *
+ *        The protocol is made of lines of text:
+ *        - Coordinator: "SWEEP <aircrafts> <chargers> <hours> <site power cap>
+ *          <common random numbers> <antithetic> <importance factor>".
+ *        - Worker: "READY", for every shard it takes.
+ *        - Coordinator: "SHARD <id> <begin> <end> <seed>", or "DONE" once the
+ *          sweep is complete.
+ *        - Worker: "RESULT <id> <count>" and a line "<passenger miles> <faults>"
+ *          per composition, or "FAILED <id> <reason>".
+ *
+ */
+class SweepCoordinator
+{
+public:
+    /********** Constants **********/
+
+    static constexpr uint32_t kuiDefaultShardSize = 16; ///< The compositions per shard by default.
+    static constexpr uint32_t kuiMaxAttempts = 3;       ///< The times a shard is handed out before the sweep fails.
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Sweep Coordinator object with all the shards pending.
+     *
+     * @param oSweep        The sweep to run, which must outlive the coordinator.
+     * @param uiSeeds       The number of seeds, at least 1.
+     * @param uiFirstSeed   The first seed, the next ones are consecutive, none can be 0.
+     * @param uiShardSize   The compositions per shard, at least 1.
+     */
+    SweepCoordinator(CompositionSweep& oSweep, uint32_t uiSeeds, uint32_t uiFirstSeed, uint32_t uiShardSize = kuiDefaultShardSize);
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of shards of the sweep.
+     *
+     * @return The number of shards.
+     */
+    inline size_t GetShardsCount() const { return moShards.size(); }
+
+    /**
+     * @brief Get the number of workers connected during the sweep.
+     *
+     * @return The number of workers.
+     */
+    uint32_t GetWorkersCount() const;
+
+    /**
+     * @brief Get the number of times a shard was handed out again.
+     *
+     * @return The number of retries.
+     */
+    uint32_t GetRetriesCount() const;
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Listen for the workers at an address, before running.
+     *
+     * @param sAddress  The address, see Socket.
+     *
+     * @throw std::runtime_error if the address cannot be used.
+     */
+    void Listen(const string& sAddress);
+
+    /**
+     * @brief Serve the shards to the workers until all the results are in,
+     *        waiting for new workers if there are none, and set the results
+     *        of the sweep.
+     *
+     * @throw std::runtime_error if not listening, or if a shard failed
+     *        kuiMaxAttempts times, once the workers in progress are done.
+     */
+    void Run();
+
+private:
+    /********** Types **********/
+
+    // A block of compositions run with a seed.
+    struct Shard
+    {
+        size_t uiBegin;         // The first composition.
+        size_t uiEnd;           // The composition after the last one.
+        uint32_t uiSeed;        // The seed.
+        uint32_t uiAttempts;    // The times the shard was handed out.
+    };
+
+    /********** Methods **********/
+
+    /**
+     * @brief Serve the shards to a worker until the sweep ends or the worker
+     *        leaves, in the thread of the connection.
+     *
+     * @param oConnection   The connection of the worker.
+     */
+    void Serve(Socket oConnection);
+
+    /**
+     * @brief Receive the result of a shard from a worker.
+     *
+     * @param oConnection   The connection of the worker.
+     * @param uiShard       The shard.
+     * @param oResults      Gets the results of the compositions of the shard.
+     * @param bConnected    Gets if the worker can take more shards.
+     *
+     * @return If the result was received.
+     */
+    bool ReceiveResult(Socket& oConnection, size_t uiShard, vector<SeedResult>& oResults, bool& bConnected) const;
+
+    /**
+     * @brief Check if all the results are in or a shard failed, with the lock held.
+     *
+     * @return If the sweep is over.
+     */
+    inline bool IsOver() const { return muiShardsDone == moShards.size() || !msError.empty(); }
+
+    /********** Variables **********/
+
+    CompositionSweep& moSweep;          // The sweep.
+    uint32_t muiSeeds;                  // The number of seeds.
+    uint32_t muiFirstSeed;              // The first seed.
+    vector<Shard> moShards;             // The shards, by composition block then seed.
+    Socket moListener;                  // The socket listening for workers.
+
+    mutable mutex moMutex;              // Guards the variables below.
+    condition_variable moShardsChanged; // Notified when a shard is pending or the sweep is over.
+    deque<size_t> moPendingShards;      // The shards to hand out, the retries first.
+    size_t muiShardsDone;               // The shards with their results in.
+    vector<SeedResult> moSeedResults;   // The results per composition and seed.
+    uint32_t muiWorkers;                // The workers connected.
+    uint32_t muiRetries;                // The shards handed out again.
+    string msError;                     // The reason of the shard that failed, empty if none.
+};
+
+#endif // _SWEEP_COORDINATOR_H_
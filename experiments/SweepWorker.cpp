@@ -0,0 +1,95 @@
+/**
+ * @brief Implementation of the SweepWorker class.
+ *
+ */
+
+#include "SweepWorker.h"
+#include "CompositionSweep.h"
+#include "utils/Socket.h"
+
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+SweepWorker::SweepWorker(const string& sAddress, uint32_t uiThreads)
+    : msAddress(sAddress),
+      muiThreads(uiThreads),
+      mpoCache(nullptr)
+{
+}
+
+uint32_t SweepWorker::Run(uint32_t uiMaxShards)
+{
+    Socket oConnection = Socket::Connect(msAddress);
+
+    // Build the sweep from the settings of the coordinator.
+    string sLine;
+    if (!oConnection.ReceiveLine(sLine))
+    {
+        throw std::runtime_error("The coordinator at " + msAddress + " closed the connection.");
+    }
+    istringstream oSettings(sLine);
+    string sKind;
+    uint32_t uiAircrafts = 0;
+    uint32_t uiChargers = 0;
+    uint16_t uiHours = 0;
+    float fSitePowerCap = 0;
+    FaultSampling oSampling;
+    if (!(oSettings >> sKind >> uiAircrafts >> uiChargers >> uiHours >> fSitePowerCap >> oSampling.bCommonRandomNumbers
+        >> oSampling.bAntithetic >> oSampling.fImportanceFactor) || sKind != "SWEEP")
+    {
+        throw std::runtime_error("Unexpected line from the coordinator: " + sLine);
+    }
+    CompositionSweep oSweep(uiAircrafts, uiChargers, uiHours, fSitePowerCap);
+    oSweep.SetFaultSampling(oSampling);
+    oSweep.SetResultCache(mpoCache);
+
+    // Take shards until the sweep is complete, or leave after the last one asked.
+    uint32_t uiShards = 0;
+    while ((uiMaxShards == 0 || uiShards < uiMaxShards) && oConnection.SendLine("READY"))
+    {
+        if (!oConnection.ReceiveLine(sLine) || sLine == "DONE")
+        {
+            break;
+        }
+
+        istringstream oShard(sLine);
+        size_t uiId = 0;
+        size_t uiBegin = 0;
+        size_t uiEnd = 0;
+        uint32_t uiSeed = 0;
+        if (!(oShard >> sKind >> uiId >> uiBegin >> uiEnd >> uiSeed) || sKind != "SHARD")
+        {
+            throw std::runtime_error("Unexpected line from the coordinator: " + sLine);
+        }
+
+        // Run the shard, a failure is reported for the coordinator to retry it elsewhere.
+        vector<SeedResult> oResults;
+        try
+        {
+            oResults = oSweep.RunShard(uiBegin, uiEnd, 1, uiSeed, muiThreads);
+        }
+        catch (const std::exception& oError)
+        {
+            oConnection.SendLine("FAILED " + to_string(uiId) + ' ' + oError.what());
+            continue;
+        }
+
+        // Send the results with all their digits.
+        ostringstream oResult;
+        oResult.precision(numeric_limits<double>::max_digits10);
+        oResult << "RESULT " << uiId << ' ' << oResults.size();
+        for (const SeedResult& koResult : oResults)
+        {
+            oResult << '\n' << koResult.fPassengerMiles << ' ' << koResult.fFaults;
+        }
+        if (!oConnection.SendLine(oResult.str()))
+        {
+            break;
+        }
+        uiShards++;
+    }
+
+    return uiShards;
+}
@@ -0,0 +1,68 @@
+#ifndef _SWEEP_WORKER_H_
+#define _SWEEP_WORKER_H_
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+class ResultCache;
+
+/**
+ * @brief Runs the shards of a composition sweep handed out by a coordinator,
+ *        see SweepCoordinator for the protocol.
+ *
+ * @note  The worker takes the settings of the sweep from the coordinator,
+ *        and runs each shard on its own pool of threads. The results are sent
+ *        with all their digits, so the coordinator merges the same values as
+ *        a sweep run in a single process. A shard whose world fails is
+ *        reported as failed, and the worker goes on with the next one.
+ *
+ */
+class SweepWorker
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Sweep Worker object.
+     *
+     * @param sAddress      The address of the coordinator, see Socket.
+     * @param uiThreads     The number of threads per shard, 0 for one per hardware thread.
+     */
+    SweepWorker(const string& sAddress, uint32_t uiThreads = 0);
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Set the cache of the results, the runs found in it are not run again.
+     *
+     * @param poCache   The cache, which must outlive the runs, nullptr for none.
+     */
+    inline void SetResultCache(ResultCache* poCache) { mpoCache = poCache; }
+
+    /********** Methods **********/
+
+    /**
+     * @brief Connect to the coordinator, and run shards until the sweep is
+     *        complete or the worker leaves.
+     *
+     * @param uiMaxShards   The shards to run before leaving the sweep, 0 for no limit.
+     *
+     * @return The number of shards run.
+     *
+     * @throw std::runtime_error if the coordinator cannot be reached, or if it
+     *        sends a line not in the protocol.
+     */
+    uint32_t Run(uint32_t uiMaxShards = 0);
+
+private:
+    /********** Variables **********/
+
+    string msAddress;       // The address of the coordinator.
+    uint32_t muiThreads;    // The number of threads per shard.
+    ResultCache* mpoCache;  // The cache of the results, nullptr for none.
+};
+
+#endif // _SWEEP_WORKER_H_
@@ -3,27 +3,702 @@
  * 
  */
 
+#include "experiments/CompositionSweep.h"
+#include "experiments/ReplicationController.h"
+#include "experiments/ResultCache.h"
+#include "experiments/SweepCoordinator.h"
+#include "experiments/SweepWorker.h"
+#include "service/LoadClient.h"
+#include "service/SimulationService.h"
+#include "worlds/RealTimePacer.h"
 #include "worlds/SimpleWorld/World.h"
+#include "worlds/SteppedWorld/World.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
-using namespace SimpleWorld;
 
-int main()
+// A statistic to estimate with a precision, as given in the options.
+struct TargetOption
 {
-    const uint8_t kuiAircraftsCount = 20;
-    const uint8_t kuiChargersCount = 3;
-    const uint8_t kuiSimulationHours = 3;
+    const char* pcMetric;
+    AircraftCompany eCompany;
+    float fRelativeHalfWidth;
+};
 
-    // Create a simulation world with 10 aircrafts and 5 chargers.
-    World poWorld(kuiAircraftsCount, kuiChargersCount);
+// The service to stop on a signal.
+static SimulationService* spoService = nullptr;
 
-    // Run the simulation for 3 hours.
-    poWorld.RunSimulation(kuiSimulationHours);
+// Stop the service on a signal, it cancels the requests waiting and waits for the ones running.
+static void StopService(int)
+{
+    if (spoService != nullptr)
+    {
+        spoService->Stop();
+    }
+}
+
+// The paced run to stop on a signal.
+static RealTimePacer* spoPacer = nullptr;
+
+// Stop the paced run on a signal, the statistics of the time reached are printed.
+static void StopPacer(int)
+{
+    if (spoPacer != nullptr)
+    {
+        spoPacer->Stop();
+    }
+}
+
+// Print the results found in the cache and the ones run, if there is a cache.
+static void PrintCacheUse(const ResultCache* poCache)
+{
+    if (poCache != nullptr)
+    {
+        cerr << poCache->GetHitsCount() << " results found in the cache, " << poCache->GetMissesCount() << " run." << endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t kuiAircraftsCount = 20;
+    const uint32_t kuiChargersCount = Scenario::kuiDefaultChargers;
+    const uint16_t kuiSimulationHours = Scenario::kuiDefaultHours;
+    const float kfWarmupSampleInterval = 0.05f;
+
+    // Parse the options.
+    bool bStepped = false;
+    bool bQuiet = false;
+    bool bDiagnostics = false;
+    float fSitePowerCap = 0;
+    bool bExportStatistics = false;
+    StatisticsFormat eStatisticsFormat = StatisticsFormat::Json;
+    const char* pcStatisticsFile = nullptr;
+    float fSampleInterval = 0;
+    const char* pcSamplesFile = nullptr;
+    const char* pcScenarioFile = nullptr;
+    const char* pcBinaryScenarioFile = nullptr;
+    uint32_t uiSweepAircrafts = 0;
+    uint32_t uiSweepSeeds = 1;
+    uint32_t uiSweepThreads = 0;
+    const char* pcSweepFile = nullptr;
+    const char* pcCoordinatorAddress = nullptr;
+    uint32_t uiShardSize = SweepCoordinator::kuiDefaultShardSize;
+    const char* pcWorkerAddress = nullptr;
+    uint32_t uiMaxShards = 0;
+    const char* pcCacheDirectory = nullptr;
+    FaultSampling oFaultSampling;
+    vector<TargetOption> aoTargets;
+    uint32_t uiMaxReplications = 1000;
+    float fHoursAfterWarmup = 0;
+    const char* pcServiceAddress = nullptr;
+    size_t uiQueueSize = SimulationService::kuiDefaultQueueSize;
+    const char* pcLoadAddress = nullptr;
+    uint32_t uiLoadRequests = 1000;
+    uint32_t uiLoadConcurrency = 16;
+    double fRealTimeSpeed = 0;
+    uint64_t uiSnapshotEvents = 0;
+    float fBatteryTaperSoc = 1.0f;
+    float fBatteryTemperature = 25.0f;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--stepped") == 0)
+        {
+            // Use the stepped world instead of the event driven one.
+            bStepped = true;
+        }
+        else if (strcmp(argv[i], "--quiet") == 0)
+        {
+            // Do not print the simulation events.
+            bQuiet = true;
+        }
+        else if (strcmp(argv[i], "--diagnostics") == 0)
+        {
+            // Print the events and allocations counters with the statistics.
+            bDiagnostics = true;
+        }
+        else if (strcmp(argv[i], "--site-power") == 0 && i + 1 < argc)
+        {
+            // Share a power cap in kW between the chargers.
+            fSitePowerCap = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--battery-taper") == 0 && i + 1 < argc)
+        {
+            // Taper the charging current of all the types from this state of charge.
+            fBatteryTaperSoc = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--battery-temperature") == 0 && i + 1 < argc)
+        {
+            // Derate the charging of all the types at this temperature in Celsius degrees.
+            fBatteryTemperature = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc && StatisticsWriter::ParseFormat(argv[i + 1], eStatisticsFormat))
+        {
+            // Also export the statistics in a machine readable format.
+            bExportStatistics = true;
+            ++i;
+        }
+        else if (strcmp(argv[i], "--stats-file") == 0 && i + 1 < argc)
+        {
+            // Export the statistics to a file instead of the standard output.
+            pcStatisticsFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc)
+        {
+            // Sample the fleet gauges every interval in hours.
+            fSampleInterval = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--steady-state") == 0 && i + 1 < argc && strtof(argv[i + 1], nullptr) > 0)
+        {
+            // Collect the statistics for some hours after the warm-up, the simulation time is the longest run.
+            fHoursAfterWarmup = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--samples-file") == 0 && i + 1 < argc)
+        {
+            // Write the fleet samples to a file instead of the standard output.
+            pcSamplesFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc)
+        {
+            // Load the fleet, the chargers and the simulation time from a scenario file.
+            pcScenarioFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--write-scenario") == 0 && i + 1 < argc)
+        {
+            // Convert the scenario to the binary format instead of running it.
+            pcBinaryScenarioFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc)
+        {
+            // Run every composition of a fleet instead of a single world.
+            uiSweepAircrafts = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--seeds") == 0 && i + 1 < argc)
+        {
+            // Run every composition with a number of seeds.
+            uiSweepSeeds = max<uint32_t>(1, strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            // Run the compositions on a number of threads, 0 for all the hardware threads.
+            uiSweepThreads = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--sweep-file") == 0 && i + 1 < argc)
+        {
+            // Write the compositions table to a file instead of the standard output.
+            pcSweepFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--coordinator") == 0 && i + 1 < argc)
+        {
+            // Hand out the sweep in shards to the workers connecting to this address.
+            pcCoordinatorAddress = argv[++i];
+        }
+        else if (strcmp(argv[i], "--shard-size") == 0 && i + 1 < argc)
+        {
+            // Hand out this number of compositions per shard.
+            uiShardSize = max<uint32_t>(1, strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--worker") == 0 && i + 1 < argc)
+        {
+            // Run the shards of the coordinator at this address instead of a world.
+            pcWorkerAddress = argv[++i];
+        }
+        else if (strcmp(argv[i], "--max-shards") == 0 && i + 1 < argc)
+        {
+            // Leave the sweep after this number of shards.
+            uiMaxShards = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            // Keep the results of the sweeps and the replications in a directory, and reuse them.
+            pcCacheDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "--crn") == 0)
+        {
+            // Draw the faults per aircraft and flight, common to the compared worlds.
+            oFaultSampling.bCommonRandomNumbers = true;
+        }
+        else if (strcmp(argv[i], "--antithetic") == 0)
+        {
+            // Use the antithetic fault draws, in pairs of runs if sweeping.
+            oFaultSampling.bAntithetic = true;
+        }
+        else if (strcmp(argv[i], "--fault-importance") == 0 && i + 1 < argc && strtof(argv[i + 1], nullptr) > 0)
+        {
+            // Raise the fault rate, the estimated faults are reweighted.
+            oFaultSampling.fImportanceFactor = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--target") == 0 && i + 3 < argc)
+        {
+            // Replicate the scenario until the statistic of the company, or of all of them, is as precise as asked.
+            TargetOption oTarget{ argv[i + 1], AircraftCompany::TotalCompanies, strtof(argv[i + 3], nullptr) };
+            if (strcmp(argv[i + 2], "all") != 0 && !AircraftType::ParseCompany(argv[i + 2], oTarget.eCompany))
+            {
+                cerr << "Unknown company " << argv[i + 2] << "." << endl;
+                return 1;
+            }
+            aoTargets.push_back(oTarget);
+            i += 3;
+        }
+        else if (strcmp(argv[i], "--max-replications") == 0 && i + 1 < argc)
+        {
+            // Stop the replications at this number even if the targets are not met.
+            uiMaxReplications = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--realtime") == 0 && i + 1 < argc && strtod(argv[i + 1], nullptr) > 0)
+        {
+            // Pace the world with the wall clock at this speed, reading commands from the standard input.
+            fRealTimeSpeed = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc && strtoul(argv[i + 1], nullptr, 10) > 0)
+        {
+            // Publish the fleet state every number of events, and print it every second from another thread.
+            uiSnapshotEvents = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc)
+        {
+            // Serve the simulation requests of the clients at this address instead of running a world.
+            pcServiceAddress = argv[++i];
+        }
+        else if (strcmp(argv[i], "--queue-size") == 0 && i + 1 < argc)
+        {
+            // Keep this number of requests waiting for a worker, the next ones are rejected as busy.
+            uiQueueSize = max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+        {
+            // Measure the service at this address with many requests instead of running a world.
+            pcLoadAddress = argv[++i];
+        }
+        else if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc)
+        {
+            // Send this number of requests to the service.
+            uiLoadRequests = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--concurrency") == 0 && i + 1 < argc)
+        {
+            // Keep this number of requests in flight.
+            uiLoadConcurrency = max<uint32_t>(1, strtoul(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--stepped] [--quiet] [--diagnostics] [--site-power <kW>] [--realtime <speed>] [--snapshot <events>]"
+                << " [--battery-taper <soc>] [--battery-temperature <celsius>]"
+                << " [--stats json|csv|prometheus] [--stats-file <path>]"
+                << " [--sample <hours> [--samples-file <path>]] [--steady-state <hours>]"
+                << " [--scenario <path> [--write-scenario <path>]]"
+                << " [--sweep <aircrafts> [--seeds <n>] [--threads <n>] [--sweep-file <path>]"
+                << " [--coordinator unix:<path>|[<host>:]<port> [--shard-size <n>]]]"
+                << " [--worker unix:<path>|<host>:<port> [--threads <n>] [--max-shards <n>]]"
+                << " [--target <metric> <company|all> <relative half-width>]... [--max-replications <n>]"
+                << " [--cache <directory>]"
+                << " [--serve unix:<path>|[<host>:]<port> [--threads <n>] [--queue-size <n>]]"
+                << " [--load unix:<path>|<host>:<port> [--requests <n>] [--concurrency <n>]]"
+                << " [--crn] [--antithetic] [--fault-importance <factor>]" << endl;
+            return 1;
+        }
+    }
+
+    // Only the simple world shares the site power, samples the fleet, detects the warm-up, publishes snapshots
+    // and counts its events.
+    if (bStepped && (fSitePowerCap > 0 || fSampleInterval > 0 || fHoursAfterWarmup > 0 || uiSnapshotEvents > 0 || bDiagnostics))
+    {
+        cerr << "The stepped world cannot be used with --site-power, --sample, --steady-state, --snapshot or --diagnostics." << endl;
+        return 1;
+    }
+
+    // The battery models of the types, shared by the worlds of all the threads, so set before any of them runs.
+    try
+    {
+        for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+        {
+            const AircraftType* poAircraftType = AircraftType::GetAircraftType(static_cast<AircraftCompany>(i));
+            AircraftType::SetBatteryModel(poAircraftType->GetCompany(),
+                BatteryModel(poAircraftType->GetTimeToCharge(), fBatteryTaperSoc, 0.05f, fBatteryTemperature));
+        }
+    }
+    catch (const std::runtime_error& oError)
+    {
+        cerr << oError.what() << endl;
+        return 1;
+    }
+
+    // Open the results cache, its index is written when it is closed.
+    unique_ptr<ResultCache> poCache;
+    if (pcCacheDirectory != nullptr)
+    {
+        try
+        {
+            poCache = make_unique<ResultCache>(pcCacheDirectory);
+        }
+        catch (const std::runtime_error& oError)
+        {
+            cerr << oError.what() << endl;
+            return 1;
+        }
+    }
+
+    // Run the shards of a coordinator, the sweep settings come from it.
+    if (pcWorkerAddress != nullptr)
+    {
+        try
+        {
+            SweepWorker oWorker(pcWorkerAddress, uiSweepThreads);
+            oWorker.SetResultCache(poCache.get());
+            uint32_t uiShards = oWorker.Run(uiMaxShards);
+            cout << uiShards << " shards run for the coordinator at " << pcWorkerAddress << "." << endl;
+            PrintCacheUse(poCache.get());
+        }
+        catch (const std::runtime_error& oError)
+        {
+            cerr << oError.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Serve the simulation requests until interrupted.
+    if (pcServiceAddress != nullptr)
+    {
+        try
+        {
+            SimulationService oService(uiSweepThreads, uiQueueSize);
+            oService.Listen(pcServiceAddress);
+            spoService = &oService;
+            signal(SIGINT, StopService);
+            signal(SIGTERM, StopService);
+            cerr << "Serving the simulation requests at " << pcServiceAddress << "." << endl;
+            oService.Run();
+            spoService = nullptr;
+            cerr << oService.GetCompletedCount() << " requests completed, " << oService.GetRejectedCount() << " rejected as busy, "
+                << oService.GetCancelledCount() << " cancelled." << endl;
+        }
+        catch (const std::runtime_error& oError)
+        {
+            cerr << oError.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Send many requests with the default fleet to a service, and report its throughput and latency.
+    if (pcLoadAddress != nullptr)
+    {
+        try
+        {
+            SimulationRequest oTemplate;
+            oTemplate.uiSeed = static_cast<uint32_t>(time(0));
+            oTemplate.fSitePowerCap = fSitePowerCap;
+            LoadReport oReport = LoadClient(pcLoadAddress, oTemplate).Run(uiLoadRequests, uiLoadConcurrency);
+            cout << oReport.uiCompleted << " requests completed, " << oReport.uiErrors << " failed, " << oReport.uiBusy
+                << " rejected as busy and sent again, in " << oReport.fSeconds << " s." << endl;
+            cout << "Throughput: " << oReport.fThroughput << " requests/s, latency p50 " << oReport.fP50 << " ms, p99 "
+                << oReport.fP99 << " ms, max " << oReport.fMax << " ms." << endl;
+        }
+        catch (const std::runtime_error& oError)
+        {
+            cerr << oError.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Load the scenario, text or binary.
+    unique_ptr<Scenario> poScenario;
+    if (pcScenarioFile != nullptr)
+    {
+        try
+        {
+            poScenario = Scenario::Load(pcScenarioFile);
+            if (pcBinaryScenarioFile != nullptr)
+            {
+                poScenario->WriteBinary(pcBinaryScenarioFile);
+                return 0;
+            }
+        }
+        catch (const std::runtime_error& oError)
+        {
+            cerr << oError.what() << endl;
+            return 1;
+        }
+    }
+
+    // Run every composition of the fleet with the scenario chargers, time and seed.
+    if (uiSweepAircrafts > 0)
+    {
+        Scenario oDefaults;
+        const Scenario& koSettings = poScenario ? *poScenario : oDefaults;
+        uint32_t uiFirstSeed = koSettings.GetSeed() != 0 ? koSettings.GetSeed() : static_cast<uint32_t>(time(0));
+
+        CompositionSweep oSweep(uiSweepAircrafts, koSettings.GetChargersCount(), koSettings.GetHours(), fSitePowerCap);
+        oSweep.SetFaultSampling(oFaultSampling);
+        oSweep.SetResultCache(poCache.get());
+        if (pcCoordinatorAddress != nullptr)
+        {
+            // The workers run the shards, this process only merges their results.
+            try
+            {
+                SweepCoordinator oCoordinator(oSweep, uiSweepSeeds, uiFirstSeed, uiShardSize);
+                oCoordinator.Listen(pcCoordinatorAddress);
+                cerr << "Waiting for workers at " << pcCoordinatorAddress << " for " << oCoordinator.GetShardsCount()
+                    << " shards." << endl;
+                oCoordinator.Run();
+                cerr << oCoordinator.GetWorkersCount() << " workers, " << oCoordinator.GetRetriesCount()
+                    << " shards handed out again." << endl;
+            }
+            catch (const std::runtime_error& oError)
+            {
+                cerr << oError.what() << endl;
+                return 1;
+            }
+        }
+        else
+        {
+            oSweep.Run(uiSweepSeeds, uiFirstSeed, uiSweepThreads);
+        }
+
+        // Write the table, and the Pareto front if the table goes to a file.
+        if (pcSweepFile != nullptr)
+        {
+            ofstream oFile(pcSweepFile);
+            if (!oFile)
+            {
+                cerr << "Cannot open the sweep file " << pcSweepFile << "." << endl;
+                return 1;
+            }
+            oSweep.WriteCsv(oFile);
+
+            cout << oSweep.GetResults().size() << " compositions run with the seeds " << uiFirstSeed << " to "
+                << uiFirstSeed + uiSweepSeeds - 1 << ", Pareto front of passenger miles versus faults:" << endl;
+            oSweep.WriteCsv(cout, true);
+        }
+        else
+        {
+            oSweep.WriteCsv(cout);
+        }
+        PrintCacheUse(poCache.get());
+
+        return 0;
+    }
+
+    // Replicate the scenario until the confidence intervals of the targets are narrow enough.
+    if (!aoTargets.empty())
+    {
+        if (!poScenario)
+        {
+            cerr << "The targets need a --scenario to replicate." << endl;
+            return 1;
+        }
+
+        uint32_t uiFirstSeed = poScenario->GetSeed() != 0 ? poScenario->GetSeed() : static_cast<uint32_t>(time(0));
+        ReplicationController oController(*poScenario, fSitePowerCap);
+        oController.SetFaultSampling(oFaultSampling);
+        oController.SetResultCache(poCache.get());
+        try
+        {
+            for (const TargetOption& koTarget : aoTargets)
+            {
+                oController.AddTarget(koTarget.pcMetric, koTarget.eCompany, koTarget.fRelativeHalfWidth);
+            }
+        }
+        catch (const std::runtime_error& oError)
+        {
+            cerr << oError.what() << endl;
+            return 1;
+        }
+
+        bool bMet = oController.Run(uiMaxReplications, uiFirstSeed, uiSweepThreads);
+        oController.WriteReport(cout);
+        PrintCacheUse(poCache.get());
+        return bMet ? 0 : 2;
+    }
+
+    // The fault draws of the single world.
+    AircraftType::SetFaultSampling(oFaultSampling);
+
+    // The fleet sampler of the simple world. The warm-up is detected on
+    // the samples, taken every 3 minutes if not asked.
+    unique_ptr<MetricsSampler> poSampler;
+    unique_ptr<WarmupDetector> poWarmup;
+    if (fSampleInterval > 0 || fHoursAfterWarmup > 0)
+    {
+        poSampler = make_unique<MetricsSampler>(fSampleInterval > 0 ? fSampleInterval : kfWarmupSampleInterval);
+    }
+    if (fHoursAfterWarmup > 0)
+    {
+        poWarmup = make_unique<WarmupDetector>();
+    }
+
+    // The fleet snapshot of the simple world, with room for the chargers the commands add.
+    unique_ptr<FleetSnapshot> poSnapshot;
+    if (uiSnapshotEvents > 0)
+    {
+        poSnapshot = make_unique<FleetSnapshot>(poScenario ? poScenario->GetAircraftsCount() : kuiAircraftsCount,
+            (poScenario ? poScenario->GetChargersCount() : kuiChargersCount) + SimpleWorld::QuietWorld::kuiMaxAddedChargers,
+            uiSnapshotEvents);
+    }
+
+    // The options of the simple world.
+    SimpleWorld::WorldOptions oWorldOptions;
+    oWorldOptions.fSitePowerCap = fSitePowerCap;
+    oWorldOptions.bTraceEvents = !bQuiet;
+    oWorldOptions.poSampler = poSampler.get();
+    oWorldOptions.poWarmup = poWarmup.get();
+    oWorldOptions.fHoursAfterWarmup = fHoursAfterWarmup;
+    oWorldOptions.poSnapshot = poSnapshot.get();
+    oWorldOptions.bDiagnostics = bDiagnostics;
+
+    // Create a simulation world with the scenario fleet, or with 20 aircrafts and 3 chargers.
+    unique_ptr<SimulationWorld> poWorld;
+    if (poScenario)
+    {
+        if (bStepped)
+        {
+            poWorld = SteppedWorld::CreateWorld(*poScenario, !bQuiet);
+        }
+        else
+        {
+            poWorld = SimpleWorld::CreateWorld(*poScenario, oWorldOptions);
+        }
+    }
+    else if (bStepped)
+    {
+        poWorld = SteppedWorld::CreateWorld(kuiAircraftsCount, kuiChargersCount, !bQuiet);
+    }
+    else
+    {
+        poWorld = SimpleWorld::CreateWorld(kuiAircraftsCount, kuiChargersCount, oWorldOptions);
+    }
+
+    // Print the fleet published last every second while the world runs, without stopping it.
+    atomic<bool> bRunning(true);
+    thread oSnapshotReader;
+    if (poSnapshot)
+    {
+        oSnapshotReader = thread([&poSnapshot, &bRunning]()
+        {
+            FleetState oState;
+            uint64_t uiPrinted = 0;
+            while (bRunning.load(memory_order_relaxed))
+            {
+                for (int i = 0; i < 10 && bRunning.load(memory_order_relaxed); i++)
+                {
+                    this_thread::sleep_for(chrono::milliseconds(100));
+                }
+                if (!poSnapshot->Read(oState) || oState.uiVersion == uiPrinted)
+                {
+                    continue;
+                }
+
+                uiPrinted = oState.uiVersion;
+                float fStateOfCharge = 0;
+                for (float fAircraft : oState.afStateOfCharge)
+                {
+                    fStateOfCharge += fAircraft;
+                }
+                cerr << "Fleet at " << oState.fTime << " hours: " << count(oState.abChargersInUse.begin(), oState.abChargersInUse.end(), true)
+                    << " of " << oState.abChargersInUse.size() << " chargers in use, " << oState.uiQueueLength
+                    << " aircrafts waiting, mean state of charge " << fStateOfCharge / max<size_t>(1, oState.afStateOfCharge.size())
+                    << "." << endl;
+            }
+        });
+    }
+
+    // Run the simulation for the scenario time, or 3 hours.
+    const uint16_t kuiHours = poScenario ? poScenario->GetHours() : kuiSimulationHours;
+    if (fRealTimeSpeed > 0)
+    {
+        // Pace the world with the wall clock, the commands are read from the standard input until it ends.
+        // The reader shares the pacer, as it may post to its inbox after the run.
+        shared_ptr<RealTimePacer> poPacer = make_shared<RealTimePacer>(*poWorld, fRealTimeSpeed);
+        thread([poPacer]()
+        {
+            string sLine;
+            WorldCommand oCommand;
+            while (getline(cin, sLine))
+            {
+                if (!RealTimePacer::ParseCommand(sLine, oCommand))
+                {
+                    cerr << "Unknown command " << sLine << ", use ground <aircraft>, release <aircraft> or add-charger." << endl;
+                }
+                else if (!poPacer->Post(oCommand))
+                {
+                    cerr << "Too many commands waiting, " << sLine << " is dropped." << endl;
+                }
+            }
+        }).detach();
+
+        spoPacer = poPacer.get();
+        signal(SIGINT, StopPacer);
+        signal(SIGTERM, StopPacer);
+        poPacer->Run(kuiHours);
+        spoPacer = nullptr;
+
+        const PacingStatistics& koPacing = poPacer->GetStatistics();
+        cerr << koPacing.uiEventTimes << " event times paced, " << koPacing.uiLateTimes << " behind the wall clock, lateness mean "
+            << koPacing.oLateness.GetMean() << " us, max " << koPacing.fMaxLateness << " us. " << koPacing.uiCommands
+            << " commands applied, " << koPacing.uiRejectedCommands << " rejected." << endl;
+    }
+    else
+    {
+        poWorld->RunSimulation(kuiHours);
+    }
+    bRunning = false;
+    if (oSnapshotReader.joinable())
+    {
+        oSnapshotReader.join();
+    }
 
     // Print the statistics.
-    poWorld.PrintStatistics();
+    poWorld->PrintStatistics();
+
+    // Export the statistics, appending to the file if any.
+    if (bExportStatistics)
+    {
+        ofstream oFile;
+        if (pcStatisticsFile != nullptr)
+        {
+            oFile.open(pcStatisticsFile, ios::app);
+            if (!oFile)
+            {
+                cerr << "Cannot open the statistics file " << pcStatisticsFile << "." << endl;
+                return 1;
+            }
+        }
+
+        unique_ptr<StatisticsWriter> poWriter = StatisticsWriter::Create(eStatisticsFormat, oFile.is_open() ? oFile : cout);
+        poWorld->ExportStatistics(*poWriter);
+    }
+
+    // Write the fleet samples, if asked.
+    if (poSampler && fSampleInterval > 0)
+    {
+        ofstream oFile;
+        if (pcSamplesFile != nullptr)
+        {
+            oFile.open(pcSamplesFile);
+            if (!oFile)
+            {
+                cerr << "Cannot open the samples file " << pcSamplesFile << "." << endl;
+                return 1;
+            }
+        }
+
+        poSampler->WriteCsv(oFile.is_open() ? oFile : cout);
+    }
 
     return 0;
 }
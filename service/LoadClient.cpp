@@ -0,0 +1,142 @@
+/**
+ * @brief Implementation of the LoadClient class.
+ *
+ */
+
+#include "LoadClient.h"
+#include "utils/Socket.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// The pause before sending again a request rejected as busy.
+static const chrono::milliseconds koBusyPause(1);
+
+// Read the id and the status of a response, which come first in its object.
+static bool ReadResponse(string_view sLine, uint64_t& uiId, string_view& sStatus)
+{
+    static const string_view ksIdKey = "{\"id\":";
+    static const string_view ksStatusKey = ",\"status\":\"";
+    if (sLine.substr(0, ksIdKey.size()) != ksIdKey)
+    {
+        return false;
+    }
+    sLine.remove_prefix(ksIdKey.size());
+    from_chars_result oResult = from_chars(sLine.data(), sLine.data() + sLine.size(), uiId);
+    if (oResult.ec != errc())
+    {
+        return false;
+    }
+    sLine.remove_prefix(oResult.ptr - sLine.data());
+    if (sLine.substr(0, ksStatusKey.size()) != ksStatusKey)
+    {
+        return false;
+    }
+    sLine.remove_prefix(ksStatusKey.size());
+    sStatus = sLine.substr(0, sLine.find('"'));
+    return true;
+}
+
+// Get a percentile of sorted values, by the nearest rank.
+static double GetPercentile(const vector<double>& kafSorted, double fPercentile)
+{
+    if (kafSorted.empty())
+    {
+        return 0;
+    }
+    size_t uiRank = static_cast<size_t>(ceil(fPercentile * kafSorted.size()));
+    return kafSorted[max<size_t>(uiRank, 1) - 1];
+}
+
+LoadClient::LoadClient(const string& sAddress, const SimulationRequest& koTemplate)
+    : msAddress(sAddress),
+      moTemplate(koTemplate)
+{
+}
+
+LoadReport LoadClient::Run(uint32_t uiRequests, uint32_t uiConcurrency)
+{
+    typedef chrono::steady_clock Clock;
+    Socket oConnection = Socket::Connect(msAddress);
+    uiConcurrency = max(1u, uiConcurrency);
+
+    // The requests to send, with the time of their first send.
+    deque<uint64_t> oToSend;
+    for (uint64_t uiId = 1; uiId <= uiRequests; uiId++)
+    {
+        oToSend.push_back(uiId);
+    }
+    vector<Clock::time_point> aoFirstSent(uiRequests + 1);
+    vector<bool> abInFlight(uiRequests + 1, false);
+    vector<double> afLatencies;
+    afLatencies.reserve(uiRequests);
+
+    LoadReport oReport;
+    uint32_t uiInFlight = 0;
+    const Clock::time_point koStart = Clock::now();
+    while (oReport.uiCompleted + oReport.uiErrors < uiRequests)
+    {
+        // Keep the requests in flight.
+        while (uiInFlight < uiConcurrency && !oToSend.empty())
+        {
+            SimulationRequest oRequest = moTemplate;
+            oRequest.uiId = oToSend.front();
+            oRequest.uiSeed = moTemplate.uiSeed + static_cast<uint32_t>(oRequest.uiId - 1);
+            oToSend.pop_front();
+            if (aoFirstSent[oRequest.uiId] == Clock::time_point())
+            {
+                aoFirstSent[oRequest.uiId] = Clock::now();
+            }
+            if (!oConnection.SendLine(SimulationService::FormatRequest(oRequest)))
+            {
+                throw std::runtime_error("The service at " + msAddress + " closed the connection.");
+            }
+            abInFlight[oRequest.uiId] = true;
+            uiInFlight++;
+        }
+
+        string sLine;
+        if (!oConnection.ReceiveLine(sLine))
+        {
+            throw std::runtime_error("The service at " + msAddress + " closed the connection.");
+        }
+        uint64_t uiId = 0;
+        string_view sStatus;
+        if (!ReadResponse(sLine, uiId, sStatus) || uiId == 0 || uiId > uiRequests || !abInFlight[uiId])
+        {
+            throw std::runtime_error("The service sent an unexpected line: " + sLine);
+        }
+        abInFlight[uiId] = false;
+        uiInFlight--;
+
+        if (sStatus == "ok")
+        {
+            afLatencies.push_back(chrono::duration<double, milli>(Clock::now() - aoFirstSent[uiId]).count());
+            oReport.uiCompleted++;
+        }
+        else if (sStatus == "busy")
+        {
+            oToSend.push_back(uiId);
+            oReport.uiBusy++;
+            this_thread::sleep_for(koBusyPause);
+        }
+        else
+        {
+            oReport.uiErrors++;
+        }
+    }
+
+    oReport.fSeconds = chrono::duration<double>(Clock::now() - koStart).count();
+    oReport.fThroughput = oReport.fSeconds > 0 ? oReport.uiCompleted / oReport.fSeconds : 0;
+    sort(afLatencies.begin(), afLatencies.end());
+    oReport.fP50 = GetPercentile(afLatencies, 0.5);
+    oReport.fP99 = GetPercentile(afLatencies, 0.99);
+    oReport.fMax = afLatencies.empty() ? 0 : afLatencies.back();
+    return oReport;
+}
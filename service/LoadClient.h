@@ -0,0 +1,75 @@
+#ifndef _LOAD_CLIENT_H_
+#define _LOAD_CLIENT_H_
+
+#include "SimulationService.h"
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief The figures of a load run against the simulation service.
+ *
+ */
+struct LoadReport
+{
+    uint64_t uiCompleted = 0;   ///< The requests run to their end.
+    uint64_t uiBusy = 0;        ///< The times a request was rejected as busy, then sent again.
+    uint64_t uiErrors = 0;      ///< The requests failed or cancelled.
+    double fSeconds = 0;        ///< The time of the whole run in seconds.
+    double fThroughput = 0;     ///< The requests completed per second.
+    double fP50 = 0;            ///< The median latency in milliseconds.
+    double fP99 = 0;            ///< The 99th percentile of the latency in milliseconds.
+    double fMax = 0;            ///< The largest latency in milliseconds.
+};
+
+/**
+ * @brief Sends many requests to a simulation service, keeping some of them in
+ *        flight, to measure its throughput and its latency.
+ *
+ * @note  The requests are copies of a template with the ids 1 to N and the
+ *        seeds following the one of the template, so they are not all the
+ *        same world. The latency of a request counts from its first send to
+ *        its result, a request rejected as busy is sent again after a short
+ *        pause and keeps waiting. The percentiles are the nearest ranks of the
+ *        latencies of the requests completed.
+ *
+ */
+class LoadClient
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Load Client object.
+     *
+     * @param sAddress      The address of the service, see Socket.
+     * @param koTemplate    The request copied by all the requests.
+     */
+    LoadClient(const string& sAddress, const SimulationRequest& koTemplate);
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Send the requests and wait for all their responses.
+     *
+     * @param uiRequests    The number of requests.
+     * @param uiConcurrency The requests in flight at most, at least 1.
+     *
+     * @return The figures of the run.
+     *
+     * @throw std::runtime_error if the service cannot be reached, or if it
+     *        closes the connection or sends a line not in the protocol.
+     */
+    LoadReport Run(uint32_t uiRequests, uint32_t uiConcurrency);
+
+private:
+    /********** Variables **********/
+
+    string msAddress;               // The address of the service.
+    SimulationRequest moTemplate;   // The request copied by all the requests.
+};
+
+#endif // _LOAD_CLIENT_H_
@@ -0,0 +1,470 @@
+/**
+ * @brief Implementation of the SimulationService class.
+ *
+ */
+
+#include "SimulationService.h"
+#include "worlds/Scenario.h"
+#include "worlds/SimpleWorld/World.h"
+#include "worlds/StatisticsWriter.h"
+#include "utils/CountingMemoryResource.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+// The time the threads wait for a connection or a request before checking if the service stops, in milliseconds.
+static const int kiPollTimeout = 100;
+
+// The largest block the worker pools keep, the world arenas grow by blocks up to a few megabytes.
+static const size_t kuiLargestPooledBlock = 16 * 1024 * 1024;
+
+// Skip the spaces before the next token.
+static void SkipSpaces(string_view& sText)
+{
+    size_t uiStart = sText.find_first_not_of(" \t\r");
+    sText.remove_prefix(uiStart != string_view::npos ? uiStart : sText.size());
+}
+
+// Read a character if it is the next token.
+static bool ReadCharacter(string_view& sText, char cCharacter)
+{
+    SkipSpaces(sText);
+    if (sText.empty() || sText.front() != cCharacter)
+    {
+        return false;
+    }
+    sText.remove_prefix(1);
+    return true;
+}
+
+// Read a key without escapes, the keys of the requests are known identifiers.
+static bool ReadKey(string_view& sText, string_view& sKey)
+{
+    if (!ReadCharacter(sText, '"'))
+    {
+        return false;
+    }
+    size_t uiEnd = sText.find('"');
+    if (uiEnd == string_view::npos)
+    {
+        return false;
+    }
+    sKey = sText.substr(0, uiEnd);
+    sText.remove_prefix(uiEnd + 1);
+    return ReadCharacter(sText, ':');
+}
+
+// Read an unsigned integer not greater than a maximum.
+template <typename T>
+static bool ReadInteger(string_view& sText, T& uiValue, T uiMax = numeric_limits<T>::max())
+{
+    SkipSpaces(sText);
+    T uiRead = 0;
+    from_chars_result oResult = from_chars(sText.data(), sText.data() + sText.size(), uiRead);
+    if (oResult.ec != errc() || uiRead > uiMax)
+    {
+        return false;
+    }
+    sText.remove_prefix(oResult.ptr - sText.data());
+    uiValue = uiRead;
+    return true;
+}
+
+// Read a finite number not lower than 0.
+static bool ReadNumber(string_view& sText, float& fValue)
+{
+    SkipSpaces(sText);
+    size_t uiEnd = sText.find_first_not_of("+-.0123456789eE");
+    string sNumber(sText.substr(0, uiEnd));
+    char* pcEnd = nullptr;
+    float fRead = strtof(sNumber.c_str(), &pcEnd);
+    if (sNumber.empty() || pcEnd != sNumber.c_str() + sNumber.size() || !isfinite(fRead) || fRead < 0)
+    {
+        return false;
+    }
+    sText.remove_prefix(sNumber.size());
+    fValue = fRead;
+    return true;
+}
+
+// Write a text as a JSON string.
+static void WriteString(ostringstream& oOutput, string_view sText)
+{
+    oOutput << '"';
+    for (char cCharacter : sText)
+    {
+        if (cCharacter == '"' || cCharacter == '\\')
+        {
+            oOutput << '\\' << cCharacter;
+        }
+        else if (static_cast<unsigned char>(cCharacter) < ' ')
+        {
+            oOutput << ' ';
+        }
+        else
+        {
+            oOutput << cCharacter;
+        }
+    }
+    oOutput << '"';
+}
+
+// Format a response without a result.
+static string FormatStatus(uint64_t uiId, const char* pcStatus, string_view sMessage = {})
+{
+    ostringstream oResponse;
+    oResponse << "{\"id\":" << uiId << ",\"status\":\"" << pcStatus << '"';
+    if (!sMessage.empty())
+    {
+        oResponse << ",\"message\":";
+        WriteString(oResponse, sMessage);
+    }
+    oResponse << '}';
+    return oResponse.str();
+}
+
+SimulationService::SimulationService(uint32_t uiThreads, size_t uiQueueSize)
+    : muiThreads(uiThreads > 0 ? uiThreads : max(1u, thread::hardware_concurrency())),
+      muiQueueSize(max<size_t>(1, uiQueueSize)),
+      mbStopping(false),
+      muiCompleted(0),
+      muiRejected(0),
+      muiCancelled(0),
+      muiSystemAllocations(0),
+      muiClients(0)
+{
+}
+
+bool SimulationService::ParseRequest(string_view sLine, SimulationRequest& oRequest)
+{
+    // A flat object, the id or the request to cancel is required.
+    bool bHasId = false;
+    if (!ReadCharacter(sLine, '{'))
+    {
+        return false;
+    }
+    do
+    {
+        string_view sKey;
+        if (!ReadKey(sLine, sKey))
+        {
+            return false;
+        }
+
+        bool bValid;
+        if (sKey == "id" || sKey == "cancel")
+        {
+            bValid = ReadInteger(sLine, oRequest.uiId);
+            oRequest.bCancel = sKey == "cancel";
+            bHasId = true;
+        }
+        else if (sKey == "hours")
+        {
+            bValid = ReadNumber(sLine, oRequest.fHours) && oRequest.fHours > 0;
+        }
+        else if (sKey == "seed")
+        {
+            bValid = ReadInteger(sLine, oRequest.uiSeed);
+        }
+        else if (sKey == "chargers")
+        {
+            bValid = ReadInteger(sLine, oRequest.uiChargers, kuiMaxFleetSize);
+        }
+        else if (sKey == "site_power")
+        {
+            bValid = ReadNumber(sLine, oRequest.fSitePowerCap);
+        }
+        else if (sKey == "aircrafts")
+        {
+            // The aircrafts of every company, in order.
+            uint32_t uiTotal = 0;
+            bValid = ReadCharacter(sLine, '[');
+            for (size_t i = 0; bValid && i < (size_t)AircraftCompany::TotalCompanies; i++)
+            {
+                bValid = (i == 0 || ReadCharacter(sLine, ',')) && ReadInteger(sLine, oRequest.auiAircrafts[i], kuiMaxFleetSize);
+                uiTotal += bValid ? oRequest.auiAircrafts[i] : 0;
+            }
+            bValid = bValid && ReadCharacter(sLine, ']') && uiTotal <= kuiMaxFleetSize;
+        }
+        else
+        {
+            bValid = false;
+        }
+
+        if (!bValid)
+        {
+            return false;
+        }
+    } while (ReadCharacter(sLine, ','));
+
+    bool bEnd = ReadCharacter(sLine, '}');
+    SkipSpaces(sLine);
+    return bEnd && sLine.empty() && bHasId;
+}
+
+string SimulationService::FormatRequest(const SimulationRequest& koRequest)
+{
+    ostringstream oRequest;
+    if (koRequest.bCancel)
+    {
+        oRequest << "{\"cancel\":" << koRequest.uiId << '}';
+        return oRequest.str();
+    }
+
+    // The floats with all their digits.
+    oRequest.precision(numeric_limits<float>::max_digits10);
+    oRequest << "{\"id\":" << koRequest.uiId << ",\"hours\":" << koRequest.fHours << ",\"seed\":" << koRequest.uiSeed
+        << ",\"chargers\":" << koRequest.uiChargers << ",\"aircrafts\":[";
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        oRequest << (i > 0 ? "," : "") << koRequest.auiAircrafts[i];
+    }
+    oRequest << "],\"site_power\":" << koRequest.fSitePowerCap << '}';
+    return oRequest.str();
+}
+
+void SimulationService::Listen(const string& sAddress)
+{
+    moListener = Socket::Listen(sAddress);
+}
+
+void SimulationService::Run()
+{
+    if (!moListener.IsOpen())
+    {
+        throw std::runtime_error("The service is not listening for clients.");
+    }
+
+    // The workers live as long as the service, with their memory.
+    vector<thread> oWorkers;
+    for (uint32_t i = 0; i < muiThreads; i++)
+    {
+        oWorkers.emplace_back(&SimulationService::Work, this);
+    }
+
+    // Accept the clients until stopped, each one served by its own thread.
+    while (!mbStopping)
+    {
+        if (moListener.WaitReadable(kiPollTimeout))
+        {
+            Socket oSocket = moListener.Accept();
+            if (oSocket.IsOpen())
+            {
+                shared_ptr<Connection> poConnection = make_shared<Connection>();
+                poConnection->oSocket = std::move(oSocket);
+                {
+                    lock_guard<mutex> oLock(moMutex);
+                    muiClients++;
+                }
+                thread(&SimulationService::Serve, this, std::move(poConnection)).detach();
+            }
+        }
+    }
+    moListener.Close();
+
+    // The clients threads see the service stopping, then the workers cancel the requests waiting.
+    {
+        unique_lock<mutex> oLock(moMutex);
+        moClientsChanged.wait(oLock, [this]() { return muiClients == 0; });
+    }
+    moQueueChanged.notify_all();
+    for (thread& oWorker : oWorkers)
+    {
+        oWorker.join();
+    }
+}
+
+void SimulationService::Serve(shared_ptr<Connection> poConnection)
+{
+    string sLine;
+    while (!mbStopping)
+    {
+        if (!poConnection->oSocket.WaitReadable(kiPollTimeout))
+        {
+            continue;
+        }
+        if (!poConnection->oSocket.ReceiveLine(sLine))
+        {
+            break;
+        }
+
+        SimulationRequest oRequest;
+        if (!ParseRequest(sLine, oRequest))
+        {
+            Respond(*poConnection, nullptr, FormatStatus(oRequest.uiId, "error", "The request is not valid."));
+            continue;
+        }
+
+        // Flag the request to cancel, its worker answers it once it takes it or between events.
+        string sResponse;
+        if (oRequest.bCancel)
+        {
+            {
+                lock_guard<mutex> oLock(poConnection->oMutex);
+                auto itJob = find_if(poConnection->oJobs.begin(), poConnection->oJobs.end(),
+                    [&oRequest](const shared_ptr<Job>& kpoJob) { return kpoJob->oRequest.uiId == oRequest.uiId; });
+                if (itJob != poConnection->oJobs.end())
+                {
+                    (*itJob)->bCancelled = true;
+                    continue;
+                }
+            }
+            Respond(*poConnection, nullptr, FormatStatus(oRequest.uiId, "error", "No request in progress with this id."));
+            continue;
+        }
+
+        // Queue the request, unless the client has one with the same id or the queue is full.
+        shared_ptr<Job> poJob = make_shared<Job>();
+        poJob->oRequest = oRequest;
+        poJob->poConnection = poConnection;
+        {
+            lock_guard<mutex> oConnectionLock(poConnection->oMutex);
+            if (any_of(poConnection->oJobs.begin(), poConnection->oJobs.end(),
+                [&oRequest](const shared_ptr<Job>& kpoJob) { return kpoJob->oRequest.uiId == oRequest.uiId; }))
+            {
+                sResponse = FormatStatus(oRequest.uiId, "error", "A request with this id is in progress.");
+            }
+            else
+            {
+                lock_guard<mutex> oLock(moMutex);
+                if (moQueue.size() >= muiQueueSize)
+                {
+                    sResponse = FormatStatus(oRequest.uiId, "busy");
+                    muiRejected++;
+                }
+                else
+                {
+                    moQueue.push_back(poJob);
+                    poConnection->oJobs.push_back(poJob);
+                }
+            }
+        }
+
+        if (sResponse.empty())
+        {
+            moQueueChanged.notify_one();
+        }
+        else
+        {
+            Respond(*poConnection, nullptr, sResponse);
+        }
+    }
+
+    // The requests of a client gone are cancelled.
+    {
+        lock_guard<mutex> oLock(poConnection->oMutex);
+        for (const shared_ptr<Job>& kpoJob : poConnection->oJobs)
+        {
+            kpoJob->bCancelled = true;
+        }
+    }
+
+    lock_guard<mutex> oLock(moMutex);
+    muiClients--;
+    moClientsChanged.notify_all();
+}
+
+void SimulationService::Work()
+{
+    // The pool keeps the blocks of the world arenas for the next worlds of the thread.
+    CountingMemoryResource oSystemMemory;
+    pmr::unsynchronized_pool_resource oMemory(pmr::pool_options{ 0, kuiLargestPooledBlock }, &oSystemMemory);
+
+    for (;;)
+    {
+        // Take the next request, the ones waiting when the service stops are cancelled, until the clients are gone.
+        shared_ptr<Job> poJob;
+        {
+            unique_lock<mutex> oLock(moMutex);
+            moQueueChanged.wait(oLock, [this]() { return !moQueue.empty() || (mbStopping && muiClients == 0); });
+            if (moQueue.empty())
+            {
+                return;
+            }
+            poJob = moQueue.front();
+            moQueue.pop_front();
+        }
+
+        const uint64_t kuiId = poJob->oRequest.uiId;
+        const uint64_t kuiAllocations = oSystemMemory.GetAllocations();
+        string sResponse;
+        try
+        {
+            string sResult = !poJob->bCancelled && !mbStopping ? RunJob(*poJob, &oMemory) : string();
+            if (!sResult.empty())
+            {
+                sResponse = "{\"id\":" + to_string(kuiId) + ",\"status\":\"ok\",\"result\":" + sResult + '}';
+                muiCompleted++;
+            }
+            else
+            {
+                sResponse = FormatStatus(kuiId, "cancelled");
+                muiCancelled++;
+            }
+        }
+        catch (const std::exception& oError)
+        {
+            sResponse = FormatStatus(kuiId, "error", oError.what());
+        }
+        muiSystemAllocations += oSystemMemory.GetAllocations() - kuiAllocations;
+
+        Respond(*poJob->poConnection, poJob.get(), sResponse);
+    }
+}
+
+string SimulationService::RunJob(const Job& koJob, pmr::memory_resource* poMemory) const
+{
+    const SimulationRequest& koRequest = koJob.oRequest;
+    Scenario oScenario;
+    oScenario.SetChargersCount(koRequest.uiChargers);
+    oScenario.SetSeed(koRequest.uiSeed);
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        oScenario.AddAircrafts(static_cast<AircraftCompany>(i), koRequest.auiAircrafts[i], 1.0f, AircraftState::Idle);
+    }
+
+    // Run the world by slices, to see the cancellation.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(oScenario, koRequest.fSitePowerCap, poMemory);
+    oWorld.Start(koRequest.fHours);
+    while (!oWorld.IsFinished())
+    {
+        if (koJob.bCancelled || mbStopping)
+        {
+            return string();
+        }
+        oWorld.Step(kuiEventsPerCancelCheck);
+    }
+
+    // The run as a JSON line, without its line end.
+    ostringstream oResult;
+    {
+        JsonStatisticsWriter oWriter(oResult);
+        oWorld.ExportStatistics(oWriter);
+    }
+    string sResult = oResult.str();
+    while (!sResult.empty() && sResult.back() == '\n')
+    {
+        sResult.pop_back();
+    }
+    return sResult;
+}
+
+void SimulationService::Respond(Connection& oConnection, const Job* poJob, const string& sResponse)
+{
+    lock_guard<mutex> oLock(oConnection.oMutex);
+    if (poJob != nullptr)
+    {
+        oConnection.oJobs.erase(find_if(oConnection.oJobs.begin(), oConnection.oJobs.end(),
+            [poJob](const shared_ptr<Job>& kpoJob) { return kpoJob.get() == poJob; }));
+    }
+
+    // A client gone does not get the response.
+    oConnection.oSocket.SendLine(sResponse);
+}
@@ -0,0 +1,201 @@
+/**
+ * @brief Contains tests for the SimulationService and LoadClient classes.
+ *
+*/
+
+#include "SimulationService.h"
+#include "LoadClient.h"
+#include "worlds/Scenario.h"
+#include "worlds/SimpleWorld/World.h"
+#include "worlds/StatisticsWriter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+// Run a service in a thread for the time of a test.
+class ServiceThread
+{
+public:
+    ServiceThread(SimulationService& oService, const string& ksName)
+        : moService(oService),
+          msAddress("unix:" + (filesystem::temp_directory_path() / ("evtol_" + ksName + ".sock")).string())
+    {
+        moService.Listen(msAddress);
+        moThread = thread(&SimulationService::Run, &moService);
+    }
+
+    ~ServiceThread()
+    {
+        moService.Stop();
+        moThread.join();
+    }
+
+    const string& GetAddress() const { return msAddress; }
+
+private:
+    SimulationService& moService;
+    string msAddress;
+    thread moThread;
+};
+
+// Test the SimulationService::ParseRequest() and SimulationService::FormatRequest() methods.
+// Check a request is read back from its line, and the invalid lines are rejected.
+TEST_CASE( "SimulationService::ParseRequest" )
+{
+    SimulationRequest oRequest;
+    oRequest.uiId = 12;
+    oRequest.fHours = 2.7f;
+    oRequest.uiSeed = 99;
+    oRequest.uiChargers = 5;
+    oRequest.auiAircrafts[3] = 0;
+    oRequest.fSitePowerCap = 150.3f;
+
+    SimulationRequest oRead;
+    REQUIRE(SimulationService::ParseRequest(SimulationService::FormatRequest(oRequest), oRead));
+    REQUIRE(oRead.uiId == 12);
+    REQUIRE(!oRead.bCancel);
+    REQUIRE(oRead.fHours == 2.7f);
+    REQUIRE(oRead.uiSeed == 99);
+    REQUIRE(oRead.uiChargers == 5);
+    REQUIRE(oRead.auiAircrafts[3] == 0);
+    REQUIRE(oRead.auiAircrafts[4] == 4);
+    REQUIRE(oRead.fSitePowerCap == 150.3f);
+
+    // Only the id is required.
+    SimulationRequest oDefaults;
+    REQUIRE(SimulationService::ParseRequest(" { \"id\" : 3 } ", oDefaults));
+    REQUIRE(oDefaults.uiId == 3);
+    REQUIRE(oDefaults.fHours == 3);
+    REQUIRE(SimulationService::ParseRequest("{\"cancel\":3}", oDefaults));
+    REQUIRE(oDefaults.bCancel);
+
+    const char* const kapcInvalid[] = {
+        "", "{}", "{\"hours\":1}", "{\"id\":1", "{\"id\":1}x", "{\"id\":-1}", "{\"id\":1,\"hours\":0}",
+        "{\"id\":1,\"hours\":1e40}", "{\"id\":1,\"site_power\":-5}", "{\"id\":1,\"wind\":3}",
+        "{\"id\":1,\"aircrafts\":[1,2,3,4]}", "{\"id\":1,\"aircrafts\":[100000,1,0,0,0]}", "{\"id\":1,\"chargers\":100001}"
+    };
+    for (const char* kpcLine : kapcInvalid)
+    {
+        SimulationRequest oInvalid;
+        INFO(kpcLine);
+        REQUIRE(!SimulationService::ParseRequest(kpcLine, oInvalid));
+    }
+}
+
+// Test the SimulationService::Run() method.
+// Check a result is the run of the world alone, and the warm workers do not ask the system for memory.
+TEST_CASE( "SimulationService::Run" )
+{
+    SimulationRequest oRequest;
+    oRequest.uiId = 1;
+    oRequest.uiSeed = 42;
+    oRequest.uiChargers = 2;
+
+    // The statistics of the world run alone.
+    Scenario oScenario;
+    oScenario.SetChargersCount(2);
+    oScenario.SetSeed(42);
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        oScenario.AddAircrafts(static_cast<AircraftCompany>(i), oRequest.auiAircrafts[i], 1.0f, AircraftState::Idle);
+    }
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(oScenario);
+    oWorld.RunSimulation(3);
+    ostringstream oExpected;
+    {
+        JsonStatisticsWriter oWriter(oExpected);
+        oWorld.ExportStatistics(oWriter);
+    }
+    string sExpected = oExpected.str();
+    sExpected.pop_back();
+
+    SimulationService oService(1);
+    ServiceThread oThread(oService, "service");
+    Socket oConnection = Socket::Connect(oThread.GetAddress());
+    string sLine;
+    for (uint64_t uiId = 1; uiId <= 2; uiId++)
+    {
+        oRequest.uiId = uiId;
+        REQUIRE(oConnection.SendLine(SimulationService::FormatRequest(oRequest)));
+        REQUIRE(oConnection.ReceiveLine(sLine));
+        REQUIRE(sLine == "{\"id\":" + to_string(uiId) + ",\"status\":\"ok\",\"result\":" + sExpected + "}");
+
+        // The first world warms the pool of the worker.
+        const uint64_t kuiAllocations = oService.GetSystemAllocations();
+        REQUIRE(kuiAllocations > 0);
+        if (uiId == 2)
+        {
+            REQUIRE(oService.GetSystemAllocations() == kuiAllocations);
+        }
+    }
+
+    REQUIRE(oConnection.SendLine("{\"id\":7,\"hours\":-1}"));
+    REQUIRE(oConnection.ReceiveLine(sLine));
+    REQUIRE(sLine.find("\"status\":\"error\"") != string::npos);
+    REQUIRE(oService.GetCompletedCount() == 2);
+}
+
+// Test the SimulationService::Run() method with a full queue and cancellations.
+// Check the requests over the queue are rejected as busy, and a cancelled request is answered as such.
+TEST_CASE( "SimulationService::Run busy" )
+{
+    SimulationService oService(1, 1);
+    ServiceThread oThread(oService, "busy");
+    Socket oConnection = Socket::Connect(oThread.GetAddress());
+
+    // A long run keeps the worker, the next request waits in the queue, the third one is rejected.
+    SimulationRequest oRequest;
+    oRequest.fHours = 1e6f;
+    oRequest.uiSeed = 1;
+    for (uint64_t uiId = 1; uiId <= 3; uiId++)
+    {
+        oRequest.uiId = uiId;
+        REQUIRE(oConnection.SendLine(SimulationService::FormatRequest(oRequest)));
+        if (uiId == 1)
+        {
+            // Wait for the worker to take the first request.
+            this_thread::sleep_for(chrono::milliseconds(200));
+        }
+    }
+    string sLine;
+    REQUIRE(oConnection.ReceiveLine(sLine));
+    REQUIRE(sLine == "{\"id\":3,\"status\":\"busy\"}");
+
+    // The cancellation of a request not in progress fails.
+    REQUIRE(oConnection.SendLine("{\"cancel\":3}"));
+    REQUIRE(oConnection.ReceiveLine(sLine));
+    REQUIRE(sLine.find("\"status\":\"error\"") != string::npos);
+
+    REQUIRE(oConnection.SendLine("{\"cancel\":2}"));
+    REQUIRE(oConnection.SendLine("{\"cancel\":1}"));
+    REQUIRE(oConnection.ReceiveLine(sLine));
+    REQUIRE(sLine == "{\"id\":1,\"status\":\"cancelled\"}");
+    REQUIRE(oConnection.ReceiveLine(sLine));
+    REQUIRE(sLine == "{\"id\":2,\"status\":\"cancelled\"}");
+    REQUIRE(oService.GetRejectedCount() == 1);
+    REQUIRE(oService.GetCancelledCount() == 2);
+}
+
+// Test the LoadClient::Run() method.
+// Check all the requests complete, some of them after being rejected as busy.
+TEST_CASE( "LoadClient::Run" )
+{
+    SimulationService oService(2, 2);
+    ServiceThread oThread(oService, "load");
+
+    SimulationRequest oTemplate;
+    oTemplate.fHours = 100;
+    oTemplate.uiSeed = 5;
+    LoadReport oReport = LoadClient(oThread.GetAddress(), oTemplate).Run(20, 8);
+    REQUIRE(oReport.uiCompleted == 20);
+    REQUIRE(oReport.uiErrors == 0);
+    REQUIRE(oReport.uiBusy > 0);
+    REQUIRE(oReport.fP50 > 0);
+    REQUIRE(oReport.fP50 <= oReport.fP99);
+    REQUIRE(oReport.fP99 <= oReport.fMax);
+    REQUIRE(oService.GetCompletedCount() == 20);
+}
@@ -0,0 +1,240 @@
+#ifndef _SIMULATION_SERVICE_H_
+#define _SIMULATION_SERVICE_H_
+
+#include "aircrafts/AircraftType.h"
+#include "utils/Socket.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief A request to the simulation service, to run a world or to cancel
+ *        the run of another request.
+ *
+ */
+struct SimulationRequest
+{
+    uint64_t uiId = 0;                  ///< The id chosen by the client, unique among its requests in progress.
+    bool bCancel = false;               ///< If the request cancels the request with the id instead of running.
+    float fHours = 3;                   ///< The simulation time in hours, fractional.
+    uint32_t uiSeed = 0;                ///< The random seed, 0 for the current time.
+    uint32_t uiChargers = 3;            ///< The number of chargers.
+    uint32_t auiAircrafts[(size_t)AircraftCompany::TotalCompanies] = { 4, 4, 4, 4, 4 }; ///< The idle aircrafts per company.
+    float fSitePowerCap = 0;            ///< The power cap in kW shared by the chargers, 0 for unlimited.
+};
+
+/**
+ * @brief A long lived service running the simulation requests of local
+ *        clients on a pool of threads, so the clients running many worlds do
+ *        not pay the start of a process and cold memory for each one.
+ *
+ * @note  Every client connection is served by its own thread, which reads
+ *        its requests into a queue of kuiDefaultQueueSize requests at most,
+ *        shared by all the clients. A request arriving with the queue full is
+ *        rejected at once as busy, for the client to send it again later. The
+ *        worker threads run the requests in order, each one in a quiet event
+ *        driven world whose arena takes its memory from a pool kept by the
+ *        thread, so once warm the worlds do not ask the system for memory.
+ *        A run checks if it was cancelled every kuiEventsPerCancelCheck
+ *        events, and the requests of a client that disconnects are cancelled.
+ *        The results are sent by the workers as they finish, in any order.
+ *
+ *        The protocol is made of JSON objects, one per line:
+ *        - Client: {"id":1,"hours":3,"seed":42,"chargers":3,
+ *          "aircrafts":[4,4,4,4,4],"site_power":0}, every field but the id
+ *          is optional, or {"cancel":1} to cancel the request 1.
+ *        - Service: {"id":1,"status":"ok","result":{...}} with the run in the
+ *          JSON statistics format, or a "status" of "busy", "cancelled" or
+ *          "error" with a "message".
+ *
+ */
+class SimulationService
+{
+public:
+    /********** Constants **********/
+
+    static constexpr size_t kuiDefaultQueueSize = 64;          ///< The requests waiting for a worker by default.
+    static constexpr uint64_t kuiEventsPerCancelCheck = 4096;  ///< The events run between the checks of a cancellation.
+    static constexpr uint32_t kuiMaxFleetSize = 100000;        ///< The most aircrafts, or chargers, of a request.
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Simulation Service object.
+     *
+     * @param uiThreads     The number of worker threads, 0 for one per hardware thread.
+     * @param uiQueueSize   The requests waiting for a worker at most, at least 1.
+     */
+    SimulationService(uint32_t uiThreads = 0, size_t uiQueueSize = kuiDefaultQueueSize);
+
+    SimulationService(const SimulationService&) = delete;
+    SimulationService& operator=(const SimulationService&) = delete;
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of requests run to their end.
+     *
+     * @return The number of requests.
+     */
+    inline uint64_t GetCompletedCount() const { return muiCompleted; }
+
+    /**
+     * @brief Get the number of requests rejected because the queue was full.
+     *
+     * @return The number of requests.
+     */
+    inline uint64_t GetRejectedCount() const { return muiRejected; }
+
+    /**
+     * @brief Get the number of requests cancelled, by their client or by its
+     *        disconnection.
+     *
+     * @return The number of requests.
+     */
+    inline uint64_t GetCancelledCount() const { return muiCancelled; }
+
+    /**
+     * @brief Get the number of allocations the worlds asked to the system,
+     *        the ones of the worker pools.
+     *
+     * @return The number of allocations.
+     */
+    inline uint64_t GetSystemAllocations() const { return muiSystemAllocations; }
+
+
+    /********** Static Methods **********/
+
+    /**
+     * @brief Parse a request line.
+     *
+     * @param sLine     The JSON object of the request.
+     * @param oRequest  Gets the request, the fields not in the line keep their value.
+     *
+     * @return If the line is a valid request.
+     */
+    static bool ParseRequest(string_view sLine, SimulationRequest& oRequest);
+
+    /**
+     * @brief Format a request as a line.
+     *
+     * @param koRequest The request.
+     *
+     * @return The JSON object of the request.
+     */
+    static string FormatRequest(const SimulationRequest& koRequest);
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Listen for the clients at an address, before running.
+     *
+     * @param sAddress  The address, see Socket.
+     *
+     * @throw std::runtime_error if the address cannot be used.
+     */
+    void Listen(const string& sAddress);
+
+    /**
+     * @brief Serve the clients until stopped, then cancel the requests
+     *        waiting and wait for the ones running.
+     *
+     * @throw std::runtime_error if not listening.
+     */
+    void Run();
+
+    /**
+     * @brief Stop serving, from any thread or a signal handler.
+     *
+     */
+    inline void Stop() { mbStopping = true; }
+
+private:
+    /********** Types **********/
+
+    struct Job;
+
+    // A client connection, shared by its thread and the workers running its requests.
+    struct Connection
+    {
+        Socket oSocket;                         // The connection, its thread receives and the workers send.
+        mutex oMutex;                           // Guards the sends and the requests below.
+        vector<shared_ptr<Job>> oJobs;          // The requests waiting or running.
+    };
+
+    // A request waiting for a worker or running.
+    struct Job
+    {
+        SimulationRequest oRequest;             // The request.
+        shared_ptr<Connection> poConnection;    // The connection of the client.
+        atomic<bool> bCancelled{ false };       // If the request was cancelled.
+    };
+
+    /********** Methods **********/
+
+    /**
+     * @brief Read the requests of a client until it disconnects or the
+     *        service stops, in the thread of the connection.
+     *
+     * @param poConnection  The connection of the client.
+     */
+    void Serve(shared_ptr<Connection> poConnection);
+
+    /**
+     * @brief Run the requests of the queue until the service stops, in a
+     *        worker thread.
+     *
+     */
+    void Work();
+
+    /**
+     * @brief Run the world of a request.
+     *
+     * @param koJob     The request.
+     * @param poMemory  The memory of the worker for the world arena.
+     *
+     * @return The run in the JSON statistics format, empty if cancelled.
+     */
+    string RunJob(const Job& koJob, pmr::memory_resource* poMemory) const;
+
+    /**
+     * @brief Send a response to a client, and forget its request.
+     *
+     * @param oConnection   The connection of the client.
+     * @param poJob         The request to forget, or nullptr.
+     * @param sResponse     The response line.
+     */
+    static void Respond(Connection& oConnection, const Job* poJob, const string& sResponse);
+
+    /********** Variables **********/
+
+    uint32_t muiThreads;                    // The number of worker threads.
+    size_t muiQueueSize;                    // The requests waiting at most.
+    Socket moListener;                      // The socket listening for clients.
+    atomic<bool> mbStopping;                // If the service is stopping.
+    atomic<uint64_t> muiCompleted;          // The requests run to their end.
+    atomic<uint64_t> muiRejected;           // The requests rejected with the queue full.
+    atomic<uint64_t> muiCancelled;          // The requests cancelled.
+    atomic<uint64_t> muiSystemAllocations;  // The allocations of the worker pools.
+
+    mutex moMutex;                          // Guards the variables below.
+    condition_variable moQueueChanged;      // Notified when a request is queued or the service stops.
+    condition_variable moClientsChanged;    // Notified when a client disconnects.
+    deque<shared_ptr<Job>> moQueue;         // The requests waiting for a worker.
+    uint32_t muiClients;                    // The clients connected, served by their own thread.
+};
+
+#endif // _SIMULATION_SERVICE_H_
@@ -0,0 +1,38 @@
+/**
+ * @brief Implementation of the CountingMemoryResource class.
+ * 
+ */
+
+#include "CountingMemoryResource.h"
+
+CountingMemoryResource::CountingMemoryResource(pmr::memory_resource* poUpstream)
+    : mpoUpstream(poUpstream),
+      muiAllocations(0),
+      muiDeallocations(0),
+      muiBytesInUse(0)
+{
+    // Nothing to do here.
+}
+
+void* CountingMemoryResource::do_allocate(size_t uiBytes, size_t uiAlignment)
+{
+    void* pvMemory = mpoUpstream->allocate(uiBytes, uiAlignment);
+
+    ++muiAllocations;
+    muiBytesInUse += uiBytes;
+
+    return pvMemory;
+}
+
+void CountingMemoryResource::do_deallocate(void* pvMemory, size_t uiBytes, size_t uiAlignment)
+{
+    mpoUpstream->deallocate(pvMemory, uiBytes, uiAlignment);
+
+    ++muiDeallocations;
+    muiBytesInUse -= uiBytes;
+}
+
+bool CountingMemoryResource::do_is_equal(const pmr::memory_resource& oOther) const noexcept
+{
+    return this == &oOther;
+}
@@ -0,0 +1,70 @@
+#ifndef _COUNTING_MEMORY_RESOURCE_H_
+#define _COUNTING_MEMORY_RESOURCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+using namespace std;
+
+/**
+ * @brief A memory resource that counts the allocations forwarded to its
+ *        upstream resource.
+ * 
+ * @note  Used as the upstream of the world arenas, so the count shows how
+ *        many times the world had to ask the system for memory.
+ * 
+ */
+class CountingMemoryResource : public pmr::memory_resource
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Counting Memory Resource object.
+     * 
+     * @param poUpstream    The resource to forward the allocations to.
+     */
+    explicit CountingMemoryResource(pmr::memory_resource* poUpstream = pmr::new_delete_resource());
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of allocations.
+     * 
+     * @return The number of allocations.
+     */
+    inline uint64_t GetAllocations() const { return muiAllocations; }
+
+    /**
+     * @brief Get the number of deallocations.
+     * 
+     * @return The number of deallocations.
+     */
+    inline uint64_t GetDeallocations() const { return muiDeallocations; }
+
+    /**
+     * @brief Get the number of bytes allocated and not deallocated yet.
+     * 
+     * @return The number of bytes in use.
+     */
+    inline uint64_t GetBytesInUse() const { return muiBytesInUse; }
+
+protected:
+    /********** Methods **********/
+
+    void* do_allocate(size_t uiBytes, size_t uiAlignment) override;
+    void do_deallocate(void* pvMemory, size_t uiBytes, size_t uiAlignment) override;
+    bool do_is_equal(const pmr::memory_resource& oOther) const noexcept override;
+
+private:
+    /********** Variables **********/
+
+    pmr::memory_resource* mpoUpstream; // The resource to forward the allocations to.
+    uint64_t muiAllocations;           // The number of allocations.
+    uint64_t muiDeallocations;         // The number of deallocations.
+    uint64_t muiBytesInUse;            // The number of bytes allocated and not deallocated yet.
+};
+
+#endif // _COUNTING_MEMORY_RESOURCE_H_
@@ -0,0 +1,83 @@
+/**
+ * @brief Contains tests for the LockFreeQueue class.
+ *
+*/
+
+#include "LockFreeQueue.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+#include <vector>
+
+// Test the LockFreeQueue::TryPush() and LockFreeQueue::TryPop() methods.
+// Check the queue is bounded and keeps the order over many laps of its ring.
+TEST_CASE( "LockFreeQueue::TryPush" )
+{
+    LockFreeQueue<int> oQueue(3);
+    REQUIRE(oQueue.GetCapacity() == 4);
+
+    int iValue = 0;
+    REQUIRE(!oQueue.TryPop(iValue));
+    for (int iLap = 0; iLap < 10; iLap++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            REQUIRE(oQueue.TryPush(iLap * 4 + i));
+        }
+        REQUIRE(!oQueue.TryPush(-1));
+        for (int i = 0; i < 4; i++)
+        {
+            REQUIRE(oQueue.TryPop(iValue));
+            REQUIRE(iValue == iLap * 4 + i);
+        }
+        REQUIRE(!oQueue.TryPop(iValue));
+    }
+}
+
+// Test the LockFreeQueue class with many producers.
+// Check every value pushed is popped once, in the order of its producer.
+TEST_CASE( "LockFreeQueue producers" )
+{
+    const uint32_t kuiProducers = 4;
+    const uint32_t kuiValues = 20000;
+    LockFreeQueue<uint32_t> oQueue(64);
+
+    vector<thread> oProducers;
+    for (uint32_t uiProducer = 0; uiProducer < kuiProducers; uiProducer++)
+    {
+        oProducers.emplace_back([&oQueue, uiProducer, kuiValues]()
+        {
+            for (uint32_t i = 0; i < kuiValues; i++)
+            {
+                while (!oQueue.TryPush(uiProducer * kuiValues + i))
+                {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // The values of a producer come in order.
+    vector<uint32_t> auiNext(kuiProducers, 0);
+    uint32_t uiPopped = 0;
+    bool bOrdered = true;
+    while (uiPopped < kuiProducers * kuiValues)
+    {
+        uint32_t uiValue = 0;
+        if (oQueue.TryPop(uiValue))
+        {
+            uint32_t uiProducer = uiValue / kuiValues;
+            bOrdered = bOrdered && uiValue % kuiValues == auiNext[uiProducer];
+            auiNext[uiProducer]++;
+            uiPopped++;
+        }
+    }
+    for (thread& oProducer : oProducers)
+    {
+        oProducer.join();
+    }
+
+    REQUIRE(bOrdered);
+    REQUIRE(auiNext == vector<uint32_t>(kuiProducers, kuiValues));
+}
@@ -0,0 +1,172 @@
+#ifndef _LOCK_FREE_QUEUE_H_
+#define _LOCK_FREE_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+/**
+ * @brief A bounded queue that many threads push to and pop from without
+ *        locks, so a thread running the simulation is never blocked by the
+ *        threads posting to it (Vyukov's bounded queue).
+ *
+ * @note  The values live in a ring of cells allocated once, each with a
+ *        sequence number telling whether it holds a value to pop or is free
+ *        for the push of a lap of the ring. A push or a pop claims its
+ *        position with a compare and swap, then publishes the cell with a
+ *        release store of its sequence, so the value is visible to the
+ *        thread that acquires it. A full queue fails the push instead of
+ *        waiting, the producer decides to drop or to retry.
+ *
+ * @tparam T    The type of the values, copyable or movable.
+ */
+template <class T>
+class LockFreeQueue
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Lock Free Queue object.
+     *
+     * @param uiCapacity    The values the queue holds at most, rounded up to a
+     *                      power of two, at least 2.
+     */
+    explicit LockFreeQueue(size_t uiCapacity)
+        : muiMask(RoundCapacity(uiCapacity) - 1),
+          mpoCells(new Cell[muiMask + 1]),
+          muiPushPosition(0),
+          muiPopPosition(0)
+    {
+        for (size_t i = 0; i <= muiMask; i++)
+        {
+            mpoCells[i].uiSequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the values the queue holds at most.
+     *
+     * @return The capacity.
+     */
+    inline size_t GetCapacity() const { return muiMask + 1; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Push a value, from any thread.
+     *
+     * @param oValue    The value, moved into the queue if it is pushed.
+     *
+     * @return If the value was pushed, false if the queue is full.
+     */
+    bool TryPush(T oValue)
+    {
+        size_t uiPosition = muiPushPosition.load(memory_order_relaxed);
+        for (;;)
+        {
+            Cell& oCell = mpoCells[uiPosition & muiMask];
+            size_t uiSequence = oCell.uiSequence.load(memory_order_acquire);
+            intptr_t iDifference = static_cast<intptr_t>(uiSequence) - static_cast<intptr_t>(uiPosition);
+            if (iDifference == 0)
+            {
+                // The cell is free for this lap, claim it.
+                if (muiPushPosition.compare_exchange_weak(uiPosition, uiPosition + 1, memory_order_relaxed))
+                {
+                    oCell.oValue = std::move(oValue);
+                    oCell.uiSequence.store(uiPosition + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (iDifference < 0)
+            {
+                // The cell still holds the value of the previous lap.
+                return false;
+            }
+            else
+            {
+                // Another thread pushed here, try the next position.
+                uiPosition = muiPushPosition.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Pop the oldest value, from any thread.
+     *
+     * @param oValue    Gets the value.
+     *
+     * @return If a value was popped, false if the queue is empty.
+     */
+    bool TryPop(T& oValue)
+    {
+        size_t uiPosition = muiPopPosition.load(memory_order_relaxed);
+        for (;;)
+        {
+            Cell& oCell = mpoCells[uiPosition & muiMask];
+            size_t uiSequence = oCell.uiSequence.load(memory_order_acquire);
+            intptr_t iDifference = static_cast<intptr_t>(uiSequence) - static_cast<intptr_t>(uiPosition + 1);
+            if (iDifference == 0)
+            {
+                // The cell holds a value, claim it and free the cell for the next lap.
+                if (muiPopPosition.compare_exchange_weak(uiPosition, uiPosition + 1, memory_order_relaxed))
+                {
+                    oValue = std::move(oCell.oValue);
+                    oCell.uiSequence.store(uiPosition + muiMask + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (iDifference < 0)
+            {
+                // The cell has no value yet.
+                return false;
+            }
+            else
+            {
+                // Another thread popped here, try the next position.
+                uiPosition = muiPopPosition.load(memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    // The cache line size, to keep the positions of the producers and the consumers apart.
+    static constexpr size_t kuiCacheLine = 64;
+
+    // A value with the sequence telling its state.
+    struct Cell
+    {
+        atomic<size_t> uiSequence;  // The position of the push that may use the cell, or that position + 1 once pushed.
+        T oValue;                   // The value.
+    };
+
+    // Round a capacity up to a power of two.
+    static size_t RoundCapacity(size_t uiCapacity)
+    {
+        size_t uiRounded = 2;
+        while (uiRounded < uiCapacity)
+        {
+            uiRounded <<= 1;
+        }
+        return uiRounded;
+    }
+
+    /********** Variables **********/
+
+    const size_t muiMask;                                   // The capacity - 1, to wrap the positions.
+    unique_ptr<Cell[]> mpoCells;                            // The ring of cells.
+    alignas(kuiCacheLine) atomic<size_t> muiPushPosition;   // The next position to push to.
+    alignas(kuiCacheLine) atomic<size_t> muiPopPosition;    // The next position to pop from.
+};
+
+#endif // _LOCK_FREE_QUEUE_H_
@@ -0,0 +1,102 @@
+/**
+ * @brief Implementation of the MappedFile class.
+ *
+ */
+
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const string& sPath)
+    : mpcData(nullptr),
+      muiSize(0)
+{
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA(sPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Cannot open the file " + sPath + ".");
+    }
+
+    LARGE_INTEGER oSize;
+    if (!GetFileSizeEx(hFile, &oSize))
+    {
+        CloseHandle(hFile);
+        throw std::runtime_error("Cannot get the size of the file " + sPath + ".");
+    }
+    muiSize = static_cast<size_t>(oSize.QuadPart);
+
+    // An empty file cannot be mapped, it has no contents anyway.
+    if (muiSize > 0)
+    {
+        // The view keeps the mapping alive after closing the handles.
+        HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* pvData = hMapping != nullptr ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (hMapping != nullptr)
+        {
+            CloseHandle(hMapping);
+        }
+        if (pvData == nullptr)
+        {
+            CloseHandle(hFile);
+            throw std::runtime_error("Cannot map the file " + sPath + ".");
+        }
+        mpcData = static_cast<const char*>(pvData);
+    }
+
+    CloseHandle(hFile);
+#else
+    int iFile = open(sPath.c_str(), O_RDONLY);
+    if (iFile < 0)
+    {
+        throw std::runtime_error("Cannot open the file " + sPath + ".");
+    }
+
+    struct stat oStat;
+    if (fstat(iFile, &oStat) != 0)
+    {
+        close(iFile);
+        throw std::runtime_error("Cannot get the size of the file " + sPath + ".");
+    }
+    muiSize = static_cast<size_t>(oStat.st_size);
+
+    // An empty file cannot be mapped, it has no contents anyway.
+    if (muiSize > 0)
+    {
+        // The mapping stays valid after closing the file.
+        void* pvData = mmap(nullptr, muiSize, PROT_READ, MAP_PRIVATE, iFile, 0);
+        if (pvData == MAP_FAILED)
+        {
+            close(iFile);
+            throw std::runtime_error("Cannot map the file " + sPath + ".");
+        }
+        mpcData = static_cast<const char*>(pvData);
+
+        // The file is read from the start to the end.
+        madvise(pvData, muiSize, MADV_SEQUENTIAL);
+    }
+
+    close(iFile);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    if (mpcData != nullptr)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mpcData);
+#else
+        munmap(const_cast<char*>(mpcData), muiSize);
+#endif
+    }
+}
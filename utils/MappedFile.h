@@ -0,0 +1,66 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief A file mapped read-only in memory, unmapped when destroyed.
+ *
+ * @note  The pages are loaded by the system when they are first read, so
+ *        opening a large file is immediate and only the parts used are read.
+ *
+ */
+class MappedFile
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Map a file in memory.
+     *
+     * @param sPath     The path of the file.
+     *
+     * @throw std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const string& sPath);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+
+    /********** Destructor **********/
+
+    /**
+     * @brief Unmap the file.
+     *
+     */
+    ~MappedFile();
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the file contents.
+     *
+     * @return The first byte of the file, nullptr if the file is empty.
+     */
+    inline const char* GetData() const { return mpcData; }
+
+    /**
+     * @brief Get the file size.
+     *
+     * @return The size in bytes.
+     */
+    inline size_t GetSize() const { return muiSize; }
+
+private:
+    /********** Variables **********/
+
+    const char* mpcData; // The file contents.
+    size_t muiSize;      // The file size in bytes.
+};
+
+#endif // _MAPPED_FILE_H_
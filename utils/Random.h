@@ -0,0 +1,111 @@
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+#include <cstdint>
+
+/**
+ * @brief A reversible linear congruential random number generator.
+ *
+ * @note  Unlike rand(), every draw can be undone by stepping the generator
+ *        backwards, so event handlers that consume random numbers can be
+ *        reverted exactly (reverse computation) without saving the state.
+ *
+ */
+class ReversibleRandom
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Reversible Random object.
+     *
+     * @param uiSeed    The initial state of the generator.
+     */
+    explicit ReversibleRandom(uint32_t uiSeed = 1) : muiState(uiSeed) {}
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Set the state of the generator.
+     *
+     * @param uiSeed    The new state of the generator.
+     */
+    inline void Seed(uint32_t uiSeed) { muiState = uiSeed; }
+
+    /**
+     * @brief Advance the generator and get the new draw.
+     *
+     * @return A random number in the range [0, 1).
+     */
+    inline float Next()
+    {
+        muiState = kuiMultiplier * muiState + kuiIncrement;
+        return Current();
+    }
+
+    /**
+     * @brief Get the last draw again without advancing the generator.
+     *
+     * @return The last random number returned by Next().
+     */
+    inline float Current() const
+    {
+        // Use the 24 most significant bits, which are the most random ones
+        // and fit exactly in the float mantissa.
+        return (muiState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * @brief Undo the last draw, restoring the state previous to Next().
+     *
+     */
+    inline void Previous()
+    {
+        muiState = kuiInverseMultiplier * (muiState - kuiIncrement);
+    }
+
+private:
+    /********** Constants **********/
+
+    static constexpr uint32_t kuiMultiplier = 1664525u;
+    static constexpr uint32_t kuiIncrement = 1013904223u;
+    static constexpr uint32_t kuiInverseMultiplier = 4276115653u; // kuiMultiplier^-1 mod 2^32.
+
+    static_assert(kuiMultiplier * kuiInverseMultiplier == 1u, "Invalid inverse multiplier.");
+
+    /********** Variables **********/
+
+    uint32_t muiState; // The current state of the generator.
+};
+
+/**
+ * @brief Get a counter-based random number, a hash of the seed, the stream
+ *        and the counter.
+ *
+ * @note  The draw only depends on its key and not on the draws before it,
+ *        so two worlds with the same seed get the same number for the same
+ *        stream and counter, whatever the order of their events.
+ *
+ * @param uiSeed        The seed.
+ * @param uiStream      The stream, as an aircraft.
+ * @param uiCounter     The counter in the stream, as a flight of the aircraft.
+ *
+ * @return A random number in the range [0, 1).
+ */
+inline float CounterRandom(uint32_t uiSeed, uint32_t uiStream, uint32_t uiCounter)
+{
+    // SplitMix64 finalizer of the key, the 24 most significant bits fit the float mantissa.
+    uint64_t uiKey = (static_cast<uint64_t>(uiSeed) << 32 | uiStream) * 0x9E3779B97F4A7C15ull + uiCounter;
+    for (int i = 0; i < 2; i++)
+    {
+        uiKey ^= uiKey >> 30;
+        uiKey *= 0xBF58476D1CE4E5B9ull;
+        uiKey ^= uiKey >> 27;
+        uiKey *= 0x94D049BB133111EBull;
+        uiKey ^= uiKey >> 31;
+    }
+    return static_cast<uint32_t>(uiKey >> 40) * (1.0f / 16777216.0f);
+}
+
+#endif // _RANDOM_H_
@@ -0,0 +1,66 @@
+/**
+ * @brief Contains tests for the RunningStatistics class.
+ *
+*/
+
+#include "RunningStatistics.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+// Test the RunningStatistics::Add() method.
+// Check the mean and the sample variance, also for large values close to each other.
+TEST_CASE( "RunningStatistics::Add" )
+{
+    RunningStatistics oStatistics;
+    REQUIRE(oStatistics.GetCount() == 0);
+    REQUIRE(std::isinf(oStatistics.GetHalfWidth()));
+
+    for (double fValue : { 2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0 })
+    {
+        oStatistics.Add(1e9 + fValue);
+    }
+    REQUIRE(oStatistics.GetCount() == 8);
+    REQUIRE(abs(oStatistics.GetMean() - (1e9 + 5)) < 1e-6);
+    REQUIRE(abs(oStatistics.GetVariance() - 32.0 / 7) < 1e-6);
+
+    // The half-width with the t quantile of 7 degrees of freedom.
+    REQUIRE(abs(oStatistics.GetHalfWidth() - 2.365 * sqrt(32.0 / 7 / 8)) < 1e-6);
+}
+
+// Test the RunningStatistics::Merge() method.
+// Check merging the statistics of two halves is the same as adding all the values.
+TEST_CASE( "RunningStatistics::Merge" )
+{
+    RunningStatistics oAll, oFirst, oSecond;
+    for (int i = 0; i < 100; i++)
+    {
+        double fValue = (i * 37) % 11 + i * 0.5;
+        oAll.Add(fValue);
+        (i < 30 ? oFirst : oSecond).Add(fValue);
+    }
+
+    oFirst.Merge(oSecond);
+    REQUIRE(oFirst.GetCount() == oAll.GetCount());
+    REQUIRE(abs(oFirst.GetMean() - oAll.GetMean()) < 1e-9);
+    REQUIRE(abs(oFirst.GetVariance() - oAll.GetVariance()) < 1e-9);
+
+    // Merging nothing, or into nothing, changes nothing.
+    RunningStatistics oEmpty;
+    oFirst.Merge(oEmpty);
+    REQUIRE(oFirst.GetCount() == oAll.GetCount());
+    oEmpty.Merge(oAll);
+    REQUIRE(oEmpty.GetMean() == oAll.GetMean());
+}
+
+// Test the RunningStatistics::StudentQuantile975() method.
+// Check the expansion continues the table, and tends to the normal quantile.
+TEST_CASE( "RunningStatistics::StudentQuantile975" )
+{
+    REQUIRE(RunningStatistics::StudentQuantile975(1) == 12.706);
+    REQUIRE(abs(RunningStatistics::StudentQuantile975(31) - 2.040) < 0.001);
+    REQUIRE(abs(RunningStatistics::StudentQuantile975(60) - 2.000) < 0.001);
+    REQUIRE(abs(RunningStatistics::StudentQuantile975(120) - 1.980) < 0.001);
+    REQUIRE(abs(RunningStatistics::StudentQuantile975(1000000) - 1.960) < 0.001);
+}
@@ -0,0 +1,138 @@
+#ifndef _RUNNING_STATISTICS_H_
+#define _RUNNING_STATISTICS_H_
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief The mean and variance of a stream of values, updated one value at a
+ *        time with Welford's algorithm.
+ *
+ * @note  It keeps three numbers whatever the number of values, it does not
+ *        lose precision when the values are large and close to each other,
+ *        as the sum of squares does, and two of them can be merged, so each
+ *        thread or process can accumulate its own values.
+ *
+ */
+class RunningStatistics
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Running Statistics object without values.
+     *
+     */
+    RunningStatistics() : muiCount(0), mfMean(0), mfSquares(0) {}
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of values.
+     *
+     * @return The number of values.
+     */
+    inline uint64_t GetCount() const { return muiCount; }
+
+    /**
+     * @brief Get the mean of the values.
+     *
+     * @return The mean, 0 without values.
+     */
+    inline double GetMean() const { return mfMean; }
+
+    /**
+     * @brief Get the sample variance of the values.
+     *
+     * @return The variance, 0 with less than two values.
+     */
+    inline double GetVariance() const { return muiCount > 1 ? mfSquares / (muiCount - 1) : 0; }
+
+    /**
+     * @brief Get the half-width of the 95% confidence interval of the mean,
+     *        with the Student's t distribution.
+     *
+     * @return The half-width, infinite with less than two values.
+     */
+    inline double GetHalfWidth() const
+    {
+        return muiCount > 1 ? StudentQuantile975(muiCount - 1) * sqrt(GetVariance() / muiCount) : INFINITY;
+    }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Add a value.
+     *
+     * @param fValue    The value.
+     */
+    inline void Add(double fValue)
+    {
+        ++muiCount;
+        double fDelta = fValue - mfMean;
+        mfMean += fDelta / muiCount;
+        mfSquares += fDelta * (fValue - mfMean);
+    }
+
+    /**
+     * @brief Add the values of other statistics, as if they were added one
+     *        by one (Chan's parallel algorithm).
+     *
+     * @param koOther   The other statistics.
+     */
+    inline void Merge(const RunningStatistics& koOther)
+    {
+        if (koOther.muiCount == 0)
+        {
+            return;
+        }
+
+        uint64_t uiCount = muiCount + koOther.muiCount;
+        double fDelta = koOther.mfMean - mfMean;
+        mfMean += fDelta * koOther.muiCount / uiCount;
+        mfSquares += koOther.mfSquares + fDelta * fDelta * muiCount * koOther.muiCount / uiCount;
+        muiCount = uiCount;
+    }
+
+
+    /********** Static Methods **********/
+
+    /**
+     * @brief Get the 97.5% quantile of the Student's t distribution, for two
+     *        sided 95% confidence intervals.
+     *
+     * @param uiDegrees     The degrees of freedom, at least 1.
+     *
+     * @return The quantile, from a table up to 30 degrees and from the
+     *         Cornish-Fisher expansion above, within 0.001.
+     */
+    static inline double StudentQuantile975(uint64_t uiDegrees)
+    {
+        static const double kafQuantiles[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+        };
+        if (uiDegrees <= sizeof(kafQuantiles) / sizeof(kafQuantiles[0]))
+        {
+            return kafQuantiles[uiDegrees > 0 ? uiDegrees - 1 : 0];
+        }
+
+        const double kfZ = 1.959964;
+        const double kfZ3 = kfZ * kfZ * kfZ;
+        const double kfZ5 = kfZ3 * kfZ * kfZ;
+        const double kfDegrees = static_cast<double>(uiDegrees);
+        return kfZ + (kfZ3 + kfZ) / (4 * kfDegrees) + (5 * kfZ5 + 16 * kfZ3 + 3 * kfZ) / (96 * kfDegrees * kfDegrees);
+    }
+
+private:
+    /********** Variables **********/
+
+    uint64_t muiCount;  // The number of values.
+    double mfMean;      // The mean of the values.
+    double mfSquares;   // The sum of the squared differences to the mean.
+};
+
+#endif // _RUNNING_STATISTICS_H_
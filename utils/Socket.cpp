@@ -0,0 +1,271 @@
+/**
+ * @brief Implementation of the Socket class.
+ *
+ */
+
+#include "Socket.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int kiSendFlags = MSG_NOSIGNAL;
+#else
+static const int kiSendFlags = 0;
+#endif
+
+#ifndef _WIN32
+// Create a Unix domain socket bound or connected to a path.
+static int OpenUnixSocket(const string& sPath, bool bListen)
+{
+    sockaddr_un oAddress{};
+    oAddress.sun_family = AF_UNIX;
+    if (sPath.empty() || sPath.size() >= sizeof(oAddress.sun_path))
+    {
+        throw std::runtime_error("Invalid Unix domain socket path " + sPath + ".");
+    }
+    memcpy(oAddress.sun_path, sPath.c_str(), sPath.size() + 1);
+
+    int iSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (iSocket < 0)
+    {
+        throw std::runtime_error("Cannot create a Unix domain socket.");
+    }
+
+    // Replace the socket left by a previous listener.
+    if (bListen)
+    {
+        unlink(sPath.c_str());
+    }
+
+    sockaddr* poAddress = reinterpret_cast<sockaddr*>(&oAddress);
+    if (bListen ? bind(iSocket, poAddress, sizeof(oAddress)) != 0 || listen(iSocket, SOMAXCONN) != 0
+                : connect(iSocket, poAddress, sizeof(oAddress)) != 0)
+    {
+        close(iSocket);
+        throw std::runtime_error(string("Cannot ") + (bListen ? "listen at " : "connect to ") + sPath + ".");
+    }
+
+    return iSocket;
+}
+
+// Create a TCP socket bound or connected to a host and port, all the interfaces if listening without host.
+static int OpenTcpSocket(const string& sHost, const string& sPort, bool bListen)
+{
+    addrinfo oHints{};
+    oHints.ai_family = AF_UNSPEC;
+    oHints.ai_socktype = SOCK_STREAM;
+    oHints.ai_flags = bListen ? AI_PASSIVE : 0;
+
+    addrinfo* poAddresses = nullptr;
+    if (getaddrinfo(sHost.empty() ? nullptr : sHost.c_str(), sPort.c_str(), &oHints, &poAddresses) != 0)
+    {
+        throw std::runtime_error("Cannot resolve the address " + sHost + ":" + sPort + ".");
+    }
+
+    // Use the first address that works.
+    int iSocket = -1;
+    for (addrinfo* poAddress = poAddresses; poAddress != nullptr && iSocket < 0; poAddress = poAddress->ai_next)
+    {
+        iSocket = socket(poAddress->ai_family, poAddress->ai_socktype, poAddress->ai_protocol);
+        if (iSocket < 0)
+        {
+            continue;
+        }
+
+        int iReuse = 1;
+        if (bListen ? setsockopt(iSocket, SOL_SOCKET, SO_REUSEADDR, &iReuse, sizeof(iReuse)) != 0
+                || bind(iSocket, poAddress->ai_addr, poAddress->ai_addrlen) != 0 || listen(iSocket, SOMAXCONN) != 0
+            : connect(iSocket, poAddress->ai_addr, poAddress->ai_addrlen) != 0)
+        {
+            close(iSocket);
+            iSocket = -1;
+        }
+    }
+    freeaddrinfo(poAddresses);
+
+    if (iSocket < 0)
+    {
+        throw std::runtime_error(string("Cannot ") + (bListen ? "listen at " : "connect to ") + sHost + ":" + sPort + ".");
+    }
+
+    return iSocket;
+}
+
+// Open a socket for an address, "unix:<path>", "<host>:<port>" or "<port>".
+static int OpenSocket(const string& sAddress, bool bListen, string& sPath)
+{
+    if (sAddress.rfind("unix:", 0) == 0)
+    {
+        sPath = sAddress.substr(5);
+        return OpenUnixSocket(sPath, bListen);
+    }
+
+    size_t uiColon = sAddress.rfind(':');
+    if (uiColon == string::npos)
+    {
+        if (!bListen)
+        {
+            throw std::runtime_error("The address " + sAddress + " has no host.");
+        }
+        return OpenTcpSocket("", sAddress, bListen);
+    }
+
+    return OpenTcpSocket(sAddress.substr(0, uiColon), sAddress.substr(uiColon + 1), bListen);
+}
+#endif
+
+Socket::Socket(Socket&& oOther) noexcept
+    : miSocket(exchange(oOther.miSocket, -1)),
+      msReceived(std::move(oOther.msReceived)),
+      msPath(std::move(oOther.msPath))
+{
+    oOther.msPath.clear();
+}
+
+Socket& Socket::operator=(Socket&& oOther) noexcept
+{
+    if (this != &oOther)
+    {
+        Close();
+        miSocket = exchange(oOther.miSocket, -1);
+        msReceived = std::move(oOther.msReceived);
+        msPath = std::move(oOther.msPath);
+        oOther.msPath.clear();
+    }
+
+    return *this;
+}
+
+Socket::~Socket()
+{
+    Close();
+}
+
+/*static*/ Socket Socket::Listen(const string& sAddress)
+{
+#ifdef _WIN32
+    throw std::runtime_error("The sockets are not supported on Windows, cannot listen at " + sAddress + ".");
+#else
+    Socket oSocket;
+    oSocket.miSocket = OpenSocket(sAddress, true, oSocket.msPath);
+    return oSocket;
+#endif
+}
+
+/*static*/ Socket Socket::Connect(const string& sAddress)
+{
+#ifdef _WIN32
+    throw std::runtime_error("The sockets are not supported on Windows, cannot connect to " + sAddress + ".");
+#else
+    // Only the listening socket removes the path.
+    Socket oSocket;
+    string sPath;
+    oSocket.miSocket = OpenSocket(sAddress, false, sPath);
+    return oSocket;
+#endif
+}
+
+bool Socket::WaitReadable(int iTimeout) const
+{
+#ifdef _WIN32
+    return false;
+#else
+    // A line already received is readable.
+    if (msReceived.find('\n') != string::npos)
+    {
+        return true;
+    }
+
+    pollfd oPoll{ miSocket, POLLIN, 0 };
+    return poll(&oPoll, 1, iTimeout) > 0;
+#endif
+}
+
+Socket Socket::Accept() const
+{
+    Socket oSocket;
+#ifndef _WIN32
+    oSocket.miSocket = accept(miSocket, nullptr, nullptr);
+#endif
+    return oSocket;
+}
+
+bool Socket::SendLine(string_view sLine)
+{
+#ifdef _WIN32
+    return false;
+#else
+    string sData;
+    sData.reserve(sLine.size() + 1);
+    sData.append(sLine).push_back('\n');
+
+    // Send until all the line is written, the system may take a part at a time.
+    for (size_t uiSent = 0; uiSent < sData.size(); )
+    {
+        ssize_t iSent = send(miSocket, sData.data() + uiSent, sData.size() - uiSent, kiSendFlags);
+        if (iSent <= 0)
+        {
+            return false;
+        }
+        uiSent += static_cast<size_t>(iSent);
+    }
+
+    return true;
+#endif
+}
+
+bool Socket::ReceiveLine(string& sLine)
+{
+#ifdef _WIN32
+    return false;
+#else
+    // Read until there is a whole line.
+    size_t uiEnd;
+    while ((uiEnd = msReceived.find('\n')) == string::npos)
+    {
+        if (msReceived.size() > kuiMaxLineSize)
+        {
+            return false;
+        }
+
+        char acBuffer[4096];
+        ssize_t iReceived = recv(miSocket, acBuffer, sizeof(acBuffer), 0);
+        if (iReceived <= 0)
+        {
+            return false;
+        }
+        msReceived.append(acBuffer, static_cast<size_t>(iReceived));
+    }
+
+    sLine.assign(msReceived, 0, uiEnd);
+    msReceived.erase(0, uiEnd + 1);
+    return true;
+#endif
+}
+
+void Socket::Close()
+{
+#ifndef _WIN32
+    if (miSocket >= 0)
+    {
+        close(miSocket);
+        miSocket = -1;
+    }
+    if (!msPath.empty())
+    {
+        unlink(msPath.c_str());
+        msPath.clear();
+    }
+#endif
+    msReceived.clear();
+}
@@ -0,0 +1,152 @@
+#ifndef _SOCKET_H_
+#define _SOCKET_H_
+
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @brief A stream socket exchanging lines of text, over TCP or a Unix domain
+ *        socket, closed when destroyed.
+ *
+ * @note  The addresses are "unix:<path>" for a Unix domain socket, or
+ *        "<host>:<port>" for TCP, a listening address can be just "<port>"
+ *        to listen on all the interfaces. Writing to a socket closed by the
+ *        peer fails instead of raising SIGPIPE. Only the POSIX sockets are
+ *        supported.
+ *
+ */
+class Socket
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Socket object, not open.
+     *
+     */
+    Socket() : miSocket(-1) {}
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    /**
+     * @brief Move a socket, the moved one is not open anymore.
+     *
+     * @param oOther    The socket to move.
+     */
+    Socket(Socket&& oOther) noexcept;
+
+    /**
+     * @brief Close this socket and move another one into it.
+     *
+     * @param oOther    The socket to move.
+     *
+     * @return This socket.
+     */
+    Socket& operator=(Socket&& oOther) noexcept;
+
+
+    /********** Destructor **********/
+
+    /**
+     * @brief Close the socket.
+     *
+     */
+    ~Socket();
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Check if the socket is open.
+     *
+     * @return If the socket is open.
+     */
+    inline bool IsOpen() const { return miSocket >= 0; }
+
+
+    /********** Static Methods **********/
+
+    /**
+     * @brief Listen for connections at an address. A Unix domain socket left
+     *        by a previous listener is replaced, and removed when closed.
+     *
+     * @param sAddress  The address.
+     *
+     * @return The listening socket.
+     *
+     * @throw std::runtime_error if the address is not valid or cannot be used.
+     */
+    static Socket Listen(const string& sAddress);
+
+    /**
+     * @brief Connect to a listening address.
+     *
+     * @param sAddress  The address.
+     *
+     * @return The connected socket.
+     *
+     * @throw std::runtime_error if the address is not valid or cannot be reached.
+     */
+    static Socket Connect(const string& sAddress);
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Wait until the socket has a line, a connection or the end of the
+     *        stream to read.
+     *
+     * @param iTimeout  The most time to wait in milliseconds.
+     *
+     * @return If the socket is readable before the timeout.
+     */
+    bool WaitReadable(int iTimeout) const;
+
+    /**
+     * @brief Accept the next connection of a listening socket.
+     *
+     * @return The connected socket, not open if the connection failed.
+     */
+    Socket Accept() const;
+
+    /**
+     * @brief Send a line, adding the line end.
+     *
+     * @param sLine     The line, without line ends.
+     *
+     * @return If the line was sent, false if the connection is closed.
+     */
+    bool SendLine(string_view sLine);
+
+    /**
+     * @brief Receive the next line.
+     *
+     * @param sLine     Gets the line without the line end.
+     *
+     * @return If a line was received, false at the end of the stream, if the
+     *         connection failed or if the line is too long.
+     */
+    bool ReceiveLine(string& sLine);
+
+    /**
+     * @brief Close the socket.
+     *
+     */
+    void Close();
+
+private:
+    /********** Constants **********/
+
+    static constexpr size_t kuiMaxLineSize = 1 << 20; // The longest line received.
+
+    /********** Variables **********/
+
+    int miSocket;       // The socket descriptor, negative if not open.
+    string msReceived;  // The data received after the last line.
+    string msPath;      // The path of a listening Unix domain socket.
+};
+
+#endif // _SOCKET_H_
@@ -0,0 +1,80 @@
+/**
+ * @brief Implementation of the TextWriter class.
+ * 
+ */
+
+#include "TextWriter.h"
+
+#include <cstring>
+
+TextWriter& TextWriter::operator<<(string_view sText)
+{
+    // Write the texts longer than the buffer directly.
+    if (sText.size() > kuiBufferSize)
+    {
+        Flush();
+        moStream.write(sText.data(), sText.size());
+        return *this;
+    }
+
+    memcpy(Reserve(sText.size()), sText.data(), sText.size());
+    muiSize += sText.size();
+    return *this;
+}
+
+TextWriter& TextWriter::operator<<(char cCharacter)
+{
+    *Reserve(1) = cCharacter;
+    ++muiSize;
+    return *this;
+}
+
+TextWriter& TextWriter::operator<<(double fValue)
+{
+    char* pcEnd = Reserve(kuiMaxNumberSize);
+    muiSize = to_chars(pcEnd, pcEnd + kuiMaxNumberSize, fValue, chars_format::general, 6).ptr - macBuffer;
+    return *this;
+}
+
+TextWriter& TextWriter::operator<<(Fixed oValue)
+{
+    char* pcEnd = Reserve(kuiMaxNumberSize);
+    to_chars_result oResult = to_chars(pcEnd, pcEnd + kuiMaxNumberSize, oValue.mfValue, chars_format::fixed, oValue.miPrecision);
+
+    // The huge numbers do not fit, write them in scientific notation instead.
+    if (oResult.ec != errc())
+    {
+        oResult = to_chars(pcEnd, pcEnd + kuiMaxNumberSize, oValue.mfValue, chars_format::scientific, oValue.miPrecision);
+    }
+
+    muiSize = oResult.ptr - macBuffer;
+    return *this;
+}
+
+TextWriter& TextWriter::operator<<(Shortest oValue)
+{
+    char* pcEnd = Reserve(kuiMaxNumberSize);
+    muiSize = to_chars(pcEnd, pcEnd + kuiMaxNumberSize, oValue.mfValue).ptr - macBuffer;
+    return *this;
+}
+
+TextWriter& TextWriter::operator<<(ostream& (*pfManipulator)(ostream&))
+{
+    // End the line and write it, without flushing the stream.
+    if (pfManipulator == static_cast<ostream& (*)(ostream&)>(endl))
+    {
+        *this << '\n';
+    }
+
+    Flush();
+    return *this;
+}
+
+void TextWriter::Flush()
+{
+    if (muiSize > 0)
+    {
+        moStream.write(macBuffer, muiSize);
+        muiSize = 0;
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @brief Contains tests for the TextWriter class.
+ * 
+*/
+
+#include "TextWriter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+// Test the TextWriter::operator<<() methods.
+// Check the numbers are formatted as the output streams and to_string() do.
+TEST_CASE( "TextWriter::operator<<" )
+{
+    ostringstream oExpected;
+    ostringstream oStream;
+    TextWriter oWriter(oStream);
+
+    // Texts and characters.
+    oWriter << "Aircraft " << string("Alpha") << '-';
+    oExpected << "Aircraft " << string("Alpha") << '-';
+
+    // Integers, the 8 bits ones are numbers and not characters.
+    uint8_t uiId = 7;
+    oWriter << uiId << " " << -12 << " " << 65535u << " " << (size_t)123456789;
+    oExpected << to_string(uiId) << " " << -12 << " " << 65535u << " " << (size_t)123456789;
+
+    // Floats with 6 significant digits, and in fixed notation.
+    for (float fValue : { 0.0f, 1.5f, 0.666667f, 123.456789f, 1e-5f, 3.2e7f })
+    {
+        oWriter << " " << fValue << " " << TextWriter::Fixed(fValue) << " " << TextWriter::Fixed(fValue, 2);
+        oExpected << " " << fValue << " " << to_string(fValue);
+        char acFixed[32];
+        snprintf(acFixed, sizeof(acFixed), " %.2f", fValue);
+        oExpected << acFixed;
+    }
+
+    // The text is written to the stream at the end of the line.
+    REQUIRE(oStream.str().empty());
+    oWriter << endl;
+    oExpected << endl;
+    REQUIRE(oWriter.GetText().empty());
+    REQUIRE(oStream.str() == oExpected.str());
+}
+
+// Test the TextWriter::Flush() method.
+// Check the text longer than the buffer is written in order.
+TEST_CASE( "TextWriter::Flush" )
+{
+    ostringstream oStream;
+    string sExpected;
+    {
+        TextWriter oWriter(oStream);
+        for (int i = 0; i < 1000; ++i)
+        {
+            oWriter << i << ',';
+            sExpected += to_string(i) + ',';
+        }
+        oWriter << string(2000, 'x');
+        sExpected += string(2000, 'x');
+    }
+
+    // The destructor writes the pending text.
+    REQUIRE(oStream.str() == sExpected);
+}
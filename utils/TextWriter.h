@@ -0,0 +1,204 @@
+#ifndef _TEXT_WRITER_H_
+#define _TEXT_WRITER_H_
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+
+using namespace std;
+
+/**
+ * @brief Writes text into a fixed buffer, formatting the numbers with
+ *        to_chars, and writes the buffer to an output stream line by line.
+ * 
+ * @note  Used for the events trace and the statistics, it does not allocate
+ *        memory nor uses the stream locale and formatting state. The numbers
+ *        are formatted as the output streams and to_string() do by default,
+ *        so the output does not change.
+ * 
+ */
+class TextWriter
+{
+public:
+    /**
+     * @brief A number to write in fixed notation, as to_string() does with
+     *        the default precision.
+     * 
+     */
+    struct Fixed
+    {
+        /**
+         * @brief Construct a new Fixed object.
+         * 
+         * @param fValue        The number.
+         * @param iPrecision    The number of decimal positions.
+         */
+        Fixed(double fValue, int iPrecision = 6) : mfValue(fValue), miPrecision(iPrecision) {}
+
+        double mfValue;     // The number.
+        int miPrecision;    // The number of decimal positions.
+    };
+
+    /**
+     * @brief A number to write with the shortest text that reads back the
+     *        same float, for the machine readable outputs.
+     * 
+     */
+    struct Shortest
+    {
+        /**
+         * @brief Construct a new Shortest object.
+         * 
+         * @param fValue    The number.
+         */
+        Shortest(float fValue) : mfValue(fValue) {}
+
+        float mfValue;      // The number.
+    };
+
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Text Writer object.
+     * 
+     * @param oStream   The stream to write the lines to.
+     */
+    explicit TextWriter(ostream& oStream) : moStream(oStream), muiSize(0) {}
+
+    /********** Destructor **********/
+
+    /**
+     * @brief Destroy the Text Writer object, writing the pending text.
+     * 
+     */
+    ~TextWriter() { Flush(); }
+
+    TextWriter(const TextWriter&) = delete;
+    TextWriter& operator=(const TextWriter&) = delete;
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the text not written to the stream yet.
+     * 
+     * @return The pending text.
+     */
+    inline string_view GetText() const { return string_view(macBuffer, muiSize); }
+
+
+    /********** Operators **********/
+
+    /**
+     * @brief Write a text.
+     * 
+     * @param sText     The text.
+     * 
+     * @return This writer.
+     */
+    TextWriter& operator<<(string_view sText);
+
+    /**
+     * @brief Write a character.
+     * 
+     * @param cCharacter    The character.
+     * 
+     * @return This writer.
+     */
+    TextWriter& operator<<(char cCharacter);
+
+    /**
+     * @brief Write an integer number, including the 8 bits ones.
+     * 
+     * @param iValue    The number.
+     * 
+     * @return This writer.
+     */
+    template <typename T, enable_if_t<is_integral_v<T> && !is_same_v<T, char> && !is_same_v<T, bool>, int> = 0>
+    inline TextWriter& operator<<(T iValue)
+    {
+        char* pcEnd = Reserve(kuiMaxNumberSize);
+        muiSize = to_chars(pcEnd, pcEnd + kuiMaxNumberSize, iValue).ptr - macBuffer;
+        return *this;
+    }
+
+    /**
+     * @brief Write a number with 6 significant digits, as the output streams do.
+     * 
+     * @param fValue    The number.
+     * 
+     * @return This writer.
+     */
+    TextWriter& operator<<(double fValue);
+
+    /**
+     * @brief Write a number in fixed notation.
+     * 
+     * @param oValue    The number and its precision.
+     * 
+     * @return This writer.
+     */
+    TextWriter& operator<<(Fixed oValue);
+
+    /**
+     * @brief Write a number with the shortest text that reads back the same float.
+     * 
+     * @param oValue    The number.
+     * 
+     * @return This writer.
+     */
+    TextWriter& operator<<(Shortest oValue);
+
+    /**
+     * @brief Apply a stream manipulator, only endl and flush are supported,
+     *        endl ends the line and writes it to the stream.
+     * 
+     * @param pfManipulator     The manipulator.
+     * 
+     * @return This writer.
+     */
+    TextWriter& operator<<(ostream& (*pfManipulator)(ostream&));
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Write the pending text to the stream.
+     * 
+     */
+    void Flush();
+
+private:
+    /**
+     * @brief Make room in the buffer, writing the pending text if needed.
+     * 
+     * @param uiSize    The number of characters to make room for.
+     * 
+     * @return The end of the pending text.
+     */
+    inline char* Reserve(size_t uiSize)
+    {
+        if (muiSize + uiSize > kuiBufferSize)
+        {
+            Flush();
+        }
+        return macBuffer + muiSize;
+    }
+
+    /********** Constants **********/
+
+    static constexpr size_t kuiBufferSize = 1024;    // Longer than the longest line.
+    static constexpr size_t kuiMaxNumberSize = 64;   // Longer than any formatted number.
+
+    /********** Variables **********/
+
+    ostream& moStream;
+    size_t muiSize;
+    char macBuffer[kuiBufferSize];
+};
+
+#endif // _TEXT_WRITER_H_
@@ -0,0 +1,18 @@
+#ifndef _VALIDATION_H_
+#define _VALIDATION_H_
+
+/**
+ * @brief If the build validates the states and invariants of the simulation.
+ *
+ * @note  Defined with EVTOL_VALIDATION, which the tests and the debug builds
+ *        set. Without it the checks are compiled out and the methods that
+ *        would throw are noexcept.
+ *
+ */
+#ifdef EVTOL_VALIDATION
+constexpr bool kbValidation = true;
+#else
+constexpr bool kbValidation = false;
+#endif
+
+#endif // _VALIDATION_H_
@@ -5,26 +5,18 @@
 
 #include "Charger.h"
 
-uint8_t Charger::muiTotalChargers = 0;
+#include <charconv>
+#include <cstring>
+
+thread_local uint32_t Charger::muiTotalChargers = 0;
 
 Charger::Charger()
     : mbCharging(false),
       muiChargerId(muiTotalChargers++)
 {
-    // Nothing to do here.
-}
-
-void Charger::StartCharging()
-{
-    mbCharging = true;
-}
-
-void Charger::StopCharging()
-{
-    mbCharging = false;
-}
-
-string Charger::GetName() const
-{
-    return "Charger-" + to_string(muiChargerId);
+    // Build the name from the Id.
+    const string_view ksPrefix = "Charger-";
+    memcpy(macName, ksPrefix.data(), ksPrefix.size());
+    char* pcEnd = to_chars(macName + ksPrefix.size(), macName + sizeof(macName), muiChargerId).ptr;
+    muiNameSize = (uint8_t)(pcEnd - macName);
 }
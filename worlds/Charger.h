@@ -3,13 +3,16 @@
 
 #include "aircrafts/Aircraft.h"
 
+#include <string_view>
+
 /**
  * @brief Generic class for the chargers, which will be used to charge the
  *        aircrafts.
  * 
  * @note This is the default charger, but it can be derived to create different
  *       chargers with different properties, for example, a charger that have a
- *       location X, Y in a 2D world.
+ *       location X, Y in a 2D world. The methods used on the events path are
+ *       not virtual, so they are inlined into the worlds.
  * 
  */
 class Charger
@@ -46,7 +49,7 @@ public:
      * 
      * @return The id of the charger.
      */
-    virtual uint8_t GetId() const { return muiChargerId; }
+    inline uint32_t GetId() const { return muiChargerId; }
 
 
     /********** Methods **********/
@@ -55,25 +58,27 @@ public:
      * @brief Start charging the aircraft.
      *
      */
-    virtual void StartCharging();
+    inline void StartCharging() { mbCharging = true; }
 
     /**
      * @brief Stop charging the aircraft.
      * 
      */
-    virtual void StopCharging();
+    inline void StopCharging() { mbCharging = false; }
 
     /**
      * @brief Get the name of the charger.
      * 
-     * @return The name of the charger.
+     * @return The name of the charger, valid while the charger exists.
      */
-    virtual string GetName() const;
+    inline string_view GetName() const { return string_view(macName, muiNameSize); }
 
 private:
     bool mbCharging;       // If the charger is charging an aircraft.
-    uint8_t muiChargerId;  // The charger id.
-    static uint8_t muiTotalChargers; // The total number of chargers.
+    uint32_t muiChargerId; // The charger id.
+    char macName[20];      // The name built once at construction, "Charger-4294967295" is the longest.
+    uint8_t muiNameSize;   // The name length.
+    static thread_local uint32_t muiTotalChargers; // The total number of chargers in the thread.
 };
 
 #endif // _CHARGER_H_
@@ -0,0 +1,95 @@
+/**
+ * @brief Implementation of the FleetSnapshot class.
+ *
+ */
+
+#include "FleetSnapshot.h"
+
+#include <algorithm>
+
+FleetSnapshot::FleetSnapshot(uint32_t uiAircrafts, uint32_t uiChargers, uint64_t uiEventsInterval)
+    : muiAircrafts(uiAircrafts),
+      muiMaxChargers(uiChargers),
+      muiEventsInterval(max<uint64_t>(1, uiEventsInterval)),
+      mpoWriting(&maoSlots[0]),
+      mpoPublished(nullptr),
+      muiVersion(0),
+      muiPublishNanoseconds(0)
+{
+    // The slots are allocated once, the publications do not allocate.
+    for (Slot& oSlot : maoSlots)
+    {
+        oSlot.afStateOfCharge = make_unique<atomic<float>[]>(uiAircrafts);
+        oSlot.aeStates = make_unique<atomic<AircraftState>[]>(uiAircrafts);
+        oSlot.abChargersInUse = make_unique<atomic<bool>[]>(uiChargers);
+    }
+}
+
+bool FleetSnapshot::Read(FleetState& oState) const
+{
+    oState.afStateOfCharge.resize(muiAircrafts);
+    oState.aeStates.resize(muiAircrafts);
+    for (;;)
+    {
+        const Slot* poSlot = mpoPublished.load(memory_order_acquire);
+        if (poSlot == nullptr)
+        {
+            return false;
+        }
+
+        // The slot is being written again if the world published twice since it was loaded.
+        const uint64_t kuiSequence = poSlot->uiSequence.load(memory_order_acquire);
+        if (kuiSequence % 2 != 0)
+        {
+            continue;
+        }
+
+        oState.uiVersion = poSlot->uiVersion.load(memory_order_relaxed);
+        oState.fTime = poSlot->fTime.load(memory_order_relaxed);
+        oState.uiQueueLength = poSlot->uiQueueLength.load(memory_order_relaxed);
+        for (uint32_t i = 0; i < muiAircrafts; i++)
+        {
+            oState.afStateOfCharge[i] = poSlot->afStateOfCharge[i].load(memory_order_relaxed);
+            oState.aeStates[i] = poSlot->aeStates[i].load(memory_order_relaxed);
+        }
+        const uint32_t kuiChargers = min(poSlot->uiChargers.load(memory_order_relaxed), muiMaxChargers);
+        oState.abChargersInUse.resize(kuiChargers);
+        for (uint32_t i = 0; i < kuiChargers; i++)
+        {
+            oState.abChargersInUse[i] = poSlot->abChargersInUse[i].load(memory_order_relaxed);
+        }
+
+        // The copy is consistent if the slot was not written meanwhile.
+        atomic_thread_fence(memory_order_acquire);
+        if (poSlot->uiSequence.load(memory_order_relaxed) == kuiSequence)
+        {
+            return true;
+        }
+    }
+}
+
+void FleetSnapshot::BeginWrite(float fTime, uint32_t uiQueueLength, uint32_t uiChargers)
+{
+    moWriteStart = chrono::steady_clock::now();
+
+    // Write the slot not published, the readers copy the other one.
+    mpoWriting = mpoPublished.load(memory_order_relaxed) == &maoSlots[0] ? &maoSlots[1] : &maoSlots[0];
+    mpoWriting->uiSequence.store(mpoWriting->uiSequence.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    mpoWriting->fTime.store(fTime, memory_order_relaxed);
+    mpoWriting->uiQueueLength.store(uiQueueLength, memory_order_relaxed);
+    mpoWriting->uiChargers.store(min(uiChargers, muiMaxChargers), memory_order_relaxed);
+}
+
+void FleetSnapshot::EndWrite()
+{
+    const uint64_t kuiVersion = muiVersion.load(memory_order_relaxed) + 1;
+    mpoWriting->uiVersion.store(kuiVersion, memory_order_relaxed);
+    mpoWriting->uiSequence.store(mpoWriting->uiSequence.load(memory_order_relaxed) + 1, memory_order_release);
+    mpoPublished.store(mpoWriting, memory_order_release);
+    muiVersion.store(kuiVersion, memory_order_relaxed);
+
+    muiPublishNanoseconds.fetch_add(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - moWriteStart).count(),
+        memory_order_relaxed);
+}
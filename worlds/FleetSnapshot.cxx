@@ -0,0 +1,151 @@
+/**
+ * @brief Contains tests for the FleetSnapshot class.
+ *
+*/
+
+#include "FleetSnapshot.h"
+#include "Scenario.h"
+#include "SimpleWorld/World.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <thread>
+
+// Test the FleetSnapshot::Read() method.
+// Check the readers get whole publications in order while the writer publishes without waiting for them.
+TEST_CASE( "FleetSnapshot::Read" )
+{
+    const uint32_t kuiAircrafts = 64;
+    const uint32_t kuiChargers = 8;
+    const uint32_t kuiPublications = 20000;
+    FleetSnapshot oSnapshot(kuiAircrafts, kuiChargers, 0);
+    REQUIRE(oSnapshot.GetEventsInterval() == 1);
+
+    FleetState oState;
+    REQUIRE(!oSnapshot.Read(oState));
+
+    // Every value of a publication is its version, a torn copy mixes two of them.
+    atomic<bool> bWriting(true);
+    thread oWriter([&oSnapshot, &bWriting]()
+    {
+        for (uint32_t uiVersion = 1; uiVersion <= kuiPublications; uiVersion++)
+        {
+            oSnapshot.BeginWrite(static_cast<float>(uiVersion), uiVersion, uiVersion % (kuiChargers + 1));
+            for (uint32_t i = 0; i < kuiAircrafts; i++)
+            {
+                oSnapshot.WriteAircraft(i, static_cast<float>(uiVersion), static_cast<AircraftState>(uiVersion % 4));
+            }
+            for (uint32_t i = 0; i < kuiChargers; i++)
+            {
+                oSnapshot.WriteCharger(i, uiVersion % 2 != 0);
+            }
+            oSnapshot.EndWrite();
+        }
+        bWriting = false;
+    });
+
+    vector<thread> oReaders;
+    atomic<bool> bConsistent(true);
+    for (int iReader = 0; iReader < 2; iReader++)
+    {
+        oReaders.emplace_back([&oSnapshot, &bWriting, &bConsistent]()
+        {
+            FleetState oCopy;
+            uint64_t uiLastVersion = 0;
+            while (bWriting.load())
+            {
+                if (!oSnapshot.Read(oCopy))
+                {
+                    continue;
+                }
+
+                const float kfVersion = static_cast<float>(oCopy.uiVersion);
+                bool bWhole = oCopy.uiVersion >= uiLastVersion && oCopy.fTime == kfVersion && oCopy.uiQueueLength == oCopy.uiVersion
+                    && oCopy.abChargersInUse.size() == oCopy.uiVersion % (kuiChargers + 1)
+                    && all_of(oCopy.afStateOfCharge.begin(), oCopy.afStateOfCharge.end(), [kfVersion](float f) { return f == kfVersion; })
+                    && all_of(oCopy.aeStates.begin(), oCopy.aeStates.end(), [&oCopy](AircraftState e) { return e == oCopy.aeStates[0]; })
+                    && count(oCopy.abChargersInUse.begin(), oCopy.abChargersInUse.end(), oCopy.uiVersion % 2 != 0) == (long)oCopy.abChargersInUse.size();
+                bConsistent = bConsistent && bWhole;
+                uiLastVersion = oCopy.uiVersion;
+            }
+        });
+    }
+
+    oWriter.join();
+    for (thread& oReader : oReaders)
+    {
+        oReader.join();
+    }
+    REQUIRE(bConsistent);
+    REQUIRE(oSnapshot.GetPublishCount() == kuiPublications);
+    REQUIRE(oSnapshot.GetPublishTime().count() > 0);
+
+    REQUIRE(oSnapshot.Read(oState));
+    REQUIRE(oState.uiVersion == kuiPublications);
+    REQUIRE(oState.afStateOfCharge.size() == kuiAircrafts);
+    REQUIRE(oState.afStateOfCharge[kuiAircrafts - 1] == static_cast<float>(kuiPublications));
+}
+
+// Test the SimpleWorld::World::SetFleetSnapshot() method.
+// Check the world publishes every events interval without changing its results, and the fleet read while it runs is consistent.
+TEST_CASE( "SimpleWorld::World::SetFleetSnapshot" )
+{
+    Scenario oScenario;
+    oScenario.SetChargersCount(2);
+    oScenario.SetSeed(5);
+    oScenario.AddAircrafts(AircraftCompany::Alpha, 4, 1.0f, AircraftState::Idle);
+    oScenario.AddAircrafts(AircraftCompany::Charlie, 4, 0.2f, AircraftState::Queued);
+
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oPlainWorld(oScenario);
+    oPlainWorld.RunSimulation(200);
+    const uint32_t kuiFlights = AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights();
+    const double kfMiles = AircraftType::GetAircraftType(AircraftCompany::Charlie)->TotalNumberOfMiles();
+
+    // The snapshot needs room for every aircraft and for the chargers the commands add.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(oScenario);
+    FleetSnapshot oSmall(8, 2);
+    REQUIRE_THROWS(oWorld.SetFleetSnapshot(&oSmall));
+
+    FleetSnapshot oSnapshot(8, 2 + SimpleWorld::QuietWorld::kuiMaxAddedChargers, 16);
+    oWorld.SetFleetSnapshot(&oSnapshot);
+
+    // The charging aircrafts of a snapshot are the chargers in use.
+    atomic<bool> bRunning(true);
+    atomic<bool> bConsistent(true);
+    thread oReader([&oSnapshot, &bRunning, &bConsistent]()
+    {
+        FleetState oState;
+        while (bRunning.load())
+        {
+            if (oSnapshot.Read(oState))
+            {
+                long iCharging = count(oState.aeStates.begin(), oState.aeStates.end(), AircraftState::Charging);
+                long iQueued = count(oState.aeStates.begin(), oState.aeStates.end(), AircraftState::Queued);
+                bConsistent = bConsistent && oState.abChargersInUse.size() == 2
+                    && iCharging == count(oState.abChargersInUse.begin(), oState.abChargersInUse.end(), true)
+                    && iQueued == (long)oState.uiQueueLength
+                    && all_of(oState.afStateOfCharge.begin(), oState.afStateOfCharge.end(), [](float f) { return f >= 0 && f <= 1; });
+            }
+        }
+    });
+
+    oWorld.RunSimulation(200);
+    bRunning = false;
+    oReader.join();
+    REQUIRE(bConsistent);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights() == kuiFlights);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Charlie)->TotalNumberOfMiles() == kfMiles);
+
+    // A publication at the start, at most one per interval of the events scheduled, and one at the end.
+    const uint64_t kuiEvents = oWorld.GetHeapEvents() + oWorld.GetImmediateEvents();
+    REQUIRE(oSnapshot.GetPublishCount() > 2);
+    REQUIRE(oSnapshot.GetPublishCount() <= 2 + kuiEvents / 16);
+
+    FleetState oFinal;
+    REQUIRE(oSnapshot.Read(oFinal));
+    REQUIRE(oFinal.uiVersion == oSnapshot.GetPublishCount());
+    REQUIRE(oFinal.fTime == 200);
+}
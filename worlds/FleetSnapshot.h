@@ -0,0 +1,184 @@
+#ifndef _FLEET_SNAPSHOT_H_
+#define _FLEET_SNAPSHOT_H_
+
+#include "aircrafts/AircraftState.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief A copy of the fleet state at a simulation time, as the readers of a
+ *        FleetSnapshot get it.
+ *
+ */
+struct FleetState
+{
+    uint64_t uiVersion = 0;                 ///< The number of the publication, from 1.
+    float fTime = 0;                        ///< The simulation time in hours.
+    uint32_t uiQueueLength = 0;             ///< The aircrafts waiting for a free charger.
+    vector<float> afStateOfCharge;          ///< The state of charge per aircraft.
+    vector<AircraftState> aeStates;         ///< The state per aircraft.
+    vector<bool> abChargersInUse;           ///< If the charger is charging an aircraft, per charger.
+};
+
+/**
+ * @brief The state of the fleet published by a running world every number of
+ *        events, which other threads read at any time without locks and
+ *        without stopping the world, for example to feed a dashboard.
+ *
+ * @note  The state is written to two slots in turn, each one guarded by a
+ *        sequence counter (a seqlock): odd while the world writes the slot,
+ *        even once written. A reader copies the slot published last, then
+ *        retries if its sequence changed meanwhile, which only happens when
+ *        the world published twice during the copy. The world never waits
+ *        for the readers, and the values are relaxed atomics, so the copies
+ *        race with the writes without undefined behaviour.
+ *
+ *        A publication costs a store per aircraft and per charger, so the
+ *        world spends at most that over the events interval. The time spent
+ *        publishing is measured, to check it against the time of the events.
+ *
+ */
+class FleetSnapshot
+{
+public:
+    /********** Constants **********/
+
+    static constexpr uint64_t kuiDefaultEventsInterval = 1024; ///< The events between the publications by default.
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Fleet Snapshot object.
+     *
+     * @param uiAircrafts       The aircrafts of the world.
+     * @param uiChargers        The chargers the world can have at most.
+     * @param uiEventsInterval  The events between the publications, at least 1.
+     */
+    FleetSnapshot(uint32_t uiAircrafts, uint32_t uiChargers, uint64_t uiEventsInterval = kuiDefaultEventsInterval);
+
+    FleetSnapshot(const FleetSnapshot&) = delete;
+    FleetSnapshot& operator=(const FleetSnapshot&) = delete;
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of aircrafts.
+     *
+     * @return The number of aircrafts.
+     */
+    inline uint32_t GetAircraftsCount() const { return muiAircrafts; }
+
+    /**
+     * @brief Get the chargers the world can have at most.
+     *
+     * @return The number of chargers.
+     */
+    inline uint32_t GetMaxChargers() const { return muiMaxChargers; }
+
+    /**
+     * @brief Get the events between the publications.
+     *
+     * @return The number of events.
+     */
+    inline uint64_t GetEventsInterval() const { return muiEventsInterval; }
+
+    /**
+     * @brief Get the number of publications, from any thread.
+     *
+     * @return The number of publications.
+     */
+    inline uint64_t GetPublishCount() const { return muiVersion.load(memory_order_relaxed); }
+
+    /**
+     * @brief Get the time the world spent publishing, from any thread.
+     *
+     * @return The time.
+     */
+    inline chrono::nanoseconds GetPublishTime() const { return chrono::nanoseconds(muiPublishNanoseconds.load(memory_order_relaxed)); }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Copy the state published last, from any thread without locks.
+     *
+     * @param oState    Gets the state, its vectors are reused.
+     *
+     * @return If a state was published.
+     */
+    bool Read(FleetState& oState) const;
+
+    /**
+     * @brief Start writing the state of a time, by the world.
+     *
+     * @param fTime             The simulation time in hours.
+     * @param uiQueueLength     The aircrafts waiting for a free charger.
+     * @param uiChargers        The chargers of the world.
+     */
+    void BeginWrite(float fTime, uint32_t uiQueueLength, uint32_t uiChargers);
+
+    /**
+     * @brief Write the state of an aircraft, between BeginWrite() and EndWrite().
+     *
+     * @param uiAircraft        The index of the aircraft.
+     * @param fStateOfCharge    The state of charge.
+     * @param eState            The state.
+     */
+    inline void WriteAircraft(uint32_t uiAircraft, float fStateOfCharge, AircraftState eState)
+    {
+        mpoWriting->afStateOfCharge[uiAircraft].store(fStateOfCharge, memory_order_relaxed);
+        mpoWriting->aeStates[uiAircraft].store(eState, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Write if a charger is in use, between BeginWrite() and EndWrite().
+     *
+     * @param uiCharger         The index of the charger.
+     * @param bInUse            If the charger is charging an aircraft.
+     */
+    inline void WriteCharger(uint32_t uiCharger, bool bInUse)
+    {
+        mpoWriting->abChargersInUse[uiCharger].store(bInUse, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Publish the state written, for the readers to get it.
+     *
+     */
+    void EndWrite();
+
+private:
+    // A copy of the state, guarded by its sequence.
+    struct Slot
+    {
+        atomic<uint64_t> uiSequence{ 0 };               // Odd while written.
+        atomic<uint64_t> uiVersion{ 0 };                // The number of the publication.
+        atomic<float> fTime{ 0 };                       // The simulation time.
+        atomic<uint32_t> uiQueueLength{ 0 };            // The aircrafts waiting.
+        atomic<uint32_t> uiChargers{ 0 };               // The chargers of the world.
+        unique_ptr<atomic<float>[]> afStateOfCharge;    // The state of charge per aircraft.
+        unique_ptr<atomic<AircraftState>[]> aeStates;   // The state per aircraft.
+        unique_ptr<atomic<bool>[]> abChargersInUse;     // If the charger is in use, per charger.
+    };
+
+    /********** Variables **********/
+
+    uint32_t muiAircrafts;                      // The aircrafts of the world.
+    uint32_t muiMaxChargers;                    // The chargers the world can have at most.
+    uint64_t muiEventsInterval;                 // The events between the publications.
+    Slot maoSlots[2];                           // The slots written in turn.
+    Slot* mpoWriting;                           // The slot being written.
+    chrono::steady_clock::time_point moWriteStart; // The time the writing started.
+    atomic<Slot*> mpoPublished;                 // The slot published last, nullptr before the first one.
+    atomic<uint64_t> muiVersion;                // The number of publications.
+    atomic<uint64_t> muiPublishNanoseconds;     // The time spent publishing.
+};
+
+#endif // _FLEET_SNAPSHOT_H_
@@ -0,0 +1,124 @@
+/**
+ * @brief Implementation of the MetricsSampler class.
+ * 
+ */
+
+#include "MetricsSampler.h"
+#include "utils/TextWriter.h"
+
+#include <algorithm>
+
+// The gauges names for the exported columns.
+static const char* const kapcGaugeNames[] = { "airborne", "queued", "charging", "lowest_soc", "mean_soc", "highest_soc" };
+static_assert(sizeof(kapcGaugeNames) / sizeof(kapcGaugeNames[0]) == (size_t)FleetGauge::TotalGauges,
+              "The gauge names do not match the fleet gauges.");
+
+MetricsSampler::MetricsSampler(float fInterval, size_t uiCapacity, pmr::memory_resource* poMemory)
+    : mfInterval(fInterval),
+      muiCapacity(max<size_t>(2, uiCapacity + uiCapacity % 2)),
+      muiSamples(0),
+      muiSamplesPerBucket(1),
+      maafMin{},
+      maafMax{},
+      maafSum{},
+      mauiCount(poMemory)
+{
+    // Allocate all the buckets from the start, recording never allocates.
+    for (size_t i = 0; i < kuiGauges; i++)
+    {
+        maafMin[i] = pmr::vector<float>(poMemory);
+        maafMax[i] = pmr::vector<float>(poMemory);
+        maafSum[i] = pmr::vector<float>(poMemory);
+        maafMin[i].reserve(muiCapacity);
+        maafMax[i].reserve(muiCapacity);
+        maafSum[i].reserve(muiCapacity);
+    }
+    mauiCount.reserve(muiCapacity);
+}
+
+void MetricsSampler::Record(const FleetGauges& oGauges)
+{
+    // Start a new bucket if the last one is full, making room if needed.
+    if (mauiCount.empty() || mauiCount.back() == muiSamplesPerBucket)
+    {
+        if (mauiCount.size() == muiCapacity)
+        {
+            Downsample();
+        }
+    }
+
+    if (mauiCount.empty() || mauiCount.back() == muiSamplesPerBucket)
+    {
+        for (size_t i = 0; i < kuiGauges; i++)
+        {
+            maafMin[i].push_back(oGauges[i]);
+            maafMax[i].push_back(oGauges[i]);
+            maafSum[i].push_back(oGauges[i]);
+        }
+        mauiCount.push_back(1);
+    }
+    else
+    {
+        for (size_t i = 0; i < kuiGauges; i++)
+        {
+            maafMin[i].back() = min(maafMin[i].back(), oGauges[i]);
+            maafMax[i].back() = max(maafMax[i].back(), oGauges[i]);
+            maafSum[i].back() += oGauges[i];
+        }
+        ++mauiCount.back();
+    }
+
+    ++muiSamples;
+}
+
+void MetricsSampler::Downsample()
+{
+    // The buckets are full, so there is an even number of them.
+    size_t uiBuckets = mauiCount.size() / 2;
+    for (size_t i = 0; i < kuiGauges; i++)
+    {
+        for (size_t j = 0; j < uiBuckets; j++)
+        {
+            maafMin[i][j] = min(maafMin[i][2 * j], maafMin[i][2 * j + 1]);
+            maafMax[i][j] = max(maafMax[i][2 * j], maafMax[i][2 * j + 1]);
+            maafSum[i][j] = maafSum[i][2 * j] + maafSum[i][2 * j + 1];
+        }
+        maafMin[i].resize(uiBuckets);
+        maafMax[i].resize(uiBuckets);
+        maafSum[i].resize(uiBuckets);
+    }
+
+    for (size_t j = 0; j < uiBuckets; j++)
+    {
+        mauiCount[j] = mauiCount[2 * j] + mauiCount[2 * j + 1];
+    }
+    mauiCount.resize(uiBuckets);
+
+    muiSamplesPerBucket *= 2;
+}
+
+void MetricsSampler::WriteCsv(ostream& oStream) const
+{
+    TextWriter oOutput(oStream);
+
+    // Write the header.
+    oOutput << "time_hours,samples";
+    for (const char* pcName : kapcGaugeNames)
+    {
+        oOutput << ",min_" << pcName << ",mean_" << pcName << ",max_" << pcName;
+    }
+    oOutput << endl;
+
+    // Write a row per bucket.
+    for (size_t j = 0; j < mauiCount.size(); j++)
+    {
+        oOutput << TextWriter::Shortest(GetBucketTime(j)) << ',' << mauiCount[j];
+        for (size_t i = 0; i < kuiGauges; i++)
+        {
+            oOutput << ',' << TextWriter::Shortest(maafMin[i][j])
+                << ',' << TextWriter::Shortest(maafSum[i][j] / mauiCount[j])
+                << ',' << TextWriter::Shortest(maafMax[i][j]);
+        }
+        oOutput << endl;
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * @brief Contains tests for the MetricsSampler class.
+ * 
+*/
+
+#include "MetricsSampler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+
+// Get gauges with all the values equal.
+static FleetGauges MakeGauges(float fValue)
+{
+    FleetGauges oGauges;
+    oGauges.fill(fValue);
+    return oGauges;
+}
+
+// Test the MetricsSampler::Record() method.
+// Check the samples are stored one per bucket until the buckets are full.
+TEST_CASE( "MetricsSampler::Record" )
+{
+    MetricsSampler oSampler(0.5f, 4);
+    REQUIRE(oSampler.GetNextSampleTime() == 0);
+    REQUIRE(oSampler.IsDueBefore(0.1f));
+    REQUIRE_FALSE(oSampler.IsDueBefore(0));
+
+    for (int i = 0; i < 4; i++)
+    {
+        oSampler.Record(MakeGauges(i));
+    }
+
+    REQUIRE(oSampler.GetSamplesCount() == 4);
+    REQUIRE(oSampler.GetNextSampleTime() == 2.0f);
+    REQUIRE(oSampler.GetBucketsCount() == 4);
+    REQUIRE(oSampler.GetSamplesPerBucket() == 1);
+    REQUIRE(oSampler.GetBucketTime(3) == 1.5f);
+    REQUIRE(oSampler.GetMean(3, FleetGauge::Airborne) == 3);
+}
+
+// Test the MetricsSampler downsampling.
+// Check the buckets are merged in pairs when full, keeping the min, max and mean.
+TEST_CASE( "MetricsSampler::Downsample" )
+{
+    MetricsSampler oSampler(1.0f, 4);
+    for (int i = 0; i < 10; i++)
+    {
+        oSampler.Record(MakeGauges(i));
+    }
+
+    // 10 samples in buckets of 4 samples: [0-3], [4-7], [8-9].
+    REQUIRE(oSampler.GetSamplesPerBucket() == 4);
+    REQUIRE(oSampler.GetBucketsCount() == 3);
+    REQUIRE(oSampler.GetBucketTime(1) == 4.0f);
+    REQUIRE(oSampler.GetMin(1, FleetGauge::Queued) == 4);
+    REQUIRE(oSampler.GetMax(1, FleetGauge::Queued) == 7);
+    REQUIRE(oSampler.GetMean(1, FleetGauge::Queued) == 5.5f);
+    REQUIRE(oSampler.GetMin(2, FleetGauge::Charging) == 8);
+    REQUIRE(oSampler.GetMean(2, FleetGauge::Charging) == 8.5f);
+
+    // The memory stays bounded for long runs.
+    for (int i = 0; i < 100000; i++)
+    {
+        oSampler.Record(MakeGauges(1));
+    }
+    REQUIRE(oSampler.GetBucketsCount() <= 4);
+}
+
+// Test the MetricsSampler::WriteCsv() method.
+TEST_CASE( "MetricsSampler::WriteCsv" )
+{
+    MetricsSampler oSampler(0.25f, 8);
+    oSampler.Record(MakeGauges(1));
+    oSampler.Record(MakeGauges(0.5f));
+
+    ostringstream oStream;
+    oSampler.WriteCsv(oStream);
+    REQUIRE(oStream.str().rfind("time_hours,samples,min_airborne,mean_airborne,max_airborne,", 0) == 0);
+    REQUIRE(oStream.str().find("\n0.25,1,0.5,0.5,0.5,") != string::npos);
+}
@@ -0,0 +1,195 @@
+#ifndef _METRICS_SAMPLER_H_
+#define _METRICS_SAMPLER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The fleet level gauges sampled over the simulation time.
+ * 
+ */
+enum class FleetGauge : uint8_t
+{
+    // The number of aircrafts flying.
+    Airborne,
+    // The number of aircrafts waiting for a free charger.
+    Queued,
+    // The number of aircrafts charging.
+    Charging,
+    // The lowest state of charge of the fleet.
+    MinStateOfCharge,
+    // The mean state of charge of the fleet.
+    MeanStateOfCharge,
+    // The highest state of charge of the fleet.
+    MaxStateOfCharge,
+
+    TotalGauges,
+};
+
+/**
+ * @brief The values of all the fleet gauges at a time.
+ * 
+ */
+using FleetGauges = array<float, (size_t)FleetGauge::TotalGauges>;
+
+/**
+ * @brief Samples the fleet gauges at a fixed simulation time interval into
+ *        a fixed number of buckets, keeping the min, max and mean per bucket.
+ * 
+ * @note  When the buckets are full, each pair of consecutive buckets is
+ *        merged and the buckets become twice as wide, so the whole run is
+ *        always covered with bounded memory. Recording a sample is O(1),
+ *        amortised over the merges. The worlds record the samples while
+ *        processing their events, without scheduling events for them.
+ * 
+ */
+class MetricsSampler
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Metrics Sampler object.
+     * 
+     * @param fInterval     The time between samples in hours.
+     * @param uiCapacity    The maximum number of buckets, rounded up to even.
+     * @param poMemory      The memory resource for the buckets.
+     */
+    MetricsSampler(float fInterval, size_t uiCapacity = 1024, pmr::memory_resource* poMemory = pmr::get_default_resource());
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the time between samples in hours.
+     * 
+     * @return The sampling interval.
+     */
+    inline float GetInterval() const { return mfInterval; }
+
+    /**
+     * @brief Get the time of the next sample in hours.
+     * 
+     * @return The next sample time.
+     */
+    inline float GetNextSampleTime() const { return muiSamples * mfInterval; }
+
+    /**
+     * @brief Get the number of samples recorded.
+     * 
+     * @return The number of samples.
+     */
+    inline uint64_t GetSamplesCount() const { return muiSamples; }
+
+    /**
+     * @brief Get the number of buckets used.
+     * 
+     * @return The number of buckets.
+     */
+    inline size_t GetBucketsCount() const { return mauiCount.size(); }
+
+    /**
+     * @brief Get the number of samples a full bucket has.
+     * 
+     * @return The samples per bucket.
+     */
+    inline uint64_t GetSamplesPerBucket() const { return muiSamplesPerBucket; }
+
+    /**
+     * @brief Get the time of the first sample of a bucket in hours.
+     * 
+     * @param uiBucket  The bucket.
+     * 
+     * @return The bucket start time.
+     */
+    inline float GetBucketTime(size_t uiBucket) const { return uiBucket * muiSamplesPerBucket * mfInterval; }
+
+    /**
+     * @brief Get the lowest value of a gauge in a bucket.
+     * 
+     * @param uiBucket  The bucket.
+     * @param eGauge    The gauge.
+     * 
+     * @return The lowest value.
+     */
+    inline float GetMin(size_t uiBucket, FleetGauge eGauge) const { return maafMin[(size_t)eGauge][uiBucket]; }
+
+    /**
+     * @brief Get the highest value of a gauge in a bucket.
+     * 
+     * @param uiBucket  The bucket.
+     * @param eGauge    The gauge.
+     * 
+     * @return The highest value.
+     */
+    inline float GetMax(size_t uiBucket, FleetGauge eGauge) const { return maafMax[(size_t)eGauge][uiBucket]; }
+
+    /**
+     * @brief Get the mean value of a gauge in a bucket.
+     * 
+     * @param uiBucket  The bucket.
+     * @param eGauge    The gauge.
+     * 
+     * @return The mean value.
+     */
+    inline float GetMean(size_t uiBucket, FleetGauge eGauge) const { return maafSum[(size_t)eGauge][uiBucket] / mauiCount[uiBucket]; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Check if a sample is due before a time.
+     * 
+     * @param fTime     The time in hours.
+     * 
+     * @return If the next sample time is before the time.
+     */
+    inline bool IsDueBefore(float fTime) const { return GetNextSampleTime() < fTime; }
+
+    /**
+     * @brief Record the sample for the next sample time.
+     * 
+     * @param oGauges   The gauges values.
+     */
+    void Record(const FleetGauges& oGauges);
+
+    /**
+     * @brief Write the buckets as CSV, one row per bucket with the min, mean
+     *        and max of every gauge.
+     * 
+     * @param oStream   The stream to write to.
+     */
+    void WriteCsv(ostream& oStream) const;
+
+private:
+    /**
+     * @brief Merge each pair of consecutive buckets, doubling the bucket width.
+     * 
+     */
+    void Downsample();
+
+    /********** Constants **********/
+
+    static constexpr size_t kuiGauges = (size_t)FleetGauge::TotalGauges;
+
+    /********** Variables **********/
+
+    float mfInterval;
+    size_t muiCapacity;
+    uint64_t muiSamples;
+    uint64_t muiSamplesPerBucket;
+
+    // The buckets, a column per gauge and statistic.
+    array<pmr::vector<float>, kuiGauges> maafMin;
+    array<pmr::vector<float>, kuiGauges> maafMax;
+    array<pmr::vector<float>, kuiGauges> maafSum;
+    pmr::vector<uint32_t> mauiCount;
+};
+
+#endif // _METRICS_SAMPLER_H_
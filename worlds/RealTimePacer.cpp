@@ -0,0 +1,197 @@
+/**
+ * @brief Implementation of the RealTimePacer class.
+ *
+ */
+
+#include "RealTimePacer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+// The nanoseconds per simulation hour at the speed of the wall clock.
+static const double kfNanosecondsPerHour = 3600e9;
+
+// Remove the spaces around a text.
+static string_view Trim(string_view sText)
+{
+    size_t uiStart = sText.find_first_not_of(" \t\r");
+    if (uiStart == string_view::npos)
+    {
+        return string_view();
+    }
+    return sText.substr(uiStart, sText.find_last_not_of(" \t\r") - uiStart + 1);
+}
+
+// Sleep until a time of the monotonic clock.
+static void SleepUntil(chrono::steady_clock::time_point koWakeUp)
+{
+#ifdef _WIN32
+    this_thread::sleep_until(koWakeUp);
+#else
+    // The steady clock is the monotonic clock, an absolute sleep does not drift when interrupted.
+    chrono::nanoseconds oSinceEpoch = koWakeUp.time_since_epoch();
+    timespec oTime;
+    oTime.tv_sec = static_cast<time_t>(oSinceEpoch.count() / 1000000000);
+    oTime.tv_nsec = static_cast<long>(oSinceEpoch.count() % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &oTime, nullptr) == EINTR)
+    {
+    }
+#endif
+}
+
+RealTimePacer::RealTimePacer(SimulationWorld& oWorld, double fSpeed, size_t uiInboxSize)
+    : moWorld(oWorld),
+      mfSpeed(fSpeed),
+      moInbox(uiInboxSize),
+      mbStopping(false),
+      mfStartTime(0)
+{
+    if (!(fSpeed > 0) || isinf(fSpeed))
+    {
+        throw std::runtime_error("The speed of the wall clock must be positive.");
+    }
+}
+
+bool RealTimePacer::ParseCommand(string_view sText, WorldCommand& oCommand)
+{
+    // The command name, then the aircraft if it takes one.
+    sText = Trim(sText);
+    size_t uiEnd = sText.find(' ');
+    string_view sName = sText.substr(0, uiEnd);
+    string_view sArgument = uiEnd != string_view::npos ? Trim(sText.substr(uiEnd + 1)) : string_view();
+
+    if (sName == "add-charger")
+    {
+        oCommand = WorldCommand{ WorldCommandType::AddCharger, 0 };
+        return sArgument.empty();
+    }
+
+    WorldCommandType eType;
+    if (sName == "ground")
+    {
+        eType = WorldCommandType::GroundAircraft;
+    }
+    else if (sName == "release")
+    {
+        eType = WorldCommandType::ReleaseAircraft;
+    }
+    else
+    {
+        return false;
+    }
+
+    uint32_t uiAircraft = 0;
+    from_chars_result oResult = from_chars(sArgument.data(), sArgument.data() + sArgument.size(), uiAircraft);
+    if (sArgument.empty() || oResult.ec != errc() || oResult.ptr != sArgument.data() + sArgument.size())
+    {
+        return false;
+    }
+    oCommand = WorldCommand{ eType, uiAircraft };
+    return true;
+}
+
+void RealTimePacer::Run(float fHorizon)
+{
+    if (!moWorld.IsStarted())
+    {
+        moWorld.Start(fHorizon);
+    }
+
+    // The wall times are anchored at the start, so the errors of the waits do not add up.
+    moStart = Clock::now();
+    mfStartTime = moWorld.GetWorldTime();
+    while (!moWorld.IsFinished() && !mbStopping)
+    {
+        ApplyCommands();
+
+        // Wait for the wall time of the next events, looking at the inbox meanwhile.
+        const float kfTime = min(moWorld.GetNextTime(), moWorld.GetHorizon());
+        const Clock::time_point koTarget = GetWallTime(kfTime);
+        const bool kbLate = Clock::now() >= koTarget;
+        if (!WaitUntil(koTarget))
+        {
+            continue;
+        }
+
+        const double kfLateness = chrono::duration<double, micro>(Clock::now() - koTarget).count();
+        moStatistics.uiEventTimes++;
+        moStatistics.uiLateTimes += kbLate;
+        moStatistics.oLateness.Add(kfLateness);
+        moStatistics.fMaxLateness = max(moStatistics.fMaxLateness, kfLateness);
+
+        moWorld.RunUntil(kfTime);
+    }
+}
+
+RealTimePacer::Clock::time_point RealTimePacer::GetWallTime(float fTime) const
+{
+    if (isinf(fTime))
+    {
+        return Clock::time_point::max();
+    }
+    return moStart + chrono::nanoseconds(llround((fTime - mfStartTime) * kfNanosecondsPerHour / mfSpeed));
+}
+
+float RealTimePacer::GetSimulationTime(Clock::time_point koWallTime) const
+{
+    return mfStartTime + static_cast<float>(chrono::duration<double, nano>(koWallTime - moStart).count() * mfSpeed / kfNanosecondsPerHour);
+}
+
+bool RealTimePacer::WaitUntil(Clock::time_point koTarget) const
+{
+    // A far target is waited for in slices, to apply the commands posted meanwhile.
+    const Clock::time_point koNow = Clock::now();
+    if (koTarget - koNow > chrono::microseconds(kuiCommandPollMicros))
+    {
+        SleepUntil(koNow + chrono::microseconds(kuiCommandPollMicros));
+        return false;
+    }
+
+    // Sleep until shortly before the target, the sleep wakes up late, then spin until it.
+    if (koTarget - koNow > chrono::microseconds(kuiSpinMicros))
+    {
+        SleepUntil(koTarget - chrono::microseconds(kuiSpinMicros));
+    }
+    while (Clock::now() < koTarget)
+    {
+    }
+    return true;
+}
+
+void RealTimePacer::ApplyCommands()
+{
+    WorldCommand oCommand;
+    bool bAdvanced = false;
+    while (moInbox.TryPop(oCommand))
+    {
+        // The commands happen at the wall clock time, if the world is not behind it and has events
+        // before its end, otherwise the world would end sooner.
+        if (!bAdvanced)
+        {
+            const float kfNow = GetSimulationTime(Clock::now());
+            const float kfNextTime = moWorld.GetNextTime();
+            if (kfNow > moWorld.GetWorldTime() && kfNow < kfNextTime && kfNextTime <= moWorld.GetHorizon())
+            {
+                moWorld.RunUntil(kfNow);
+            }
+            bAdvanced = true;
+        }
+
+        if (moWorld.ApplyCommand(oCommand))
+        {
+            moStatistics.uiCommands++;
+        }
+        else
+        {
+            moStatistics.uiRejectedCommands++;
+        }
+    }
+}
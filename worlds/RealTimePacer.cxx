@@ -0,0 +1,114 @@
+/**
+ * @brief Contains tests for the RealTimePacer class.
+ *
+*/
+
+#include "RealTimePacer.h"
+#include "Scenario.h"
+#include "SimpleWorld/World.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+// The speed running 2 simulation hours in 50 ms.
+static const double kfTestSpeed = 2 * 3600 / 0.05;
+
+// The scenario of the tests, a small fleet with aircrafts waiting for the chargers.
+static unique_ptr<Scenario> CreateScenario()
+{
+    unique_ptr<Scenario> poScenario = make_unique<Scenario>();
+    poScenario->SetChargersCount(1);
+    poScenario->SetSeed(11);
+    poScenario->AddAircrafts(AircraftCompany::Alpha, 1, 1.0f, AircraftState::Idle);
+    poScenario->AddAircrafts(AircraftCompany::Bravo, 2, 0.5f, AircraftState::Queued);
+    return poScenario;
+}
+
+// Test the RealTimePacer::Run() method.
+// Check the run takes the wall time of its simulation time, and gets the statistics of a run at once.
+TEST_CASE( "RealTimePacer::Run" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+    REQUIRE_THROWS(RealTimePacer(*SimpleWorld::CreateWorld(*poScenario), 0));
+
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWholeWorld(*poScenario);
+    oWholeWorld.RunSimulation(2);
+    const uint32_t kuiFlights = AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights();
+    const double kfMiles = AircraftType::GetAircraftType(AircraftCompany::Bravo)->TotalNumberOfMiles();
+
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(*poScenario);
+    RealTimePacer oPacer(oWorld, kfTestSpeed);
+    const chrono::steady_clock::time_point koStart = chrono::steady_clock::now();
+    oPacer.Run(2);
+    REQUIRE(chrono::steady_clock::now() - koStart >= chrono::milliseconds(50));
+    REQUIRE(oWorld.IsFinished());
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights() == kuiFlights);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Bravo)->TotalNumberOfMiles() == kfMiles);
+
+    const PacingStatistics& koStatistics = oPacer.GetStatistics();
+    REQUIRE(koStatistics.uiEventTimes > 2);
+    REQUIRE(koStatistics.oLateness.GetCount() == koStatistics.uiEventTimes);
+    REQUIRE(koStatistics.fMaxLateness >= koStatistics.oLateness.GetMean());
+}
+
+// Test the RealTimePacer::Post() method.
+// Check the commands posted from another thread are applied while the world runs, and the run can be stopped.
+TEST_CASE( "RealTimePacer::Post" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+
+    // The aircraft grounded before the start never flies, the added charger takes the second aircraft waiting.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(*poScenario);
+    RealTimePacer oPacer(oWorld, kfTestSpeed);
+    REQUIRE(oPacer.Post(WorldCommand{ WorldCommandType::GroundAircraft, 0 }));
+    REQUIRE(oPacer.Post(WorldCommand{ WorldCommandType::AddCharger, 0 }));
+    REQUIRE(oPacer.Post(WorldCommand{ WorldCommandType::ReleaseAircraft, 7 }));
+    oPacer.Run(2);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights() == 0);
+    REQUIRE(oWorld.GetChargersCount() == 2);
+    REQUIRE(oPacer.GetStatistics().uiCommands == 2);
+    REQUIRE(oPacer.GetStatistics().uiRejectedCommands == 1);
+
+    // A run without end until stopped, with a command posted while it waits.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oEndless(*poScenario);
+    RealTimePacer oEndlessPacer(oEndless, kfTestSpeed);
+    thread oControl([&oEndlessPacer]()
+    {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        oEndlessPacer.Post(WorldCommand{ WorldCommandType::AddCharger, 0 });
+        this_thread::sleep_for(chrono::milliseconds(20));
+        oEndlessPacer.Stop();
+    });
+    oEndlessPacer.Run();
+    oControl.join();
+    REQUIRE(!oEndless.IsFinished());
+    REQUIRE(oEndless.GetWorldTime() > 0);
+    REQUIRE(oEndless.GetChargersCount() == 2);
+}
+
+// Test the RealTimePacer::ParseCommand() method.
+// Check the commands are read from their text, and the invalid texts are rejected.
+TEST_CASE( "RealTimePacer::ParseCommand" )
+{
+    WorldCommand oCommand;
+    REQUIRE(RealTimePacer::ParseCommand(" ground 12\r", oCommand));
+    REQUIRE(oCommand.eType == WorldCommandType::GroundAircraft);
+    REQUIRE(oCommand.uiAircraft == 12);
+    REQUIRE(RealTimePacer::ParseCommand("release 3", oCommand));
+    REQUIRE(oCommand.eType == WorldCommandType::ReleaseAircraft);
+    REQUIRE(RealTimePacer::ParseCommand("add-charger", oCommand));
+    REQUIRE(oCommand.eType == WorldCommandType::AddCharger);
+
+    REQUIRE(!RealTimePacer::ParseCommand("", oCommand));
+    REQUIRE(!RealTimePacer::ParseCommand("ground", oCommand));
+    REQUIRE(!RealTimePacer::ParseCommand("ground x1", oCommand));
+    REQUIRE(!RealTimePacer::ParseCommand("ground 1x", oCommand));
+    REQUIRE(!RealTimePacer::ParseCommand("add-charger 2", oCommand));
+    REQUIRE(!RealTimePacer::ParseCommand("fly 2", oCommand));
+}
@@ -0,0 +1,178 @@
+#ifndef _REAL_TIME_PACER_H_
+#define _REAL_TIME_PACER_H_
+
+#include "SimulationWorld.h"
+#include "utils/LockFreeQueue.h"
+#include "utils/RunningStatistics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @brief The timing of a paced run, to see how close the world kept to the
+ *        wall clock.
+ *
+ */
+struct PacingStatistics
+{
+    uint64_t uiEventTimes = 0;          ///< The event times waited for.
+    uint64_t uiLateTimes = 0;           ///< The event times already past when the world got to them, it could not keep up.
+    RunningStatistics oLateness;        ///< The time the event times started after their wall time, in microseconds.
+    double fMaxLateness = 0;            ///< The largest lateness in microseconds.
+    uint64_t uiCommands = 0;            ///< The commands applied.
+    uint64_t uiRejectedCommands = 0;    ///< The commands the world did not apply.
+};
+
+/**
+ * @brief Runs a world at the speed of the wall clock, or at a multiple of it,
+ *        next to the software it is a twin of, which changes the world with
+ *        commands posted while it runs.
+ *
+ * @note  Each event time of the world is given a wall time from the start of
+ *        the run, and the pacer waits until then to process its events: it
+ *        sleeps with the absolute monotonic clock until kuiSpinMicros before,
+ *        as the sleep wakes up late by the scheduler latency, and spins the
+ *        rest. The wall times are computed from the start and not from the
+ *        previous event, so the error of a wait does not drift the later
+ *        ones. A world behind its schedule runs its events without waiting
+ *        until it catches up, and the lateness is reported.
+ *
+ *        The commands are posted to a lock-free inbox from any thread, and
+ *        applied between the events at the time of the wall clock. A long
+ *        wait wakes up every kuiCommandPollMicros to look at the inbox. A
+ *        world behind its schedule applies them at the time it reached.
+ *
+ */
+class RealTimePacer
+{
+public:
+    /********** Constants **********/
+
+    static constexpr size_t kuiDefaultInboxSize = 256;      ///< The commands waiting to be applied at most by default.
+    static constexpr uint32_t kuiSpinMicros = 200;          ///< The part of a wait spent spinning instead of sleeping.
+    static constexpr uint32_t kuiCommandPollMicros = 2000;  ///< The longest sleep before looking at the inbox.
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Real Time Pacer object.
+     *
+     * @param oWorld        The world to run, which must outlive the pacer.
+     * @param fSpeed        The simulation hours per wall clock hour.
+     * @param uiInboxSize   The commands waiting to be applied at most.
+     *
+     * @throw std::runtime_error if the speed is not positive and finite.
+     */
+    RealTimePacer(SimulationWorld& oWorld, double fSpeed = 1, size_t uiInboxSize = kuiDefaultInboxSize);
+
+    RealTimePacer(const RealTimePacer&) = delete;
+    RealTimePacer& operator=(const RealTimePacer&) = delete;
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the timing of the run, once it is over.
+     *
+     * @return The statistics.
+     */
+    inline const PacingStatistics& GetStatistics() const { return moStatistics; }
+
+
+    /********** Static Methods **********/
+
+    /**
+     * @brief Parse a command line: "ground <aircraft>", "release <aircraft>"
+     *        or "add-charger", the aircrafts by their index in the world.
+     *
+     * @param sText     The text of the command.
+     * @param oCommand  Gets the command.
+     *
+     * @return If the text is a command.
+     */
+    static bool ParseCommand(string_view sText, WorldCommand& oCommand);
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Post a command to the world, from any thread without locks.
+     *
+     * @param koCommand The command.
+     *
+     * @return If the command was posted, false if the inbox is full.
+     */
+    inline bool Post(const WorldCommand& koCommand) { return moInbox.TryPush(koCommand); }
+
+    /**
+     * @brief Run the world paced by the wall clock until it finishes or the
+     *        pacer is stopped, the commands posted before are applied first.
+     *
+     * @param fHorizon  The time the simulation ends in hours, if the world is
+     *                  not started yet.
+     */
+    void Run(float fHorizon = numeric_limits<float>::infinity());
+
+    /**
+     * @brief Stop the run, from any thread or a signal handler, the world is
+     *        left where it is.
+     *
+     */
+    inline void Stop() { mbStopping = true; }
+
+private:
+    typedef chrono::steady_clock Clock;
+
+    /********** Methods **********/
+
+    /**
+     * @brief Get the wall time of a simulation time.
+     *
+     * @param fTime     The time in hours.
+     *
+     * @return The wall time, the largest one for an infinite time.
+     */
+    Clock::time_point GetWallTime(float fTime) const;
+
+    /**
+     * @brief Get the simulation time of a wall time.
+     *
+     * @param koWallTime    The wall time.
+     *
+     * @return The time in hours.
+     */
+    float GetSimulationTime(Clock::time_point koWallTime) const;
+
+    /**
+     * @brief Wait until a wall time, or until the inbox must be looked at.
+     *
+     * @param koTarget  The wall time.
+     *
+     * @return If the wall time was reached.
+     */
+    bool WaitUntil(Clock::time_point koTarget) const;
+
+    /**
+     * @brief Bring the world to the wall clock time and apply the commands
+     *        posted.
+     *
+     */
+    void ApplyCommands();
+
+    /********** Variables **********/
+
+    SimulationWorld& moWorld;               // The world to run.
+    double mfSpeed;                         // The simulation hours per wall clock hour.
+    LockFreeQueue<WorldCommand> moInbox;    // The commands posted.
+    atomic<bool> mbStopping;                // If the run is stopping.
+    Clock::time_point moStart;              // The wall time the run started.
+    float mfStartTime;                      // The simulation time the run started.
+    PacingStatistics moStatistics;          // The timing of the run.
+};
+
+#endif // _REAL_TIME_PACER_H_
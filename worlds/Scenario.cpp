@@ -0,0 +1,214 @@
+/**
+ * @brief Implementation of the Scenario class.
+ *
+ */
+
+#include "Scenario.h"
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+// The magic and the version of the binary scenario files.
+static const char kacMagic[4] = { 'E', 'V', 'S', 'C' };
+static const uint16_t kuiVersion = 1;
+
+// Parse a whole token as a number of the type.
+template <class T>
+static bool ParseNumber(const string& sToken, T& oValue)
+{
+    const char* pcEnd = sToken.data() + sToken.size();
+    from_chars_result oResult = from_chars(sToken.data(), pcEnd, oValue);
+    return oResult.ec == errc() && oResult.ptr == pcEnd;
+}
+
+Scenario::Scenario()
+    : moHeader{},
+      mpoAircrafts(nullptr)
+{
+    memcpy(moHeader.acMagic, kacMagic, sizeof(kacMagic));
+    moHeader.uiVersion = kuiVersion;
+    moHeader.uiHours = kuiDefaultHours;
+    moHeader.uiChargers = kuiDefaultChargers;
+}
+
+void Scenario::AddAircrafts(AircraftCompany eCompany, uint32_t uiCount, float fStateOfCharge, AircraftState eState)
+{
+    // The mapped aircrafts are read-only.
+    if (mpoFile)
+    {
+        throw std::runtime_error("Cannot add aircrafts to a scenario mapped from a file.");
+    }
+
+    ScenarioAircraft oAircraft{ fStateOfCharge, eCompany, eState, { 0, 0 } };
+    if (!IsValid(oAircraft))
+    {
+        throw std::runtime_error("Invalid initial state of the aircrafts.");
+    }
+    if (uiCount > numeric_limits<uint32_t>::max() - moHeader.uiAircrafts)
+    {
+        throw std::runtime_error("Too many aircrafts in the scenario.");
+    }
+
+    moOwnAircrafts.insert(moOwnAircrafts.end(), uiCount, oAircraft);
+    moHeader.uiAircrafts += uiCount;
+    mpoAircrafts = moOwnAircrafts.data();
+}
+
+void Scenario::WriteBinary(const string& sPath) const
+{
+    ofstream oFile(sPath, ios::binary | ios::trunc);
+    oFile.write(reinterpret_cast<const char*>(&moHeader), sizeof(moHeader));
+    if (moHeader.uiAircrafts > 0)
+    {
+        oFile.write(reinterpret_cast<const char*>(mpoAircrafts), static_cast<streamsize>(moHeader.uiAircrafts) * sizeof(ScenarioAircraft));
+    }
+
+    oFile.close();
+    if (!oFile)
+    {
+        throw std::runtime_error("Cannot write the scenario file " + sPath + ".");
+    }
+}
+
+/*static*/ unique_ptr<Scenario> Scenario::Parse(istream& oInput)
+{
+    unique_ptr<Scenario> poScenario = make_unique<Scenario>();
+
+    string sLine;
+    vector<string> asTokens;
+    uint32_t uiLine = 0;
+    while (getline(oInput, sLine))
+    {
+        ++uiLine;
+
+        // Split the line in tokens, up to the comment.
+        asTokens.clear();
+        istringstream oLine(sLine.substr(0, sLine.find('#')));
+        for (string sToken; oLine >> sToken; )
+        {
+            asTokens.push_back(std::move(sToken));
+        }
+
+        // Skip the empty lines.
+        if (asTokens.empty())
+        {
+            continue;
+        }
+
+        bool bValid = false;
+        const string& ksKey = asTokens[0];
+        if (ksKey == "hours" && asTokens.size() == 2)
+        {
+            uint16_t uiHours = 0;
+            bValid = ParseNumber(asTokens[1], uiHours);
+            poScenario->SetHours(uiHours);
+        }
+        else if (ksKey == "chargers" && asTokens.size() == 2)
+        {
+            uint32_t uiChargers = 0;
+            bValid = ParseNumber(asTokens[1], uiChargers);
+            poScenario->SetChargersCount(uiChargers);
+        }
+        else if (ksKey == "seed" && asTokens.size() == 2)
+        {
+            uint32_t uiSeed = 0;
+            bValid = ParseNumber(asTokens[1], uiSeed);
+            poScenario->SetSeed(uiSeed);
+        }
+        else if (ksKey == "aircrafts" && asTokens.size() >= 3 && asTokens.size() <= 5)
+        {
+            // The state of charge is full by default, and the state depends on it.
+            AircraftCompany eCompany = AircraftCompany::TotalCompanies;
+            uint32_t uiCount = 0;
+            float fStateOfCharge = 1.0f;
+            bValid = AircraftType::ParseCompany(asTokens[1], eCompany) && ParseNumber(asTokens[2], uiCount)
+                && (asTokens.size() < 4 || ParseNumber(asTokens[3], fStateOfCharge));
+
+            AircraftState eState = fStateOfCharge == 1.0f ? AircraftState::Idle : AircraftState::Queued;
+            if (asTokens.size() == 5)
+            {
+                bValid = bValid && (asTokens[4] == "idle" || asTokens[4] == "queued");
+                eState = asTokens[4] == "idle" ? AircraftState::Idle : AircraftState::Queued;
+            }
+
+            bValid = bValid && IsValid(ScenarioAircraft{ fStateOfCharge, eCompany, eState, { 0, 0 } });
+            if (bValid)
+            {
+                poScenario->AddAircrafts(eCompany, uiCount, fStateOfCharge, eState);
+            }
+        }
+
+        if (!bValid)
+        {
+            throw std::runtime_error("Invalid scenario line " + to_string(uiLine) + ": " + sLine);
+        }
+    }
+
+    return poScenario;
+}
+
+/*static*/ unique_ptr<Scenario> Scenario::Load(const string& sPath)
+{
+    // Read the magic to tell the binary files from the text ones.
+    ifstream oFile(sPath, ios::binary);
+    if (!oFile)
+    {
+        throw std::runtime_error("Cannot open the scenario file " + sPath + ".");
+    }
+
+    char acMagic[sizeof(kacMagic)] = {};
+    oFile.read(acMagic, sizeof(acMagic));
+    if (oFile.gcount() != sizeof(acMagic) || memcmp(acMagic, kacMagic, sizeof(kacMagic)) != 0)
+    {
+        oFile.clear();
+        oFile.seekg(0);
+        return Parse(oFile);
+    }
+    oFile.close();
+
+    // Map the binary file, the records are used from the mapping.
+    unique_ptr<Scenario> poScenario = make_unique<Scenario>();
+    poScenario->mpoFile = make_unique<MappedFile>(sPath);
+    const MappedFile& koFile = *poScenario->mpoFile;
+
+    // Check the header and that the file has exactly the records announced.
+    ScenarioHeader& oHeader = poScenario->moHeader;
+    if (koFile.GetSize() < sizeof(oHeader))
+    {
+        throw std::runtime_error("The scenario file " + sPath + " is truncated.");
+    }
+    memcpy(&oHeader, koFile.GetData(), sizeof(oHeader));
+    if (oHeader.uiVersion != kuiVersion)
+    {
+        throw std::runtime_error("The scenario file " + sPath + " has the unsupported version " + to_string(oHeader.uiVersion) + ".");
+    }
+    if (koFile.GetSize() != sizeof(oHeader) + static_cast<uint64_t>(oHeader.uiAircrafts) * sizeof(ScenarioAircraft))
+    {
+        throw std::runtime_error("The scenario file " + sPath + " does not have " + to_string(oHeader.uiAircrafts) + " aircrafts.");
+    }
+
+    // Check the records in a single pass, which also loads the pages.
+    const ScenarioAircraft* poAircrafts = reinterpret_cast<const ScenarioAircraft*>(koFile.GetData() + sizeof(oHeader));
+    for (uint32_t i = 0; i < oHeader.uiAircrafts; i++)
+    {
+        if (!IsValid(poAircrafts[i]))
+        {
+            throw std::runtime_error("The scenario file " + sPath + " has an invalid aircraft at index " + to_string(i) + ".");
+        }
+    }
+    poScenario->mpoAircrafts = poAircrafts;
+
+    return poScenario;
+}
+
+/*static*/ bool Scenario::IsValid(const ScenarioAircraft& koAircraft)
+{
+    // The range comparisons are false for a state of charge not being a number.
+    return koAircraft.eCompany < AircraftCompany::TotalCompanies
+        && (koAircraft.eState == AircraftState::Idle || koAircraft.eState == AircraftState::Queued)
+        && koAircraft.fStateOfCharge >= 0 && koAircraft.fStateOfCharge <= 1;
+}
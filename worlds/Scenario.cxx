@@ -0,0 +1,133 @@
+/**
+ * @brief Contains tests for the Scenario class.
+ *
+*/
+
+#include "Scenario.h"
+#include "worlds/SimpleWorld/World.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// The scenario used by the tests.
+static const char* kpcScenario =
+    "# A small fleet.\n"
+    "hours 2\n"
+    "chargers 1\n"
+    "seed 42\n"
+    "\n"
+    "aircrafts Alpha 2           # Full and idle.\n"
+    "aircrafts Bravo 1 0.5\n"
+    "aircrafts Echo 1 0.25 idle\n";
+
+// Parse a scenario text.
+static unique_ptr<Scenario> ParseScenario(const string& sText)
+{
+    istringstream oInput(sText);
+    return Scenario::Parse(oInput);
+}
+
+// Test the Scenario::Parse() method.
+// Check the settings, and the aircrafts are idle when full and queued otherwise by default.
+TEST_CASE( "Scenario::Parse" )
+{
+    unique_ptr<Scenario> poScenario = ParseScenario(kpcScenario);
+    REQUIRE(poScenario->GetHours() == 2);
+    REQUIRE(poScenario->GetChargersCount() == 1);
+    REQUIRE(poScenario->GetSeed() == 42);
+    REQUIRE(poScenario->GetAircraftsCount() == 4);
+
+    const ScenarioAircraft& koAlpha = poScenario->GetAircraft(1);
+    REQUIRE(koAlpha.eCompany == AircraftCompany::Alpha);
+    REQUIRE(koAlpha.fStateOfCharge == 1.0f);
+    REQUIRE(koAlpha.eState == AircraftState::Idle);
+
+    const ScenarioAircraft& koBravo = poScenario->GetAircraft(2);
+    REQUIRE(koBravo.eCompany == AircraftCompany::Bravo);
+    REQUIRE(koBravo.fStateOfCharge == 0.5f);
+    REQUIRE(koBravo.eState == AircraftState::Queued);
+
+    const ScenarioAircraft& koEcho = poScenario->GetAircraft(3);
+    REQUIRE(koEcho.eCompany == AircraftCompany::Echo);
+    REQUIRE(koEcho.eState == AircraftState::Idle);
+
+    // An empty scenario has the default settings.
+    poScenario = ParseScenario("");
+    REQUIRE(poScenario->GetHours() == Scenario::kuiDefaultHours);
+    REQUIRE(poScenario->GetChargersCount() == Scenario::kuiDefaultChargers);
+    REQUIRE(poScenario->GetSeed() == 0);
+    REQUIRE(poScenario->GetAircraftsCount() == 0);
+
+    // The invalid lines are rejected.
+    REQUIRE_THROWS(ParseScenario("hours -1\n"));
+    REQUIRE_THROWS(ParseScenario("hours 70000\n"));
+    REQUIRE_THROWS(ParseScenario("chargers 3 4\n"));
+    REQUIRE_THROWS(ParseScenario("aircrafts Zulu 1\n"));
+    REQUIRE_THROWS(ParseScenario("aircrafts Alpha 1 1.5\n"));
+    REQUIRE_THROWS(ParseScenario("aircrafts Alpha 1 0.5 flying\n"));
+    REQUIRE_THROWS(ParseScenario("wind 10\n"));
+}
+
+// Test the Scenario::Load() method.
+// Check the binary files have the same scenario as the text they were written from.
+TEST_CASE( "Scenario::Load" )
+{
+    const string ksTextPath = (filesystem::temp_directory_path() / "evtol_scenario.txt").string();
+    const string ksBinaryPath = (filesystem::temp_directory_path() / "evtol_scenario.bin").string();
+    ofstream(ksTextPath) << kpcScenario;
+
+    // Load the text file and write it in the binary format.
+    unique_ptr<Scenario> poText = Scenario::Load(ksTextPath);
+    REQUIRE(poText->GetAircraftsCount() == 4);
+    poText->WriteBinary(ksBinaryPath);
+    REQUIRE(filesystem::file_size(ksBinaryPath) == sizeof(ScenarioHeader) + 4 * sizeof(ScenarioAircraft));
+
+    // Load the binary file.
+    unique_ptr<Scenario> poBinary = Scenario::Load(ksBinaryPath);
+    REQUIRE(poBinary->GetHours() == poText->GetHours());
+    REQUIRE(poBinary->GetChargersCount() == poText->GetChargersCount());
+    REQUIRE(poBinary->GetSeed() == poText->GetSeed());
+    REQUIRE(poBinary->GetAircraftsCount() == poText->GetAircraftsCount());
+    for (uint32_t i = 0; i < poBinary->GetAircraftsCount(); i++)
+    {
+        REQUIRE(poBinary->GetAircraft(i).eCompany == poText->GetAircraft(i).eCompany);
+        REQUIRE(poBinary->GetAircraft(i).fStateOfCharge == poText->GetAircraft(i).fStateOfCharge);
+        REQUIRE(poBinary->GetAircraft(i).eState == poText->GetAircraft(i).eState);
+    }
+
+    // The mapped aircrafts cannot be changed.
+    REQUIRE_THROWS(poBinary->AddAircrafts(AircraftCompany::Alpha, 1, 1.0f, AircraftState::Idle));
+    poBinary.reset();
+
+    // A truncated binary file is rejected.
+    filesystem::resize_file(ksBinaryPath, sizeof(ScenarioHeader) + sizeof(ScenarioAircraft));
+    REQUIRE_THROWS(Scenario::Load(ksBinaryPath));
+
+    // A missing file is rejected.
+    filesystem::remove(ksTextPath);
+    filesystem::remove(ksBinaryPath);
+    REQUIRE_THROWS(Scenario::Load(ksTextPath));
+}
+
+// Test the worlds created from a scenario.
+// Check the aircrafts start with their charge, and the queued ones charge first.
+TEST_CASE( "Scenario::World" )
+{
+    unique_ptr<Scenario> poScenario = ParseScenario("chargers 1\naircrafts Bravo 1 0.5\naircrafts Bravo 1 0.5 idle\n");
+    SimpleWorld::QuietWorld oWorld(*poScenario);
+    REQUIRE(oWorld.GetAircraftsCount() == 2);
+    REQUIRE(oWorld.GetChargersCount() == 1);
+    oWorld.AuditInvariants();
+
+    // The queued aircraft charges from the start, the idle one takes off
+    // with half a battery and waits for the charger when it lands.
+    uint32_t uiChargeSessions = AircraftType::GetAircraftType(AircraftCompany::Bravo)->TotalChargeSessions();
+    uint32_t uiFlights = AircraftType::GetAircraftType(AircraftCompany::Bravo)->TotalFlights();
+    oWorld.RunSimulation(1);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Bravo)->TotalChargeSessions() > uiChargeSessions);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Bravo)->TotalFlights() > uiFlights);
+}
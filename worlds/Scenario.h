@@ -0,0 +1,217 @@
+#ifndef _SCENARIO_H_
+#define _SCENARIO_H_
+
+#include "aircrafts/AircraftState.h"
+#include "aircrafts/AircraftType.h"
+#include "utils/MappedFile.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The initial state of an aircraft in a scenario, as stored in the
+ *        binary scenario files.
+ *
+ */
+struct ScenarioAircraft
+{
+    float fStateOfCharge;     ///< The battery charge as a fraction of the capacity.
+    AircraftCompany eCompany; ///< The aircraft company.
+    AircraftState eState;     ///< Idle to take off at the start, or Queued to wait for a charger.
+    uint8_t auiReserved[2];   ///< Zero, pads the record to 8 bytes.
+};
+
+/**
+ * @brief The header of the binary scenario files, followed by the aircrafts records.
+ *
+ * @note  The integers and floats are stored in the byte order of the machine,
+ *        little endian on all the supported platforms.
+ *
+ */
+struct ScenarioHeader
+{
+    char acMagic[4];          ///< "EVSC".
+    uint16_t uiVersion;       ///< The format version.
+    uint16_t uiHours;         ///< The simulation time in hours.
+    uint32_t uiAircrafts;     ///< The number of aircrafts records following the header.
+    uint32_t uiChargers;      ///< The number of chargers.
+    uint32_t uiSeed;          ///< The random seed, 0 to use the current time.
+    uint32_t uiReserved;      ///< Zero, pads the header to 24 bytes.
+};
+
+static_assert(sizeof(ScenarioAircraft) == 8 && is_trivially_copyable_v<ScenarioAircraft>, "The aircrafts records are mapped from the files.");
+static_assert(sizeof(ScenarioHeader) == 24 && sizeof(ScenarioHeader) % alignof(ScenarioAircraft) == 0, "The header keeps the records aligned.");
+
+/**
+ * @brief The initial state of a simulation: the simulation time, the chargers
+ *        and every aircraft with its company, state of charge and state.
+ *
+ *        The text format has one setting per line, '#' starts a comment:
+ *
+ *            hours 3
+ *            chargers 3
+ *            seed 42
+ *            aircrafts Alpha 4
+ *            aircrafts Bravo 2 0.5 idle
+ *            aircrafts Echo 1 0.2 queued
+ *
+ *        The aircrafts lines add a number of aircrafts of a company, with an
+ *        optional state of charge, full by default, and an optional state, by
+ *        default idle if the battery is full and queued otherwise. The idle
+ *        aircrafts take off at the start, the queued ones wait for a charger.
+ *
+ *        The binary format is a ScenarioHeader followed by a ScenarioAircraft
+ *        per aircraft, the file is mapped in memory and used without copying
+ *        the records, so a fleet of millions of aircrafts loads in milliseconds.
+ *
+ */
+class Scenario
+{
+public:
+    static constexpr uint16_t kuiDefaultHours = 3;    ///< The simulation time when not set.
+    static constexpr uint32_t kuiDefaultChargers = 3; ///< The chargers when not set.
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct an empty scenario with the default settings.
+     *
+     */
+    Scenario();
+
+    Scenario(const Scenario&) = delete;
+    Scenario& operator=(const Scenario&) = delete;
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the simulation time.
+     *
+     * @return The simulation time in hours.
+     */
+    inline uint16_t GetHours() const { return moHeader.uiHours; }
+
+    /**
+     * @brief Get the number of chargers.
+     *
+     * @return The number of chargers.
+     */
+    inline uint32_t GetChargersCount() const { return moHeader.uiChargers; }
+
+    /**
+     * @brief Get the random seed.
+     *
+     * @return The random seed, 0 to use the current time.
+     */
+    inline uint32_t GetSeed() const { return moHeader.uiSeed; }
+
+    /**
+     * @brief Get the number of aircrafts.
+     *
+     * @return The number of aircrafts.
+     */
+    inline uint32_t GetAircraftsCount() const { return moHeader.uiAircrafts; }
+
+    /**
+     * @brief Get the initial state of an aircraft.
+     *
+     * @param uiIndex   The aircraft index, less than the number of aircrafts.
+     *
+     * @return The aircraft initial state.
+     */
+    inline const ScenarioAircraft& GetAircraft(uint32_t uiIndex) const { return mpoAircrafts[uiIndex]; }
+
+    /**
+     * @brief Set the simulation time.
+     *
+     * @param uiHours   The simulation time in hours.
+     */
+    inline void SetHours(uint16_t uiHours) { moHeader.uiHours = uiHours; }
+
+    /**
+     * @brief Set the number of chargers.
+     *
+     * @param uiChargers    The number of chargers.
+     */
+    inline void SetChargersCount(uint32_t uiChargers) { moHeader.uiChargers = uiChargers; }
+
+    /**
+     * @brief Set the random seed.
+     *
+     * @param uiSeed    The random seed, 0 to use the current time.
+     */
+    inline void SetSeed(uint32_t uiSeed) { moHeader.uiSeed = uiSeed; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Add aircrafts of a company with the same initial state.
+     *
+     * @param eCompany          The aircraft company.
+     * @param uiCount           The number of aircrafts.
+     * @param fStateOfCharge    The battery charge as a fraction of the capacity.
+     * @param eState            Idle or Queued.
+     *
+     * @throw std::runtime_error if the initial state is not valid, or if the
+     *        scenario is mapped from a file.
+     */
+    void AddAircrafts(AircraftCompany eCompany, uint32_t uiCount, float fStateOfCharge, AircraftState eState);
+
+    /**
+     * @brief Write the scenario in the binary format.
+     *
+     * @param sPath     The path of the file, replaced if it exists.
+     *
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void WriteBinary(const string& sPath) const;
+
+    /**
+     * @brief Parse a scenario in the text format.
+     *
+     * @param oInput    The text.
+     *
+     * @return The scenario.
+     *
+     * @throw std::runtime_error with the line number if a line is not valid.
+     */
+    static unique_ptr<Scenario> Parse(istream& oInput);
+
+    /**
+     * @brief Load a scenario file, mapping the binary files and parsing the text ones.
+     *
+     * @param sPath     The path of the file.
+     *
+     * @return The scenario.
+     *
+     * @throw std::runtime_error if the file cannot be read or is not valid.
+     */
+    static unique_ptr<Scenario> Load(const string& sPath);
+
+private:
+    /**
+     * @brief Check the initial state of an aircraft.
+     *
+     * @param koAircraft    The aircraft initial state.
+     *
+     * @return If the company, the state of charge and the state are valid.
+     */
+    static bool IsValid(const ScenarioAircraft& koAircraft);
+
+    /********** Variables **********/
+
+    ScenarioHeader moHeader;                  // The settings and the number of aircrafts.
+    vector<ScenarioAircraft> moOwnAircrafts;  // The aircrafts of the scenarios not mapped from a file.
+    unique_ptr<MappedFile> mpoFile;           // The binary file the aircrafts are mapped from, if any.
+    const ScenarioAircraft* mpoAircrafts;     // The aircrafts, owned or mapped.
+};
+
+#endif // _SCENARIO_H_
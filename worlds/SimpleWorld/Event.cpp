@@ -8,7 +8,7 @@
 
 namespace SimpleWorld
 {
-    /*static*/ uint32_t Event::muNextId;
+    /*static*/ thread_local uint32_t Event::muNextId;
 
     Event::Event(AircraftEvent eType, Aircraft* poAircraft, float fTime)
         : meType(eType),
@@ -59,12 +59,19 @@ namespace SimpleWorld
          */
         inline Aircraft* GetAircraft() const { return mpoAircraft; }
 
+        /**
+         * @brief Gets the event Id, unique and increasing with the scheduling order.
+         * 
+         * @return The event Id.
+         */
+        inline uint32_t GetId() const { return muId; }
+
     private:
         AircraftEvent meType;
         Aircraft* mpoAircraft;
         float mfTime;
         uint32_t muId;
-        static uint32_t muNextId;
+        static thread_local uint32_t muNextId;
     };
 
 } // namespace SimpleWorld
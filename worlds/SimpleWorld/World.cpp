@@ -10,15 +10,80 @@
 #include "aircrafts/Aircraft.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <cstdio>
 #include <cstdlib>
-#include <sstream>
-#include <iomanip>
-#include <ctime>
-#include <map>
+#include <stdexcept>
 
 using namespace std;
 
+// The initial size of the world arena, enough for a small world.
+static const size_t kuiArenaInitialSize = 64 * 1024;
+
+// The number of events batches between the fleet audits in validation builds.
+static const uint32_t kuiAuditPeriod = 64;
+
+// The state of an aircraft and of the statistics of its type, which the rollback of an event restores.
+struct RollbackState
+{
+    AircraftState eState;
+    Charger* poCharger;
+    float fBatteryCharge;
+    uint32_t uiFlights;
+    uint32_t uiFaults;
+    float fEstimatedFaults;
+    float fMiles;
+
+    // Check the states match, the float sums within the rounding of undoing them.
+    bool Matches(const RollbackState& koOther) const
+    {
+        auto Near = [](float fA, float fB) { return fabs(fA - fB) <= 1e-5f * max(1.0f, max(fabs(fA), fabs(fB))); };
+        return eState == koOther.eState && poCharger == koOther.poCharger && uiFlights == koOther.uiFlights
+            && uiFaults == koOther.uiFaults && Near(fBatteryCharge, koOther.fBatteryCharge)
+            && Near(fEstimatedFaults, koOther.fEstimatedFaults) && Near(fMiles, koOther.fMiles);
+    }
+};
+
+// Get the state of an aircraft the rollback of an event restores.
+static RollbackState GetRollbackState(const Aircraft* poAircraft)
+{
+    const AircraftType* poAircraftType = poAircraft->GetAircraftType();
+    return RollbackState{ poAircraft->GetState(), poAircraft->GetCharger(), poAircraft->GetBatteryCharge(),
+                          poAircraftType->TotalFlights(), poAircraftType->TotalNumberOfFaults(),
+                          poAircraftType->EstimatedNumberOfFaults(), poAircraftType->TotalNumberOfMiles() };
+}
+
+// Apply a transition of an aircraft. Validation builds then undo it with its reverse handler
+// and apply it again, as an optimistic run rolling back and replaying the event would, and
+// check the aircraft, its type statistics and its fault draws come back the same.
+template <class Apply, class Revert>
+static void ApplyReversibly(const Aircraft* poAircraft, Apply&& oApply, Revert&& oRevert)
+{
+    if constexpr (!kbValidation)
+    {
+        oApply();
+    }
+    else
+    {
+        const RollbackState koBefore = GetRollbackState(poAircraft);
+        oApply();
+        const RollbackState koAfter = GetRollbackState(poAircraft);
+
+        oRevert();
+        if (!GetRollbackState(poAircraft).Matches(koBefore))
+        {
+            throw std::runtime_error("Rolling back the aircraft " + string(poAircraft->GetName()) + " did not restore it.");
+        }
+
+        oApply();
+        if (!GetRollbackState(poAircraft).Matches(koAfter))
+        {
+            throw std::runtime_error("Replaying the aircraft " + string(poAircraft->GetName()) + " did not reach the same state.");
+        }
+    }
+}
+
 namespace SimpleWorld
 { 
     /**
@@ -28,138 +93,342 @@ namespace SimpleWorld
      *                           in the world at the same time.
      * @param uiChargers         The maximum number of chargers that can be
      *                           in the world at the same time.
+     * @param fSitePowerCap      The power cap in kW shared by all the chargers,
+     *                           0 for unlimited.
+     * @param poScenario         The scenario, or nullptr for random companies.
+     * @param poMemory           The memory the world arena takes its blocks from.
      */
-    World::World(uint8_t uiAircrafts, uint8_t uiChargers)
-        : SimulationWorld(uiAircrafts, uiChargers),
-        mfCurrentTime(0)
+    template <class TraceSink>
+    BasicWorld<TraceSink>::BasicWorld(uint32_t uiAircrafts, uint32_t uiChargers, float fSitePowerCap, const Scenario* poScenario,
+                                      pmr::memory_resource* poMemory)
+        : SimulationWorld(uiAircrafts, uiChargers + kuiMaxAddedChargers),
+        moSystemMemory(poMemory),
+        moArena(kuiArenaInitialSize, &moSystemMemory),
+        moPool(&moArena),
+        muiEventsAllocations(0),
+        moAircraftsSlab(&moArena),
+        mafTakeOffTime(&moArena),
+        mafTakeOffCharge(&moArena),
+        mabGrounded(&moArena),
+        mabParked(&moArena),
+        moChargersSlab(&moArena),
+        mfCurrentTime(0),
+        moEvents(less<Event>(), pmr::vector<Event>(&moPool)),
+        moImmediateEvents(pmr::deque<Event>(&moPool)),
+        muiHeapEvents(0),
+        muiImmediateEvents(0),
+        moEventsBatch(&moPool),
+        muiBatchPosition(0),
+        muiBatches(0),
+        moAircraftsQueue(pmr::deque<Aircraft*>(&moPool)),
+        moCancelledEvents(&moPool),
+        moSitePower(fSitePowerCap, &moPool),
+        moChargeSessions(&moPool),
+        mpoSampler(nullptr),
+        mpoSnapshot(nullptr),
+        muiSnapshotEvents(0),
+        mbDiagnostics(false),
+        mpoWarmup(nullptr),
+        mfHoursAfterWarmup(0),
+        mfWarmupTime(-1),
+        mfEndTime(0)
     {
-        cout << "Creating a simple world with " << to_string(uiAircrafts) << " aircrafts and "
-            << to_string(uiChargers) << " chargers." << endl << endl;
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << "Creating a simple world with " << uiAircrafts << " aircrafts and "
+                << uiChargers << " chargers";
+            if (fSitePowerCap > 0)
+            {
+                TraceSink::Stream() << " sharing " << fSitePowerCap << " kW";
+            }
+            TraceSink::Stream() << "." << endl << endl;
+
+            TraceSink::Stream() << "Aircrafts added to the world:" << endl;
+        }
 
-        cout << "Aircrafts added to the world:" << endl;
+        // Reserve the storage for the entities and the containers used by the events,
+        // every aircraft has at most one pending event, plus the cancelled ones. The
+        // chargers storage does not move when the commands add chargers.
+        moAircraftsSlab.reserve(uiAircrafts);
+        mafTakeOffTime.resize(uiAircrafts);
+        mafTakeOffCharge.resize(uiAircrafts);
+        mabGrounded.resize(uiAircrafts);
+        mabParked.resize(uiAircrafts);
+        moChargersSlab.reserve(uiChargers + kuiMaxAddedChargers);
+        pmr::vector<Event> oEvents(&moPool);
+        oEvents.reserve(2 * uiAircrafts);
+        moEvents = priority_queue<Event, pmr::vector<Event>>(less<Event>(), std::move(oEvents));
+        moCancelledEvents.reserve(uiAircrafts);
+        moEventsBatch.reserve(uiAircrafts);
+        moChargeSessions.reserve(uiChargers);
+        moChangedSessions.reserve(uiChargers);
 
-        // Set the random seed for the aircrafts creation.
-        srand(static_cast<unsigned int>(time(0)));
+        // Set the random seed for the aircrafts creation and the faults.
+        SeedWorld(poScenario);
 
-        // Create the aircrafts from the start, choosing a random
-        // company for each one.
-        for (uint8_t i = 0; i < uiAircrafts; i++)
+        // Create the aircrafts from the start, as in the scenario or
+        // choosing a random company for each one.
+        for (uint32_t i = 0; i < uiAircrafts; i++)
         {
-            // Choose a random company for the aircraft.
-            int iCompany = rand() % static_cast<int>(AircraftCompany::TotalCompanies);
-            AircraftCompany eCompany = static_cast<AircraftCompany>(iCompany);
-            
-            // Create the aircraft.
-            Aircraft* poAircraft = new Aircraft(eCompany);
+            if (poScenario != nullptr)
+            {
+                // Create the aircraft in the world storage with its initial charge.
+                const ScenarioAircraft& koInitial = poScenario->GetAircraft(i);
+                moAircraftsSlab.emplace_back(koInitial.eCompany, koInitial.fStateOfCharge);
+                Aircraft* poAircraft = &moAircraftsSlab.back();
+
+                // Put the aircraft in line for a charger if it starts waiting.
+                if (koInitial.eState == AircraftState::Queued)
+                {
+                    moAircraftsQueue.push(poAircraft);
+                    poAircraft->Queue();
+                }
+            }
+            else
+            {
+                // Choose a random company for the aircraft.
+                int iCompany = rand() % static_cast<int>(AircraftCompany::TotalCompanies);
+                AircraftCompany eCompany = static_cast<AircraftCompany>(iCompany);
+
+                // Create the aircraft in the world storage.
+                moAircraftsSlab.emplace_back(eCompany);
+            }
 
             // Add the aircraft to the world.
-            AddAircraft(poAircraft);
+            AddAircraft(&moAircraftsSlab.back());
         }
 
-        // Print the aircrafts added to the world in groups per type.
-        for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+        if constexpr (kbTrace)
         {
-            // Get the pointer to the aircraft type.
-            AircraftType* poAircraftType = AircraftType::GetAircraftType(static_cast<AircraftCompany>(i));
+            // Print the aircrafts added to the world in groups per type.
+            for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+            {
+                // Get the pointer to the aircraft type.
+                AircraftType* poAircraftType = AircraftType::GetAircraftType(static_cast<AircraftCompany>(i));
 
-            // Print the company name and the number of aircrafts of that type.
-            cout << poAircraftType->CompanyName() << ": " << to_string(poAircraftType->TotalAircrafts()) << endl;
+                // Print the company name and the number of aircrafts of that type.
+                TraceSink::Stream() << poAircraftType->CompanyName() << ": " << poAircraftType->TotalAircrafts() << endl;
 
-            // Print the aircrafts of that type.
-            for (Aircraft* poAircraft : GetAircrafts())
-            {
-                if (poAircraft->GetAircraftType() == poAircraftType)
+                // Print the aircrafts of that type.
+                for (Aircraft* poAircraft : GetAircrafts())
                 {
-                    cout << " " << poAircraft->GetName();
+                    if (poAircraft->GetAircraftType() == poAircraftType)
+                    {
+                        TraceSink::Stream() << " " << poAircraft->GetName();
+                    }
                 }
+
+                TraceSink::Stream() << endl;
             }
 
-            cout << endl;
+            TraceSink::Stream() << endl << "Chargers added to the world:" << endl;
         }
 
-        cout << endl << "Chargers added to the world:" << endl;
-
         // Create the chargers from the start.
-        for (uint8_t i = 0; i < uiChargers; i++)
+        for (uint32_t i = 0; i < uiChargers; i++)
         {
-            // Create the charger.
-            Charger* poCharger = new Charger();
+            // Create the charger in the world storage.
+            moChargersSlab.emplace_back();
+            Charger* poCharger = &moChargersSlab.back();
 
             // Add the charger to the world.
             AddCharger(poCharger);
 
             // Print that the charger was added to the world.
-            cout << " " << poCharger->GetName();
+            if constexpr (kbTrace)
+            {
+                TraceSink::Stream() << " " << poCharger->GetName();
+            }
         }
 
-        cout << endl << endl;
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << endl << endl;
+        }
     }
 
     /**
      * @brief Destroy the Simple World object.
      * 
      */
-    World::~World()
+    template <class TraceSink>
+    BasicWorld<TraceSink>::~BasicWorld()
     {
-        // Destroy the aircrafts.
-        for (const Aircraft* poAircraft : GetAircrafts())
+        // Nothing to do here, the aircrafts and chargers are destroyed with
+        // their storage, and the arena releases all the memory at once.
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::BeginRun()
+    {
+        // The run may end sooner than the simulation time after the warm-up.
+        mfEndTime = GetSimulationTime();
+        mfWarmupTime = -1;
+
+        if constexpr (kbTrace)
         {
-            delete poAircraft;
+            // Print the start of the simulation.
+            TraceSink::Stream() << endl;
+            TraceSink::Stream() << "============================================" << endl;
+            if (isinf(mfEndTime))
+            {
+                TraceSink::Stream() << " Running the simulation without end." << endl;
+            }
+            else
+            {
+                TraceSink::Stream() << " Running the simulation for " << TextWriter::Shortest(mfEndTime) << " hours." << endl;
+            }
+            TraceSink::Stream() << "============================================" << endl << endl;
+
+            // Print the number of aircrafts and chargers in the world.
+            TraceSink::Stream() << "Number of aircrafts in the world: " << GetAircraftsCount() << endl;
+            TraceSink::Stream() << "Number of chargers in the world: " << GetChargersCount() << endl << endl;
+
+            // Indicate the start of the simulation events.
+            TraceSink::Stream() << "Simulation events:" << endl;
         }
 
-        // Destroy the chargers.
-        for (const Charger* poCharger : GetChargers())
+        // Create the events for the aircrafts depending on its current state.
+        for (Aircraft* poAircraft : GetAircrafts())
         {
-            delete poCharger;
+            // Check if the aircraft is ready to fly, the others are in line for a charger.
+            if (poAircraft->GetState() == AircraftState::Idle)
+            {
+                // Schedule a event for the aircraft to take off.
+                ScheduleEvent(0, poAircraft, AircraftEvent::TakeOff);
+            }
+        }
+
+        // The aircrafts starting in line for a charger look for one now, in their order.
+        while (moAircraftsQueue.size() > 0)
+        {
+            Aircraft* poAircraft = moAircraftsQueue.front();
+            moAircraftsQueue.pop();
+            poAircraft->Dequeue();
+
+            // Schedule a event for the aircraft to charge.
+            ScheduleEvent(0, poAircraft, AircraftEvent::Charge);
+        }
+
+        // The readers get the fleet from the start.
+        if (mpoSnapshot != nullptr)
+        {
+            PublishSnapshot();
         }
     }
 
-    void World::RunSimulation(uint16_t uiHours)
+    template <class TraceSink>
+    uint64_t BasicWorld<TraceSink>::AdvanceRun(float fTime, uint64_t uiMaxEvents)
     {
-        // Set the simulation time.
-        SetSimulationTime(uiHours);
-
-        // Print the start of the simulation.
-        cout << endl;
-        cout << "============================================" << endl;
-        cout << " Running the simulation for " << to_string(uiHours) << " hours." << endl;
-        cout << "============================================" << endl << endl;
-
-        // Print the number of aircrafts and chargers in the world.
-        cout << "Number of aircrafts in the world: " << GetAircraftsCount() << endl;
-        cout << "Number of chargers in the world: " << GetChargersCount() << endl << endl;
-        
-        // Indicate the start of the simulation events.
-        cout << "Simulation events:" << endl;
+        // Count the system allocations while processing the events.
+        uint64_t uiAllocations = moSystemMemory.GetAllocations();
 
-        // Create the events for the aircrafts depending on its current state.
-        for (Aircraft* poAircraft : GetAircrafts())
+        // Process the events until the time, or the end of the run if sooner.
+        uint64_t uiEvents = 0;
+        while (uiEvents < uiMaxEvents)
         {
-            // Check if the aircraft has full battery charge.
-            if (poAircraft->GetBatteryCharge() == poAircraft->GetAircraftType()->GetBatteryCapacity())
+            // Take the next batch once the previous one is processed.
+            if (muiBatchPosition == moEventsBatch.size())
             {
-                // Schedule a event for the aircraft to take off.
-                ScheduleEvent(0, poAircraft, AircraftEvent::TakeOff);
+                if (!HasEvents() || GetNextEventTime() > fTime || GetNextEventTime() > mfEndTime)
+                {
+                    break;
+                }
+
+                // Get all the events happening at the next time.
+                PopNextEvents(moEventsBatch);
+                muiBatchPosition = 0;
+
+                // Sample the fleet as it was until now.
+                if (mpoSampler != nullptr)
+                {
+                    SampleFleet(moEventsBatch.front().GetTime(), false);
+                }
+
+                // Update the current time.
+                mfCurrentTime = moEventsBatch.front().GetTime();
             }
-            else
+
+            while (muiBatchPosition < moEventsBatch.size() && uiEvents < uiMaxEvents)
             {
-                // Schedule a event for the aircraft to charge.
-                ScheduleEvent(0, poAircraft, AircraftEvent::Charge);
+                Event& oEvent = moEventsBatch[muiBatchPosition++];
+                uiEvents++;
+
+                // Discard the event if it was cancelled, maybe by an event of the same batch.
+                if (moCancelledEvents.size() > 0 && moCancelledEvents.erase(oEvent.GetId()) > 0)
+                {
+                    continue;
+                }
+
+                // Process the event.
+                ProcessEvent(&oEvent);
+            }
+
+            // The rest of the batch is left for the next call.
+            if (muiBatchPosition < moEventsBatch.size())
+            {
+                break;
+            }
+
+            // Audit the fleet periodically, between batches the world is consistent.
+            if constexpr (kbValidation)
+            {
+                if (++muiBatches % kuiAuditPeriod == 0)
+                {
+                    AuditInvariants();
+                }
+            }
+
+            // Publish the fleet state once the events interval is reached.
+            if (mpoSnapshot != nullptr && (muiSnapshotEvents += moEventsBatch.size()) >= mpoSnapshot->GetEventsInterval())
+            {
+                PublishSnapshot();
+            }
+
+            // Once the fleet is steady, restart the statistics and run the hours asked after the warm-up.
+            if (mpoWarmup != nullptr && mfWarmupTime < 0 && mpoWarmup->IsDetected())
+            {
+                mfWarmupTime = mfCurrentTime;
+                mfEndTime = min(mfEndTime, mfCurrentTime + mfHoursAfterWarmup);
+                AircraftType::TruncateStatistics();
             }
         }
-        
-        // Process the events until reaching the end of the simulation.
-        while (moEvents.size() > 0)
+
+        // The world reaches the time when nothing happens before it, but the end of the run is left to EndRun().
+        if (muiBatchPosition == moEventsBatch.size() && fTime < mfEndTime && fTime > mfCurrentTime
+            && (!HasEvents() || GetNextEventTime() > fTime))
         {
-            // Get the first event.
-            Event oEvent = moEvents.top();
-            moEvents.pop();
+            mfCurrentTime = fTime;
+        }
 
-            // Update the current time.
-            mfCurrentTime = oEvent.GetTime();
+        muiEventsAllocations += moSystemMemory.GetAllocations() - uiAllocations;
+        return uiEvents;
+    }
 
-            // Process the event.
-            ProcessEvent(&oEvent);
+    template <class TraceSink>
+    bool BasicWorld<TraceSink>::IsRunOver() const
+    {
+        // A run without end is never over, even without events.
+        return !isinf(mfEndTime) && muiBatchPosition == moEventsBatch.size()
+            && (!HasEvents() || GetNextEventTime() > mfEndTime);
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::EndRun()
+    {
+        // Sample the fleet until the end of the simulation.
+        if (mpoSampler != nullptr)
+        {
+            SampleFleet(mfEndTime, true);
+        }
+
+        // Account the site energy until the end of the simulation.
+        moSitePower.Update(mfEndTime);
+
+        // The readers get the fleet at the end, with the aircrafts still waiting.
+        if (mpoSnapshot != nullptr)
+        {
+            PublishSnapshot();
         }
 
         // Free the charging queue.
@@ -168,17 +437,31 @@ namespace SimpleWorld
             // Get the first aircraft in the queue.
             Aircraft* poAircraft = moAircraftsQueue.front();
             moAircraftsQueue.pop();
+            poAircraft->Dequeue();
 
             // Print that the aircraft is not waiting to be charged anymore.
-            cout << GetTimeString() << ": Aircraft " << poAircraft->GetName()
-                << " is not waiting for a free charger anymore." << endl;
+            if constexpr (kbTrace)
+            {
+                TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                    << " is not waiting for a free charger anymore." << endl;
+            }
+        }
+
+        // Audit the fleet at the end of the simulation.
+        if constexpr (kbValidation)
+        {
+            AuditInvariants();
         }
 
         // Indicate the end of the simulation events.
-        cout << endl << "End of simulation events." << endl << endl;
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << endl << "End of simulation events." << endl << endl;
+        }
     }
 
-    float World::ScheduleEvent(float fTime, Aircraft* poAircraft, AircraftEvent peAircraftEvent, bool force)
+    template <class TraceSink>
+    float BasicWorld<TraceSink>::ScheduleEvent(float fTime, Aircraft* poAircraft, AircraftEvent peAircraftEvent, bool force, uint32_t* puiEventId)
     {
         // Check if the current time is the end of the simulation and the event is not forced.
         if (mfCurrentTime == GetSimulationTime() && !force)
@@ -199,14 +482,61 @@ namespace SimpleWorld
         // Allocate the event.
         Event poEvent(peAircraftEvent, poAircraft, fTriggeringTime);
 
-        // Add the event to the map.
-        moEvents.push(poEvent);
+        // Events at the current time happen after all the events already scheduled
+        // for now, as they have greater Ids, so they can skip the heap.
+        if (fTriggeringTime == mfCurrentTime)
+        {
+            moImmediateEvents.push(poEvent);
+            ++muiImmediateEvents;
+        }
+        else
+        {
+            moEvents.push(poEvent);
+            ++muiHeapEvents;
+        }
+
+        // Return the event Id if requested.
+        if (puiEventId != nullptr)
+        {
+            *puiEventId = poEvent.GetId();
+        }
 
         // Return the triggering time.
         return fTriggeringTime - mfCurrentTime;
     }
 
-    bool World::AssignCharger(Aircraft* poAircraft)
+    template <class TraceSink>
+    Event BasicWorld<TraceSink>::PopNextEvent()
+    {
+        // Take the immediate event unless the heap has one happening before it,
+        // scheduled before the immediate one or for the current time.
+        if (!moImmediateEvents.empty() && (moEvents.empty() || moEvents.top() < moImmediateEvents.front()))
+        {
+            Event oEvent = moImmediateEvents.front();
+            moImmediateEvents.pop();
+            return oEvent;
+        }
+
+        Event oEvent = moEvents.top();
+        moEvents.pop();
+        return oEvent;
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::PopNextEvents(pmr::vector<Event>& oBatch)
+    {
+        oBatch.clear();
+
+        // Take the events in order while they happen at the same time.
+        const float kfTime = GetNextEventTime();
+        do
+        {
+            oBatch.push_back(PopNextEvent());
+        } while (HasEvents() && GetNextEventTime() == kfTime);
+    }
+
+    template <class TraceSink>
+    Charger* BasicWorld<TraceSink>::FindFreeCharger() const
     {
         // Find the first available charger.
         for (Charger* poCharger : GetChargers())
@@ -214,49 +544,183 @@ namespace SimpleWorld
             // Check if the charger is not being used.
             if (!poCharger->IsCharging())
             {
-                // Charge the aircraft.
-                ChargeAircraft(poAircraft, poCharger);
-                return true;
+                return poCharger;
             }
         }
 
-        return false;
+        return nullptr;
     }
 
-    bool World::ChargeAircraft(Aircraft* poAircraft, Charger* poCharger)
+    template <class TraceSink>
+    bool BasicWorld<TraceSink>::AssignCharger(Aircraft* poAircraft)
     {
-        // Get the time it takes to fully charge the aircraft in hours.
-        float fTimeToCharge = poAircraft->GetTimeToFullCharge();
+        // Wait if another charger would not get a share of the site power.
+        if (!moSitePower.HasPowerLeft())
+        {
+            return false;
+        }
 
-        // Schedule the StopCharge event to happen when the aircraft
-        // stops charging, and get the real charging time in case the
-        // simulation time ends sooner.
-        fTimeToCharge = ScheduleEvent(fTimeToCharge, poAircraft, AircraftEvent::StopCharge);
+        // Find an available charger.
+        Charger* poCharger = FindFreeCharger();
+        if (poCharger == nullptr)
+        {
+            return false;
+        }
 
+        // Charge the aircraft.
+        ChargeAircraft(poAircraft, poCharger);
+        return true;
+    }
+
+    template <class TraceSink>
+    bool BasicWorld<TraceSink>::ChargeAircraft(Aircraft* poAircraft, Charger* poCharger)
+    {
         // Abort charging if the simulation already ended.
-        if (fTimeToCharge == 0)
+        if (mfCurrentTime == GetSimulationTime())
         {
             return false;
         }
 
-        // Get the charging rate of the aircraft.
-        float fChargingRate = poAircraft->GetAircraftType()->GetBatteryCapacity() / poAircraft->GetAircraftType()->GetTimeToCharge();
+        // Start the session at the site, it gets the nominal charging power
+        // of the aircraft or its share of the site power cap.
+        AircraftType* poAircraftType = poAircraft->GetAircraftType();
+        float fNominalPower = poAircraftType->GetBatteryCapacity() / poAircraftType->GetTimeToCharge();
+        moChangedSessions.clear();
+        float fPower = moSitePower.StartSession(poAircraft, fNominalPower, mfCurrentTime, moChangedSessions);
 
-        // Get the energy to charge the aircraft without exceeding the battery capacity.
-        float fEnergy =  min(fTimeToCharge * fChargingRate, poAircraft->GetAircraftType()->GetBatteryCapacity() - poAircraft->GetBatteryCharge());
-
-        // Charge the aircraft.
-        float fTime = poAircraft->ChargeAircraft(poCharger, fEnergy);
+        // Plan the session until the battery is full.
+        float fSoc = poAircraft->GetStateOfCharge();
+        ChargeSession& oSession = moChargeSessions[poAircraft];
+        oSession = ChargeSession{ poCharger, mfCurrentTime, fSoc, mfCurrentTime, fSoc, fNominalPower, fPower / fNominalPower, 0, 1, 0 };
+        float fTime = PlanChargeSession(poAircraft, oSession);
 
         // Print that the aircraft is charging.
-        cout << GetTimeString() << ": Aircraft " << poAircraft->GetName()
-            << " is charging at " << poCharger->GetName()
-            << " for " << fTime << " hours." << endl;
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                << " is charging at " << poCharger->GetName()
+                << " for " << fTime << " hours";
+            if (moSitePower.GetPowerCap() > 0)
+            {
+                TraceSink::Stream() << " at " << fPower << " kW";
+            }
+            TraceSink::Stream() << "." << endl;
+        }
+
+        // Replan the sessions that gave power to the new one.
+        ReplanChangedSessions();
 
         return true;
     }
 
-    void World::ProcessEvent(Event* poEvent)
+    template <class TraceSink>
+    float BasicWorld<TraceSink>::PlanChargeSession(Aircraft* poAircraft, ChargeSession& oSession)
+    {
+        AircraftType* poAircraftType = poAircraft->GetAircraftType();
+        const BatteryModel& oBatteryModel = poAircraftType->GetBatteryModel();
+        const float kfBatteryCapacity = poAircraftType->GetBatteryCapacity();
+
+        // Get the time it takes to fully charge the aircraft with the current power in hours.
+        float fTimeToFullCharge = oBatteryModel.GetTimeToCharge(oSession.mfSegmentSoc, 1.0f) / oSession.mfPowerFactor;
+
+        // Schedule the StopCharge event to happen when the aircraft
+        // stops charging, and get the real charging time in case the
+        // simulation time ends sooner.
+        float fTimeToCharge = ScheduleEvent(fTimeToFullCharge, poAircraft, AircraftEvent::StopCharge, false, &oSession.muiStopEventId);
+
+        // Undo the previous plan, getting the battery charge at the start of the session.
+        if (poAircraft->IsCharging())
+        {
+            poAircraft->RevertChargeAircraft(oSession.mfChargedEnergy, oSession.mfChargedFactor);
+        }
+
+        // Get the energy to charge the aircraft, the remaining capacity unless
+        // the simulation ends sooner, then what the battery model charges in that time.
+        float fEnergy = kfBatteryCapacity - poAircraft->GetBatteryCharge();
+        float fEndSoc = 1.0f;
+        if (fTimeToCharge < fTimeToFullCharge)
+        {
+            fEndSoc = oBatteryModel.GetSocAfterCharging(oSession.mfSegmentSoc, fTimeToCharge * oSession.mfPowerFactor);
+            fEnergy = min((fEndSoc - oSession.mfStartSoc) * kfBatteryCapacity, fEnergy);
+        }
+
+        // Get the average power factor of the whole session if the power changed.
+        oSession.mfChargedFactor = oSession.mfPowerFactor;
+        float fSessionTime = mfCurrentTime - oSession.mfStartTime + fTimeToCharge;
+        if (oSession.mfSegmentTime != oSession.mfStartTime && fSessionTime > 0)
+        {
+            float fFactor = oBatteryModel.GetTimeToCharge(oSession.mfStartSoc, fEndSoc) / fSessionTime;
+            if (fFactor > 0)
+            {
+                oSession.mfChargedFactor = min(fFactor, 1.0f);
+            }
+        }
+
+        // Charge the aircraft for the whole session.
+        oSession.mfChargedEnergy = fEnergy;
+        poAircraft->ChargeAircraft(oSession.mpoCharger, fEnergy, oSession.mfChargedFactor);
+
+        return fTimeToCharge;
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::ReplanChangedSessions()
+    {
+        for (Aircraft* poCharging : moChangedSessions)
+        {
+            // The sessions finish at the end of the simulation anyway.
+            if (mfCurrentTime == GetSimulationTime())
+            {
+                break;
+            }
+
+            // Get the charge reached with the previous power.
+            ChargeSession& oSession = moChargeSessions[poCharging];
+            const BatteryModel& oBatteryModel = poCharging->GetAircraftType()->GetBatteryModel();
+            oSession.mfSegmentSoc = oBatteryModel.GetSocAfterCharging(oSession.mfSegmentSoc,
+                (mfCurrentTime - oSession.mfSegmentTime) * oSession.mfPowerFactor);
+            oSession.mfSegmentTime = mfCurrentTime;
+
+            // Replace the StopCharge event with one for the new power.
+            float fPower = moSitePower.GetSessionPower(poCharging);
+            oSession.mfPowerFactor = fPower / oSession.mfNominalPower;
+            CancelEvent(oSession.muiStopEventId);
+            float fTime = PlanChargeSession(poCharging, oSession);
+
+            // Print that the aircraft charging power changed.
+            if constexpr (kbTrace)
+            {
+                TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poCharging->GetName()
+                    << " is charging at " << fPower << " kW now, and will finish in " << fTime << " hours." << endl;
+            }
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::ChargeQueuedAircrafts()
+    {
+        while (moAircraftsQueue.size() > 0 && moSitePower.HasPowerLeft())
+        {
+            // Find an available charger.
+            Charger* poCharger = FindFreeCharger();
+            if (poCharger == nullptr)
+            {
+                break;
+            }
+
+            // Try to charge the first aircraft in the queue.
+            if (!ChargeAircraft(moAircraftsQueue.front(), poCharger))
+            {
+                break;
+            }
+
+            // Remove the aircraft from the queue.
+            moAircraftsQueue.pop();
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::ProcessEvent(Event* poEvent)
     {
         // Get the aircraft involved in the event.
         Aircraft* poAircraft = poEvent->GetAircraft();
@@ -266,8 +730,21 @@ namespace SimpleWorld
         {
             case AircraftEvent::TakeOff:
             {
+                // A grounded aircraft stays idle until it is released.
+                size_t uiIndex = poAircraft - moAircraftsSlab.data();
+                if (mabGrounded[uiIndex])
+                {
+                    mabParked[uiIndex] = true;
+                    if constexpr (kbTrace)
+                    {
+                        TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                            << " stays on the ground." << endl;
+                    }
+                    break;
+                }
+
                 // Get the flying time for the aircraft.
-                float fFlyingTime = poAircraft->GetCurrentRange() / poAircraft->GetAircraftType()->GetCruiseSpeed();
+                float fFlyingTime = poAircraft->GetCurrentRange() * poAircraft->GetAircraftType()->GetHoursPerMile();
 
                 // Schedule the land event to happen when the aircraft will be out of battery,
                 // and get the real flying time in case the simulation time ends sooner.
@@ -276,27 +753,37 @@ namespace SimpleWorld
                 // Get the distance the aircraft will fly in the flying time without exceeding the current range.
                 float fDistance = min(fFlyingTime * poAircraft->GetAircraftType()->GetCruiseSpeed(), poAircraft->GetCurrentRange());
 
+                // Keep the take off for the sampler.
+                mafTakeOffTime[uiIndex] = mfCurrentTime;
+                mafTakeOffCharge[uiIndex] = poAircraft->GetBatteryCharge();
+
                 // Fly the aircraft.
-                poAircraft->Fly(fDistance);
+                ApplyReversibly(poAircraft, [&]() { poAircraft->Fly(fDistance); }, [&]() { poAircraft->RevertFly(fDistance); });
 
                 // Print that the aircraft is taking off.
-                cout << GetTimeString() << ": Aircraft " << poAircraft->GetName()
-                    << " is taking off and will fly " << to_string(fDistance) << " miles for "
-                    << to_string(fFlyingTime) << " hours." << endl;
+                if constexpr (kbTrace)
+                {
+                    TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                        << " is taking off and will fly " << TextWriter::Fixed(fDistance) << " miles for "
+                        << TextWriter::Fixed(fFlyingTime) << " hours." << endl;
+                }
             }
             break;
 
             case AircraftEvent::Land:
             {
                 // Land the aircraft.
-                poAircraft->Land();
+                ApplyReversibly(poAircraft, [&]() { poAircraft->Land(); }, [&]() { poAircraft->RevertLand(); });
 
                 // Schedule the charge event to inmediately charge the aircraft.
                 ScheduleEvent(0, poAircraft, AircraftEvent::Charge);
 
                 // Print that the aircraft had landed.
-                cout << GetTimeString() << ": Aircraft " << poAircraft->GetName()
-                    << " has landed." << endl;
+                if constexpr (kbTrace)
+                {
+                    TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                        << " has landed." << endl;
+                }
             }
             break;
 
@@ -307,10 +794,14 @@ namespace SimpleWorld
                 {
                     // If the aircraft is not charging, add the aircraft to the queue.
                     moAircraftsQueue.push(poAircraft);
+                    poAircraft->Queue();
 
                     // Print that the aircraft is waiting to be charged.
-                    cout << GetTimeString() << ": Aircraft " << poAircraft->GetName()
-                        << " is waiting for a free charger." << endl;
+                    if constexpr (kbTrace)
+                    {
+                        TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                            << " is waiting for a free charger." << endl;
+                    }
                 }
             }
             break;
@@ -318,42 +809,333 @@ namespace SimpleWorld
             case AircraftEvent::StopCharge:
             {
                 // Stop charging the aircraft and get the newly available charger.
-                Charger* poCharger = poAircraft->StopCharging();
+                Charger* poCharger = nullptr;
+                ApplyReversibly(poAircraft, [&]() { poCharger = poAircraft->StopCharging(); },
+                                [&]() { poAircraft->RevertStopCharging(poCharger); });
 
                 // Schedule the take off event to inmediately take off the aircraft.
                 ScheduleEvent(0, poAircraft, AircraftEvent::TakeOff);
 
                 // Print that the aircraft is fully charged.
-                cout << GetTimeString() << ": Aircraft " << poAircraft->GetName()
-                    << " has been charged up to " << poAircraft->GetBatteryCharge()
-                    << " kWh, and has been disconnected from " << poCharger->GetName() << "." << endl;
+                if constexpr (kbTrace)
+                {
+                    TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                        << " has been charged up to " << poAircraft->GetBatteryCharge()
+                        << " kWh, and has been disconnected from " << poCharger->GetName() << "." << endl;
+                }
+
+                // Release the site power, and replan the sessions receiving it.
+                moChangedSessions.clear();
+                moSitePower.StopSession(poAircraft, mfCurrentTime, moChangedSessions);
+                moChargeSessions.erase(poAircraft);
+
+                ReplanChangedSessions();
+
+                // Charge the aircrafts waiting with the released charger and power.
+                ChargeQueuedAircrafts();
+            }
+            break;
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::PrintStatistics() const
+    {
+        // Print the statistics per aircraft type.
+        SimulationWorld::PrintStatistics();
+
+        TextWriter oOutput(cout);
+
+        // Print the window of the statistics if they are collected after the warm-up.
+        if (mpoWarmup != nullptr)
+        {
+            oOutput << "===============================================" << endl;
+            oOutput << " Warm-up" << endl;
+            oOutput << "===============================================" << endl << endl;
+            if (mfWarmupTime >= 0)
+            {
+                oOutput << "Warm-up truncation (MSER-5): " << TextWriter::Fixed(mpoWarmup->GetTruncationSamples() * mpoSampler->GetInterval()) << " hours" << endl;
+                oOutput << "Statistics collected from " << TextWriter::Fixed(mfWarmupTime) << " to " << TextWriter::Fixed(mfEndTime) << " hours" << endl;
+            }
+            else
+            {
+                oOutput << "Warm-up not detected in " << TextWriter::Fixed(mfEndTime) << " hours, the statistics include it" << endl;
+            }
+            oOutput << endl;
+        }
+
+        // Print the site power statistics when the chargers share a cap.
+        if (moSitePower.GetPowerCap() > 0)
+        {
+            float fHours = moSitePower.GetTime();
+            oOutput << "===============================================" << endl;
+            oOutput << " Site power statistics" << endl;
+            oOutput << "===============================================" << endl << endl;
+            oOutput << "Site power cap: " << TextWriter::Fixed(moSitePower.GetPowerCap()) << " kW" << endl;
+            oOutput << "Peak site power: " << TextWriter::Fixed(moSitePower.GetPeakPower()) << " kW" << endl;
+            oOutput << "Total energy delivered: " << TextWriter::Fixed(moSitePower.GetEnergy()) << " kWh" << endl;
+            oOutput << "Average energy per hour: " << TextWriter::Fixed(fHours > 0 ? moSitePower.GetEnergy() / fHours : 0.0f) << " kWh/hour" << endl;
+            oOutput << endl;
+        }
+
+        // Print the events diagnostics if asked for, and the snapshots published.
+        bool bSnapshots = mpoSnapshot != nullptr && mpoSnapshot->GetPublishCount() > 0;
+        if (mbDiagnostics || bSnapshots)
+        {
+            oOutput << "===============================================" << endl;
+            oOutput << " Events diagnostics" << endl;
+            oOutput << "===============================================" << endl << endl;
+            if (mbDiagnostics)
+            {
+                oOutput << "System allocations: " << GetSystemAllocations() << endl;
+                oOutput << "System allocations while processing the events: " << GetEventsAllocations() << endl;
+                oOutput << "Events scheduled through the heap: " << GetHeapEvents() << endl;
+                oOutput << "Events scheduled immediately: " << GetImmediateEvents() << endl;
+            }
+            if (bSnapshots)
+            {
+                oOutput << "Fleet snapshots published: " << mpoSnapshot->GetPublishCount() << ", "
+                    << TextWriter::Fixed(chrono::duration<double, micro>(mpoSnapshot->GetPublishTime()).count() / mpoSnapshot->GetPublishCount())
+                    << " us each" << endl;
+            }
+            oOutput << endl;
+        }
+
+        // Close the blocks printed after the statistics per aircraft type.
+        if (mpoWarmup != nullptr || moSitePower.GetPowerCap() > 0 || mbDiagnostics || bSnapshots)
+        {
+            oOutput << "===============================================" << endl << endl;
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::SampleFleet(float fTime, bool bIncluded)
+    {
+        while (mpoSampler->IsDueBefore(fTime) || (bIncluded && mpoSampler->GetNextSampleTime() == fTime))
+        {
+            float fSampleTime = mpoSampler->GetNextSampleTime();
+
+            // Count the aircrafts per state and get the states of charge.
+            FleetGauges oGauges{};
+            float fLowestSoc = 1.0f;
+            float fHighestSoc = 0.0f;
+            float fTotalSoc = 0.0f;
+            for (const Aircraft* poAircraft : GetAircrafts())
+            {
+                oGauges[(size_t)FleetGauge::Airborne] += poAircraft->IsFlying();
+                oGauges[(size_t)FleetGauge::Queued] += poAircraft->GetState() == AircraftState::Queued;
+                oGauges[(size_t)FleetGauge::Charging] += poAircraft->IsCharging();
+
+                // Clamp the rounding errors of the empty and full batteries.
+                float fSoc = clamp(GetStateOfChargeAt(poAircraft, fSampleTime), 0.0f, 1.0f);
+                fLowestSoc = min(fLowestSoc, fSoc);
+                fHighestSoc = max(fHighestSoc, fSoc);
+                fTotalSoc += fSoc;
+            }
 
-                // Check if there are aircrafts waiting to be charged.
-                if (moAircraftsQueue.size() > 0)
+            if (GetAircraftsCount() > 0)
+            {
+                oGauges[(size_t)FleetGauge::MinStateOfCharge] = fLowestSoc;
+                oGauges[(size_t)FleetGauge::MeanStateOfCharge] = fTotalSoc / GetAircraftsCount();
+                oGauges[(size_t)FleetGauge::MaxStateOfCharge] = fHighestSoc;
+            }
+
+            mpoSampler->Record(oGauges);
+            if (mpoWarmup != nullptr)
+            {
+                mpoWarmup->Add(oGauges);
+            }
+        }
+    }
+
+    template <class TraceSink>
+    float BasicWorld<TraceSink>::GetStateOfChargeAt(const Aircraft* poAircraft, float fTime) const
+    {
+        // The battery charge is updated when the flight or the charge starts,
+        // so it is the charge at the end of the current flight or charge.
+        float fEndSoc = poAircraft->GetStateOfCharge();
+        const AircraftType* poAircraftType = poAircraft->GetAircraftType();
+
+        if (poAircraft->IsFlying())
+        {
+            // Discharge linearly from the take off.
+            size_t uiIndex = poAircraft - moAircraftsSlab.data();
+            float fUsedEnergy = (fTime - mafTakeOffTime[uiIndex]) * poAircraftType->GetCruiseSpeed() * poAircraftType->GetEnergyUse();
+            return max(fEndSoc, (mafTakeOffCharge[uiIndex] - fUsedEnergy) * poAircraftType->GetInverseBatteryCapacity());
+        }
+
+        if (poAircraft->IsCharging())
+        {
+            // Charge with the battery model from the current power allocation.
+            auto oSession = moChargeSessions.find(const_cast<Aircraft*>(poAircraft));
+            if (oSession != moChargeSessions.end())
+            {
+                const ChargeSession& koSession = oSession->second;
+                float fSoc = poAircraftType->GetBatteryModel().GetSocAfterCharging(koSession.mfSegmentSoc,
+                    (fTime - koSession.mfSegmentTime) * koSession.mfPowerFactor);
+                return min(fEndSoc, fSoc);
+            }
+        }
+
+        return fEndSoc;
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::SetFleetSnapshot(FleetSnapshot* poSnapshot)
+    {
+        // The snapshot has room for every aircraft and for the chargers the commands add.
+        if (poSnapshot != nullptr && (poSnapshot->GetAircraftsCount() != GetAircraftsCount() || poSnapshot->GetMaxChargers() < GetMaxChargers()))
+        {
+            throw std::runtime_error("The fleet snapshot is not sized for " + to_string(GetAircraftsCount()) + " aircrafts and "
+                + to_string(GetMaxChargers()) + " chargers.");
+        }
+        mpoSnapshot = poSnapshot;
+        muiSnapshotEvents = 0;
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::PublishSnapshot()
+    {
+        muiSnapshotEvents = 0;
+        mpoSnapshot->BeginWrite(mfCurrentTime, static_cast<uint32_t>(moAircraftsQueue.size()), GetChargersCount());
+
+        // Clamp the rounding errors of the empty and full batteries.
+        for (uint32_t i = 0; i < moAircraftsSlab.size(); i++)
+        {
+            const Aircraft& koAircraft = moAircraftsSlab[i];
+            mpoSnapshot->WriteAircraft(i, clamp(GetStateOfChargeAt(&koAircraft, mfCurrentTime), 0.0f, 1.0f), koAircraft.GetState());
+        }
+
+        const vector<Charger*>& koChargers = GetChargers();
+        for (uint32_t i = 0; i < koChargers.size(); i++)
+        {
+            mpoSnapshot->WriteCharger(i, koChargers[i]->IsCharging());
+        }
+
+        mpoSnapshot->EndWrite();
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::AuditInvariants() const
+    {
+        SimulationWorld::AuditInvariants();
+
+        // The queued aircrafts are the ones in the charging queue.
+        const vector<Aircraft*>& koAircrafts = GetAircrafts();
+        size_t uiQueued = count_if(koAircrafts.begin(), koAircrafts.end(),
+            [](const Aircraft* poAircraft) { return poAircraft->GetState() == AircraftState::Queued; });
+        if (uiQueued != moAircraftsQueue.size())
+        {
+            throw std::runtime_error(to_string(uiQueued) + " aircrafts are queued but the charging queue has "
+                + to_string(moAircraftsQueue.size()) + ".");
+        }
+    }
+
+    template <class TraceSink>
+    bool BasicWorld<TraceSink>::ApplyCommand(const WorldCommand& koCommand)
+    {
+        if (IsFinished())
+        {
+            return false;
+        }
+
+        // Sample the fleet as it was until now.
+        if (mpoSampler != nullptr && IsStarted())
+        {
+            SampleFleet(mfCurrentTime, false);
+        }
+
+        switch (koCommand.eType)
+        {
+            case WorldCommandType::GroundAircraft:
+            case WorldCommandType::ReleaseAircraft:
+            {
+                if (koCommand.uiAircraft >= moAircraftsSlab.size())
                 {
-                    // Get the first aircraft in the queue.
-                    Aircraft* poAircraft = moAircraftsQueue.front();
+                    return false;
+                }
+                Aircraft* poAircraft = &moAircraftsSlab[koCommand.uiAircraft];
+                bool bGround = koCommand.eType == WorldCommandType::GroundAircraft;
+                mabGrounded[koCommand.uiAircraft] = bGround;
 
-                    // Try to charge the aircraft.
-                    if (ChargeAircraft(poAircraft, poCharger))
-                    {
-                        // Remove the aircraft from the queue.
-                        moAircraftsQueue.pop();
-                    }
+                // A released aircraft waiting on the ground takes off now.
+                if (!bGround && mabParked[koCommand.uiAircraft])
+                {
+                    mabParked[koCommand.uiAircraft] = false;
+                    ScheduleEvent(0, poAircraft, AircraftEvent::TakeOff);
+                }
+
+                if constexpr (kbTrace)
+                {
+                    TraceSink::Stream() << FormatCurrentTime() << ": Aircraft " << poAircraft->GetName()
+                        << (bGround ? " is grounded." : " is released.") << endl;
                 }
+                return true;
+            }
+
+            case WorldCommandType::AddCharger:
+            {
+                // The chargers are kept in place, the aircrafts point to them.
+                if (moChargersSlab.size() == moChargersSlab.capacity())
+                {
+                    return false;
+                }
+                moChargersSlab.emplace_back();
+                Charger* poCharger = &moChargersSlab.back();
+                AddCharger(poCharger);
+
+                if constexpr (kbTrace)
+                {
+                    TraceSink::Stream() << FormatCurrentTime() << ": " << poCharger->GetName() << " is added to the world." << endl;
+                }
+
+                // The aircrafts waiting take the new charger, the run starts with them in line.
+                if (IsStarted())
+                {
+                    ChargeQueuedAircrafts();
+                }
+                return true;
             }
-            break;
         }
+
+        return false;
     }
 
-    string World::GetTimeString() const
+    // Build the worlds with the available trace sinks.
+    template class BasicWorld<ConsoleTrace>;
+    template class BasicWorld<NullTrace>;
+
+    // Set the options of a new world that are not constructor arguments.
+    template <class TraceSink>
+    static unique_ptr<SimulationWorld> SetWorldOptions(unique_ptr<BasicWorld<TraceSink>> poWorld, const WorldOptions& koOptions)
     {
-        // Convert the current time to a string with 2 decimal positions.
-        stringstream oTime;
-        oTime << fixed << setprecision(2) << mfCurrentTime;
+        poWorld->SetMetricsSampler(koOptions.poSampler);
+        poWorld->SetWarmupDetector(koOptions.poWarmup, koOptions.fHoursAfterWarmup);
+        poWorld->SetFleetSnapshot(koOptions.poSnapshot);
+        poWorld->SetDiagnostics(koOptions.bDiagnostics);
+        return poWorld;
+    }
 
-        // Return the formatted time string.
-        return oTime.str();
+    // Create the world with the trace sink chosen, forwarding the constructor arguments.
+    template <class... Args>
+    static unique_ptr<SimulationWorld> CreateTracedWorld(const WorldOptions& koOptions, const Args&... args)
+    {
+        if (koOptions.bTraceEvents)
+        {
+            return SetWorldOptions(make_unique<BasicWorld<ConsoleTrace>>(args..., koOptions.fSitePowerCap), koOptions);
+        }
+
+        return SetWorldOptions(make_unique<BasicWorld<NullTrace>>(args..., koOptions.fSitePowerCap), koOptions);
+    }
+
+    unique_ptr<SimulationWorld> CreateWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers, const WorldOptions& koOptions)
+    {
+        return CreateTracedWorld(koOptions, uiMaxAircrafts, uiMaxChargers);
+    }
+
+    unique_ptr<SimulationWorld> CreateWorld(const Scenario& oScenario, const WorldOptions& koOptions)
+    {
+        return CreateTracedWorld(koOptions, oScenario);
     }
 
 } // namespace SimpleWorld
@@ -2,11 +2,23 @@
 #define _SIMPLE_WORLD_H_
 
 #include "worlds/SimulationWorld.h"
+#include "worlds/SitePower.h"
+#include "worlds/TraceSinks.h"
 #include "aircrafts/Aircraft.h"
 #include "AircraftEvents.h"
 #include "Event.h"
+#include "worlds/MetricsSampler.h"
+#include "worlds/FleetSnapshot.h"
+#include "worlds/WarmupDetector.h"
+#include "worlds/Scenario.h"
+#include "utils/CountingMemoryResource.h"
+#include "utils/TextWriter.h"
 
+#include <memory>
+#include <memory_resource>
 #include <queue>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 
@@ -17,10 +29,21 @@ namespace SimpleWorld
      *        the time, with aircrafts that can travel without changing their
      *        position and chargers located in the only position. 
      * 
+     * @note  The world is a template of its trace sink, so a world without
+     *        tracing has no printing code nor branches on the events path.
+     *        The SimulationWorld base class is the runtime interface, called
+     *        once per simulation and not per event.
+     * 
+     * @tparam TraceSink    The trace sink policy, see worlds/TraceSinks.h.
      */
-    class World : public SimulationWorld
+    template <class TraceSink>
+    class BasicWorld : public SimulationWorld
     {
     public:
+        /********** Constants **********/
+
+        static constexpr uint32_t kuiMaxAddedChargers = 16; ///< The chargers the commands can add to the world.
+
         /********** Constructors **********/
 
         /**
@@ -30,8 +53,24 @@ namespace SimpleWorld
          *                           in the world at the same time.
          * @param uiMaxChargers      The maximum number of chargers that can be
          *                           in the world at the same time.
+         * @param fSitePowerCap      The power cap in kW shared by all the chargers,
+         *                           0 for unlimited.
          */
-        World(uint8_t uiMaxAircrafts, uint8_t uiMaxChargers);
+        BasicWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers, float fSitePowerCap = 0)
+            : BasicWorld(uiMaxAircrafts, uiMaxChargers, fSitePowerCap, nullptr, pmr::new_delete_resource()) {}
+
+        /**
+         * @brief Construct a new Simple World object with the fleet of a scenario.
+         * 
+         * @param oScenario          The scenario, only used while constructing.
+         * @param fSitePowerCap      The power cap in kW shared by all the chargers,
+         *                           0 for unlimited.
+         * @param poMemory           The memory the world arena takes its blocks
+         *                           from, which must outlive the world, as a pool
+         *                           kept by a thread to reuse them between worlds.
+         */
+        BasicWorld(const Scenario& oScenario, float fSitePowerCap = 0, pmr::memory_resource* poMemory = pmr::new_delete_resource())
+            : BasicWorld(oScenario.GetAircraftsCount(), oScenario.GetChargersCount(), fSitePowerCap, &oScenario, poMemory) {}
 
         /********** Destructor **********/
 
@@ -39,18 +78,226 @@ namespace SimpleWorld
          * @brief Destroy the Simple World object.
          * 
          */
-        ~World();
+        ~BasicWorld();
 
         /********** Methods **********/
 
         /**
-         * @brief Run the simulation for a given number of hours using the Event-Driven method.
+         * @brief Print the world statistics, including the site power ones when
+         *        the chargers share a cap.
+         * 
+         */
+        void PrintStatistics() const override;
+
+        /**
+         * @brief Get the name of the kind of world.
+         * 
+         * @return The world name.
+         */
+        inline string_view GetWorldName() const override { return "simple"; }
+
+        /**
+         * @brief Get the time the simulation reached, the time of the last
+         *        events or the time it was advanced to.
+         * 
+         * @return The time in hours.
+         */
+        inline float GetWorldTime() const override { return mfCurrentTime; }
+
+        /**
+         * @brief Get the time of the next event, the current time if a batch
+         *        of events was left half processed.
+         * 
+         * @return The time in hours, infinite without events.
+         */
+        inline float GetNextTime() const override
+        {
+            if (muiBatchPosition < moEventsBatch.size())
+            {
+                return mfCurrentTime;
+            }
+            return HasEvents() ? GetNextEventTime() : numeric_limits<float>::infinity();
+        }
+
+        /**
+         * @brief Get the number of allocations the world asked to the system.
+         * 
+         * @return The number of allocations.
+         */
+        inline uint64_t GetSystemAllocations() const { return moSystemMemory.GetAllocations(); }
+
+        /**
+         * @brief Get the number of allocations the world asked to the system
+         *        while processing the simulation events, after the start-up.
+         * 
+         * @return The number of allocations.
+         */
+        inline uint64_t GetEventsAllocations() const { return muiEventsAllocations; }
+
+        /**
+         * @brief Get the number of events scheduled through the events heap.
+         * 
+         * @return The number of events.
+         */
+        inline uint64_t GetHeapEvents() const { return muiHeapEvents; }
+
+        /**
+         * @brief Get the number of events scheduled to happen immediately,
+         *        which bypass the events heap.
          * 
-         * @param uiHours       The number of hours to run the simulation.
+         * @return The number of events.
          */
-        void RunSimulation(uint16_t uiHours) override;
+        inline uint64_t GetImmediateEvents() const { return muiImmediateEvents; }
+
+        /**
+         * @brief Sample the fleet gauges while running the simulation.
+         * 
+         * @param poSampler     The sampler, owned by the caller, or nullptr to stop sampling.
+         * 
+         * @note  The samples are taken between the events batches, the fleet
+         *        state is constant between events except the states of charge,
+         *        which are interpolated for the flying and charging aircrafts.
+         */
+        inline void SetMetricsSampler(MetricsSampler* poSampler) { mpoSampler = poSampler; }
+
+        /**
+         * @brief Publish the fleet state every number of events while running
+         *        the simulation, for other threads to read it without locks.
+         * 
+         * @param poSnapshot    The snapshot, owned by the caller, or nullptr to stop publishing.
+         * 
+         * @throw std::runtime_error if the snapshot is not sized for the world.
+         * 
+         * @note  The state is published between the events batches, once the
+         *        events interval of the snapshot is reached, and at the start
+         *        and the end of the run. The states of charge are interpolated
+         *        for the flying and charging aircrafts.
+         */
+        void SetFleetSnapshot(FleetSnapshot* poSnapshot);
+
+        /**
+         * @brief Print the events and allocations counters with the statistics,
+         *        to diagnose the events path.
+         * 
+         * @param bDiagnostics  If the counters are printed.
+         */
+        inline void SetDiagnostics(bool bDiagnostics) { mbDiagnostics = bDiagnostics; }
+
+        /**
+         * @brief Detect the end of the warm-up on the sampled fleet gauges,
+         *        then restart the statistics and run some hours more, at
+         *        most until the simulation time (steady state statistics).
+         * 
+         * @param poDetector            The detector, owned by the caller, or nullptr to
+         *                              collect the statistics of the whole run.
+         * @param fHoursAfterWarmup     The hours to run once the warm-up is detected.
+         * 
+         * @note  The detector only gets samples with a metrics sampler.
+         */
+        inline void SetWarmupDetector(WarmupDetector* poDetector, float fHoursAfterWarmup)
+        {
+            mpoWarmup = poDetector;
+            mfHoursAfterWarmup = fHoursAfterWarmup;
+        }
+
+        /**
+         * @brief Get the time the warm-up was detected and the statistics restarted.
+         * 
+         * @return The time in hours, or a negative time if it was not detected.
+         */
+        inline float GetWarmupTime() const { return mfWarmupTime; }
+
+        /**
+         * @brief Check the invariants of the fleet and of the charging queue.
+         * 
+         * @throw std::runtime_error if an invariant does not hold.
+         */
+        void AuditInvariants() const override;
+
+        /**
+         * @brief Apply a command between the events, at the current time.
+         * 
+         * @param koCommand     The command.
+         * 
+         * @return If the command was applied, false if the aircraft does not
+         *         exist, if kuiMaxAddedChargers were added or if the
+         *         simulation finished.
+         * 
+         * @note  A grounded aircraft finishes its flight and its charge, then
+         *        stays idle until it is released. An added charger takes the
+         *        first aircraft waiting at once.
+         */
+        bool ApplyCommand(const WorldCommand& koCommand) override;
+
+    protected:
+        /**
+         * @brief Schedule the events of the aircrafts depending on their state.
+         * 
+         */
+        void BeginRun() override;
+
+        /**
+         * @brief Process the events using the Event-Driven method, the events
+         *        happening at the same time are processed as a batch, which a
+         *        number of events can leave unfinished.
+         * 
+         * @param fTime         The time in hours.
+         * @param uiMaxEvents   The maximum number of events to process.
+         * 
+         * @return The events processed.
+         */
+        uint64_t AdvanceRun(float fTime, uint64_t uiMaxEvents) override;
+
+        /**
+         * @brief Check if all the events until the end of the run, the
+         *        simulation time or sooner after the warm-up, were processed.
+         * 
+         * @return If the run is over.
+         */
+        bool IsRunOver() const override;
+
+        /**
+         * @brief Sample the fleet and account the site energy until the end of
+         *        the run, and free the charging queue.
+         * 
+         */
+        void EndRun() override;
 
     private:
+        static constexpr bool kbTrace = TraceSink::kbEnabled; // If the world prints its events.
+
+        /**
+         * @brief Construct a new Simple World object, with random companies or
+         *        with the fleet of a scenario.
+         * 
+         * @param uiAircrafts        The number of aircrafts.
+         * @param uiChargers         The number of chargers.
+         * @param fSitePowerCap      The power cap in kW shared by all the chargers,
+         *                           0 for unlimited.
+         * @param poScenario         The scenario, or nullptr for random companies.
+         * @param poMemory           The memory the world arena takes its blocks from.
+         */
+        BasicWorld(uint32_t uiAircrafts, uint32_t uiChargers, float fSitePowerCap, const Scenario* poScenario,
+                   pmr::memory_resource* poMemory);
+
+        /**
+         * @brief A charge session, tracked to replan it when its power changes.
+         * 
+         */
+        struct ChargeSession
+        {
+            Charger* mpoCharger;     // The charger used.
+            float mfStartTime;       // The time the session started in hours.
+            float mfStartSoc;        // The state of charge when the session started.
+            float mfSegmentTime;     // The time the current power was allocated in hours.
+            float mfSegmentSoc;      // The state of charge when the current power was allocated.
+            float mfNominalPower;    // The power the aircraft charges at without sharing in kW.
+            float mfPowerFactor;     // The current fraction of the nominal power.
+            float mfChargedEnergy;   // The energy charged to the aircraft for the planned session in kWh.
+            float mfChargedFactor;   // The average power factor of the planned session.
+            uint32_t muiStopEventId; // The Id of the StopCharge event.
+        };
+
         /**
          * @brief Schedule an event.
          * 
@@ -58,10 +305,62 @@ namespace SimpleWorld
          * @param poAircraft        The aircraft involved in the event.
          * @param peAircraftEvent   The type of event that will happen.
          * @param force             If the event must happen to get the aircraft into a state that makes sense.
+         * @param puiEventId        If not null, gets the Id of the scheduled event.
          * 
          * @return The real time when the event will happen from now.
          */
-        float ScheduleEvent(float fTime, Aircraft* poAircraft, AircraftEvent peAircraftEvent, bool force = false);
+        float ScheduleEvent(float fTime, Aircraft* poAircraft, AircraftEvent peAircraftEvent, bool force = false, uint32_t* puiEventId = nullptr);
+
+        /**
+         * @brief Cancel a scheduled event, it will be discarded when its time comes.
+         * 
+         * @param uiEventId         The Id of the event to cancel.
+         */
+        inline void CancelEvent(uint32_t uiEventId) { moCancelledEvents.insert(uiEventId); }
+
+        /**
+         * @brief Check if there are events pending.
+         * 
+         * @return If there are events pending.
+         */
+        inline bool HasEvents() const { return !moEvents.empty() || !moImmediateEvents.empty(); }
+
+        /**
+         * @brief Remove the next event to happen, from the immediate events
+         *        or the events heap, in the same order as a single heap.
+         * 
+         * @return The next event.
+         */
+        Event PopNextEvent();
+
+        /**
+         * @brief Get the time of the next event to happen.
+         * 
+         * @return The time of the next event, there must be events pending.
+         */
+        inline float GetNextEventTime() const
+        {
+            // The immediate events happen now, before any event in the heap.
+            return !moImmediateEvents.empty() ? moImmediateEvents.front().GetTime() : moEvents.top().GetTime();
+        }
+
+        /**
+         * @brief Remove all the events happening at the time of the next event,
+         *        in the order they must be processed.
+         * 
+         * @param oBatch    Gets the events, it is cleared first.
+         * 
+         * @note  The events scheduled while processing the batch for the same
+         *        time have greater Ids, so they belong to the next batch.
+         */
+        void PopNextEvents(pmr::vector<Event>& oBatch);
+
+        /**
+         * @brief Find a charger not being used.
+         * 
+         * @return The free charger, or nullptr if all are being used.
+         */
+        Charger* FindFreeCharger() const;
 
         /**
          * @brief Tries to assign a charger to an aircraft.
@@ -82,6 +381,30 @@ namespace SimpleWorld
          */
         bool ChargeAircraft(Aircraft* poAircraft, Charger* poCharger);
 
+        /**
+         * @brief Plan a charge session until the battery is full with the power
+         *        currently allocated, replacing the previous plan if any.
+         * 
+         * @param poAircraft    The aircraft charging.
+         * @param oSession      The charge session.
+         * 
+         * @return The charging time from now in hours.
+         */
+        float PlanChargeSession(Aircraft* poAircraft, ChargeSession& oSession);
+
+        /**
+         * @brief Replan the charge sessions whose site power changed, from the
+         *        current time with their new power.
+         * 
+         */
+        void ReplanChangedSessions();
+
+        /**
+         * @brief Charge the aircrafts in the queue while there are free chargers and power.
+         * 
+         */
+        void ChargeQueuedAircrafts();
+
         /**
          * @brief Process an event.
          * 
@@ -90,17 +413,126 @@ namespace SimpleWorld
         void ProcessEvent(Event* poEvent);
 
         /**
-         * @brief Get the current time as a string.
+         * @brief Record the samples due before a time, or until the time included.
+         * 
+         * @param fTime         The time in hours.
+         * @param bIncluded     If the sample at the time is also due.
+         */
+        void SampleFleet(float fTime, bool bIncluded);
+
+        /**
+         * @brief Get the state of charge of an aircraft at a time, interpolated
+         *        if it is flying or charging.
+         * 
+         * @param poAircraft    The aircraft.
+         * @param fTime         The time in hours, not after the aircraft next event.
+         * 
+         * @return The state of charge.
+         */
+        float GetStateOfChargeAt(const Aircraft* poAircraft, float fTime) const;
+
+        /**
+         * @brief Publish the fleet state at the current time to the snapshot.
+         * 
+         */
+        void PublishSnapshot();
+
+        /**
+         * @brief Get the current time to write it with 2 decimal positions.
          * 
-         * @return The current time as a string.
+         * @return The current time formatted.
          */
-        string GetTimeString() const;
+        inline TextWriter::Fixed FormatCurrentTime() const { return TextWriter::Fixed(mfCurrentTime, 2); }
 
         /********** Variables **********/
+
+        // Memory of the world, released at once when the world is destroyed.
+        CountingMemoryResource moSystemMemory; // Counts the allocations asked to the system, or to the memory given.
+        pmr::monotonic_buffer_resource moArena; // The world arena.
+        pmr::unsynchronized_pool_resource moPool; // Reuses the memory released by the containers.
+        uint64_t muiEventsAllocations; // The system allocations while processing the events.
+
+        pmr::vector<Aircraft> moAircraftsSlab; // The storage for the aircrafts.
+        pmr::vector<float> mafTakeOffTime; // The last take off time per aircraft, for the sampler.
+        pmr::vector<float> mafTakeOffCharge; // The battery charge at the last take off per aircraft, for the sampler.
+        pmr::vector<bool> mabGrounded; // If the aircraft is grounded by a command, per aircraft.
+        pmr::vector<bool> mabParked; // If the grounded aircraft is idle without events, per aircraft.
+        pmr::vector<Charger> moChargersSlab; // The storage for the chargers.
+
         float mfCurrentTime; // The current time in the world.
-        priority_queue<Event> moEvents; // The events that will happen in the world.
-        queue<Aircraft*> moAircraftsQueue; // The queue of aircrafts waiting to be charged.
+        priority_queue<Event, pmr::vector<Event>> moEvents; // The events that will happen in the world.
+        queue<Event, pmr::deque<Event>> moImmediateEvents; // The events that happen at the current time, in scheduling order.
+        uint64_t muiHeapEvents; // The events scheduled through the heap.
+        uint64_t muiImmediateEvents; // The events scheduled at the current time.
+        pmr::vector<Event> moEventsBatch; // The events happening at the same time, reused between batches.
+        size_t muiBatchPosition; // The next event of the batch to process, its size once processed.
+        uint32_t muiBatches; // The batches processed, to audit the fleet periodically.
+        queue<Aircraft*, pmr::deque<Aircraft*>> moAircraftsQueue; // The queue of aircrafts waiting to be charged.
+        pmr::unordered_set<uint32_t> moCancelledEvents; // The Ids of the scheduled events cancelled.
+        SitePower moSitePower; // The power shared by the chargers.
+        pmr::unordered_map<Aircraft*, ChargeSession> moChargeSessions; // The charge sessions in progress.
+        vector<Aircraft*> moChangedSessions; // The sessions whose power changed, reused between events.
+        MetricsSampler* mpoSampler; // The sampler of the fleet gauges, if any.
+        FleetSnapshot* mpoSnapshot; // The snapshot the fleet state is published to, if any.
+        uint64_t muiSnapshotEvents; // The events processed since the last publication.
+        bool mbDiagnostics; // If the statistics include the events and allocations counters.
+        WarmupDetector* mpoWarmup; // The detector of the warm-up on the samples, if any.
+        float mfHoursAfterWarmup; // The hours to run after the warm-up.
+        float mfWarmupTime; // The time the warm-up was detected, negative until then.
+        float mfEndTime; // The time the run ends, the simulation time or sooner after the warm-up.
     };
+
+    /**
+     * @brief The simple world printing its events to the console.
+     * 
+     */
+    using World = BasicWorld<ConsoleTrace>;
+
+    /**
+     * @brief The simple world without printing its events.
+     * 
+     */
+    using QuietWorld = BasicWorld<NullTrace>;
+
+    /**
+     * @brief The options of a simple world created with the trace sink chosen
+     *        at runtime.
+     * 
+     */
+    struct WorldOptions
+    {
+        float fSitePowerCap = 0;                ///< The power cap in kW shared by all the chargers, 0 for unlimited.
+        bool bTraceEvents = false;              ///< If the world prints its events.
+        MetricsSampler* poSampler = nullptr;    ///< The sampler of the fleet gauges, owned by the caller, or nullptr.
+        WarmupDetector* poWarmup = nullptr;     ///< The detector of the warm-up on the samples, owned by the caller, or nullptr.
+        float fHoursAfterWarmup = 0;            ///< The hours to run once the warm-up is detected.
+        FleetSnapshot* poSnapshot = nullptr;    ///< The snapshot the fleet state is published to, owned by the caller, or nullptr.
+        bool bDiagnostics = false;              ///< If the statistics include the events and allocations counters.
+    };
+
+    /**
+     * @brief Create a simple world choosing the trace sink at runtime.
+     * 
+     * @param uiMaxAircrafts     The maximum number of aircrafts that can be
+     *                           in the world at the same time.
+     * @param uiMaxChargers      The maximum number of chargers that can be
+     *                           in the world at the same time.
+     * @param koOptions          The options of the world.
+     * 
+     * @return The new world.
+     */
+    unique_ptr<SimulationWorld> CreateWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers, const WorldOptions& koOptions = WorldOptions());
+
+    /**
+     * @brief Create a simple world with the fleet of a scenario, choosing the
+     *        trace sink at runtime.
+     * 
+     * @param oScenario          The scenario, only used while creating the world.
+     * @param koOptions          The options of the world.
+     * 
+     * @return The new world.
+     */
+    unique_ptr<SimulationWorld> CreateWorld(const Scenario& oScenario, const WorldOptions& koOptions = WorldOptions());
 }
 
 #endif // _SIMPLE_WORLD_H_
@@ -5,15 +5,20 @@
  */
 
 #include "SimulationWorld.h"
+#include "utils/TextWriter.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
 #include <iostream>
+#include <stdexcept>
 
 using namespace std;
 
 
-SimulationWorld::SimulationWorld(uint8_t uiMaxAircrafts, uint8_t uiMaxChargers)
-    : muiMaxAircrafts(uiMaxAircrafts), muiMaxChargers(uiMaxChargers)
+SimulationWorld::SimulationWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers)
+    : mfSimulationTime(0), mbStarted(false), mbFinished(false), muiSeed(0), muiMaxAircrafts(uiMaxAircrafts), muiMaxChargers(uiMaxChargers)
 {
     // Reserve memory for the aircrafts and chargers vectors.
     moAircrafts.reserve(muiMaxAircrafts);
@@ -27,6 +32,88 @@ SimulationWorld::~SimulationWorld()
     moChargers.clear();
 }
 
+void SimulationWorld::RunSimulation(uint16_t uiHours)
+{
+    Start(uiHours);
+    RunUntil(uiHours);
+}
+
+void SimulationWorld::Start(float fHorizon)
+{
+    if (mbStarted)
+    {
+        throw std::runtime_error("The simulation already started.");
+    }
+    if (isnan(fHorizon) || fHorizon < 0)
+    {
+        throw std::runtime_error("The simulation horizon must not be negative.");
+    }
+
+    mfSimulationTime = fHorizon;
+    mbStarted = true;
+    BeginRun();
+}
+
+void SimulationWorld::RunUntil(float fTime)
+{
+    if (!mbStarted)
+    {
+        Start();
+    }
+    if (mbFinished)
+    {
+        return;
+    }
+
+    AdvanceRun(min(fTime, mfSimulationTime), numeric_limits<uint64_t>::max());
+
+    // Report the flights and charge sessions in progress once the end is reached.
+    if (IsRunOver())
+    {
+        EndRun();
+        mbFinished = true;
+    }
+}
+
+uint64_t SimulationWorld::Step(uint64_t uiMaxEvents)
+{
+    if (!mbStarted)
+    {
+        Start();
+    }
+    if (mbFinished)
+    {
+        return 0;
+    }
+
+    uint64_t uiEvents = AdvanceRun(mfSimulationTime, uiMaxEvents);
+    if (IsRunOver())
+    {
+        EndRun();
+        mbFinished = true;
+    }
+    return uiEvents;
+}
+
+uint64_t SimulationWorld::StepFor(chrono::nanoseconds oBudget)
+{
+    // Process a few events between the clock checks, reading the clock costs as much as an event.
+    const chrono::steady_clock::time_point koDeadline = chrono::steady_clock::now() + oBudget;
+    uint64_t uiEvents = 0;
+    do
+    {
+        uiEvents += Step(kuiEventsPerClockCheck);
+    } while (!mbFinished && chrono::steady_clock::now() < koDeadline);
+
+    return uiEvents;
+}
+
+bool SimulationWorld::ApplyCommand(const WorldCommand&)
+{
+    // Only the worlds that can change while running support the commands.
+    return false;
+}
+
 bool SimulationWorld::AddAircraft(Aircraft* oAircraft)
 {
     // Check if there is space for the aircraft.
@@ -55,17 +142,42 @@ bool SimulationWorld::AddCharger(Charger* oCharger)
     return false;
 }
 
+void SimulationWorld::SeedWorld(const Scenario* poScenario)
+{
+    // Set the random seed for the aircrafts creation, the scenario one if any.
+    SetSeed(static_cast<uint32_t>(time(0)));
+    if (poScenario != nullptr && poScenario->GetSeed() != 0)
+    {
+        SetSeed(poScenario->GetSeed());
+    }
+
+    if (poScenario == nullptr)
+    {
+        // Seed the faults generators from the same random sequence as the companies.
+        srand(GetSeed());
+        AircraftType::SeedFaultGenerators(static_cast<uint32_t>(rand()));
+    }
+    else
+    {
+        // The scenario has the companies, the faults generators are seeded without
+        // the global rand() sequence, so the worlds can run in parallel threads.
+        AircraftType::SeedFaultGenerators(GetSeed());
+    }
+}
+
 void SimulationWorld::PrintStatistics() const
 {
+    TextWriter oOutput(cout);
+
     // Print the maximum number of aircrafts and chargers.
-    cout << endl;
-    cout << "===============================================" << endl;
-    cout << " Simulation statistics per aircraft type" << endl;
-    cout << "===============================================" << endl << endl;
-    cout << "Total number of aircrafts types: " << to_string((int)AircraftCompany::TotalCompanies) << endl;
-    cout << "Total number of aircrafts: " << to_string(moAircrafts.size()) << endl;
-    cout << "Total number of chargers: " << to_string(moChargers.size()) << endl;
-    cout << endl;
+    oOutput << endl;
+    oOutput << "===============================================" << endl;
+    oOutput << " Simulation statistics per aircraft type" << endl;
+    oOutput << "===============================================" << endl << endl;
+    oOutput << "Total number of aircrafts types: " << (int)AircraftCompany::TotalCompanies << endl;
+    oOutput << "Total number of aircrafts: " << moAircrafts.size() << endl;
+    oOutput << "Total number of chargers: " << moChargers.size() << endl;
+    oOutput << endl;
 
     // Iterate the aircraft types.
     for (int i = 0; i < static_cast<int>(AircraftCompany::TotalCompanies); i++)
@@ -75,22 +187,72 @@ void SimulationWorld::PrintStatistics() const
         AircraftType* poAircraftType = AircraftType::GetAircraftType(eCompany);
 
         // Print the statistics for the aircraft type.
-        cout << "Aircraft type: " << poAircraftType->CompanyName() << endl;
-        cout << "-----------------------------------------------" << endl;
-        cout << "Total number of aircrafts: " << to_string(poAircraftType->TotalAircrafts()) << endl;
-        cout << "Passenger capacity per aircraft: " << to_string(poAircraftType->GetPassengers()) << " passengers" << endl;
-        cout << "Total number of flights: " << to_string(poAircraftType->TotalFlights()) << endl;
-        cout << "Total number of miles: " << to_string(poAircraftType->TotalNumberOfMiles()) << endl;
-        cout << "Total number of passengers: " << to_string(poAircraftType->TotalNumberOfPassengers()) << endl;
-        cout << "Total number of charge sessions: " << to_string(poAircraftType->TotalChargeSessions()) << endl;
-        cout << endl;
-        cout << "Average flight time per flight: " << to_string(poAircraftType->AverageFlightTimePerFlight()) << " hours" << endl;
-        cout << "Average distance travelled per flight: " << to_string(poAircraftType->AverageDistanceTravelledPerFlight()) << " miles" << endl;
-        cout << "Average time charging per charge session: " << to_string(poAircraftType->AverageTimeChargingPerChargeSession()) << " hours" << endl;
-        cout << "Total number of faults: " << to_string(poAircraftType->TotalNumberOfFaults()) << endl;
-        cout << "Total number of passenger miles: " << to_string(poAircraftType->TotalNumberOfPassengerMiles()) << endl;
-        cout << endl;
-    }
-
-    cout << "===============================================" << endl << endl;
-}
\ No newline at end of file
+        oOutput << "Aircraft type: " << poAircraftType->CompanyName() << endl;
+        oOutput << "-----------------------------------------------" << endl;
+        oOutput << "Total number of aircrafts: " << poAircraftType->TotalAircrafts() << endl;
+        oOutput << "Passenger capacity per aircraft: " << poAircraftType->GetPassengers() << " passengers" << endl;
+        oOutput << "Total number of flights: " << poAircraftType->TotalFlights() << endl;
+        oOutput << "Total number of miles: " << TextWriter::Fixed(poAircraftType->TotalNumberOfMiles()) << endl;
+        oOutput << "Total number of passengers: " << poAircraftType->TotalNumberOfPassengers() << endl;
+        oOutput << "Total number of charge sessions: " << poAircraftType->TotalChargeSessions() << endl;
+        oOutput << endl;
+        oOutput << "Average flight time per flight: " << TextWriter::Fixed(poAircraftType->AverageFlightTimePerFlight()) << " hours" << endl;
+        oOutput << "Average distance travelled per flight: " << TextWriter::Fixed(poAircraftType->AverageDistanceTravelledPerFlight()) << " miles" << endl;
+        oOutput << "Average time charging per charge session: " << TextWriter::Fixed(poAircraftType->AverageTimeChargingPerChargeSession()) << " hours" << endl;
+        oOutput << "Total number of faults: " << poAircraftType->TotalNumberOfFaults() << endl;
+        if (AircraftType::GetFaultSampling().fImportanceFactor != 1.0f)
+        {
+            oOutput << "Estimated number of faults: " << TextWriter::Fixed(poAircraftType->EstimatedNumberOfFaults()) << endl;
+        }
+        oOutput << "Total number of passenger miles: " << TextWriter::Fixed(poAircraftType->TotalNumberOfPassengerMiles()) << endl;
+        oOutput << endl;
+    }
+
+    oOutput << "===============================================" << endl << endl;
+}
+
+void SimulationWorld::ExportStatistics(StatisticsWriter& oWriter) const
+{
+    // A run in progress has simulated the time reached.
+    oWriter.WriteRun(RunMetadata{ GetWorldName(), muiSeed, mbFinished ? mfSimulationTime : GetWorldTime(),
+        (uint32_t)moAircrafts.size(), (uint32_t)moChargers.size() });
+}
+
+void SimulationWorld::AuditInvariants() const
+{
+    // Tolerance for the rounding of the battery charge in kWh.
+    const float kfTolerance = 1e-3f;
+
+    uint32_t uiChargingAircrafts = 0;
+    for (const Aircraft* poAircraft : moAircrafts)
+    {
+        // The battery charge must be within the battery capacity.
+        float fBatteryCharge = poAircraft->GetBatteryCharge();
+        if (fBatteryCharge < -kfTolerance || fBatteryCharge > poAircraft->GetAircraftType()->GetBatteryCapacity() + kfTolerance)
+        {
+            throw std::runtime_error("Aircraft " + string(poAircraft->GetName()) + " has a battery charge out of its capacity.");
+        }
+
+        // Only the charging aircrafts are connected, to a charger in use.
+        if (poAircraft->IsCharging() != (poAircraft->GetCharger() != nullptr))
+        {
+            throw std::runtime_error("Aircraft " + string(poAircraft->GetName()) + " is " + AircraftStateName(poAircraft->GetState())
+                + (poAircraft->GetCharger() != nullptr ? " with a charger." : " without a charger."));
+        }
+        if (poAircraft->IsCharging())
+        {
+            if (!poAircraft->GetCharger()->IsCharging())
+            {
+                throw std::runtime_error("Aircraft " + string(poAircraft->GetName()) + " is connected to an unused charger.");
+            }
+            ++uiChargingAircrafts;
+        }
+    }
+
+    // Each charger in use charges only one aircraft.
+    uint32_t uiChargersInUse = count_if(moChargers.begin(), moChargers.end(), [](const Charger* poCharger) { return poCharger->IsCharging(); });
+    if (uiChargersInUse != uiChargingAircrafts)
+    {
+        throw std::runtime_error(to_string(uiChargingAircrafts) + " aircrafts are charging at " + to_string(uiChargersInUse) + " chargers.");
+    }
+}
@@ -0,0 +1,371 @@
+/**
+ * @brief Contains tests for the SimulationWorld class.
+ *
+*/
+
+#include "SimulationWorld.h"
+#include "Scenario.h"
+#include "SimpleWorld/World.h"
+#include "SteppedWorld/World.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// The scenario of the tests, a small fleet with aircrafts waiting for the chargers.
+static unique_ptr<Scenario> CreateScenario()
+{
+    unique_ptr<Scenario> poScenario = make_unique<Scenario>();
+    poScenario->SetChargersCount(2);
+    poScenario->SetSeed(7);
+    poScenario->AddAircrafts(AircraftCompany::Alpha, 3, 1.0f, AircraftState::Idle);
+    poScenario->AddAircrafts(AircraftCompany::Charlie, 2, 1.0f, AircraftState::Idle);
+    poScenario->AddAircrafts(AircraftCompany::Echo, 2, 0.5f, AircraftState::Queued);
+    return poScenario;
+}
+
+// Get all the metrics of all the companies of the calling thread.
+static vector<double> GetStatistics()
+{
+    vector<double> afValues;
+    for (size_t uiMetric = 0; uiMetric < StatisticsWriter::GetMetricsCount(); uiMetric++)
+    {
+        for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+        {
+            afValues.push_back(StatisticsWriter::GetMetric(uiMetric).pfGetValue(*AircraftType::GetAircraftType(static_cast<AircraftCompany>(i))));
+        }
+    }
+    return afValues;
+}
+
+// Get the bound of the difference of a metric of a company between the stepped and the event driven
+// worlds, for a fleet with a charger per aircraft. Each cycle of an aircraft, a full flight and a full
+// charge, delays its charge and its take off one time step at most, so by the end of the run the
+// aircraft lags at most two steps per cycle, and can start or finish that lag over a cycle less or more.
+static double GetSteppedTolerance(size_t uiMetric, AircraftCompany eCompany, uint32_t uiAircrafts, float fHours, float fTimeStep,
+                                  const vector<double>& kafExpected)
+{
+    const AircraftType& koType = *AircraftType::GetAircraftType(eCompany);
+    const double kfFlightTime = koType.GetBatteryCapacity() * koType.GetHoursPerMile() / koType.GetEnergyUse();
+    const double kfCycleTime = kfFlightTime + koType.GetBatteryModel().GetTimeToCharge(0.0f, 1.0f);
+    const double kfLag = 2 * ceil(fHours / kfCycleTime) * fTimeStep;
+
+    // The flights and charge sessions, and the hours flying or charging, of the whole company.
+    const double kfCycles = uiAircrafts * (1 + floor(kfLag / kfCycleTime));
+    const double kfHoursLag = uiAircrafts * kfLag;
+
+    // The expected value of a metric of the company.
+    auto Expected = [&](const char* pcMetric)
+    {
+        const size_t kuiMetric = StatisticsWriter::FindMetric(pcMetric) - &StatisticsWriter::GetMetric(0);
+        return kafExpected[kuiMetric * (size_t)AircraftCompany::TotalCompanies + (size_t)eCompany];
+    };
+
+    // The bound of an average, from the bounds of its total and of its count.
+    auto AverageTolerance = [&](const char* pcCount, double fTotalTolerance)
+    {
+        const double kfAverage = kafExpected[uiMetric * (size_t)AircraftCompany::TotalCompanies + (size_t)eCompany];
+        const double kfCount = Expected(pcCount);
+        if (kfCount <= kfCycles)
+        {
+            return numeric_limits<double>::infinity();
+        }
+        return max((kfAverage * kfCount + fTotalTolerance) / (kfCount - kfCycles) - kfAverage,
+                   kfAverage - (kfAverage * kfCount - fTotalTolerance) / (kfCount + kfCycles));
+    };
+
+    const string_view ksMetric = StatisticsWriter::GetMetric(uiMetric).pcName;
+    if (ksMetric == "flights" || ksMetric == "charge_sessions")
+    {
+        return kfCycles;
+    }
+    if (ksMetric == "passengers")
+    {
+        return koType.GetPassengers() * kfCycles;
+    }
+    if (ksMetric == "miles")
+    {
+        return koType.GetCruiseSpeed() * kfHoursLag;
+    }
+    if (ksMetric == "passenger_miles")
+    {
+        // The product of the passengers and the miles.
+        const double kfPassengersTolerance = koType.GetPassengers() * kfCycles;
+        const double kfMilesTolerance = koType.GetCruiseSpeed() * kfHoursLag;
+        return Expected("passengers") * kfMilesTolerance + Expected("miles") * kfPassengersTolerance
+            + kfPassengersTolerance * kfMilesTolerance;
+    }
+    if (ksMetric == "faults" || ksMetric == "estimated_faults")
+    {
+        // The same flights draw the same faults, the others have the faults of a flight at most.
+        return (kfCycles + uiAircrafts) * (ceil(koType.GetFaultProbability() * kfFlightTime) + 1);
+    }
+    if (ksMetric == "average_flight_time_hours")
+    {
+        return AverageTolerance("flights", kfHoursLag);
+    }
+    if (ksMetric == "average_flight_distance_miles")
+    {
+        return AverageTolerance("flights", koType.GetCruiseSpeed() * kfHoursLag);
+    }
+    if (ksMetric == "average_charge_time_hours")
+    {
+        return AverageTolerance("charge_sessions", kfHoursLag);
+    }
+
+    // The fleet does not depend on the time step.
+    return 0;
+}
+
+// Test the SimulationWorld::RunUntil() and SimulationWorld::Step() methods.
+// Check a run advanced by many calls gets the statistics of the run at once.
+TEST_CASE( "SimulationWorld::RunUntil" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWholeWorld(*poScenario);
+    oWholeWorld.RunSimulation(5);
+    REQUIRE(oWholeWorld.IsFinished());
+    const vector<double> kafExpected = GetStatistics();
+
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(*poScenario);
+    oWorld.Start(5);
+    oWorld.RunUntil(0.75f);
+    REQUIRE(oWorld.GetWorldTime() == 0.75f);
+    REQUIRE(!oWorld.IsFinished());
+
+    // A batch of events can be left half processed.
+    uint64_t uiEvents = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        uiEvents += oWorld.Step(3);
+    }
+    REQUIRE(uiEvents == 30);
+    oWorld.RunUntil(2.5f);
+    while (!oWorld.IsFinished())
+    {
+        oWorld.Step(1);
+    }
+    REQUIRE(oWorld.GetWorldTime() <= 5);
+    REQUIRE(oWorld.Step(10) == 0);
+    REQUIRE(GetStatistics() == kafExpected);
+    REQUIRE_THROWS(oWorld.Start(5));
+}
+
+// Test the SimulationWorld::Step() method of the stepped world.
+// Check a time step counts as an event, and the run advanced by many calls gets the statistics of the run at once.
+TEST_CASE( "SimulationWorld::Step stepped" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+
+    AircraftType::ResetStatistics();
+    SteppedWorld::QuietWorld oWholeWorld(*poScenario, 0.1f);
+    oWholeWorld.RunSimulation(3);
+    const vector<double> kafExpected = GetStatistics();
+
+    AircraftType::ResetStatistics();
+    SteppedWorld::QuietWorld oWorld(*poScenario, 0.1f);
+    oWorld.Start(3);
+    REQUIRE(oWorld.Step(5) == 5);
+    oWorld.RunUntil(1.05f);
+    REQUIRE(fabs(oWorld.GetWorldTime() - 1.0f) < 1e-5f);
+    REQUIRE(oWorld.Step(100) == 20);
+    REQUIRE(oWorld.IsFinished());
+    REQUIRE(GetStatistics() == kafExpected);
+}
+
+// The quiet stepped world with its fleet visible to the tests.
+class InspectedSteppedWorld : public SteppedWorld::QuietWorld
+{
+public:
+    using SteppedWorld::QuietWorld::QuietWorld;
+    using SimulationWorld::GetAircrafts;
+    using SimulationWorld::GetChargers;
+};
+
+// Test the SteppedWorld::World aircrafts while stepping.
+// Check the aircrafts and the chargers get the states of the arrays through the transitions table.
+TEST_CASE( "SteppedWorld::World fleet state" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+
+    AircraftType::ResetStatistics();
+    InspectedSteppedWorld oWorld(*poScenario, 0.1f);
+    REQUIRE(oWorld.GetAircrafts()[5]->GetState() == AircraftState::Queued);
+    oWorld.Start(3);
+
+    // The queued aircrafts take the chargers, and leave them once charged.
+    const float kfStartCharge = oWorld.GetAircrafts()[0]->GetStateOfCharge();
+    for (long iExpected : { 2, 0 })
+    {
+        oWorld.Step(iExpected > 0 ? 1 : 5);
+        long iCharging = 0;
+        for (const Aircraft* poAircraft : oWorld.GetAircrafts())
+        {
+            iCharging += poAircraft->IsCharging();
+            REQUIRE(poAircraft->GetState() != AircraftState::Idle);
+            REQUIRE(poAircraft->GetStateOfCharge() >= 0);
+            REQUIRE(poAircraft->GetStateOfCharge() <= 1);
+            REQUIRE((poAircraft->GetCharger() != nullptr) == poAircraft->IsCharging());
+        }
+        REQUIRE(iCharging == iExpected);
+        REQUIRE(count_if(oWorld.GetChargers().begin(), oWorld.GetChargers().end(), [](const Charger* poCharger) { return poCharger->IsCharging(); }) == iExpected);
+    }
+    REQUIRE(oWorld.GetAircrafts()[0]->GetStateOfCharge() < kfStartCharge);
+}
+
+// Test the SimulationWorld::StepFor() method and the runs without end or past 65535 hours.
+// Check the world advances within the budget, and the fractional and long horizons are reached.
+TEST_CASE( "SimulationWorld::StepFor" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+
+    // A run without end never finishes, the time reached is kept.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oEndless(*poScenario);
+    REQUIRE(oEndless.Step(1000) == 1000);
+    REQUIRE(isinf(oEndless.GetHorizon()));
+    oEndless.RunUntil(oEndless.GetWorldTime() + 10);
+    REQUIRE(!oEndless.IsFinished());
+    REQUIRE(oEndless.StepFor(chrono::milliseconds(1)) > 0);
+    REQUIRE(!oEndless.IsFinished());
+
+    // A fractional horizon far past the hours of RunSimulation().
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(*poScenario);
+    oWorld.Start(70000.5f);
+    while (!oWorld.IsFinished())
+    {
+        oWorld.StepFor(chrono::milliseconds(5));
+    }
+    REQUIRE(oWorld.GetWorldTime() == 70000.5f);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights() > 10000);
+}
+
+// Test the SimulationWorld::ApplyCommand() method.
+// Check a grounded aircraft stops flying until released, and the chargers added are bounded.
+TEST_CASE( "SimulationWorld::ApplyCommand" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+    const AircraftType* kpoAlpha = AircraftType::GetAircraftType(AircraftCompany::Alpha);
+
+    // The aircrafts 0 to 2 are the Alpha ones.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(*poScenario);
+    oWorld.Start(6);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        REQUIRE(oWorld.ApplyCommand(WorldCommand{ WorldCommandType::GroundAircraft, i }));
+    }
+    REQUIRE(!oWorld.ApplyCommand(WorldCommand{ WorldCommandType::GroundAircraft, 7 }));
+    oWorld.RunUntil(3);
+    REQUIRE(kpoAlpha->TotalFlights() == 0);
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        REQUIRE(oWorld.ApplyCommand(WorldCommand{ WorldCommandType::ReleaseAircraft, i }));
+    }
+    REQUIRE(oWorld.GetNextTime() == 3);
+    oWorld.RunUntil(6);
+    REQUIRE(kpoAlpha->TotalFlights() >= 3);
+
+    // The chargers storage has room for a few more.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oChargers(*poScenario);
+    for (uint32_t i = 0; i < SimpleWorld::QuietWorld::kuiMaxAddedChargers; i++)
+    {
+        REQUIRE(oChargers.ApplyCommand(WorldCommand{ WorldCommandType::AddCharger, 0 }));
+    }
+    REQUIRE(!oChargers.ApplyCommand(WorldCommand{ WorldCommandType::AddCharger, 0 }));
+    oChargers.RunSimulation(1);
+    REQUIRE(!oChargers.ApplyCommand(WorldCommand{ WorldCommandType::AddCharger, 0 }));
+    REQUIRE(oChargers.GetChargersCount() == poScenario->GetChargersCount() + SimpleWorld::QuietWorld::kuiMaxAddedChargers);
+
+    // The stepped world does not support the commands.
+    SteppedWorld::QuietWorld oStepped(*poScenario, 0.1f);
+    REQUIRE(!oStepped.ApplyCommand(WorldCommand{ WorldCommandType::AddCharger, 0 }));
+}
+
+// Test the SteppedWorld::World statistics against the event driven world with the same scenario.
+// Check every metric of every company is within the bound of delaying the transitions one time step, and the gap shrinks with the step.
+TEST_CASE( "SteppedWorld::World tolerance" )
+{
+    // A charger per aircraft, so the delays do not reorder the queue, and the faults drawn per
+    // aircraft and flight, so the same flights get the same faults in both worlds.
+    const float kfHours = 20;
+    const uint32_t kuiAircrafts = 2;
+    Scenario oScenario;
+    oScenario.SetChargersCount(kuiAircrafts * static_cast<uint32_t>(AircraftCompany::TotalCompanies));
+    oScenario.SetSeed(3);
+    for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+    {
+        oScenario.AddAircrafts(static_cast<AircraftCompany>(i), kuiAircrafts, 1.0f, AircraftState::Idle);
+    }
+    FaultSampling oSampling;
+    oSampling.bCommonRandomNumbers = true;
+    AircraftType::SetFaultSampling(oSampling);
+
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oEventWorld(oScenario);
+    oEventWorld.RunSimulation(kfHours);
+    const vector<double> kafExpected = GetStatistics();
+
+    double fLastGap = numeric_limits<double>::infinity();
+    for (float fTimeStep : { 0.1f, 0.01f, 0.001f })
+    {
+        AircraftType::ResetStatistics();
+        SteppedWorld::QuietWorld oSteppedWorld(oScenario, fTimeStep);
+        oSteppedWorld.RunSimulation(kfHours);
+        const vector<double> kafValues = GetStatistics();
+
+        // The float sums of both worlds are also rounded differently.
+        bool bWithinTolerance = true;
+        double fGap = 0;
+        for (size_t uiMetric = 0; uiMetric < StatisticsWriter::GetMetricsCount(); uiMetric++)
+        {
+            for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+            {
+                const size_t kuiValue = uiMetric * static_cast<size_t>(AircraftCompany::TotalCompanies) + i;
+                const double kfDifference = fabs(kafValues[kuiValue] - kafExpected[kuiValue]);
+                const double kfTolerance = GetSteppedTolerance(uiMetric, static_cast<AircraftCompany>(i), kuiAircrafts, kfHours, fTimeStep,
+                                                               kafExpected);
+                bWithinTolerance = bWithinTolerance && kfDifference <= kfTolerance + 1e-4 * fabs(kafExpected[kuiValue]);
+                fGap += kfDifference / max(1.0, fabs(kafExpected[kuiValue]));
+            }
+        }
+        REQUIRE(bWithinTolerance);
+        REQUIRE(fGap < fLastGap);
+        fLastGap = fGap;
+    }
+
+    AircraftType::SetFaultSampling(FaultSampling());
+}
+
+// Test the SimpleWorld::World events and allocations counters.
+// Check the run allocates nothing once started, and every event goes through the heap or bypasses it.
+TEST_CASE( "SimpleWorld::World counters" )
+{
+    unique_ptr<Scenario> poScenario = CreateScenario();
+
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oWorld(*poScenario, 150);
+    REQUIRE(oWorld.GetHeapEvents() + oWorld.GetImmediateEvents() == 0);
+    oWorld.Start(20);
+    REQUIRE(oWorld.GetSystemAllocations() > 0);
+
+    uint64_t uiEvents = 0;
+    while (!oWorld.IsFinished())
+    {
+        uiEvents += oWorld.Step(1);
+    }
+    REQUIRE(oWorld.GetEventsAllocations() == 0);
+    REQUIRE(oWorld.GetHeapEvents() > 0);
+    REQUIRE(oWorld.GetImmediateEvents() > 0);
+    REQUIRE(uiEvents <= oWorld.GetHeapEvents() + oWorld.GetImmediateEvents());
+}
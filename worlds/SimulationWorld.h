@@ -3,12 +3,39 @@
 
 #include "aircrafts/Aircraft.h"
 #include "Charger.h"
+#include "Scenario.h"
+#include "StatisticsWriter.h"
 
+#include <chrono>
 #include <cstdint>
+#include <limits>
+#include <string_view>
 #include <vector>
 
 using namespace std;
 
+/**
+ * @brief The kinds of commands a world applies between its events.
+ * 
+ */
+enum class WorldCommandType : uint8_t
+{
+    GroundAircraft,     ///< Keep an aircraft on the ground once its flight and its charge are over.
+    ReleaseAircraft,    ///< Let a grounded aircraft fly again.
+    AddCharger,         ///< Add a charger to the site.
+};
+
+/**
+ * @brief A command to change a running world, sent from outside the
+ *        simulation, for example by the ground control software.
+ * 
+ */
+struct WorldCommand
+{
+    WorldCommandType eType = WorldCommandType::AddCharger; ///< The kind of command.
+    uint32_t uiAircraft = 0;                               ///< The index of the aircraft, for the aircraft commands.
+};
+
 /**
  * @brief Abstract class to represent a simulation world.
  * 
@@ -31,7 +58,7 @@ public:
      * @param uiMaxChargers      The maximum number of chargers that can be
      *                           in the world at the same time.
      */
-    SimulationWorld(uint8_t uiMaxAircrafts, uint8_t uiMaxChargers);
+    SimulationWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers);
 
 
     /********** Destructor **********/
@@ -75,6 +102,57 @@ public:
      */
     inline uint32_t GetChargersCount() const { return moChargers.size(); }
 
+    /**
+     * @brief Get the random seed used to create the world.
+     * 
+     * @return The random seed.
+     */
+    inline uint32_t GetSeed() const { return muiSeed; }
+
+    /**
+     * @brief Get the name of the kind of world.
+     * 
+     * @return The world name.
+     */
+    virtual string_view GetWorldName() const = 0;
+
+    /**
+     * @brief Get the time the simulation reached.
+     * 
+     * @return The time in hours.
+     */
+    virtual float GetWorldTime() const = 0;
+
+    /**
+     * @brief Get the time of the next event, or of the next step, to pace
+     *        the run with the wall clock.
+     * 
+     * @return The time in hours, infinite if nothing is pending.
+     */
+    virtual float GetNextTime() const = 0;
+
+    /**
+     * @brief Get the time the simulation ends.
+     * 
+     * @return The time in hours, infinite if the run has no end.
+     */
+    inline float GetHorizon() const { return mfSimulationTime; }
+
+    /**
+     * @brief Check if the simulation started.
+     * 
+     * @return If the simulation started.
+     */
+    inline bool IsStarted() const { return mbStarted; }
+
+    /**
+     * @brief Check if the simulation reached its end, and the flights and
+     *        charge sessions in progress were reported.
+     * 
+     * @return If the simulation finished.
+     */
+    inline bool IsFinished() const { return mbFinished; }
+
 
     /********** Methods **********/
 
@@ -83,7 +161,57 @@ public:
      * 
      * @param uiHours       The number of hours to run the simulation.
      */
-    virtual void RunSimulation(uint16_t uiHours) = 0;
+    void RunSimulation(uint16_t uiHours);
+
+    /**
+     * @brief Start the simulation, to advance it with RunUntil(), Step() and
+     *        StepFor(). It is started without end by them if it was not.
+     * 
+     * @param fHorizon      The time the simulation ends in hours, fractional
+     *                      or infinite. The flights and charge sessions in
+     *                      progress then are reported, a run without end only
+     *                      reports the finished ones.
+     * 
+     * @throw std::runtime_error if the simulation already started or the
+     *        horizon is negative.
+     * 
+     * @note  The times are single precision floats, so past 524288 hours
+     *        the events of a run are placed on a grid of 0.0625 hours, 3.75
+     *        minutes, and each time is rounded by up to half of it.
+     */
+    void Start(float fHorizon = numeric_limits<float>::infinity());
+
+    /**
+     * @brief Advance the simulation until a time, the events and the
+     *        statistics continue from the previous call.
+     * 
+     * @param fTime         The time in hours, the horizon at most.
+     */
+    void RunUntil(float fTime);
+
+    /**
+     * @brief Advance the simulation by a number of events, the events and the
+     *        statistics continue from the previous call.
+     * 
+     * @param uiMaxEvents   The maximum number of events to process.
+     * 
+     * @return The events processed, fewer if the simulation finished.
+     */
+    uint64_t Step(uint64_t uiMaxEvents);
+
+    /**
+     * @brief Advance the simulation for a wall clock time, to bound the time
+     *        of a call, the events and the statistics continue from the
+     *        previous call.
+     * 
+     * @param oBudget       The wall clock time to spend.
+     * 
+     * @return The events processed.
+     * 
+     * @note  The clock is checked every kuiEventsPerClockCheck events, so the
+     *        call can exceed the budget by the time of those events.
+     */
+    uint64_t StepFor(chrono::nanoseconds oBudget);
 
     /**
      * @brief Print the world statistics.
@@ -91,6 +219,36 @@ public:
      */
     virtual void PrintStatistics() const;
 
+    /**
+     * @brief Write the world statistics in a machine readable format.
+     * 
+     * @param oWriter   The statistics writer.
+     */
+    void ExportStatistics(StatisticsWriter& oWriter) const;
+
+    /**
+     * @brief Check the invariants of the whole fleet: the batteries are within
+     *        their capacity, the charging aircrafts are connected to a charger
+     *        in use, and no charger is shared.
+     * 
+     * @throw std::runtime_error if an invariant does not hold.
+     * 
+     * @note  The worlds call it periodically in validation builds, see Validation.h.
+     */
+    virtual void AuditInvariants() const;
+
+    /**
+     * @brief Apply a command between the events, at the time the world reached.
+     * 
+     * @param koCommand     The command.
+     * 
+     * @return If the command was applied, false if the world does not support
+     *         it, if it is not valid or if the simulation finished.
+     */
+    virtual bool ApplyCommand(const WorldCommand& koCommand);
+
+    static constexpr uint64_t kuiEventsPerClockCheck = 64; ///< The events processed between the clock checks of StepFor().
+
 protected:
     /********** Methods **********/
 
@@ -131,29 +289,75 @@ protected:
     bool AddCharger(Charger* oCharger);
 
     /**
-     * @brief Set the simulation time.
+     * @brief Get the simulation time, the time the simulation ends.
      * 
-     * @param uiTime        The simulation time.
+     * @return The simulation time.
      * 
      */
-    inline void SetSimulationTime(uint16_t uiTime) { muiSimulationTime = uiTime; }
+    inline float GetSimulationTime() const { return mfSimulationTime; }
 
     /**
-     * @brief Get the simulation time.
+     * @brief Start the events or the steps of the run, once the simulation
+     *        time is set.
      * 
-     * @return The simulation time.
+     */
+    virtual void BeginRun() = 0;
+
+    /**
+     * @brief Process the events until a time, or until a number of them.
+     * 
+     * @param fTime         The time in hours, the simulation time at most.
+     * @param uiMaxEvents   The maximum number of events to process.
+     * 
+     * @return The events processed.
+     * 
+     */
+    virtual uint64_t AdvanceRun(float fTime, uint64_t uiMaxEvents) = 0;
+
+    /**
+     * @brief Check if all the events until the end of the run were processed.
+     * 
+     * @return If the run is over.
+     * 
+     */
+    virtual bool IsRunOver() const = 0;
+
+    /**
+     * @brief End the run, reporting the flights and charge sessions in progress.
+     * 
+     */
+    virtual void EndRun() = 0;
+
+    /**
+     * @brief Set the random seed used to create the world.
+     * 
+     * @param uiSeed        The random seed.
+     * 
+     */
+    inline void SetSeed(uint32_t uiSeed) { muiSeed = uiSeed; }
+
+    /**
+     * @brief Choose the random seed of the world, the scenario one if any or
+     *        the current time, and seed the faults generators from it. The
+     *        worlds call it before creating their aircrafts.
+     * 
+     * @param poScenario    The scenario, or nullptr for random companies, then
+     *                      rand() is also seeded for choosing them.
      * 
      */
-    inline uint16_t GetSimulationTime() const { return muiSimulationTime; }
+    void SeedWorld(const Scenario* poScenario);
 
 private:
     /********** Variables **********/
 
     vector<Aircraft*> moAircrafts;
     vector<Charger*> moChargers;
-    uint16_t muiSimulationTime;
-    uint8_t muiMaxAircrafts;
-    uint8_t muiMaxChargers;
+    float mfSimulationTime;
+    bool mbStarted;
+    bool mbFinished;
+    uint32_t muiSeed;
+    uint32_t muiMaxAircrafts;
+    uint32_t muiMaxChargers;
 };
 
 #endif // _SIMULATION_WORLD_H_
@@ -0,0 +1,169 @@
+/**
+ * @brief Implementation of the SitePower class.
+ * 
+ */
+
+#include "SitePower.h"
+
+#include <algorithm>
+
+// Power below this is considered nothing, to absorb the rounding errors.
+static const float kfMinPower = 1e-3f;
+
+SitePower::SitePower(float fPowerCap, pmr::memory_resource* poMemory)
+    : moSessions(poMemory),
+      moSessionsIndex(poMemory),
+      moFirstThrottled(moSessions.end()),
+      mfPowerCap(fPowerCap),
+      mfFullPower(0),
+      muiThrottled(0),
+      mfLevel(0),
+      mfPower(0),
+      mfPeakPower(0),
+      mfEnergy(0),
+      mfTime(0)
+{
+    // Nothing to do here.
+}
+
+bool SitePower::HasPowerLeft() const
+{
+    // A new session gets at least an equal share of the cap.
+    return mfPowerCap == 0 || mfPowerCap / (moSessions.size() + 1) > kfMinPower;
+}
+
+float SitePower::StartSession(Aircraft* poAircraft, float fNominalPower, float fTime, vector<Aircraft*>& oChanged)
+{
+    Update(fTime);
+
+    // The session starts throttled if it is not below the first throttled one,
+    // the sessions with the same nominal power are inserted after it.
+    bool bThrottled = moFirstThrottled != moSessions.end() && !(fNominalPower < moFirstThrottled->first);
+    auto oSession = moSessions.emplace(fNominalPower, Session{ poAircraft, fNominalPower, bThrottled });
+    moSessionsIndex[poAircraft] = oSession;
+    if (bThrottled)
+    {
+        muiThrottled++;
+    }
+    else
+    {
+        mfFullPower += fNominalPower;
+    }
+
+    // Share the cap with the new session.
+    ShareTheCap(poAircraft, oChanged);
+    oSession->second.mfPower = oSession->second.mbThrottled ? mfLevel : fNominalPower;
+    mfPeakPower = max(mfPeakPower, mfPower);
+
+    return oSession->second.mfPower;
+}
+
+void SitePower::StopSession(Aircraft* poAircraft, float fTime, vector<Aircraft*>& oChanged)
+{
+    Update(fTime);
+
+    // Find the session.
+    auto oIndex = moSessionsIndex.find(poAircraft);
+    if (oIndex == moSessionsIndex.end())
+    {
+        return;
+    }
+
+    // Remove the session and release its power.
+    auto oSession = oIndex->second;
+    if (oSession == moFirstThrottled)
+    {
+        ++moFirstThrottled;
+    }
+    if (oSession->second.mbThrottled)
+    {
+        muiThrottled--;
+    }
+    else
+    {
+        mfFullPower -= oSession->first;
+    }
+    moSessions.erase(oSession);
+    moSessionsIndex.erase(oIndex);
+
+    // Share the released power with the other sessions.
+    ShareTheCap(poAircraft, oChanged);
+}
+
+float SitePower::GetSessionPower(Aircraft* poAircraft) const
+{
+    auto oIndex = moSessionsIndex.find(poAircraft);
+    return oIndex != moSessionsIndex.end() ? oIndex->second->second.mfPower : 0;
+}
+
+void SitePower::ShareTheCap(Aircraft* poSkipped, vector<Aircraft*>& oChanged)
+{
+    float fPreviousLevel = mfLevel;
+    bool bNewThrottled = false;
+
+    if (mfPowerCap > 0)
+    {
+        // Throttle the largest sessions at their nominal power while it is above
+        // the level they would share with the throttled ones.
+        while (moFirstThrottled != moSessions.begin())
+        {
+            auto oLast = prev(moFirstThrottled);
+            if (oLast->first * (muiThrottled + 1) <= mfPowerCap - mfFullPower + oLast->first)
+            {
+                break;
+            }
+
+            mfFullPower -= oLast->first;
+            muiThrottled++;
+            oLast->second.mbThrottled = true;
+            moFirstThrottled = oLast;
+            bNewThrottled = true;
+        }
+
+        // Give the nominal power to the smallest throttled sessions while it is
+        // not above the level.
+        while (moFirstThrottled != moSessions.end() && moFirstThrottled->first * muiThrottled <= mfPowerCap - mfFullPower)
+        {
+            Session& oSession = moFirstThrottled->second;
+            mfFullPower += moFirstThrottled->first;
+            muiThrottled--;
+            oSession.mbThrottled = false;
+            if (oSession.mfPower != moFirstThrottled->first && oSession.mpoAircraft != poSkipped)
+            {
+                oChanged.push_back(oSession.mpoAircraft);
+            }
+            oSession.mfPower = moFirstThrottled->first;
+            ++moFirstThrottled;
+        }
+    }
+
+    // Avoid accumulating rounding errors when no session is at its nominal power.
+    if (moFirstThrottled == moSessions.begin())
+    {
+        mfFullPower = 0;
+    }
+
+    // The throttled sessions split the power left equally, and get the whole cap.
+    mfLevel = muiThrottled > 0 ? (mfPowerCap - mfFullPower) / muiThrottled : 0;
+    mfPower = muiThrottled > 0 ? mfPowerCap : mfFullPower;
+
+    // Only the throttled sessions follow the level.
+    if (mfLevel != fPreviousLevel || bNewThrottled)
+    {
+        for (auto oSession = moFirstThrottled; oSession != moSessions.end(); ++oSession)
+        {
+            if (oSession->second.mfPower != mfLevel && oSession->second.mpoAircraft != poSkipped)
+            {
+                oChanged.push_back(oSession->second.mpoAircraft);
+            }
+            oSession->second.mfPower = mfLevel;
+        }
+    }
+}
+
+void SitePower::Update(float fTime)
+{
+    // Accumulate the energy delivered since the last update.
+    mfEnergy += mfPower * (fTime - mfTime);
+    mfTime = fTime;
+}
@@ -0,0 +1,91 @@
+/**
+ * @brief Contains tests for the SitePower class.
+ * 
+*/
+
+#include "SitePower.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <type_traits>
+
+// The sessions iterators cannot be copied or moved along with the site.
+static_assert(!is_copy_constructible_v<SitePower> && !is_move_constructible_v<SitePower>);
+static_assert(!is_copy_assignable_v<SitePower> && !is_move_assignable_v<SitePower>);
+
+// Test the SitePower::StartSession() method.
+TEST_CASE( "SitePower::StartSession" )
+{
+    // Check if the sessions get the nominal power without a cap.
+    Aircraft oAircraft1(AircraftCompany::Alpha);
+    Aircraft oAircraft2(AircraftCompany::Alpha);
+    Aircraft oAircraft3(AircraftCompany::Alpha);
+    vector<Aircraft*> oChanged;
+    SitePower oUnlimited;
+    REQUIRE(oUnlimited.StartSession(&oAircraft1, 100, 0, oChanged) == 100);
+    REQUIRE(oUnlimited.StartSession(&oAircraft2, 100, 0, oChanged) == 100);
+    REQUIRE(oChanged.empty());
+    REQUIRE(oUnlimited.HasPowerLeft());
+    REQUIRE(oUnlimited.GetPeakPower() == 200);
+
+    // Check if the sessions share the cap equally, the first one giving power to the second.
+    SitePower oCapped(150);
+    REQUIRE(oCapped.StartSession(&oAircraft1, 100, 0, oChanged) == 100);
+    REQUIRE(oCapped.StartSession(&oAircraft2, 100, 0, oChanged) == 75);
+    REQUIRE(oChanged.size() == 1);
+    REQUIRE(oChanged[0] == &oAircraft1);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft1) == 75);
+    REQUIRE(oCapped.HasPowerLeft());
+    REQUIRE(oCapped.GetPeakPower() == 150);
+
+    // Check if a session below the share gets its nominal power, and the others split the rest.
+    oChanged.clear();
+    REQUIRE(oCapped.StartSession(&oAircraft3, 30, 0, oChanged) == 30);
+    REQUIRE(oChanged.size() == 2);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft1) == 60);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft2) == 60);
+    REQUIRE(oCapped.GetPower() == 150);
+}
+
+// Test the SitePower::StopSession() method.
+TEST_CASE( "SitePower::StopSession" )
+{
+    // Check if the released power is shared by the throttled sessions.
+    Aircraft oAircraft1(AircraftCompany::Alpha);
+    Aircraft oAircraft2(AircraftCompany::Alpha);
+    Aircraft oAircraft3(AircraftCompany::Alpha);
+    vector<Aircraft*> oChanged;
+    SitePower oCapped(150);
+    oCapped.StartSession(&oAircraft1, 100, 0, oChanged);
+    oCapped.StartSession(&oAircraft2, 40, 0, oChanged);
+    oCapped.StartSession(&oAircraft3, 100, 0, oChanged);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft1) == 55);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft2) == 40);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft3) == 55);
+
+    oChanged.clear();
+    oCapped.StopSession(&oAircraft2, 1, oChanged);
+    REQUIRE(oChanged.size() == 2);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft1) == 75);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft3) == 75);
+    REQUIRE(oCapped.GetPower() == 150);
+
+    // Check if a session back to its nominal power is the only one changed.
+    oChanged.clear();
+    oCapped.StopSession(&oAircraft3, 2, oChanged);
+    REQUIRE(oChanged.size() == 1);
+    REQUIRE(oChanged[0] == &oAircraft1);
+    REQUIRE(oCapped.GetSessionPower(&oAircraft1) == 100);
+    REQUIRE(oCapped.GetPower() == 100);
+
+    // Check if stopping a session at its nominal power under the share changes nothing else.
+    oCapped.StartSession(&oAircraft2, 40, 2, oChanged);
+    oChanged.clear();
+    oCapped.StopSession(&oAircraft2, 3, oChanged);
+    REQUIRE(oChanged.empty());
+
+    // Check if the energy is accumulated with the power over time.
+    REQUIRE(oCapped.GetEnergy() == 150 + 150 + 140);
+    oCapped.Update(4);
+    REQUIRE(oCapped.GetEnergy() == 150 + 150 + 140 + 100);
+}
@@ -0,0 +1,168 @@
+#ifndef _SITE_POWER_H_
+#define _SITE_POWER_H_
+
+#include "aircrafts/Aircraft.h"
+
+#include <map>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The power model of a site whose chargers share a grid connection.
+ * 
+ * @note  The power is shared fairly: the sessions below an equal share of the
+ *        cap get their nominal power, and the rest split what is left equally.
+ *        That share is a water level over the sessions sorted by nominal
+ *        power, so starting or stopping a session only moves the level past
+ *        the sessions whose power changes, and only the throttled sessions
+ *        follow the level. The reallocation is O(changed sessions) instead of
+ *        re-solving the whole site.
+ * 
+ */
+class SitePower
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Site Power object.
+     * 
+     * @param fPowerCap     The site power cap in kW, 0 for unlimited.
+     * @param poMemory      The memory resource for the sessions.
+     */
+    SitePower(float fPowerCap = 0, pmr::memory_resource* poMemory = pmr::get_default_resource());
+
+    // The index and the first throttled session point into the sessions, a copy or a move would leave them dangling.
+    SitePower(const SitePower&) = delete;
+    SitePower(SitePower&&) = delete;
+    SitePower& operator=(const SitePower&) = delete;
+    SitePower& operator=(SitePower&&) = delete;
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the site power cap in kW.
+     * 
+     * @return The power cap, 0 if unlimited.
+     */
+    inline float GetPowerCap() const { return mfPowerCap; }
+
+    /**
+     * @brief Get the power being delivered by the site in kW.
+     * 
+     * @return The power being delivered.
+     */
+    inline float GetPower() const { return mfPower; }
+
+    /**
+     * @brief Get the peak power delivered by the site in kW.
+     * 
+     * @return The peak power.
+     */
+    inline float GetPeakPower() const { return mfPeakPower; }
+
+    /**
+     * @brief Get the energy delivered by the site until the last update in kWh.
+     * 
+     * @return The energy delivered.
+     */
+    inline float GetEnergy() const { return mfEnergy; }
+
+    /**
+     * @brief Get the time of the last update in hours.
+     * 
+     * @return The time of the last update.
+     */
+    inline float GetTime() const { return mfTime; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Gets if there is power left for a new charge session.
+     * 
+     * @return If a new charge session would get a share of the power.
+     */
+    bool HasPowerLeft() const;
+
+    /**
+     * @brief Start a charge session and share the power with it.
+     * 
+     * @param poAircraft        The aircraft charging.
+     * @param fNominalPower     The power the aircraft charges at without sharing in kW.
+     * @param fTime             The current time in hours.
+     * @param oChanged          The other aircrafts whose session power changed are appended here.
+     * 
+     * @return The power allocated to the session in kW.
+     */
+    float StartSession(Aircraft* poAircraft, float fNominalPower, float fTime, vector<Aircraft*>& oChanged);
+
+    /**
+     * @brief Stop a charge session and reallocate its power.
+     * 
+     * @param poAircraft        The aircraft charging.
+     * @param fTime             The current time in hours.
+     * @param oChanged          The aircrafts whose session power changed are appended here.
+     */
+    void StopSession(Aircraft* poAircraft, float fTime, vector<Aircraft*>& oChanged);
+
+    /**
+     * @brief Get the power allocated to a charge session.
+     * 
+     * @param poAircraft        The aircraft charging.
+     * 
+     * @return The power allocated in kW, 0 if the aircraft is not charging.
+     */
+    float GetSessionPower(Aircraft* poAircraft) const;
+
+    /**
+     * @brief Accumulate the energy delivered until a given time.
+     * 
+     * @param fTime             The current time in hours.
+     */
+    void Update(float fTime);
+
+private:
+    /**
+     * @brief A charge session at the site.
+     * 
+     */
+    struct Session
+    {
+        Aircraft* mpoAircraft; // The aircraft charging.
+        float mfPower;         // The power allocated in kW.
+        bool mbThrottled;      // If the session gets the shared level instead of its nominal power.
+    };
+
+    using Sessions = pmr::multimap<float, Session>;
+
+    /**
+     * @brief Move the water level to the sessions after a start or a stop,
+     *        and update the power of the sessions it changed.
+     * 
+     * @param poSkipped         The aircraft that started or stopped, not appended.
+     * @param oChanged          The aircrafts whose session power changed are appended here.
+     */
+    void ShareTheCap(Aircraft* poSkipped, vector<Aircraft*>& oChanged);
+
+    /********** Variables **********/
+
+    Sessions moSessions; // The sessions by nominal power.
+    pmr::unordered_map<Aircraft*, Sessions::iterator> moSessionsIndex; // The sessions by aircraft.
+    Sessions::iterator moFirstThrottled; // The first session under its nominal power, the rest are too.
+
+    float mfPowerCap;      // The site power cap in kW, 0 for unlimited.
+    float mfFullPower;     // The power of the sessions at their nominal power in kW.
+    uint32_t muiThrottled; // The number of sessions under their nominal power.
+    float mfLevel;         // The power of each throttled session in kW.
+    float mfPower;         // The power being delivered in kW.
+    float mfPeakPower;     // The peak power delivered in kW.
+    float mfEnergy;        // The energy delivered in kWh.
+    float mfTime;          // The time of the last update in hours.
+};
+
+#endif // _SITE_POWER_H_
@@ -0,0 +1,156 @@
+/**
+ * @brief Implementation of the statistics writers.
+ * 
+ */
+
+#include "StatisticsWriter.h"
+
+/*static*/ const StatisticsMetric StatisticsWriter::kaoMetrics[] = {
+    { "aircrafts", "Total number of aircrafts.", false,
+        [](const AircraftType& oType) -> float { return oType.TotalAircrafts(); } },
+    { "passengers_per_aircraft", "Passenger capacity per aircraft.", false,
+        [](const AircraftType& oType) -> float { return oType.GetPassengers(); } },
+    { "flights", "Total number of flights.", true,
+        [](const AircraftType& oType) -> float { return oType.TotalFlights(); } },
+    { "miles", "Total number of miles.", true,
+        [](const AircraftType& oType) -> float { return oType.TotalNumberOfMiles(); } },
+    { "passengers", "Total number of passengers.", true,
+        [](const AircraftType& oType) -> float { return oType.TotalNumberOfPassengers(); } },
+    { "charge_sessions", "Total number of charge sessions.", true,
+        [](const AircraftType& oType) -> float { return oType.TotalChargeSessions(); } },
+    { "average_flight_time_hours", "Average flight time per flight in hours.", false,
+        [](const AircraftType& oType) -> float { return oType.AverageFlightTimePerFlight(); } },
+    { "average_flight_distance_miles", "Average distance travelled per flight in miles.", false,
+        [](const AircraftType& oType) -> float { return oType.AverageDistanceTravelledPerFlight(); } },
+    { "average_charge_time_hours", "Average time charging per charge session in hours.", false,
+        [](const AircraftType& oType) -> float { return oType.AverageTimeChargingPerChargeSession(); } },
+    { "faults", "Total number of faults.", true,
+        [](const AircraftType& oType) -> float { return oType.TotalNumberOfFaults(); } },
+    { "estimated_faults", "Estimated number of faults, reweighted when the fault rate is importance sampled.", true,
+        [](const AircraftType& oType) -> float { return oType.EstimatedNumberOfFaults(); } },
+    { "passenger_miles", "Total number of passenger miles.", true,
+        [](const AircraftType& oType) -> float { return oType.TotalNumberOfPassengerMiles(); } },
+};
+
+/*static*/ const size_t StatisticsWriter::kuiMetricsCount = sizeof(kaoMetrics) / sizeof(kaoMetrics[0]);
+
+/*static*/ unique_ptr<StatisticsWriter> StatisticsWriter::Create(StatisticsFormat eFormat, ostream& oStream)
+{
+    switch (eFormat)
+    {
+        case StatisticsFormat::Json:       return make_unique<JsonStatisticsWriter>(oStream);
+        case StatisticsFormat::Csv:        return make_unique<CsvStatisticsWriter>(oStream);
+        case StatisticsFormat::Prometheus: return make_unique<PrometheusStatisticsWriter>(oStream);
+        default:                           return nullptr;
+    }
+}
+
+/*static*/ bool StatisticsWriter::ParseFormat(string_view sName, StatisticsFormat& eFormat)
+{
+    if (sName == "json")
+    {
+        eFormat = StatisticsFormat::Json;
+    }
+    else if (sName == "csv")
+    {
+        eFormat = StatisticsFormat::Csv;
+    }
+    else if (sName == "prometheus")
+    {
+        eFormat = StatisticsFormat::Prometheus;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*static*/ const StatisticsMetric* StatisticsWriter::FindMetric(string_view sName)
+{
+    for (const StatisticsMetric& koMetric : kaoMetrics)
+    {
+        if (koMetric.pcName == sName)
+        {
+            return &koMetric;
+        }
+    }
+
+    return nullptr;
+}
+
+void JsonStatisticsWriter::WriteRun(const RunMetadata& oRun)
+{
+    // The names are known identifiers, they do not need escaping.
+    moOutput << "{\"world\":\"" << oRun.sWorld << "\",\"seed\":" << oRun.uiSeed
+        << ",\"hours\":" << TextWriter::Shortest(oRun.fHours) << ",\"aircrafts\":" << oRun.uiAircrafts
+        << ",\"chargers\":" << oRun.uiChargers << ",\"aircraft_types\":[";
+
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        const AircraftType& oType = *AircraftType::GetAircraftType((AircraftCompany)i);
+        moOutput << (i > 0 ? ",{" : "{") << "\"company\":\"" << oType.CompanyName() << "\"";
+        for (size_t j = 0; j < kuiMetricsCount; j++)
+        {
+            moOutput << ",\"" << kaoMetrics[j].pcName << "\":" << TextWriter::Shortest(kaoMetrics[j].pfGetValue(oType));
+        }
+        moOutput << '}';
+    }
+
+    moOutput << "]}" << endl;
+}
+
+void CsvStatisticsWriter::WriteRun(const RunMetadata& oRun)
+{
+    // Write the header once, so the rows of many runs can be appended.
+    if (!mbHeaderWritten)
+    {
+        moOutput << "world,seed,hours,aircrafts_in_world,chargers,company";
+        for (size_t j = 0; j < kuiMetricsCount; j++)
+        {
+            moOutput << ',' << kaoMetrics[j].pcName;
+        }
+        moOutput << endl;
+        mbHeaderWritten = true;
+    }
+
+    for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+    {
+        const AircraftType& oType = *AircraftType::GetAircraftType((AircraftCompany)i);
+        moOutput << oRun.sWorld << ',' << oRun.uiSeed << ',' << TextWriter::Shortest(oRun.fHours) << ','
+            << oRun.uiAircrafts << ',' << oRun.uiChargers << ',' << oType.CompanyName();
+        for (size_t j = 0; j < kuiMetricsCount; j++)
+        {
+            moOutput << ',' << TextWriter::Shortest(kaoMetrics[j].pfGetValue(oType));
+        }
+        moOutput << endl;
+    }
+}
+
+void PrometheusStatisticsWriter::WriteRun(const RunMetadata& oRun)
+{
+    // The run description as an info metric.
+    moOutput << "# HELP evtol_run_info The simulation run description." << endl;
+    moOutput << "# TYPE evtol_run_info gauge" << endl;
+    moOutput << "evtol_run_info{world=\"" << oRun.sWorld << "\",seed=\"" << oRun.uiSeed
+        << "\",hours=\"" << TextWriter::Shortest(oRun.fHours) << "\",aircrafts=\"" << oRun.uiAircrafts
+        << "\",chargers=\"" << oRun.uiChargers << "\"} 1" << endl;
+
+    // A family per metric, with a sample per aircraft type.
+    for (size_t j = 0; j < kuiMetricsCount; j++)
+    {
+        const StatisticsMetric& oMetric = kaoMetrics[j];
+        const char* pcSuffix = oMetric.bCounter ? "_total" : "";
+        moOutput << "# HELP evtol_" << oMetric.pcName << pcSuffix << ' ' << oMetric.pcHelp << endl;
+        moOutput << "# TYPE evtol_" << oMetric.pcName << pcSuffix << (oMetric.bCounter ? " counter" : " gauge") << endl;
+
+        for (size_t i = 0; i < (size_t)AircraftCompany::TotalCompanies; i++)
+        {
+            const AircraftType& oType = *AircraftType::GetAircraftType((AircraftCompany)i);
+            moOutput << "evtol_" << oMetric.pcName << pcSuffix << "{world=\"" << oRun.sWorld
+                << "\",seed=\"" << oRun.uiSeed << "\",company=\"" << oType.CompanyName() << "\"} "
+                << TextWriter::Shortest(oMetric.pfGetValue(oType)) << endl;
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/**
+ * @brief Contains tests for the statistics writers.
+ * 
+*/
+
+#include "StatisticsWriter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <string>
+
+// The run used by the tests.
+static const RunMetadata koRun = { "simple", 42, 3, 20, 3 };
+
+// Count the lines of a text.
+static size_t CountLines(const string& sText)
+{
+    size_t uiLines = 0;
+    for (char cCharacter : sText)
+    {
+        uiLines += cCharacter == '\n';
+    }
+    return uiLines;
+}
+
+// Test the StatisticsWriter::ParseFormat() method.
+TEST_CASE( "StatisticsWriter::ParseFormat" )
+{
+    StatisticsFormat eFormat;
+    REQUIRE(StatisticsWriter::ParseFormat("json", eFormat));
+    REQUIRE(eFormat == StatisticsFormat::Json);
+    REQUIRE(StatisticsWriter::ParseFormat("csv", eFormat));
+    REQUIRE(eFormat == StatisticsFormat::Csv);
+    REQUIRE(StatisticsWriter::ParseFormat("prometheus", eFormat));
+    REQUIRE(eFormat == StatisticsFormat::Prometheus);
+    REQUIRE_FALSE(StatisticsWriter::ParseFormat("xml", eFormat));
+}
+
+// Test the JsonStatisticsWriter::WriteRun() method.
+// Check each run is a single line object with all the aircraft types.
+TEST_CASE( "JsonStatisticsWriter::WriteRun" )
+{
+    ostringstream oStream;
+    StatisticsWriter::Create(StatisticsFormat::Json, oStream)->WriteRun(koRun);
+
+    string sText = oStream.str();
+    REQUIRE(CountLines(sText) == 1);
+    REQUIRE(sText.rfind("{\"world\":\"simple\",\"seed\":42,\"hours\":3,\"aircrafts\":20,\"chargers\":3,\"aircraft_types\":[{", 0) == 0);
+    REQUIRE(sText.find("{\"company\":\"Alpha\",\"aircrafts\":") != string::npos);
+    REQUIRE(sText.find("{\"company\":\"Echo\",\"aircrafts\":") != string::npos);
+    REQUIRE(sText.find("\"passengers_per_aircraft\":4,") != string::npos);
+    REQUIRE(sText.substr(sText.size() - 4) == "}]}\n");
+}
+
+// Test the CsvStatisticsWriter::WriteRun() method.
+// Check the header is written once and there is a row per run and aircraft type.
+TEST_CASE( "CsvStatisticsWriter::WriteRun" )
+{
+    ostringstream oStream;
+    {
+        unique_ptr<StatisticsWriter> poWriter = StatisticsWriter::Create(StatisticsFormat::Csv, oStream);
+        poWriter->WriteRun(koRun);
+        poWriter->WriteRun(koRun);
+    }
+
+    string sText = oStream.str();
+    REQUIRE(CountLines(sText) == 1 + 2 * (size_t)AircraftCompany::TotalCompanies);
+    REQUIRE(sText.rfind("world,seed,hours,aircrafts_in_world,chargers,company,aircrafts,passengers_per_aircraft,", 0) == 0);
+    REQUIRE(sText.find("\nsimple,42,3,20,3,Alpha,") != string::npos);
+}
+
+// Test the PrometheusStatisticsWriter::WriteRun() method.
+// Check the metric families and the samples labels.
+TEST_CASE( "PrometheusStatisticsWriter::WriteRun" )
+{
+    ostringstream oStream;
+    StatisticsWriter::Create(StatisticsFormat::Prometheus, oStream)->WriteRun(koRun);
+
+    string sText = oStream.str();
+    REQUIRE(sText.find("evtol_run_info{world=\"simple\",seed=\"42\",hours=\"3\",aircrafts=\"20\",chargers=\"3\"} 1\n") != string::npos);
+    REQUIRE(sText.find("# TYPE evtol_flights_total counter\n") != string::npos);
+    REQUIRE(sText.find("# TYPE evtol_aircrafts gauge\n") != string::npos);
+    REQUIRE(sText.find("evtol_passengers_per_aircraft{world=\"simple\",seed=\"42\",company=\"Bravo\"} 5\n") != string::npos);
+}
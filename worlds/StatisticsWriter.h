@@ -0,0 +1,194 @@
+#ifndef _STATISTICS_WRITER_H_
+#define _STATISTICS_WRITER_H_
+
+#include "aircrafts/AircraftType.h"
+#include "utils/TextWriter.h"
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @brief The machine readable formats of the statistics.
+ * 
+ */
+enum class StatisticsFormat : uint8_t
+{
+    // One JSON object per run and line (JSON Lines).
+    Json,
+    // One CSV row per run and aircraft type, with a header row.
+    Csv,
+    // Prometheus text exposition format.
+    Prometheus,
+};
+
+/**
+ * @brief The description of a simulation run, written with its statistics.
+ * 
+ */
+struct RunMetadata
+{
+    string_view sWorld;     ///< The world name.
+    uint32_t uiSeed;        ///< The random seed of the run.
+    float fHours;           ///< The simulated hours.
+    uint32_t uiAircrafts;   ///< The number of aircrafts.
+    uint32_t uiChargers;    ///< The number of chargers.
+};
+
+/**
+ * @brief A statistic of an aircraft type.
+ * 
+ */
+struct StatisticsMetric
+{
+    const char* pcName;                             ///< The metric name, in snake case.
+    const char* pcHelp;                             ///< The metric description.
+    bool bCounter;                                  ///< If the metric only increases during a run.
+    float (*pfGetValue)(const AircraftType&);       ///< Gets the metric value of an aircraft type.
+};
+
+/**
+ * @brief Writes the statistics per aircraft type of simulation runs in a
+ *        machine readable format, straight from the aircraft types.
+ * 
+ * @note  The same metrics are printed by SimulationWorld::PrintStatistics.
+ *        The writers do not build the documents in memory, so a writer can
+ *        stream the statistics of thousands of runs.
+ * 
+ */
+class StatisticsWriter
+{
+public:
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Statistics Writer object.
+     * 
+     * @param oStream   The stream to write the statistics to.
+     */
+    explicit StatisticsWriter(ostream& oStream) : moOutput(oStream) {}
+
+    /********** Destructor **********/
+
+    /**
+     * @brief Destroy the Statistics Writer object.
+     * 
+     */
+    virtual ~StatisticsWriter() {}
+
+
+    /********** Static Methods **********/
+
+    /**
+     * @brief Create a writer for a format.
+     * 
+     * @param eFormat   The format.
+     * @param oStream   The stream to write the statistics to.
+     * 
+     * @return The writer.
+     */
+    static unique_ptr<StatisticsWriter> Create(StatisticsFormat eFormat, ostream& oStream);
+
+    /**
+     * @brief Get a format from its name.
+     * 
+     * @param sName     The format name: json, csv or prometheus.
+     * @param eFormat   Gets the format.
+     * 
+     * @return If the name is a known format.
+     */
+    static bool ParseFormat(string_view sName, StatisticsFormat& eFormat);
+
+    /**
+     * @brief Get a metric from its name.
+     * 
+     * @param sName     The metric name, in snake case.
+     * 
+     * @return The metric, or nullptr if the name is not a known metric.
+     */
+    static const StatisticsMetric* FindMetric(string_view sName);
+
+    /**
+     * @brief Get the number of metrics of each aircraft type.
+     * 
+     * @return The number of metrics.
+     */
+    static inline size_t GetMetricsCount() { return kuiMetricsCount; }
+
+    /**
+     * @brief Get a metric by its position.
+     * 
+     * @param uiMetric  The position of the metric, lower than GetMetricsCount().
+     * 
+     * @return The metric.
+     */
+    static inline const StatisticsMetric& GetMetric(size_t uiMetric) { return kaoMetrics[uiMetric]; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Write the statistics of all the aircraft types for a run.
+     * 
+     * @param oRun      The run description.
+     */
+    virtual void WriteRun(const RunMetadata& oRun) = 0;
+
+protected:
+    /********** Constants **********/
+
+    static const StatisticsMetric kaoMetrics[];     // The metrics of each aircraft type.
+    static const size_t kuiMetricsCount;            // The number of metrics.
+
+    /********** Variables **********/
+
+    TextWriter moOutput;
+};
+
+/**
+ * @brief Writes one JSON object per run and line.
+ * 
+ */
+class JsonStatisticsWriter : public StatisticsWriter
+{
+public:
+    using StatisticsWriter::StatisticsWriter;
+
+    void WriteRun(const RunMetadata& oRun) override;
+};
+
+/**
+ * @brief Writes one CSV row per run and aircraft type, after a header row.
+ * 
+ */
+class CsvStatisticsWriter : public StatisticsWriter
+{
+public:
+    using StatisticsWriter::StatisticsWriter;
+
+    void WriteRun(const RunMetadata& oRun) override;
+
+private:
+    bool mbHeaderWritten = false;   // If the header row was written.
+};
+
+/**
+ * @brief Writes the Prometheus text exposition format, one sample per
+ *        metric and aircraft type labelled with the world, seed and company.
+ * 
+ * @note  Each metric family is written once per run, so write one run per
+ *        exposition.
+ * 
+ */
+class PrometheusStatisticsWriter : public StatisticsWriter
+{
+public:
+    using StatisticsWriter::StatisticsWriter;
+
+    void WriteRun(const RunMetadata& oRun) override;
+};
+
+#endif // _STATISTICS_WRITER_H_
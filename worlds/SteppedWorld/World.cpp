@@ -0,0 +1,467 @@
+/**
+ * @brief Implementation of the SteppedWorld class methods,
+ *        constructors, and destructor.
+ * 
+ */
+
+#include "World.h"
+#include "aircrafts/Aircraft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace SteppedWorld
+{
+    template <class TraceSink>
+    BasicWorld<TraceSink>::BasicWorld(uint32_t uiAircrafts, uint32_t uiChargers, float fTimeStep, const Scenario* poScenario)
+        : SimulationWorld(uiAircrafts, uiChargers),
+        mfTimeStep(fTimeStep),
+        mfCurrentTime(0),
+        muiStep(0),
+        muiSteps(0)
+    {
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << "Creating a stepped world with " << uiAircrafts << " aircrafts and "
+                << uiChargers << " chargers, and a time step of " << mfTimeStep << " hours." << endl << endl;
+
+            TraceSink::Stream() << "Aircrafts added to the world:" << endl;
+        }
+
+        // Set the random seed for the aircrafts creation and the faults.
+        SeedWorld(poScenario);
+
+        // Create the aircrafts from the start, as in the scenario or choosing
+        // a random company for each one, and load their state into the arrays.
+        for (uint32_t i = 0; i < uiAircrafts; i++)
+        {
+            Aircraft* poAircraft = nullptr;
+            if (poScenario != nullptr)
+            {
+                // Create the aircraft with its initial charge, in line for a
+                // charger if it starts waiting.
+                const ScenarioAircraft& koInitial = poScenario->GetAircraft(i);
+                poAircraft = new Aircraft(koInitial.eCompany, koInitial.fStateOfCharge);
+                if (koInitial.eState == AircraftState::Queued)
+                {
+                    poAircraft->Queue();
+                }
+            }
+            else
+            {
+                // Choose a random company for the aircraft.
+                int iCompany = rand() % static_cast<int>(AircraftCompany::TotalCompanies);
+                AircraftCompany eCompany = static_cast<AircraftCompany>(iCompany);
+
+                // Create the aircraft.
+                poAircraft = new Aircraft(eCompany);
+            }
+
+            // Add the aircraft to the world.
+            AddAircraft(poAircraft);
+
+            // Load the aircraft state.
+            AircraftType* poAircraftType = poAircraft->GetAircraftType();
+            mafBatteryCharge.push_back(poAircraft->GetBatteryCharge());
+            mafBatteryCapacity.push_back(poAircraftType->GetBatteryCapacity());
+            mafDischargeRate.push_back(poAircraftType->GetEnergyUse() * poAircraftType->GetCruiseSpeed());
+            mafElapsedTime.push_back(0);
+            mafIsFlying.push_back(0);
+            maeState.push_back(poAircraft->GetState());
+            mauiCharger.push_back(0);
+            mauiFlights.push_back(0);
+        }
+
+        // Print the aircrafts added to the world in groups per type.
+        if constexpr (kbTrace)
+        {
+            for (uint8_t i = 0; i < static_cast<uint8_t>(AircraftCompany::TotalCompanies); i++)
+            {
+                // Get the pointer to the aircraft type.
+                AircraftType* poAircraftType = AircraftType::GetAircraftType(static_cast<AircraftCompany>(i));
+
+                // Print the company name and the number of aircrafts of that type.
+                TraceSink::Stream() << poAircraftType->CompanyName() << ": " << poAircraftType->TotalAircrafts() << endl;
+
+                // Print the aircrafts of that type.
+                for (Aircraft* poAircraft : GetAircrafts())
+                {
+                    if (poAircraft->GetAircraftType() == poAircraftType)
+                    {
+                        TraceSink::Stream() << " " << poAircraft->GetName();
+                    }
+                }
+
+                TraceSink::Stream() << endl;
+            }
+
+            TraceSink::Stream() << endl << "Chargers added to the world:" << endl;
+        }
+
+        // Create the chargers from the start.
+        for (uint32_t i = 0; i < uiChargers; i++)
+        {
+            // Create the charger and add it to the world.
+            Charger* poCharger = new Charger();
+            AddCharger(poCharger);
+            mabChargerBusy.push_back(false);
+            mauiChargerAircraft.push_back(0);
+
+            // Print that the charger was added to the world.
+            if constexpr (kbTrace)
+            {
+                TraceSink::Stream() << " " << poCharger->GetName();
+            }
+        }
+
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << endl << endl;
+        }
+    }
+
+    template <class TraceSink>
+    BasicWorld<TraceSink>::~BasicWorld()
+    {
+        // Destroy the aircrafts.
+        for (const Aircraft* poAircraft : GetAircrafts())
+        {
+            delete poAircraft;
+        }
+
+        // Destroy the chargers.
+        for (const Charger* poCharger : GetChargers())
+        {
+            delete poCharger;
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::BeginRun()
+    {
+        if constexpr (kbTrace)
+        {
+            // Print the start of the simulation.
+            TraceSink::Stream() << endl;
+            TraceSink::Stream() << "============================================" << endl;
+            if (isinf(GetSimulationTime()))
+            {
+                TraceSink::Stream() << " Running the simulation without end." << endl;
+            }
+            else
+            {
+                TraceSink::Stream() << " Running the simulation for " << TextWriter::Shortest(GetSimulationTime()) << " hours." << endl;
+            }
+            TraceSink::Stream() << "============================================" << endl << endl;
+
+            // Print the number of aircrafts and chargers in the world.
+            TraceSink::Stream() << "Number of aircrafts in the world: " << GetAircraftsCount() << endl;
+            TraceSink::Stream() << "Number of chargers in the world: " << GetChargersCount() << endl << endl;
+
+            // Indicate the start of the simulation events.
+            TraceSink::Stream() << "Simulation events:" << endl;
+        }
+        mfCurrentTime = 0;
+
+        // Take off the idle aircrafts and queue the others.
+        for (size_t i = 0; i < maeState.size(); i++)
+        {
+            if (maeState[i] == AircraftState::Idle)
+            {
+                TakeOff(i);
+            }
+            else
+            {
+                moAircraftsQueue.push(i);
+            }
+        }
+        AssignChargers();
+        WriteBackFleet();
+
+        // The steps until the end of the simulation, a run without end never runs out of them.
+        muiStep = 0;
+        muiSteps = isinf(GetSimulationTime()) ? numeric_limits<uint64_t>::max()
+            : static_cast<uint64_t>(ceil(GetSimulationTime() / mfTimeStep));
+    }
+
+    template <class TraceSink>
+    uint64_t BasicWorld<TraceSink>::AdvanceRun(float fTime, uint64_t uiMaxEvents)
+    {
+        // Advance the world by whole steps, the last step is shortened to end
+        // exactly at the simulation time.
+        uint64_t uiSteps = 0;
+        while (uiSteps < uiMaxEvents && muiStep < muiSteps)
+        {
+            float fNextTime = min((muiStep + 1) * mfTimeStep, GetSimulationTime());
+            if (fNextTime > fTime)
+            {
+                break;
+            }
+
+            Advance(fNextTime - mfCurrentTime);
+            mfCurrentTime = fNextTime;
+
+            ProcessTransitions();
+            AssignChargers();
+            muiStep++;
+            uiSteps++;
+        }
+
+        // Keep the aircrafts up to date for the callers stepping the world.
+        if (uiSteps > 0)
+        {
+            WriteBackFleet();
+        }
+
+        return uiSteps;
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::EndRun()
+    {
+        // Report the flights and charge sessions that did not finish.
+        ReportInterrupted();
+        WriteBackFleet();
+
+        // Indicate the end of the simulation events.
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << endl << "End of simulation events." << endl << endl;
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::Advance(float fTimeStep)
+    {
+        const size_t kuiAircrafts = maeState.size();
+        float* pfBatteryCharge = mafBatteryCharge.data();
+        float* pfElapsedTime = mafElapsedTime.data();
+        const float* pfDischargeRate = mafDischargeRate.data();
+        const float* pfIsFlying = mafIsFlying.data();
+
+        // Branch-free update of the whole fleet, the flying mask selects
+        // which aircrafts are using their battery.
+        for (size_t i = 0; i < kuiAircrafts; i++)
+        {
+            pfBatteryCharge[i] -= pfIsFlying[i] * pfDischargeRate[i] * fTimeStep;
+            pfElapsedTime[i] += pfIsFlying[i] * fTimeStep;
+        }
+
+        // Charge the aircrafts at the chargers.
+        for (size_t uiCharger = 0; uiCharger < mabChargerBusy.size(); uiCharger++)
+        {
+            if (!mabChargerBusy[uiCharger])
+            {
+                continue;
+            }
+
+            size_t i = mauiChargerAircraft[uiCharger];
+            const BatteryModel& oBatteryModel = GetAircrafts()[i]->GetAircraftType()->GetBatteryModel();
+            float fSoc = mafBatteryCharge[i] / mafBatteryCapacity[i];
+
+            // Stop at the exact time the battery gets full, or charge the whole step.
+            float fTimeToFullCharge = oBatteryModel.GetTimeToCharge(fSoc, 1.0f);
+            if (fTimeToFullCharge <= fTimeStep)
+            {
+                mafBatteryCharge[i] = mafBatteryCapacity[i];
+                mafElapsedTime[i] += fTimeToFullCharge;
+            }
+            else
+            {
+                mafBatteryCharge[i] = oBatteryModel.GetSocAfterCharging(fSoc, fTimeStep) * mafBatteryCapacity[i];
+                mafElapsedTime[i] += fTimeStep;
+            }
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::ProcessTransitions()
+    {
+        for (size_t i = 0; i < maeState.size(); i++)
+        {
+            AircraftType* poAircraftType = GetAircrafts()[i]->GetAircraftType();
+
+            if (maeState[i] == AircraftState::Flying && mafBatteryCharge[i] <= 0)
+            {
+                // Discount the time flown after running out of battery.
+                float fFlightTime = mafElapsedTime[i] + mafBatteryCharge[i] / mafDischargeRate[i];
+                mafBatteryCharge[i] = 0;
+
+                // Report the flight.
+                poAircraftType->ReportFlight(fFlightTime * poAircraftType->GetCruiseSpeed(), fFlightTime,
+                    GetAircrafts()[i]->GetId(), mauiFlights[i]++);
+
+                // Land the aircraft and put it in line for a charger.
+                maeState[i] = AircraftState::Queued;
+                mafIsFlying[i] = 0;
+                moAircraftsQueue.push(i);
+
+                // Print that the aircraft had landed.
+                if constexpr (kbTrace)
+                {
+                    TraceSink::Stream() << FormatCurrentTime() << ": Aircraft "
+                        << GetAircrafts()[i]->GetName() << " has landed." << endl;
+                }
+            }
+            else if (maeState[i] == AircraftState::Charging && mafBatteryCharge[i] >= mafBatteryCapacity[i])
+            {
+                // Report the charge session and free the charger.
+                poAircraftType->ReportChargeSession(mafElapsedTime[i]);
+                mabChargerBusy[mauiCharger[i]] = false;
+
+                // Print that the aircraft is fully charged.
+                if constexpr (kbTrace)
+                {
+                    TraceSink::Stream() << FormatCurrentTime() << ": Aircraft "
+                        << GetAircrafts()[i]->GetName() << " has been charged up to " << mafBatteryCharge[i]
+                        << " kWh, and has been disconnected from " << GetChargers()[mauiCharger[i]]->GetName() << "." << endl;
+                }
+
+                // Take off immediately.
+                TakeOff(i);
+            }
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::AssignChargers()
+    {
+        for (size_t uiCharger = 0; uiCharger < mabChargerBusy.size() && moAircraftsQueue.size() > 0; uiCharger++)
+        {
+            // Skip the chargers being used.
+            if (mabChargerBusy[uiCharger])
+            {
+                continue;
+            }
+
+            // Get the first aircraft in the queue.
+            size_t i = moAircraftsQueue.front();
+            moAircraftsQueue.pop();
+
+            // Connect the aircraft to the charger.
+            mabChargerBusy[uiCharger] = true;
+            mauiCharger[i] = static_cast<uint32_t>(uiCharger);
+            mauiChargerAircraft[uiCharger] = i;
+            maeState[i] = AircraftState::Charging;
+            mafElapsedTime[i] = 0;
+
+            // Print that the aircraft is charging.
+            if constexpr (kbTrace)
+            {
+                TraceSink::Stream() << FormatCurrentTime() << ": Aircraft "
+                    << GetAircrafts()[i]->GetName() << " is charging at " << GetChargers()[uiCharger]->GetName() << "." << endl;
+            }
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::TakeOff(size_t uiIndex)
+    {
+        maeState[uiIndex] = AircraftState::Flying;
+        mafIsFlying[uiIndex] = 1;
+        mafElapsedTime[uiIndex] = 0;
+
+        // Print that the aircraft is taking off.
+        if constexpr (kbTrace)
+        {
+            TraceSink::Stream() << FormatCurrentTime() << ": Aircraft "
+                << GetAircrafts()[uiIndex]->GetName() << " is taking off with " << mafBatteryCharge[uiIndex] << " kWh." << endl;
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::ReportInterrupted()
+    {
+        for (size_t i = 0; i < maeState.size(); i++)
+        {
+            AircraftType* poAircraftType = GetAircrafts()[i]->GetAircraftType();
+
+            switch (maeState[i])
+            {
+                case AircraftState::Flying:
+                {
+                    poAircraftType->ReportFlight(mafElapsedTime[i] * poAircraftType->GetCruiseSpeed(), mafElapsedTime[i],
+                        GetAircrafts()[i]->GetId(), mauiFlights[i]++);
+                }
+                break;
+
+                case AircraftState::Charging:
+                {
+                    poAircraftType->ReportChargeSession(mafElapsedTime[i]);
+                }
+                break;
+
+                case AircraftState::Queued:
+                {
+                    if constexpr (kbTrace)
+                    {
+                        TraceSink::Stream() << FormatCurrentTime() << ": Aircraft "
+                            << GetAircrafts()[i]->GetName() << " is not waiting for a free charger anymore." << endl;
+                    }
+                }
+                break;
+
+                default:
+                {
+                    // The aircrafts are always flying, queued or charging while running.
+                }
+                break;
+            }
+        }
+    }
+
+    template <class TraceSink>
+    void BasicWorld<TraceSink>::WriteBackFleet()
+    {
+        // Move every aircraft to its state, the chargers follow the aircrafts
+        // using them, but one can be released and taken in the same step.
+        for (size_t i = 0; i < maeState.size(); i++)
+        {
+            Charger* poCharger = maeState[i] == AircraftState::Charging ? GetChargers()[mauiCharger[i]] : nullptr;
+            GetAircrafts()[i]->MoveToState(maeState[i], clamp(mafBatteryCharge[i], 0.0f, mafBatteryCapacity[i]), poCharger);
+        }
+
+        // So set the chargers in use from the arrays afterwards.
+        for (size_t uiCharger = 0; uiCharger < mabChargerBusy.size(); uiCharger++)
+        {
+            if (mabChargerBusy[uiCharger])
+            {
+                GetChargers()[uiCharger]->StartCharging();
+            }
+            else
+            {
+                GetChargers()[uiCharger]->StopCharging();
+            }
+        }
+    }
+
+    // Build the worlds with the available trace sinks.
+    template class BasicWorld<ConsoleTrace>;
+    template class BasicWorld<NullTrace>;
+
+    unique_ptr<SimulationWorld> CreateWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers, bool bTraceEvents)
+    {
+        if (bTraceEvents)
+        {
+            return make_unique<BasicWorld<ConsoleTrace>>(uiMaxAircrafts, uiMaxChargers);
+        }
+
+        return make_unique<BasicWorld<NullTrace>>(uiMaxAircrafts, uiMaxChargers);
+    }
+
+    unique_ptr<SimulationWorld> CreateWorld(const Scenario& oScenario, bool bTraceEvents)
+    {
+        if (bTraceEvents)
+        {
+            return make_unique<BasicWorld<ConsoleTrace>>(oScenario);
+        }
+
+        return make_unique<BasicWorld<NullTrace>>(oScenario);
+    }
+
+} // namespace SteppedWorld
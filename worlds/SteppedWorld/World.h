@@ -0,0 +1,280 @@
+#ifndef _STEPPED_WORLD_H_
+#define _STEPPED_WORLD_H_
+
+#include "worlds/SimulationWorld.h"
+#include "worlds/Scenario.h"
+#include "worlds/TraceSinks.h"
+#include "aircrafts/Aircraft.h"
+#include "utils/TextWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+using namespace std;
+
+namespace SteppedWorld
+{
+    /**
+     * @brief This class represents the same world as SimpleWorld, but instead
+     *        of scheduling an event per state transition, it advances all the
+     *        aircrafts at fixed time steps.
+     * 
+     * @note  The aircrafts state is stored as a structure of arrays, so the
+     *        per step loop over the flying fleet can be vectorised by the
+     *        compiler. Only the aircrafts at the chargers are charging, those
+     *        are advanced per charger with the aircraft type battery model.
+     *        The flights and charge sessions are reported when they finish,
+     *        with their exact duration, so the statistics only differ from
+     *        the event driven world by the transitions being delayed up to
+     *        one time step. The arrays hold the aircraft states of the
+     *        transitions table, and are written back to the aircrafts and
+     *        the chargers every time the world is advanced.
+     * 
+     *        The world is a template of its trace sink like the simple world,
+     *        so a quiet world has no printing code in its steps.
+     * 
+     *        A world runs in the thread that steps it, there is no parallel
+     *        split of a step. The scenarios and the service allow fleets of
+     *        many thousands of aircrafts, which each step advances on one
+     *        core, and the transitions must stay in that thread as they are
+     *        reported to its thread local aircraft types. The threads are
+     *        used by running many worlds at once, as the sweeps and the
+     *        service do.
+     * 
+     * @tparam TraceSink    The trace sink policy, see worlds/TraceSinks.h.
+     */
+    template <class TraceSink>
+    class BasicWorld : public SimulationWorld
+    {
+    public:
+        /********** Constructors **********/
+
+        /**
+         * @brief Construct a new Stepped World object.
+         * 
+         * @param uiMaxAircrafts     The maximum number of aircrafts that can be
+         *                           in the world at the same time.
+         * @param uiMaxChargers      The maximum number of chargers that can be
+         *                           in the world at the same time.
+         * @param fTimeStep          The time step in hours, the smaller the closer
+         *                           to the event driven world statistics.
+         */
+        BasicWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers, float fTimeStep = 1.0f / 60.0f)
+            : BasicWorld(uiMaxAircrafts, uiMaxChargers, fTimeStep, nullptr) {}
+
+        /**
+         * @brief Construct a new Stepped World object with the fleet of a scenario.
+         * 
+         * @param oScenario          The scenario, only used while constructing.
+         * @param fTimeStep          The time step in hours, the smaller the closer
+         *                           to the event driven world statistics.
+         */
+        BasicWorld(const Scenario& oScenario, float fTimeStep = 1.0f / 60.0f)
+            : BasicWorld(oScenario.GetAircraftsCount(), oScenario.GetChargersCount(), fTimeStep, &oScenario) {}
+
+        /********** Destructor **********/
+
+        /**
+         * @brief Destroy the Stepped World object.
+         * 
+         */
+        ~BasicWorld();
+
+        /********** Properties **********/
+
+        /**
+         * @brief Get the time step in hours.
+         * 
+         * @return The time step.
+         */
+        inline float GetTimeStep() const { return mfTimeStep; }
+
+        /**
+         * @brief Get the name of the kind of world.
+         * 
+         * @return The world name.
+         */
+        inline string_view GetWorldName() const override { return "stepped"; }
+
+        /**
+         * @brief Get the time the simulation reached, the time of the last step.
+         * 
+         * @return The time in hours.
+         */
+        inline float GetWorldTime() const override { return mfCurrentTime; }
+
+        /**
+         * @brief Get the time of the next step.
+         * 
+         * @return The time in hours, infinite once the steps are over.
+         */
+        inline float GetNextTime() const override
+        {
+            return muiStep < muiSteps ? min((muiStep + 1) * mfTimeStep, GetSimulationTime()) : numeric_limits<float>::infinity();
+        }
+
+    protected:
+        /********** Methods **********/
+
+        /**
+         * @brief Take off the idle aircrafts and queue the others.
+         * 
+         */
+        void BeginRun() override;
+
+        /**
+         * @brief Advance the world by fixed time steps, each one counts as an
+         *        event, the last step is shortened to end exactly at the
+         *        simulation time.
+         * 
+         * @param fTime         The time in hours, the world stops at the last
+         *                      step before it.
+         * @param uiMaxEvents   The maximum number of steps.
+         * 
+         * @return The steps advanced.
+         */
+        uint64_t AdvanceRun(float fTime, uint64_t uiMaxEvents) override;
+
+        /**
+         * @brief Check if the world advanced until the simulation time.
+         * 
+         * @return If the run is over.
+         */
+        inline bool IsRunOver() const override { return muiStep == muiSteps; }
+
+        /**
+         * @brief Report the flights and charge sessions in progress.
+         * 
+         */
+        void EndRun() override;
+
+    private:
+        /********** Constants **********/
+
+        static constexpr bool kbTrace = TraceSink::kbEnabled; // If the world prints its events.
+
+        /**
+         * @brief Construct a new Stepped World object, with random companies or
+         *        with the fleet of a scenario.
+         * 
+         * @param uiAircrafts        The number of aircrafts.
+         * @param uiChargers         The number of chargers.
+         * @param fTimeStep          The time step in hours.
+         * @param poScenario         The scenario, or nullptr for random companies.
+         */
+        BasicWorld(uint32_t uiAircrafts, uint32_t uiChargers, float fTimeStep, const Scenario* poScenario);
+
+        /**
+         * @brief Advance the batteries and the flight and charge times of all
+         *        the aircrafts by one time step.
+         * 
+         * @param fTimeStep     The time step in hours.
+         */
+        void Advance(float fTimeStep);
+
+        /**
+         * @brief Land the aircrafts out of battery and disconnect the fully
+         *        charged ones, reporting the finished flights and sessions.
+         * 
+         */
+        void ProcessTransitions();
+
+        /**
+         * @brief Assign the free chargers to the aircrafts waiting in the queue.
+         * 
+         */
+        void AssignChargers();
+
+        /**
+         * @brief Take off an aircraft with its current battery charge.
+         * 
+         * @param uiIndex     The index of the aircraft.
+         */
+        void TakeOff(size_t uiIndex);
+
+        /**
+         * @brief Report the flights and charge sessions interrupted by the
+         *        end of the simulation.
+         * 
+         */
+        void ReportInterrupted();
+
+        /**
+         * @brief Write the states and the battery charges of the arrays back to
+         *        the aircrafts, through their transitions, and the chargers in use.
+         * 
+         */
+        void WriteBackFleet();
+
+        /**
+         * @brief Get the current time to write it with 2 decimal positions.
+         * 
+         * @return The current time formatted.
+         */
+        inline TextWriter::Fixed FormatCurrentTime() const { return TextWriter::Fixed(mfCurrentTime, 2); }
+
+        /********** Variables **********/
+        float mfTimeStep; // The time step in hours.
+        float mfCurrentTime; // The current time in the world.
+        uint64_t muiStep; // The steps advanced.
+        uint64_t muiSteps; // The steps until the simulation time, the maximum without end.
+
+        // Aircrafts state, one entry per aircraft.
+        vector<float> mafBatteryCharge;   // The battery charge in kWh.
+        vector<float> mafBatteryCapacity; // The battery capacity in kWh.
+        vector<float> mafDischargeRate;   // The energy used per hour flying in kWh.
+        vector<float> mafElapsedTime;     // The time flying or charging in the current state in hours.
+        vector<float> mafIsFlying;        // 1 if the aircraft is flying, 0 otherwise.
+        vector<AircraftState> maeState;   // The aircraft state, flying, queued or charging once running.
+        vector<uint32_t> mauiCharger;     // The charger index used by the aircraft while charging.
+        vector<uint32_t> mauiFlights;     // The flights reported by the aircraft, which number its fault draws.
+
+        // Chargers state, one entry per charger.
+        vector<uint8_t> mabChargerBusy;   // If the charger is being used.
+        vector<size_t> mauiChargerAircraft; // The aircraft index charging at the charger.
+
+        queue<size_t> moAircraftsQueue;   // The queue of aircrafts waiting to be charged.
+    };
+
+    /**
+     * @brief The stepped world printing its events to the console.
+     * 
+     */
+    using World = BasicWorld<ConsoleTrace>;
+
+    /**
+     * @brief The stepped world without printing its events.
+     * 
+     */
+    using QuietWorld = BasicWorld<NullTrace>;
+
+    /**
+     * @brief Create a stepped world choosing the trace sink at runtime.
+     * 
+     * @param uiMaxAircrafts     The maximum number of aircrafts that can be
+     *                           in the world at the same time.
+     * @param uiMaxChargers      The maximum number of chargers that can be
+     *                           in the world at the same time.
+     * @param bTraceEvents       If the world prints its events.
+     * 
+     * @return The new world.
+     */
+    unique_ptr<SimulationWorld> CreateWorld(uint32_t uiMaxAircrafts, uint32_t uiMaxChargers, bool bTraceEvents);
+
+    /**
+     * @brief Create a stepped world with the fleet of a scenario, choosing the
+     *        trace sink at runtime.
+     * 
+     * @param oScenario          The scenario, only used while creating the world.
+     * @param bTraceEvents       If the world prints its events.
+     * 
+     * @return The new world.
+     */
+    unique_ptr<SimulationWorld> CreateWorld(const Scenario& oScenario, bool bTraceEvents);
+}
+
+#endif // _STEPPED_WORLD_H_
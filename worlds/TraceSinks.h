@@ -0,0 +1,43 @@
+#ifndef _TRACE_SINKS_H_
+#define _TRACE_SINKS_H_
+
+#include "utils/TextWriter.h"
+
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Trace sink that prints the world events to the console.
+ * 
+ * @note  A trace sink is a compile time policy of the world, it must
+ *        provide kbEnabled and, if enabled, a Stream() to print to.
+ * 
+ */
+struct ConsoleTrace
+{
+    static constexpr bool kbEnabled = true; ///< The world prints its events.
+
+    /**
+     * @brief Get the writer to print the events to.
+     * 
+     * @return The console writer, shared by all the worlds.
+     */
+    static inline TextWriter& Stream()
+    {
+        static TextWriter soConsole(cout);
+        return soConsole;
+    }
+};
+
+/**
+ * @brief Trace sink that discards the world events, the world is built
+ *        without any tracing code on the events path.
+ * 
+ */
+struct NullTrace
+{
+    static constexpr bool kbEnabled = false; ///< The world does not print its events.
+};
+
+#endif // _TRACE_SINKS_H_
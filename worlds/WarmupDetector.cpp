@@ -0,0 +1,89 @@
+/**
+ * @brief Implementation of the WarmupDetector class.
+ *
+ */
+
+#include "WarmupDetector.h"
+
+#include <algorithm>
+
+WarmupDetector::WarmupDetector()
+    : muiSamples(0),
+      moBatch{},
+      mbDetected(false),
+      muiTruncationBatches(0)
+{
+    for (size_t i = 0; i < kuiGauges; i++)
+    {
+        maafSums[i].push_back(0);
+        maafSquares[i].push_back(0);
+    }
+}
+
+void WarmupDetector::Add(const FleetGauges& oGauges)
+{
+    for (size_t i = 0; i < kuiGauges; i++)
+    {
+        moBatch[i] += oGauges[i];
+    }
+
+    // Wait for the batch to complete.
+    if (++muiSamples % kuiBatchSize != 0)
+    {
+        return;
+    }
+
+    // Add the batch means to the prefix sums, and start the next batch.
+    for (size_t i = 0; i < kuiGauges; i++)
+    {
+        double fMean = static_cast<double>(moBatch[i]) / kuiBatchSize;
+        maafSums[i].push_back(maafSums[i].back() + fMean);
+        maafSquares[i].push_back(maafSquares[i].back() + fMean * fMean);
+    }
+    moBatch.fill(0);
+
+    // Check the rule once there are enough batches, the warm-up ends with the slowest gauge.
+    const size_t kuiBatches = maafSums[0].size() - 1;
+    if (mbDetected || kuiBatches < kuiMinBatches)
+    {
+        return;
+    }
+
+    size_t uiTruncation = 0;
+    for (size_t i = 0; i < kuiGauges; i++)
+    {
+        size_t uiGaugeTruncation = FindTruncation(maafSums[i], maafSquares[i], kuiBatches / 2);
+        if (uiGaugeTruncation == kuiBatches / 2)
+        {
+            return;
+        }
+        uiTruncation = max(uiTruncation, uiGaugeTruncation);
+    }
+
+    mbDetected = true;
+    muiTruncationBatches = uiTruncation;
+}
+
+/*static*/ size_t WarmupDetector::FindTruncation(const vector<double>& afSums, const vector<double>& afSquares, size_t uiMaxBatches)
+{
+    const size_t kuiBatches = afSums.size() - 1;
+    size_t uiBest = 0;
+    double fBestError = 0;
+    for (size_t d = 0; d <= uiMaxBatches && d < kuiBatches; d++)
+    {
+        // The sum of the squared deviations of the batches left, from their sums.
+        const double kfCount = static_cast<double>(kuiBatches - d);
+        const double kfSum = afSums[kuiBatches] - afSums[d];
+        const double kfSquares = max(0.0, afSquares[kuiBatches] - afSquares[d] - kfSum * kfSum / kfCount);
+        const double kfError = kfSquares / (kfCount * kfCount);
+
+        // Ignore the rounding differences, as for a constant series.
+        if (d == 0 || kfError < fBestError * (1 - 1e-9))
+        {
+            uiBest = d;
+            fBestError = kfError;
+        }
+    }
+
+    return uiBest;
+}
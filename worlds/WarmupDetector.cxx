@@ -0,0 +1,92 @@
+/**
+ * @brief Contains tests for the WarmupDetector class.
+ *
+*/
+
+#include "WarmupDetector.h"
+#include "worlds/SimpleWorld/World.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+// Get gauges with all the values equal.
+static FleetGauges MakeGauges(float fValue)
+{
+    FleetGauges oGauges;
+    oGauges.fill(fValue);
+    return oGauges;
+}
+
+// Test the WarmupDetector::Add() method.
+// Check a decaying transient is truncated, and a constant series is steady from the start.
+TEST_CASE( "WarmupDetector::Add" )
+{
+    // A transient decaying in about 100 samples, then oscillating around 0.
+    WarmupDetector oDetector;
+    for (int i = 0; i < 1000 && !oDetector.IsDetected(); i++)
+    {
+        oDetector.Add(MakeGauges(20.0f * exp(-i / 25.0f) + sin(i * 1.3f)));
+    }
+    REQUIRE(oDetector.IsDetected());
+    REQUIRE(oDetector.GetTruncationSamples() >= 50);
+    REQUIRE(oDetector.GetTruncationSamples() <= 150);
+    REQUIRE(oDetector.GetSamplesCount() >= 2 * oDetector.GetTruncationSamples());
+
+    // A constant series is detected at the first check, without truncation.
+    WarmupDetector oConstant;
+    for (uint32_t i = 0; i < WarmupDetector::kuiBatchSize * WarmupDetector::kuiMinBatches; i++)
+    {
+        REQUIRE_FALSE(oConstant.IsDetected());
+        oConstant.Add(MakeGauges(3.0f));
+    }
+    REQUIRE(oConstant.IsDetected());
+    REQUIRE(oConstant.GetTruncationSamples() == 0);
+
+    // A trend is never steady.
+    WarmupDetector oTrend;
+    for (int i = 0; i < 1000; i++)
+    {
+        oTrend.Add(MakeGauges(i * 0.1f));
+    }
+    REQUIRE_FALSE(oTrend.IsDetected());
+}
+
+// Test the warm-up detection of the simple world.
+// Check the run ends some hours after the warm-up, with the statistics restarted at it.
+TEST_CASE( "WarmupDetector::World" )
+{
+    Scenario oScenario;
+    oScenario.SetChargersCount(3);
+    oScenario.SetSeed(42);
+    oScenario.AddAircrafts(AircraftCompany::Alpha, 4, 1.0f, AircraftState::Idle);
+    oScenario.AddAircrafts(AircraftCompany::Bravo, 4, 1.0f, AircraftState::Idle);
+    oScenario.AddAircrafts(AircraftCompany::Delta, 4, 1.0f, AircraftState::Idle);
+
+    // The whole run.
+    AircraftType::ResetStatistics();
+    SimpleWorld::QuietWorld oFullWorld(oScenario);
+    oFullWorld.RunSimulation(200);
+    uint32_t uiFullFlights = AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights();
+
+    // The run after the warm-up.
+    AircraftType::ResetStatistics();
+    MetricsSampler oSampler(0.05f);
+    WarmupDetector oDetector;
+    SimpleWorld::QuietWorld oWorld(oScenario);
+    oWorld.SetMetricsSampler(&oSampler);
+    oWorld.SetWarmupDetector(&oDetector, 10);
+    oWorld.RunSimulation(200);
+
+    REQUIRE(oDetector.IsDetected());
+    REQUIRE(oWorld.GetWarmupTime() > 0);
+    REQUIRE(oWorld.GetWarmupTime() + 10 < 200);
+    REQUIRE(oDetector.GetTruncationSamples() * oSampler.GetInterval() <= oWorld.GetWarmupTime());
+
+    // The samples stop at the end of the run, and the statistics only have its last hours.
+    REQUIRE(oSampler.GetNextSampleTime() <= oWorld.GetWarmupTime() + 10 + oSampler.GetInterval());
+    uint32_t uiFlights = AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalFlights();
+    REQUIRE(uiFlights > 0);
+    REQUIRE(uiFlights < uiFullFlights / 5);
+    REQUIRE(AircraftType::GetAircraftType(AircraftCompany::Alpha)->TotalAircrafts() == 4);
+}
@@ -0,0 +1,106 @@
+#ifndef _WARMUP_DETECTOR_H_
+#define _WARMUP_DETECTOR_H_
+
+#include "MetricsSampler.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Detects the end of the initial transient of the fleet gauges, as
+ *        the mass take off at the start and the charger stampede after it,
+ *        with the MSER-5 rule (Marginal Standard Error Rule on the means of
+ *        batches of 5 samples).
+ *
+ * @note  For each gauge, the truncation is the number of batches d that
+ *        minimises the squared standard error of the mean of the batches
+ *        left, sum((Z_j - mean)^2) / (n - d)^2. The samples are added one
+ *        at a time, and the rule is checked every time a batch completes,
+ *        in O(n) with the prefix sums of the batch means. The warm-up is
+ *        detected once the truncation of every gauge is in the first half
+ *        of the batches, a truncation in the second half means the run is
+ *        still in the transient.
+ *
+ */
+class WarmupDetector
+{
+public:
+    /********** Constants **********/
+
+    static constexpr uint32_t kuiBatchSize = 5;     ///< The samples per batch.
+    static constexpr uint32_t kuiMinBatches = 10;   ///< The batches before checking the rule.
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Construct a new Warmup Detector object without samples.
+     *
+     */
+    WarmupDetector();
+
+
+    /********** Properties **********/
+
+    /**
+     * @brief Get the number of samples added.
+     *
+     * @return The number of samples.
+     */
+    inline uint64_t GetSamplesCount() const { return muiSamples; }
+
+    /**
+     * @brief Check if the end of the warm-up was detected.
+     *
+     * @return If the warm-up was detected, it does not change afterwards.
+     */
+    inline bool IsDetected() const { return mbDetected; }
+
+    /**
+     * @brief Get the samples of the warm-up, to discard from the start.
+     *
+     * @return The samples to discard, 0 until the warm-up is detected.
+     */
+    inline uint64_t GetTruncationSamples() const { return muiTruncationBatches * kuiBatchSize; }
+
+
+    /********** Methods **********/
+
+    /**
+     * @brief Add the next sample of the gauges, and check the rule if it
+     *        completes a batch and the warm-up was not detected yet.
+     *
+     * @param oGauges   The gauges values.
+     */
+    void Add(const FleetGauges& oGauges);
+
+    /**
+     * @brief Find the MSER truncation of a series of batch means.
+     *
+     * @param afSums        The prefix sums of the batch means, n + 1 of them from 0.
+     * @param afSquares     The prefix sums of the squared batch means, n + 1 of them from 0.
+     * @param uiMaxBatches  The most batches to truncate.
+     *
+     * @return The number of batches to truncate, the first one with the minimum error.
+     */
+    static size_t FindTruncation(const vector<double>& afSums, const vector<double>& afSquares, size_t uiMaxBatches);
+
+private:
+    /********** Constants **********/
+
+    static constexpr size_t kuiGauges = (size_t)FleetGauge::TotalGauges;
+
+    /********** Variables **********/
+
+    uint64_t muiSamples;                        // The samples added.
+    FleetGauges moBatch;                        // The sums of the samples of the batch in progress.
+    array<vector<double>, kuiGauges> maafSums;  // The prefix sums of the batch means per gauge.
+    array<vector<double>, kuiGauges> maafSquares; // The prefix sums of the squared batch means per gauge.
+    bool mbDetected;                            // If the warm-up was detected.
+    size_t muiTruncationBatches;                // The batches of the warm-up, once detected.
+};
+
+#endif // _WARMUP_DETECTOR_H_